@@ -0,0 +1,70 @@
+#pragma once
+
+#include "benchmark/benchmark.h"
+
+#include "notf/app/application.hpp"
+#include "notf/app/graph/window.hpp"
+#include "notf/app/widget/widget_scene.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// benchmark scene ================================================================================================== //
+
+/// Application with a single, invisible Window showing a WidgetScene, for benchmarks of real Widgets.
+/// Widgets can only exist within an Application, which in turn requires a display to create its OpenGL context. If the
+/// Application cannot be started, the benchmark is skipped with an error and has to return right away.
+class BenchmarkScene {
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    /// Constructor.
+    /// @param state    Benchmark state, used to skip the benchmark if the Application cannot be started.
+    /// @param size     Size of the Window and the WidgetScene.
+    BenchmarkScene(benchmark::State& state, const Size2i& size = Size2i(1920, 1080)) {
+        try {
+            m_app = std::make_unique<TheApplication>(TheApplication::Arguments("Benchmark", -1, nullptr));
+        }
+        catch (const notf_exception& error) {
+            state.SkipWithError(error.what());
+            for (auto _ : state) {} // a skipped benchmark still has to start (and finish) its state loop
+            return;
+        }
+
+        Window::Arguments arguments;
+        arguments.size = size;
+        arguments.is_visible = false;
+        m_window = Window::create(arguments);
+        m_scene = m_window->set_scene<WidgetScene>();
+    }
+
+    /// Whether the Application is running and the Scene can be used.
+    bool is_running() const { return m_app != nullptr; }
+
+    /// The Window, owns the OpenGL context.
+    WindowHandle& get_window() { return m_window; }
+
+    /// The WidgetScene in the Window.
+    WidgetSceneHandle& get_scene() { return m_scene; }
+
+    /// Sets a new Widget at the top of the hierarchy in the Scene and lays it out.
+    /// @param args Arguments that are forwarded to the constructor of the Widget.
+    template<class T, class... Args>
+    NodeHandle<T> set_widget(Args&&... args) {
+        NodeHandle<T> widget = m_scene->set_widget<T>(std::forward<Args>(args)...);
+        m_scene->update_layout();
+        return widget;
+    }
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Application, must outlive all Nodes.
+    std::unique_ptr<TheApplication> m_app;
+
+    /// Window containing the Scene.
+    WindowHandle m_window;
+
+    /// WidgetScene in the Window.
+    WidgetSceneHandle m_scene;
+};
+
+NOTF_CLOSE_NAMESPACE
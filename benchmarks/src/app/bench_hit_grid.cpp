@@ -0,0 +1,234 @@
+#include <algorithm>
+
+#include "benchmark/benchmark.h"
+
+#include "notf/common/random.hpp"
+
+#include "notf/app/widget/hit_grid.hpp"
+#include "notf/app/widget/widget.hpp"
+
+#include "bench/app.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Size of the simulated window.
+const Aabrf window_rect(Size2f(1920, 1080));
+
+/// Produces `count` random rects of varying sizes inside the window.
+std::vector<Aabrf> produce_rects(const size_t count) {
+    std::vector<Aabrf> rects(count);
+    for (Aabrf& rect : rects) {
+        const float width = random(5.f, 40.f);
+        const float height = random(5.f, 40.f);
+        rect = Aabrf(random(0.f, window_rect.get_width() - width), random(0.f, window_rect.get_height() - height),
+                     width, height);
+    }
+    return rects;
+}
+
+/// Produces a path of mouse positions, moving across the window in small steps like a mouse cursor would.
+std::vector<V2f> produce_mouse_path() {
+    std::vector<V2f> path(1024);
+    V2f position = window_rect.get_center();
+    for (V2f& point : path) {
+        position.x() = clamp(position.x() + random(-8.f, 8.f), 0, window_rect.get_width());
+        position.y() = clamp(position.y() + random(-8.f, 8.f), 0, window_rect.get_height());
+        point = position;
+    }
+    return path;
+}
+
+/// Grid containing `count` random rects, the value of each entry is its draw order.
+HitGrid<size_t> produce_grid(const std::vector<Aabrf>& rects) {
+    HitGrid<size_t> grid(window_rect, 64);
+    for (size_t i = 0; i < rects.size(); ++i) {
+        grid.insert(rects[i], i);
+    }
+    return grid;
+}
+
+// widgets ====================================================================
+
+class FieldWidget;
+class RectWidget;
+
+struct FieldState : State<FieldState, FieldWidget> {
+    static constexpr ConstString name = "field";
+    explicit FieldState(FieldWidget& node) : FieldState::super_t(node) {}
+};
+
+struct FieldPolicy {
+    using states = std::variant<FieldState>;
+};
+
+struct RectState : State<RectState, RectWidget> {
+    static constexpr ConstString name = "rect";
+    explicit RectState(RectWidget& node) : RectState::super_t(node) {}
+};
+
+struct RectPolicy {
+    using states = std::variant<RectState>;
+};
+
+/// Widget covering a single rect in the window.
+class RectWidget : public Widget<RectPolicy> {
+public:
+    /// Constructor.
+    /// @param parent   Parent Node.
+    /// @param rect     Rect in the window covered by this Widget.
+    RectWidget(valid_ptr<AnyNode*> parent, const Aabrf& rect) : Widget<RectPolicy>(parent), m_rect(rect) {}
+
+private:
+    void _finalize() override {
+        set_claim(WidgetClaim::fixed(m_rect.get_size()));
+        AnyWidget::set<offset_xform>(M3f::translation(m_rect.get_bottom_left()));
+    }
+
+    void _get_widgets_at(const V2f&, std::vector<WidgetHandle>&) const override {}
+
+    void _paint(Painter&) const override {}
+
+    /// Rect in the window covered by this Widget.
+    const Aabrf m_rect;
+};
+
+/// Widget covering the whole window, with one RectWidget child for each given rect.
+class FieldWidget : public Widget<FieldPolicy> {
+public:
+    /// Constructor.
+    /// @param parent   Parent Node.
+    /// @param rects    Rects in the window, one for each child Widget.
+    FieldWidget(valid_ptr<AnyNode*> parent, const std::vector<Aabrf>& rects)
+        : Widget<FieldPolicy>(parent), m_rects(rects) {}
+
+private:
+    void _finalize() override {
+        for (const Aabrf& rect : m_rects) {
+            _create_child<RectWidget>(this, rect);
+        }
+    }
+
+    void _get_widgets_at(const V2f&, std::vector<WidgetHandle>&) const override {}
+
+    void _paint(Painter&) const override {}
+
+    /// Rects in the window, one for each child Widget.
+    const std::vector<Aabrf> m_rects;
+};
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Finds the front-most of `range(0)` rects under the mouse cursor by testing every single one of them.
+static void HitTestLinear(benchmark::State& state)
+{
+    const std::vector<Aabrf> rects = produce_rects(static_cast<size_t>(state.range(0)));
+    const std::vector<V2f> mouse_path = produce_mouse_path();
+
+    std::vector<size_t> hits;
+    size_t step = 0;
+    for (auto _ : state) {
+        const V2f& mouse = mouse_path[step++ % mouse_path.size()];
+        hits.clear();
+        for (size_t i = 0; i < rects.size(); ++i) {
+            if (rects[i].contains(mouse)) { hits.emplace_back(i); }
+        }
+        std::sort(hits.begin(), hits.end(), std::greater<size_t>()); // front to back
+        benchmark::DoNotOptimize(hits.data());
+    }
+}
+BENCHMARK(HitTestLinear)->ArgNames({"widgets"})->Arg(1000)->Arg(100000);
+
+/// Finds the front-most of `range(0)` rects under the mouse cursor using a HitGrid.
+static void HitTestGrid(benchmark::State& state)
+{
+    const std::vector<Aabrf> rects = produce_rects(static_cast<size_t>(state.range(0)));
+    const std::vector<V2f> mouse_path = produce_mouse_path();
+    const HitGrid<size_t> grid = produce_grid(rects);
+
+    std::vector<HitGrid<size_t>::Handle> handles;
+    std::vector<size_t> hits;
+    size_t step = 0;
+    size_t hit_count = 0;
+    for (auto _ : state) {
+        const V2f& mouse = mouse_path[step++ % mouse_path.size()];
+        grid.query(mouse, handles);
+        hits.clear();
+        for (const HitGrid<size_t>::Handle handle : handles) {
+            hits.emplace_back(grid.get_value(handle));
+        }
+        std::sort(hits.begin(), hits.end(), std::greater<size_t>()); // front to back
+        hit_count += hits.size();
+        benchmark::DoNotOptimize(hits.data());
+    }
+    state.counters["hits/query"] = static_cast<double>(hit_count) / static_cast<double>(state.iterations());
+}
+BENCHMARK(HitTestGrid)->ArgNames({"widgets"})->Arg(1000)->Arg(100000);
+
+/// Finds all of `range(0)` Widgets under the mouse cursor in a WidgetScene, front to back.
+/// This is the path that every mouse event takes: querying the hit grid of the Scene, sorting the hits in draw order
+/// and returning them as WidgetHandles.
+static void HitTestWidgetScene(benchmark::State& state)
+{
+    BenchmarkScene scene(state); // as large as the simulated window
+    if (!scene.is_running()) { return; }
+    const std::vector<Aabrf> rects = produce_rects(static_cast<size_t>(state.range(0)));
+    scene.set_widget<FieldWidget>(rects);
+    const std::vector<V2f> mouse_path = produce_mouse_path();
+
+    size_t step = 0;
+    size_t hit_count = 0;
+    for (auto _ : state) {
+        const V2f& mouse = mouse_path[step++ % mouse_path.size()];
+        const std::vector<WidgetHandle> hits = scene.get_scene()->get_widgets_at(mouse);
+        hit_count += hits.size();
+        benchmark::DoNotOptimize(hits.data());
+    }
+    state.counters["hits/query"] = static_cast<double>(hit_count) / static_cast<double>(state.iterations());
+}
+BENCHMARK(HitTestWidgetScene)->ArgNames({"widgets"})->Arg(1000)->Arg(100000);
+
+/// Finds all of `range(0)` rects within a 200x200 selection rectangle using a HitGrid.
+static void HitTestGridRect(benchmark::State& state)
+{
+    const std::vector<Aabrf> rects = produce_rects(static_cast<size_t>(state.range(0)));
+    const std::vector<V2f> mouse_path = produce_mouse_path();
+    const HitGrid<size_t> grid = produce_grid(rects);
+
+    std::vector<HitGrid<size_t>::Handle> handles;
+    size_t step = 0;
+    for (auto _ : state) {
+        const V2f& mouse = mouse_path[step++ % mouse_path.size()];
+        grid.query(Aabrf(mouse, 200, 200), handles);
+        benchmark::DoNotOptimize(handles.data());
+    }
+}
+BENCHMARK(HitTestGridRect)->ArgNames({"widgets"})->Arg(100000);
+
+/// Moves `range(1)` of `range(0)` rects in a HitGrid, as it happens after a relayout.
+static void HitGridUpdate(benchmark::State& state)
+{
+    const std::vector<Aabrf> rects = produce_rects(static_cast<size_t>(state.range(0)));
+    const size_t moved_count = static_cast<size_t>(state.range(1));
+    HitGrid<size_t> grid = produce_grid(rects);
+
+    float offset = 0;
+    size_t first = 0;
+    for (auto _ : state) {
+        offset = offset > 100 ? 0 : offset + 3;
+        for (size_t i = 0; i < moved_count; ++i) {
+            const size_t index = (first + i) % rects.size();
+            Aabrf moved = rects[index];
+            moved.move_by(V2f(offset, 0));
+            grid.update(static_cast<HitGrid<size_t>::Handle>(index), moved);
+        }
+        first += moved_count;
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moved_count));
+}
+BENCHMARK(HitGridUpdate)->ArgNames({"widgets", "moved"})->Args({100000, 100})->Args({100000, 10000});
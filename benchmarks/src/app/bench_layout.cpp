@@ -0,0 +1,309 @@
+#include "benchmark/benchmark.h"
+
+#include <fstream>
+
+#include "notf/common/geo/path2.hpp"
+#include "notf/common/random.hpp"
+#include "notf/common/thread.hpp"
+
+#include "notf/graphic/graphics_context.hpp"
+#include "notf/graphic/opengl.hpp"
+#include "notf/graphic/plotter/painter.hpp"
+
+#include "notf/app/graph/graph.hpp"
+#include "notf/app/widget/layout.hpp"
+#include "notf/app/widget/list_widget.hpp"
+#include "notf/app/widget/widget_visualizer.hpp"
+
+#include "bench/app.hpp"
+
+#ifdef NOTF_LINUX
+#include <unistd.h>
+#endif
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Produces `count` random Claims with varied sizes, scale factors and priorities.
+/// @param count            Number of Claims to produce.
+/// @param priority_count   Number of distinct priorities to choose from.
+std::vector<WidgetClaim> produce_claims(const size_t count, const int priority_count) {
+    std::vector<WidgetClaim> claims(count);
+    for (WidgetClaim& claim : claims) {
+        claim.set_min(random(5.f, 10.f), random(5.f, 10.f));
+        claim.set_preferred(random(10.f, 40.f), random(10.f, 40.f));
+        claim.set_max(random(40.f, 100.f), random(40.f, 100.f));
+        claim.set_scale_factor(random(0.5f, 2.f));
+        claim.set_priority(random(0, priority_count - 1));
+    }
+    return claims;
+}
+
+/// Pointers to all given Claims.
+std::vector<const WidgetClaim*> to_claim_list(const std::vector<WidgetClaim>& claims) {
+    std::vector<const WidgetClaim*> result;
+    result.reserve(claims.size());
+    for (const WidgetClaim& claim : claims) {
+        result.push_back(&claim);
+    }
+    return result;
+}
+
+/// Number of lines that a FlexLayout broke the given Placements into.
+/// A new line starts whenever a Placement is not further along the main axis than its predecessor.
+size_t count_lines(const std::vector<AnyLayout::Placement>& placements, const FlexLayout& layout) {
+    if (placements.empty()) { return 0; }
+    const size_t main_axis = layout.is_horizontal() ? 0 : 1;
+    const FlexLayout::Direction direction = layout.get_direction();
+    const float forward = (direction == FlexLayout::Direction::RIGHT_TO_LEFT
+                           || direction == FlexLayout::Direction::TOP_TO_BOTTOM) ? -1.f : 1.f;
+    size_t result = 1;
+    for (size_t i = 1; i < placements.size(); ++i) {
+        if (forward * placements[i].xform[2][main_axis] <= forward * placements[i - 1].xform[2][main_axis]) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+/// Lays out `range(0)` children with `range(1)` distinct priorities in a FlexLayout.
+/// The layout is wrapped if `range(2)` is not zero.
+void run_flex_layout(benchmark::State& state, const FlexLayout::Direction direction) {
+    const size_t child_count = static_cast<size_t>(state.range(0));
+    const std::vector<WidgetClaim> claims = produce_claims(child_count, static_cast<int>(state.range(1)));
+    const std::vector<const WidgetClaim*> claim_list = to_claim_list(claims);
+
+    FlexLayout layout;
+    layout.set_direction(direction, /* relayout = */ false);
+    layout.set_spacing(2, false);
+    layout.set_cross_spacing(2, false);
+    const bool is_wrapping = state.range(2) != 0;
+    layout.set_wrap(is_wrapping ? FlexLayout::Wrap::WRAP : FlexLayout::Wrap::NO_WRAP, false);
+
+    // without wrapping, the grant is large enough to distribute surplus among all children, which is the expensive part
+    // with wrapping, the main axis only fits about 50 children, so the children are broken into many lines
+    const float main_extent = is_wrapping ? 2000.f : static_cast<float>(child_count) * 60.f;
+    const Size2f grant = layout.is_horizontal() ? Size2f(main_extent, 1000.f) : Size2f(1000.f, main_extent);
+
+    std::vector<AnyLayout::Placement> placements;
+    layout.update(placements, claim_list, grant); // warm up all scratch buffers
+    for (auto _ : state) {
+        layout.update(placements, claim_list, grant);
+        benchmark::DoNotOptimize(placements.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(child_count));
+    state.counters["lines"] = static_cast<double>(count_lines(placements, layout));
+}
+
+// list widget ================================================================
+
+class BenchListWidget;
+class BenchRowWidget;
+
+struct ListState : State<ListState, BenchListWidget> {
+    static constexpr ConstString name = "list";
+    explicit ListState(BenchListWidget& node) : ListState::super_t(node) {}
+};
+
+struct ListPolicy {
+    using states = std::variant<ListState>;
+};
+
+struct ItemProperty {
+    using value_t = int;
+    static constexpr ConstString name = "item";
+    static constexpr value_t default_value = -1;
+    static constexpr AnyProperty::Visibility visibility = AnyProperty::Visibility::REDRAW;
+};
+
+struct RowState : State<RowState, BenchRowWidget> {
+    static constexpr ConstString name = "row";
+    explicit RowState(BenchRowWidget& node) : RowState::super_t(node) {}
+};
+
+struct RowPolicy {
+    using properties = std::tuple<ItemProperty>;
+    using states = std::variant<RowState>;
+};
+
+/// Row displaying a single item of a BenchListWidget.
+class BenchRowWidget : public Widget<RowPolicy> {
+public:
+    static constexpr const ConstString& item = ItemProperty::name;
+
+    BenchRowWidget(valid_ptr<AnyNode*> parent) : Widget<RowPolicy>(parent) {}
+
+private:
+    void _get_widgets_at(const V2f&, std::vector<WidgetHandle>&) const override {}
+
+    void _paint(Painter& painter) const override {
+        painter.set_path(Path2::rect(get_grant()));
+        painter.fill();
+    }
+};
+
+/// List showing one BenchRowWidget for each visible item.
+class BenchListWidget : public ListWidget<ListPolicy> {
+public:
+    BenchListWidget(valid_ptr<AnyNode*> parent) : ListWidget<ListPolicy>(parent) {}
+
+    /// Window containing this list.
+    const Window& get_window() const { return *_get_first_ancestor<Window>(); }
+
+    /// WidgetScene containing this list.
+    WidgetScene* get_scene() const { return _get_first_ancestor<WidgetScene>(); }
+
+private:
+    void _create_row() override { _create_child<BenchRowWidget>(this); }
+
+    void _bind_row(AnyWidget& row, const size_t item) override {
+        static_cast<BenchRowWidget&>(row).set<BenchRowWidget::item>(static_cast<int>(item));
+    }
+
+    void _get_widgets_at(const V2f&, std::vector<WidgetHandle>&) const override {}
+
+    void _paint(Painter&) const override {}
+};
+
+/// Draws a WidgetScene on a thread of kind `RENDER`, like the RenderManager does after every layout pass.
+/// @param visualizer   Visualizer drawing the Scene.
+/// @param scene        WidgetScene to draw.
+/// @param context      GraphicsContext of the Window containing the Scene.
+void draw_scene(const WidgetVisualizer& visualizer, WidgetScene* scene, GraphicsContext& context) {
+    Thread render_thread(Thread::Kind::RENDER);
+    render_thread.run([&] {
+        NOTF_GUARD(context.make_current());
+        if (context.begin_frame(visualizer.get_damage(scene))) {
+            visualizer.visualize(scene);
+            context.finish_frame();
+        }
+        NOTF_CHECK_GL(glFinish()); // wait for the (software) renderer
+    });
+    render_thread.join();
+}
+
+/// Resident memory of this process in bytes, or zero if it cannot be determined.
+size_t get_resident_memory() {
+#ifdef NOTF_LINUX
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+} // namespace
+
+NOTF_OPEN_NAMESPACE
+namespace detail {
+
+template<>
+struct NodeHandleInterface<BenchListWidget> : public NodeHandleBaseInterface<BenchListWidget> {
+    using BenchListWidget::get_child_count;
+    using BenchListWidget::get_scene;
+    using BenchListWidget::get_scroll_item;
+    using BenchListWidget::get_window;
+    using BenchListWidget::scroll_by;
+    using BenchListWidget::set_item_count;
+    using BenchListWidget::set_row_claim;
+    using BenchListWidget::set_scroll_position;
+};
+
+} // namespace detail
+NOTF_CLOSE_NAMESPACE
+
+// benchmark ======================================================================================================== //
+
+static void FlexLayoutHorizontal(benchmark::State& state)
+{
+    run_flex_layout(state, FlexLayout::Direction::LEFT_TO_RIGHT);
+}
+BENCHMARK(FlexLayoutHorizontal)
+    ->ArgNames({"children", "priorities", "wrap"})
+    ->Args({100, 1, 0})
+    ->Args({10000, 1, 0})
+    ->Args({10000, 8, 0})
+    ->Args({10000, 1, 1})
+    ->Args({10000, 8, 1});
+
+static void FlexLayoutVertical(benchmark::State& state)
+{
+    run_flex_layout(state, FlexLayout::Direction::TOP_TO_BOTTOM);
+}
+BENCHMARK(FlexLayoutVertical)
+    ->ArgNames({"children", "priorities", "wrap"})
+    ->Args({10000, 1, 0})
+    ->Args({10000, 8, 0})
+    ->Args({10000, 8, 1});
+
+/// Scrolls through a ListWidget with `range(0)` items by `range(1)` pixels every frame, lays it out and draws it.
+/// Scrolling starts at 90% of the list, which for 1M items is far beyond the 2^24 pixels that a float can address
+/// exactly. Drawing re-paints the rows that were bound to a new item and renders the Scene on a render thread. Run it
+/// with Mesa's software renderer for results that do not depend on the GPU (see PlotterRender).
+/// Reports the number of rows and Nodes, the number of Widgets laid out per frame, and how much memory the process
+/// grew while creating and scrolling the list.
+static void ListWidgetScroll(benchmark::State& state)
+{
+    const size_t memory_before = get_resident_memory();
+    BenchmarkScene scene(state);
+    if (!scene.is_running()) { return; }
+
+    const size_t item_count = static_cast<size_t>(state.range(0));
+    const float scroll_step = static_cast<float>(state.range(1));
+    const size_t start_item = item_count / 10 * 9;
+
+    NodeHandle<BenchListWidget> list = scene.set_widget<BenchListWidget>();
+    list->set_row_claim(WidgetClaim(WidgetClaim::Stretch(200), WidgetClaim::Stretch(20)));
+    list->set_item_count(item_count);
+    list->set_scroll_position(start_item);
+    scene.get_scene()->update_layout();
+
+    // the WidgetScene draws itself only for the RenderManager, so the benchmark uses a WidgetVisualizer of its own
+    GraphicsContext& context = scene.get_window()->get_graphics_context();
+    WidgetScene* widget_scene = list->get_scene();
+    std::unique_ptr<WidgetVisualizer> visualizer;
+    try {
+        NOTF_GUARD(context.make_current());
+        visualizer = std::make_unique<WidgetVisualizer>(list->get_window());
+    }
+    catch (const notf_exception& error) {
+        state.SkipWithError(error.what());
+        for (auto _ : state) {}
+        return;
+    }
+    draw_scene(*visualizer, widget_scene, context); // the first frame paints all rows
+
+    const size_t relayouts_before = scene.get_scene()->get_layout_statistics().relayout_count;
+    for (auto _ : state) {
+        list->scroll_by(scroll_step);
+        if (list->get_scroll_item() + 100 >= item_count) { list->set_scroll_position(start_item); }
+        scene.get_scene()->update_layout();
+        draw_scene(*visualizer, widget_scene, context);
+    }
+    const size_t relayouts = scene.get_scene()->get_layout_statistics().relayout_count - relayouts_before;
+
+    // memory is proportional to the number of rows, not the number of items
+    state.counters["rows"] = static_cast<double>(list->get_child_count());
+    state.counters["nodes"] = static_cast<double>(TheGraph()->get_node_count());
+    state.counters["relayouts/frame"] = static_cast<double>(relayouts) / static_cast<double>(state.iterations());
+    const size_t memory_after = get_resident_memory();
+    state.counters["memory_growth"] = static_cast<double>(memory_after - min(memory_before, memory_after));
+
+    // the Plotter of the Visualizer frees its OpenGL objects
+    NOTF_GUARD(context.make_current());
+    visualizer.reset();
+}
+BENCHMARK(ListWidgetScroll)
+    ->ArgNames({"items", "scroll"})
+    ->Args({1000, 5})
+    ->Args({1000000, 5})
+    ->Args({1000000, 50})
+    ->Args({1000000, 5000})
+    ->UseRealTime();
@@ -0,0 +1,126 @@
+#include "benchmark/benchmark.h"
+
+#include <thread>
+
+#include "notf/app/resource_manager.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Resource with the size of a typical texture.
+struct BenchResource {
+    size_t get_byte_size() const { return 1024 * 1024 * 4; }
+};
+
+/// Number of distinct resources.
+constexpr size_t g_resource_count = 1000;
+
+/// Names of all resources.
+const std::vector<std::string>& get_names() {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> result;
+        for (size_t i = 0; i < g_resource_count; ++i) {
+            result.emplace_back("texture_" + std::to_string(i));
+        }
+        return result;
+    }();
+    return names;
+}
+
+/// Number of resources used by the next screen.
+constexpr size_t g_screen_resource_count = 20;
+
+/// Loads a resource, simulating 1ms of disk I/O.
+std::shared_ptr<BenchResource> load_resource(const std::string&) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return std::make_shared<BenchResource>();
+}
+
+/// Names of the resources used by the next screen.
+std::vector<std::string> get_screen_names() {
+    return std::vector<std::string>(get_names().begin(), get_names().begin() + g_screen_resource_count);
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Looks up cached resources from `threads` threads at once. Items processed are lookups.
+static void ResourceGet(benchmark::State& state)
+{
+    auto& type = ResourceManager::get_instance().get_type<BenchResource>();
+    if (state.thread_index == 0) {
+        type.set_byte_budget(max_v<size_t>);
+        for (const std::string& name : get_names()) {
+            type.set(name, std::make_shared<BenchResource>());
+        }
+    }
+    size_t index = static_cast<size_t>(state.thread_index) * 97;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(type.get(get_names()[index++ % g_resource_count]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ResourceGet)->Threads(1)->Threads(4);
+
+/// Stores new resources into a type whose budget fits only half of them, so that every call evicts the least recently
+/// used one. Items processed are stored resources.
+static void ResourceSetWithEviction(benchmark::State& state)
+{
+    auto& type = ResourceManager::get_instance().get_type<BenchResource>();
+    type.set_byte_budget(g_resource_count / 2 * BenchResource().get_byte_size());
+    size_t index = 0;
+    for (auto _ : state) {
+        type.set(get_names()[index++ % g_resource_count], std::make_shared<BenchResource>());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["evictions"] = static_cast<double>(type.get_stats().evictions);
+    ResourceManager::get_instance().clear();
+}
+BENCHMARK(ResourceSetWithEviction);
+
+/// Loads the resources of the next screen on the calling thread, which stalls for the whole time.
+/// Items processed are screens.
+static void ResourceLoadScreenBlocking(benchmark::State& state)
+{
+    auto& type = ResourceManager::get_instance().get_type<BenchResource>();
+    type.set_byte_budget(max_v<size_t>);
+    const std::vector<std::string> names = get_screen_names();
+    for (auto _ : state) {
+        for (const std::string& name : names) {
+            type.set(name, load_resource(name));
+        }
+        state.PauseTiming();
+        ResourceManager::get_instance().clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ResourceLoadScreenBlocking)->Iterations(50)->Unit(benchmark::kMillisecond);
+
+/// Prefetches the resources of the next screen, only the time spent on the calling thread is measured. Runs a fixed
+/// number of iterations, because waiting for the loads is not measured but would still make automatic runs very long.
+/// Items processed are screens.
+static void ResourcePrefetchScreen(benchmark::State& state)
+{
+    auto& type = ResourceManager::get_instance().get_type<BenchResource>();
+    type.set_byte_budget(max_v<size_t>);
+    type.set_loader(load_resource);
+    const std::vector<std::string> names = get_screen_names();
+    for (auto _ : state) {
+        type.prefetch(names);
+
+        state.PauseTiming();
+        for (const std::string& name : names) {
+            type.get_async(name).wait();
+        }
+        ResourceManager::get_instance().clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+    type.set_loader({});
+}
+BENCHMARK(ResourcePrefetchScreen)->Iterations(50)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,162 @@
+#include "benchmark/benchmark.h"
+
+#include <thread>
+
+#include "notf/common/random.hpp"
+
+#include "notf/app/widget/widget.hpp"
+
+#include "bench/app.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+class ChainWidget;
+
+struct ChainState : State<ChainState, ChainWidget> {
+    static constexpr ConstString name = "chain";
+    explicit ChainState(ChainWidget& node) : ChainState::super_t(node) {}
+};
+
+struct ChainPolicy {
+    using states = std::variant<ChainState>;
+};
+
+/// Widget in a deep hierarchy, with a single child Widget down to the given depth.
+/// Each Widget is moved by a random offset relative to its parent.
+class ChainWidget : public Widget<ChainPolicy> {
+public:
+    /// Constructor.
+    /// @param parent   Parent Node.
+    /// @param depth    Number of Widgets in the chain, starting with this one.
+    ChainWidget(valid_ptr<AnyNode*> parent, const size_t depth) : Widget<ChainPolicy>(parent), m_depth(depth) {}
+
+    /// The Widget at the given level below this one in the chain.
+    /// @param level    Level of the Widget, zero is this Widget.
+    ChainWidget& get_descendant(const size_t level) {
+        if (level == 0 || get_child_count() == 0) { return *this; }
+        return static_cast<ChainWidget&>(_get_child_widget(0)).get_descendant(level - 1);
+    }
+
+    /// Moves this Widget relative to its parent.
+    /// @param offset   New offset transformation.
+    void set_offset(const M3f& offset) { AnyWidget::set<offset_xform>(offset); }
+
+    /// Moves this Widget (and all of its descendants) to a new parent.
+    /// @param parent   New parent.
+    void move_to(ChainWidget& parent) { _set_parent(parent.shared_from_this()); }
+
+private:
+    void _finalize() override {
+        set_offset(M3f::translation(V2f(random(0.f, 10.f), random(0.f, 10.f))));
+        if (m_depth > 1) { _create_child<ChainWidget>(this, m_depth - 1); }
+    }
+
+    void _get_widgets_at(const V2f&, std::vector<WidgetHandle>&) const override {}
+
+    void _paint(Painter&) const override {}
+
+    /// Number of Widgets in the chain, starting with this one.
+    const size_t m_depth;
+};
+
+} // namespace
+
+NOTF_OPEN_NAMESPACE
+namespace detail {
+
+template<>
+struct NodeHandleInterface<ChainWidget> : public NodeHandleBaseInterface<ChainWidget> {
+    using ChainWidget::get_descendant;
+};
+
+} // namespace detail
+NOTF_CLOSE_NAMESPACE
+
+// benchmark ======================================================================================================== //
+
+/// Window transformation of the deepest Widget in a hierarchy of `range(0)` levels, calculated every time.
+/// This is how the renderer calculates the transformation, so the benchmark calls it from a thread other than the UI
+/// thread and measures the wall time.
+static void WindowXformUncached(benchmark::State& state)
+{
+    BenchmarkScene scene(state);
+    if (!scene.is_running()) { return; }
+    const size_t depth = static_cast<size_t>(state.range(0));
+    ChainWidget& deepest = scene.set_widget<ChainWidget>(depth)->get_descendant(depth - 1);
+
+    std::thread render_thread([&] {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(deepest.get_window_xform());
+        }
+    });
+    render_thread.join();
+}
+BENCHMARK(WindowXformUncached)->ArgNames({"depth"})->Arg(8)->Arg(32)->Arg(128)->UseRealTime();
+
+/// Window transformation of the deepest Widget in a hierarchy of `range(0)` levels, while nothing moves.
+static void WindowXformCached(benchmark::State& state)
+{
+    BenchmarkScene scene(state);
+    if (!scene.is_running()) { return; }
+    const size_t depth = static_cast<size_t>(state.range(0));
+    ChainWidget& deepest = scene.set_widget<ChainWidget>(depth)->get_descendant(depth - 1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(deepest.get_window_xform());
+    }
+}
+BENCHMARK(WindowXformCached)->ArgNames({"depth"})->Arg(8)->Arg(32)->Arg(128);
+
+/// Window transformation of the deepest Widget in a hierarchy of `range(0)` levels, after the Widget at level
+/// `range(1)` moved, which invalidates all of its descendants.
+static void WindowXformCachedMoved(benchmark::State& state)
+{
+    BenchmarkScene scene(state);
+    if (!scene.is_running()) { return; }
+    const size_t depth = static_cast<size_t>(state.range(0));
+    NodeHandle<ChainWidget> root = scene.set_widget<ChainWidget>(depth);
+    ChainWidget& moved = root->get_descendant(static_cast<size_t>(state.range(1)));
+    ChainWidget& deepest = root->get_descendant(depth - 1);
+
+    float offset = 0;
+    for (auto _ : state) {
+        offset = offset > 100 ? 0 : offset + 1;
+        moved.set_offset(M3f::translation(V2f(offset, 0)));
+        benchmark::DoNotOptimize(deepest.get_window_xform());
+    }
+    scene.get_scene()->update_layout();
+}
+BENCHMARK(WindowXformCachedMoved)
+    ->ArgNames({"depth", "moved"})
+    ->Args({32, 0})
+    ->Args({32, 30})
+    ->Args({128, 0})
+    ->Args({128, 126});
+
+/// Window transformation of the deepest Widget in a hierarchy of `range(0)` levels, after the Widget at level
+/// `range(1)` was moved back and forth between its parent and grandparent, which invalidates all of its descendants.
+static void WindowXformCachedReparented(benchmark::State& state)
+{
+    BenchmarkScene scene(state);
+    if (!scene.is_running()) { return; }
+    const size_t depth = static_cast<size_t>(state.range(0));
+    const size_t level = static_cast<size_t>(state.range(1));
+    NodeHandle<ChainWidget> root = scene.set_widget<ChainWidget>(depth);
+    ChainWidget& grandparent = root->get_descendant(level - 2);
+    ChainWidget& parent = root->get_descendant(level - 1);
+    ChainWidget& moved = root->get_descendant(level);
+    ChainWidget& deepest = root->get_descendant(depth - 1);
+
+    bool is_at_parent = true;
+    for (auto _ : state) {
+        moved.move_to(is_at_parent ? grandparent : parent);
+        is_at_parent = !is_at_parent;
+        benchmark::DoNotOptimize(deepest.get_window_xform());
+    }
+    scene.get_scene()->update_layout();
+}
+BENCHMARK(WindowXformCachedReparented)->ArgNames({"depth", "moved"})->Args({32, 2})->Args({128, 64});
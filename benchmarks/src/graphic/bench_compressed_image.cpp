@@ -0,0 +1,56 @@
+#include "benchmark/benchmark.h"
+
+#include <filesystem>
+
+#include "notf/graphic/compressed_image.hpp"
+#include "notf/graphic/raw_image.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Path to a file in the texture resource directory.
+std::string get_texture_file(const char* name) {
+    return (std::filesystem::path(__FILE__).parent_path().parent_path().parent_path().parent_path() / "res"
+            / "textures" / name)
+        .string();
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Decodes a 1024x1024 RGBA png into raw pixels, ready for upload. Items processed are images.
+/// The `texture_bytes` counter is the size of the largest mip level in texture memory.
+static void TextureFileRaw(benchmark::State& state)
+{
+    const std::string file = get_texture_file("test.png");
+    int64_t texture_bytes = 0;
+    for (auto _ : state) {
+        RawImage image(file);
+        benchmark::DoNotOptimize(image.get_data());
+        texture_bytes = image.get_size().get_area() * image.get_channels();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["texture_bytes"] = static_cast<double>(texture_bytes);
+}
+BENCHMARK(TextureFileRaw)->Unit(benchmark::kMillisecond);
+
+/// Maps a 1024x1024 ASTC 6x6 image of the same picture into memory, ready for upload. Items processed are images.
+/// The `texture_bytes` counter is the size of the largest mip level in texture memory.
+static void TextureFileCompressed(benchmark::State& state)
+{
+    const std::string file = get_texture_file("test.astc");
+    int64_t texture_bytes = 0;
+    for (auto _ : state) {
+        CompressedImage image(file);
+        image.page_in();
+        benchmark::DoNotOptimize(image.get_levels().front().data);
+        texture_bytes = static_cast<int64_t>(image.get_levels().front().length);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["texture_bytes"] = static_cast<double>(texture_bytes);
+}
+BENCHMARK(TextureFileCompressed)->Unit(benchmark::kMillisecond);
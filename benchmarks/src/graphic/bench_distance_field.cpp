@@ -0,0 +1,87 @@
+#include "benchmark/benchmark.h"
+
+#include "notf/graphic/text/distance_field.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Font sizes that a UI typically uses, each requiring its own set of bitmap Glyphs.
+constexpr int g_font_sizes[] = {10, 12, 14, 16, 20, 24, 32, 48};
+
+/// Number of Glyphs in a font set (printable ASCII).
+constexpr int g_glyph_count = 95;
+
+/// Coverage bitmap of a synthetic Glyph: an anti-aliased ring that fills a `size` x `size` bitmap.
+std::vector<uchar> produce_ring(const int size) {
+    std::vector<uchar> bitmap(static_cast<size_t>(size * size));
+    const float center = static_cast<float>(size) / 2.f;
+    const float outer = center;
+    const float inner = center * 0.6f;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const float dx = static_cast<float>(x) + 0.5f - center;
+            const float dy = static_cast<float>(y) + 0.5f - center;
+            const float distance = std::sqrt(dx * dx + dy * dy);
+            const float coverage = clamp(min(outer - distance, distance - inner) + 0.5f, 0.f, 1.f);
+            bitmap[static_cast<size_t>(y * size + x)] = static_cast<uchar>(coverage * 255.f);
+        }
+    }
+    return bitmap;
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Copies the coverage bitmap of a `range(0)` pixel Glyph, as done for regular Glyphs. Items processed are Glyphs.
+static void GlyphBitmap(benchmark::State& state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const std::vector<uchar> ring = produce_ring(size);
+    for (auto _ : state) {
+        std::vector<uchar> bitmap = ring;
+        benchmark::DoNotOptimize(bitmap.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(GlyphBitmap)->ArgNames({"size"})->Arg(16)->Arg(32)->Arg(64);
+
+/// Converts the coverage bitmap of a `range(0)` pixel Glyph into a distance field. Items processed are Glyphs.
+static void GlyphDistanceField(benchmark::State& state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const std::vector<uchar> ring = produce_ring(size);
+    for (auto _ : state) {
+        std::vector<uchar> field = produce_distance_field(ring.data(), size, size, size, Font::distance_field_spread);
+        benchmark::DoNotOptimize(field.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(GlyphDistanceField)->ArgNames({"size"})->Arg(16)->Arg(32)->Arg(64);
+
+/// Atlas pixels needed for all Glyphs of a font in every size in `g_font_sizes`, either as one bitmap set per size
+/// (`range(0)` = 0) or as a single distance field set (`range(0)` = 1).
+/// Items processed are font sizes that can be rendered from the atlas.
+static void GlyphAtlasMemory(benchmark::State& state)
+{
+    const bool is_distance_field = state.range(0) != 0;
+    int64_t atlas_pixels = 0;
+    for (auto _ : state) {
+        atlas_pixels = 0;
+        if (is_distance_field) {
+            const int size = Font::distance_field_size + Font::distance_field_spread * 2;
+            atlas_pixels = static_cast<int64_t>(size * size) * g_glyph_count;
+        } else {
+            for (const int size : g_font_sizes) {
+                atlas_pixels += static_cast<int64_t>(size * size) * g_glyph_count;
+            }
+        }
+        benchmark::DoNotOptimize(atlas_pixels);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(std::size(g_font_sizes)));
+    state.counters["atlas_bytes"] = static_cast<double>(atlas_pixels);
+}
+BENCHMARK(GlyphAtlasMemory)->ArgNames({"distance_field"})->Arg(0)->Arg(1);
@@ -0,0 +1,104 @@
+#include "benchmark/benchmark.h"
+
+#include <unordered_map>
+
+#include "notf/common/utf8.hpp"
+
+#include "notf/graphic/text/font.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Latin text, repeated to produce longer strings.
+constexpr const char* g_latin_text = "The quick brown fox jumps over the lazy dog. ";
+
+/// Text mixing latin, cyrillic and CJK characters, repeated to produce longer strings.
+constexpr const char* g_mixed_text = "Hello Привет 你好世界 ";
+
+/// Repeats the given text until it is at least `length` bytes long.
+std::string produce_text(const char* text, const size_t length) {
+    std::string result;
+    while (result.size() < length) {
+        result += text;
+    }
+    return result;
+}
+
+/// Glyph with a rectangle and advance derived from the codepoint.
+Glyph produce_glyph(const codepoint_t codepoint) {
+    Glyph glyph;
+    glyph.rect = Glyph::Rect(static_cast<Glyph::coord_t>(codepoint % 256), 0, 8, 12);
+    glyph.left = 0;
+    glyph.top = 12;
+    glyph.advance_x = static_cast<Glyph::coord_t>(6 + codepoint % 4);
+    glyph.advance_y = 0;
+    return glyph;
+}
+
+/// Measures the advance of the text, looking up every Glyph in the given container.
+template<class Container>
+int measure_text(const Utf8& text, Container& glyphs) {
+    int advance = 0;
+    for (const auto character : text) {
+        const codepoint_t codepoint = static_cast<codepoint_t>(character);
+        if constexpr (std::is_same_v<Container, GlyphTable<Glyph>>) {
+            advance += glyphs.find(codepoint)->advance_x;
+        } else {
+            advance += glyphs.find(codepoint)->second.advance_x;
+        }
+    }
+    return advance;
+}
+
+/// Benchmarks measuring a text in a Glyph container that contains all of its characters.
+template<class Container>
+void run_benchmark(benchmark::State& state, const char* source, Container& glyphs) {
+    const Utf8 text(produce_text(source, static_cast<size_t>(state.range(0))));
+    for (const auto character : text) {
+        const codepoint_t codepoint = static_cast<codepoint_t>(character);
+        glyphs.emplace(codepoint, produce_glyph(codepoint));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(measure_text(text, glyphs));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(text.length()));
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Looks up the Glyphs of a latin text of `range(0)` bytes in a GlyphTable, items processed are characters.
+static void GlyphTableLatin(benchmark::State& state)
+{
+    GlyphTable<Glyph> glyphs;
+    run_benchmark(state, g_latin_text, glyphs);
+}
+BENCHMARK(GlyphTableLatin)->ArgNames({"bytes"})->Arg(100)->Arg(10000);
+
+/// Looks up the Glyphs of a latin text of `range(0)` bytes in a hash map, items processed are characters.
+static void GlyphMapLatin(benchmark::State& state)
+{
+    std::unordered_map<codepoint_t, Glyph> glyphs;
+    run_benchmark(state, g_latin_text, glyphs);
+}
+BENCHMARK(GlyphMapLatin)->ArgNames({"bytes"})->Arg(100)->Arg(10000);
+
+/// Looks up the Glyphs of a mixed-script text of `range(0)` bytes in a GlyphTable, items processed are characters.
+static void GlyphTableMixed(benchmark::State& state)
+{
+    GlyphTable<Glyph> glyphs;
+    run_benchmark(state, g_mixed_text, glyphs);
+}
+BENCHMARK(GlyphTableMixed)->ArgNames({"bytes"})->Arg(100)->Arg(10000);
+
+/// Looks up the Glyphs of a mixed-script text of `range(0)` bytes in a hash map, items processed are characters.
+static void GlyphMapMixed(benchmark::State& state)
+{
+    std::unordered_map<codepoint_t, Glyph> glyphs;
+    run_benchmark(state, g_mixed_text, glyphs);
+}
+BENCHMARK(GlyphMapMixed)->ArgNames({"bytes"})->Arg(100)->Arg(10000);
@@ -0,0 +1,155 @@
+#include "benchmark/benchmark.h"
+
+#include <random>
+
+#include "notf/graphic/image_kernels.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Size of the benchmarked image, a typical texture.
+const Size2i g_image_size(1024, 1024);
+
+/// Random RGBA pixels of an image of `g_image_size`.
+const std::vector<uchar>& get_pixels() {
+    static const std::vector<uchar> pixels = [] {
+        std::mt19937 random(1234);
+        std::uniform_int_distribution<int> distribution(0, 255);
+        std::vector<uchar> result(static_cast<size_t>(g_image_size.get_area() * 4));
+        for (uchar& value : result) {
+            value = static_cast<uchar>(distribution(random));
+        }
+        return result;
+    }();
+    return pixels;
+}
+
+/// Uses the kernel set `range(0)`, skips the benchmark if the CPU does not support it.
+bool use_kernel_set(benchmark::State& state) {
+    const auto set = static_cast<ImageKernelSet>(state.range(0));
+    if (to_number(set) > to_number(get_best_image_kernel_set())) {
+        state.SkipWithError("Image kernel set not supported by the CPU");
+        return false;
+    }
+    set_image_kernel_set(set);
+    return true;
+}
+
+/// Reports the number of input pixels processed per second in millions.
+void report_pixels(benchmark::State& state, const Size2i& size) {
+    state.counters["MPix/s"] = benchmark::Counter(static_cast<double>(state.iterations() * size.get_area()) / 1e6,
+                                                  benchmark::Counter::kIsRate);
+    set_image_kernel_set(get_best_image_kernel_set());
+}
+
+/// Runs a benchmark once for each kernel set.
+void each_kernel_set(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"kernel_set"});
+    for (int set = to_number(ImageKernelSet::SCALAR); set <= to_number(ImageKernelSet::AVX2); ++set) {
+        benchmark->Arg(set);
+    }
+}
+
+/// Runs a benchmark once for each kernel set in linear and sRGB color space.
+void each_kernel_set_and_color_space(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"kernel_set", "srgb"});
+    for (int set = to_number(ImageKernelSet::SCALAR); set <= to_number(ImageKernelSet::AVX2); ++set) {
+        benchmark->Args({set, 0});
+        benchmark->Args({set, 1});
+    }
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Premultiplies the alpha of a 1024x1024 RGBA image.
+static void ImagePremultiply(benchmark::State& state)
+{
+    if (!use_kernel_set(state)) { return; }
+    std::vector<uchar> pixels = get_pixels();
+    for (auto _ : state) {
+        premultiply_alpha(pixels.data(), pixels.size() / 4);
+        benchmark::ClobberMemory();
+    }
+    report_pixels(state, g_image_size);
+}
+BENCHMARK(ImagePremultiply)->Apply(each_kernel_set);
+
+/// Unpremultiplies the alpha of a 1024x1024 RGBA image.
+static void ImageUnpremultiply(benchmark::State& state)
+{
+    if (!use_kernel_set(state)) { return; }
+    std::vector<uchar> pixels = get_pixels();
+    for (auto _ : state) {
+        state.PauseTiming();
+        pixels = get_pixels(); // the result of unpremultiplying depends on the input, always start fresh
+        state.ResumeTiming();
+        unpremultiply_alpha(pixels.data(), pixels.size() / 4);
+        benchmark::ClobberMemory();
+    }
+    report_pixels(state, g_image_size);
+}
+BENCHMARK(ImageUnpremultiply)->Apply(each_kernel_set);
+
+/// Converts a 1024x1024 image from RGBA to BGRA.
+static void ImageSwizzle(benchmark::State& state)
+{
+    if (!use_kernel_set(state)) { return; }
+    std::vector<uchar> pixels = get_pixels();
+    for (auto _ : state) {
+        swizzle_channels(pixels.data(), pixels.size() / 4, {2, 1, 0, 3});
+        benchmark::ClobberMemory();
+    }
+    report_pixels(state, g_image_size);
+}
+BENCHMARK(ImageSwizzle)->Apply(each_kernel_set);
+
+/// Converts a 1024x1024 RGBA image from sRGB to linear color space, the same for all kernel sets.
+static void ImageDecodeSrgb(benchmark::State& state)
+{
+    std::vector<uchar> pixels = get_pixels();
+    for (auto _ : state) {
+        decode_srgb(pixels.data(), pixels.size() / 4, 4);
+        benchmark::ClobberMemory();
+    }
+    report_pixels(state, g_image_size);
+}
+BENCHMARK(ImageDecodeSrgb);
+
+/// Halves the size of a 1024x1024 RGBA image in linear (`srgb` = 0) or sRGB (`srgb` = 1) color space.
+static void ImageDownsampleBox(benchmark::State& state)
+{
+    if (!use_kernel_set(state)) { return; }
+    const bool is_srgb = state.range(1) != 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(downsample_box(get_pixels().data(), g_image_size, 4, is_srgb));
+    }
+    report_pixels(state, g_image_size);
+}
+BENCHMARK(ImageDownsampleBox)->Apply(each_kernel_set_and_color_space);
+
+/// Resizes a 1024x1024 RGBA image to 384x384 with a Lanczos filter.
+static void ImageDownsampleLanczos(benchmark::State& state)
+{
+    if (!use_kernel_set(state)) { return; }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(downsample_lanczos(get_pixels().data(), g_image_size, 4, Size2i(384, 384)));
+    }
+    report_pixels(state, g_image_size);
+}
+BENCHMARK(ImageDownsampleLanczos)->Apply(each_kernel_set)->Unit(benchmark::kMillisecond);
+
+/// Produces the full mip chain of a 1024x1024 RGBA image.
+static void ImageMipChain(benchmark::State& state)
+{
+    if (!use_kernel_set(state)) { return; }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(produce_mip_chain(get_pixels().data(), g_image_size, 4));
+    }
+    report_pixels(state, g_image_size);
+}
+BENCHMARK(ImageMipChain)->Apply(each_kernel_set);
@@ -0,0 +1,324 @@
+#include "benchmark/benchmark.h"
+
+#include "notf/common/geo/matrix3.hpp"
+#include "notf/common/geo/path2.hpp"
+#include "notf/common/random.hpp"
+#include "notf/common/thread.hpp"
+#include "notf/common/thread_pool.hpp"
+
+#include "notf/graphic/opengl.hpp"
+#include "notf/graphic/plotter/design.hpp"
+#include "notf/graphic/plotter/draw_batcher.hpp"
+#include "notf/graphic/plotter/frame_builder.hpp"
+#include "notf/graphic/plotter/painter.hpp"
+
+#include "bench/app.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+using FrameBuilder = Plotter::FrameBuilder;
+
+/// Size of the simulated window.
+const Aabrf window_rect(Size2f(1920, 1080));
+
+/// Produces `count` random transformations, placing an icon somewhere in the window.
+std::vector<M3f> produce_xforms(const size_t count) {
+    std::vector<M3f> xforms(count);
+    for (M3f& xform : xforms) {
+        xform = M3f::translation(V2f(random(0.f, window_rect.get_width()), random(0.f, window_rect.get_height())));
+    }
+    return xforms;
+}
+
+/// FrameBuilder of a Plotter, together with the client-side buffers that the Plotter would upload.
+/// The Plotter itself can only exist with a GraphicsContext.
+struct Frame {
+
+    /// Number of bytes that the Plotter would upload at the end of the current frame.
+    size_t get_upload_size() {
+        const size_t result = (vertices.size() - builder.get_dirty_vertex()) * sizeof(FrameBuilder::Vertex)
+                              + (indices.size() - builder.get_dirty_index()) * sizeof(FrameBuilder::Index)
+                              + paints.size() * sizeof(FrameBuilder::PaintBlock)
+                              + instances.size() * sizeof(FrameBuilder::Instance)
+                              + commands.size() * sizeof(FrameBuilder::Command);
+        builder.clear_dirty();
+        return result;
+    }
+
+    std::vector<FrameBuilder::Vertex> vertices;
+    std::vector<FrameBuilder::Index> indices;
+    std::vector<FrameBuilder::PaintBlock> paints;
+    std::vector<FrameBuilder::Instance> instances;
+    std::vector<FrameBuilder::Command> commands;
+    FrameBuilder builder{vertices, indices, paints, instances, commands};
+};
+
+/// Runs a function on a thread of kind `RENDER`, where Painters are allowed to record PlotterDesigns.
+template<class Function>
+void run_on_render_thread(Function&& function) {
+    Thread render_thread(Thread::Kind::RENDER);
+    render_thread.run(std::forward<Function>(function));
+    render_thread.join();
+}
+
+/// Base transformation of the Widget with the given index, Widgets are laid out in rows of 60.
+M3f get_widget_xform(const size_t index) {
+    return M3f::translation(V2f(static_cast<float>(index % 60) * 32, static_cast<float>(index / 60) * 32));
+}
+
+/// Produces 8 circular icons of different sizes.
+std::array<Path2Ptr, 8> produce_icons() {
+    std::array<Path2Ptr, 8> icons;
+    for (size_t i = 0; i < icons.size(); ++i) {
+        icons[i] = Path2::circle(V2f(11, 11), 4 + static_cast<float>(i));
+    }
+    return icons;
+}
+
+/// Records the Design of a Widget, which fills its background and one of 8 icons with a random rotation.
+void record_design(PlotterDesign& design, const std::array<Path2Ptr, 8>& icons) {
+    static const Path2Ptr background = Path2::rect(Aabrf(Size2f(30, 30)));
+    Painter painter(design);
+    painter.set_path(background);
+    painter.fill();
+    painter.set_transform(M3f::translation(V2f(4, 4)) * M3f::rotation(random(0.f, 1.f)));
+    painter.set_path(icons[static_cast<size_t>(random(0, 7))]);
+    painter.fill();
+}
+
+/// Records the Designs of `count` Widgets.
+std::vector<PlotterDesign> record_designs(const size_t count) {
+    const std::array<Path2Ptr, 8> icons = produce_icons();
+    std::vector<PlotterDesign> designs(count);
+    run_on_render_thread([&] {
+        for (PlotterDesign& design : designs) {
+            record_design(design, icons);
+        }
+    });
+    return designs;
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Draws the same icon `range(0)` times per frame, by transforming and tessellating a copy of the icon for each draw.
+static void PlotterIconsTransformed(benchmark::State& state)
+{
+    const Path2Ptr icon = Path2::rect(Aabrf(Size2f(16, 16)));
+    const std::vector<M3f> xforms = produce_xforms(static_cast<size_t>(state.range(0)));
+
+    std::vector<FrameBuilder::Vertex> vertices;
+    std::vector<FrameBuilder::Index> indices;
+    size_t uploaded_bytes = 0;
+    for (auto _ : state) {
+        vertices.clear();
+        indices.clear();
+        for (const M3f& xform : xforms) {
+            const Path2Ptr copy = Path2::create(transform_by(icon->get_subpaths().front().m_path, xform));
+            FrameBuilder::tessellate_path(*copy, vertices, indices);
+        }
+        uploaded_bytes += vertices.size() * sizeof(FrameBuilder::Vertex);
+        uploaded_bytes += indices.size() * sizeof(FrameBuilder::Index);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.counters["bytes/frame"] = static_cast<double>(uploaded_bytes) / static_cast<double>(state.iterations());
+}
+BENCHMARK(PlotterIconsTransformed)->ArgNames({"icons"})->Arg(100)->Arg(1000)->Arg(10000);
+
+/// Draws the same icon `range(0)` times per frame with the FrameBuilder of the Plotter, which keeps the icon resident
+/// and only writes one transformation per draw.
+static void PlotterIconsInstanced(benchmark::State& state)
+{
+    const Path2Ptr icon = Path2::rect(Aabrf(Size2f(16, 16)));
+    const std::vector<M3f> xforms = produce_xforms(static_cast<size_t>(state.range(0)));
+    PlotterDesign design;
+    run_on_render_thread([&] {
+        Painter painter(design);
+        painter.set_path(icon);
+        for (const M3f& xform : xforms) {
+            painter.set_transform(xform);
+            painter.fill();
+        }
+    });
+
+    Frame frame;
+    size_t uploaded_bytes = 0;
+    for (auto _ : state) {
+        frame.builder.start_frame();
+        frame.builder.parse(design, M3f::identity());
+        frame.builder.finish_frame(window_rect);
+        uploaded_bytes += frame.get_upload_size();
+        benchmark::DoNotOptimize(frame.instances.data());
+    }
+    state.counters["bytes/frame"] = static_cast<double>(uploaded_bytes) / static_cast<double>(state.iterations());
+    state.counters["batches"] = static_cast<double>(frame.builder.get_batches().size());
+}
+BENCHMARK(PlotterIconsInstanced)->ArgNames({"icons"})->Arg(100)->Arg(1000)->Arg(10000);
+
+/// Groups the draw calls of `range(0)` widgets into batches, each widget draws a background and one of 8 icons.
+/// Widgets are laid out in rows, like the items of a list or a toolbar.
+static void PlotterBatching(benchmark::State& state)
+{
+    const size_t widget_count = static_cast<size_t>(state.range(0));
+    std::vector<std::pair<uint, Aabrf>> draws;
+    draws.reserve(widget_count * 2);
+    Aabrf area = Aabrf::zero();
+    for (size_t i = 0; i < widget_count; ++i) {
+        const Aabrf widget_rect(V2f(static_cast<float>(i % 60) * 32, static_cast<float>(i / 60) * 32), 30, 30);
+        const uint icon = 1 + static_cast<uint>(random(0, 7));
+        draws.emplace_back(0, widget_rect);                     // background
+        draws.emplace_back(icon, Aabrf(widget_rect).shrink(4)); // icon
+        area.unite(widget_rect);
+    }
+
+    DrawBatcher<uint> batcher;
+    for (auto _ : state) {
+        batcher.clear(area);
+        for (const auto& [key, bounds] : draws) {
+            batcher.add(key, bounds);
+        }
+        benchmark::DoNotOptimize(batcher.get_batches().data());
+    }
+    state.counters["draws"] = static_cast<double>(draws.size());
+    state.counters["batches"] = static_cast<double>(batcher.get_batches().size());
+}
+BENCHMARK(PlotterBatching)->ArgNames({"widgets"})->Arg(100)->Arg(1000)->Arg(10000);
+
+/// Parses the Designs of `range(0)` Widgets on `range(1)` worker threads and the calling thread, merging the results in
+/// order (see `FrameBuilder::parse`). Zero worker threads parse all Designs on the calling thread.
+/// The clip of all Designs alternates between frames, so that no Fragment can be retained.
+static void PlotterParallelParse(benchmark::State& state)
+{
+    const size_t widget_count = static_cast<size_t>(state.range(0));
+    const std::vector<PlotterDesign> designs = record_designs(widget_count);
+    std::vector<Plotter::DesignInstance> instances(widget_count);
+    for (size_t i = 0; i < widget_count; ++i) {
+        instances[i] = {&designs[i], get_widget_xform(i), Aabrf(Size2f(30, 30))};
+    }
+    ThreadPool thread_pool(static_cast<size_t>(state.range(1)));
+
+    Frame frame;
+    uint parsed_designs = 0;
+    for (auto _ : state) {
+        for (Plotter::DesignInstance& instance : instances) {
+            instance.clip.grow(instance.clip.get_width() > 30 ? -1 : 1);
+        }
+        frame.builder.start_frame();
+        frame.builder.parse(instances, thread_pool);
+        parsed_designs += frame.builder.get_statistics().designs_parsed;
+        benchmark::DoNotOptimize(frame.builder.get_drawcalls().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["parsed/frame"] = static_cast<double>(parsed_designs) / static_cast<double>(state.iterations());
+}
+BENCHMARK(PlotterParallelParse)
+    ->ArgNames({"widgets", "threads"})
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({10000, 3})
+    ->Args({10000, 7})
+    ->UseRealTime();
+
+/// Draws the Designs of `range(0)` Widgets every frame, one of which is animated and re-records its Design every frame.
+/// If `range(1)` is zero, the clip of all Designs alternates between frames so that all of them are parsed every frame,
+/// otherwise the Fragments of unchanged Designs are retained and merged again (see `FrameBuilder::_retain_fragment`).
+static void PlotterRetainedFragments(benchmark::State& state)
+{
+    const size_t widget_count = static_cast<size_t>(state.range(0));
+    std::vector<PlotterDesign> designs = record_designs(widget_count);
+    const std::array<Path2Ptr, 8> icons = produce_icons();
+    const bool is_retaining = state.range(1) != 0;
+
+    Frame frame;
+    Aabrf clip(Size2f(30, 30));
+    uint parsed_designs = 0;
+    const auto draw_frame = [&] {
+        record_design(designs.front(), icons);
+        if (!is_retaining) { clip.grow(clip.get_width() > 30 ? -1 : 1); }
+
+        frame.builder.start_frame();
+        for (size_t i = 0; i < widget_count; ++i) {
+            frame.builder.parse(designs[i], get_widget_xform(i), clip);
+        }
+        parsed_designs += frame.builder.get_statistics().designs_parsed;
+    };
+
+    // Painters can only record on the render thread
+    run_on_render_thread([&] {
+        draw_frame(); // the first frame parses all Designs
+        parsed_designs = 0;
+        for (auto _ : state) {
+            draw_frame();
+            benchmark::DoNotOptimize(frame.builder.get_drawcalls().data());
+        }
+    });
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["parsed/frame"] = static_cast<double>(parsed_designs) / static_cast<double>(state.iterations());
+}
+BENCHMARK(PlotterRetainedFragments)
+    ->ArgNames({"widgets", "retained"})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({10000, 0})
+    ->Args({10000, 1});
+
+/// Renders the Designs of `range(0)` Widgets with the Plotter, each Widget strokes its frame and one of 8 icons.
+/// Requires a display for the OpenGL context, run it with Mesa's software renderer for results that do not depend on
+/// the GPU: `LIBGL_ALWAYS_SOFTWARE=1 xvfb-run notf-benchmark --benchmark_filter=PlotterRender`. Reports the number of
+/// calls stored by the Designs next to the OpenGL draw calls and state changes that were needed to render them.
+static void PlotterRender(benchmark::State& state)
+{
+    BenchmarkScene scene(state);
+    if (!scene.is_running()) { return; }
+
+    const size_t widget_count = static_cast<size_t>(state.range(0));
+    std::array<Path2Ptr, 8> icons;
+    for (size_t i = 0; i < icons.size(); ++i) {
+        icons[i] = Path2::circle(V2f(15, 15), 4 + static_cast<float>(i));
+    }
+    const Path2Ptr frame = Path2::rect(Aabrf(Size2f(30, 30)));
+    std::vector<PlotterDesign> designs(widget_count);
+    run_on_render_thread([&] {
+        for (size_t i = 0; i < widget_count; ++i) {
+            const V2f position(static_cast<float>(i % 60) * 32, static_cast<float>(i / 60) * 32);
+            Painter painter(designs[i]);
+            painter.set_transform(M3f::translation(position));
+            painter.set_path(frame);
+            painter.stroke();
+            painter.set_paint(Color(0.2f, 0.4f, 0.8f));
+            painter.set_path(icons[static_cast<size_t>(random(0, 7))]);
+            painter.stroke();
+        }
+    });
+
+    GraphicsContext& context = scene.get_window()->get_graphics_context();
+    NOTF_GUARD(context.make_current());
+    std::unique_ptr<Plotter> plotter;
+    try {
+        plotter = std::make_unique<Plotter>(context);
+    }
+    catch (const notf_exception& error) {
+        state.SkipWithError(error.what());
+        for (auto _ : state) {}
+        return;
+    }
+
+    for (auto _ : state) {
+        plotter->start_parsing();
+        for (const PlotterDesign& design : designs) {
+            plotter->parse(design, M3f::identity());
+        }
+        plotter->finish_parsing();
+        NOTF_CHECK_GL(glFinish()); // wait for the (software) renderer
+    }
+    const Plotter::FrameStatistics& statistics = plotter->get_statistics();
+    state.counters["calls"] = statistics.calls_stored;
+    state.counters["draw_calls"] = statistics.draw_calls;
+    state.counters["state_changes"] = statistics.state_changes;
+}
+BENCHMARK(PlotterRender)->ArgNames({"widgets"})->Arg(100)->Arg(1000)->Arg(10000)->UseRealTime();
@@ -0,0 +1,202 @@
+#include "benchmark/benchmark.h"
+
+#include "notf/common/random.hpp"
+#include "notf/common/thread.hpp"
+#include "notf/common/variant.hpp"
+
+#include "notf/graphic/plotter/design.hpp"
+#include "notf/graphic/plotter/painter.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Stand-in for the previous encoding of a PlotterDesign, where every Command with a payload owned a heap allocation.
+namespace legacy {
+
+struct SetXform {
+    struct Data {
+        M3f xform;
+    };
+    std::unique_ptr<Data> data;
+};
+struct SetPaint {
+    struct Data {
+        Plotter::Paint paint;
+    };
+    std::unique_ptr<Data> data;
+};
+struct SetPath {
+    struct Data {
+        Path2Ptr path;
+    };
+    std::unique_ptr<Data> data;
+};
+struct Fill {};
+using Command = std::variant<SetXform, SetPaint, SetPath, Fill>;
+
+} // namespace legacy
+
+/// Input of a single fill: transformation, paint and path.
+struct Shape {
+    M3f xform;
+    Plotter::Paint paint;
+    Path2Ptr path;
+};
+
+/// Produces `command_count / 4` Shapes, each of which records into 4 Commands.
+std::vector<Shape> produce_shapes(const size_t command_count) {
+    const std::array<Path2Ptr, 4> paths = {Path2::rect(Aabrf(Size2f(10, 10))), Path2::rect(Aabrf(Size2f(20, 10))),
+                                           Path2::rect(Aabrf(Size2f(10, 20))), Path2::rect(Aabrf(Size2f(20, 20)))};
+    std::vector<Shape> shapes(command_count / 4);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        shapes[i].xform = M3f::translation(V2f(random(0.f, 1920.f), random(0.f, 1080.f)));
+        shapes[i].paint = Color(random(0.f, 1.f), random(0.f, 1.f), random(0.f, 1.f));
+        shapes[i].path = paths[i % paths.size()];
+    }
+    return shapes;
+}
+
+/// Records all Shapes into the given PlotterDesign.
+void record(PlotterDesign& design, const std::vector<Shape>& shapes) {
+    Painter painter(design);
+    for (const Shape& shape : shapes) {
+        painter.set_transform(shape.xform);
+        painter.set_paint(shape.paint);
+        painter.set_path(shape.path);
+        painter.fill();
+    }
+}
+
+/// Records all Shapes into a legacy Command buffer, diffing against the current state like the Painter does.
+/// In an application, the allocations of a Design are interleaved with those of other Designs and everything else going
+/// on in the render thread. If `noise` is given, a block of random size is allocated after each Command to simulate
+/// this, otherwise all Commands end up next to each other in the heap.
+void record(std::vector<legacy::Command>& design, const std::vector<Shape>& shapes,
+            std::vector<std::unique_ptr<char[]>>* noise = nullptr) {
+    const auto add_noise = [&] {
+        if (noise) { noise->emplace_back(std::make_unique<char[]>(static_cast<size_t>(random(16, 512)))); }
+    };
+    Plotter::PainterState state;
+    design.clear();
+    for (const Shape& shape : shapes) {
+        if (shape.xform != state.xform) {
+            state.xform = shape.xform;
+            design.emplace_back(legacy::SetXform{make_unique_aggregate<legacy::SetXform::Data>(state.xform)});
+            add_noise();
+        }
+        if (shape.paint != state.paint) {
+            state.paint = shape.paint;
+            design.emplace_back(legacy::SetPaint{make_unique_aggregate<legacy::SetPaint::Data>(state.paint)});
+            add_noise();
+        }
+        if (shape.path != state.path) {
+            state.path = shape.path;
+            design.emplace_back(legacy::SetPath{make_unique_aggregate<legacy::SetPath::Data>(state.path)});
+            add_noise();
+        }
+        design.emplace_back(legacy::Fill{});
+    }
+}
+
+/// Runs a benchmark on the render thread, the only thread that is allowed to use a Painter.
+template<class Function>
+void run_on_render_thread(Function&& function) {
+    Thread render_thread(Thread::Kind::RENDER);
+    render_thread.run(std::forward<Function>(function));
+    render_thread.join();
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Records a Design with `range(0)` Commands, each Command with a payload in its own allocation.
+static void DesignRecordLegacy(benchmark::State& state)
+{
+    const std::vector<Shape> shapes = produce_shapes(static_cast<size_t>(state.range(0)));
+    std::vector<legacy::Command> design;
+    for (auto _ : state) {
+        record(design, shapes);
+        benchmark::DoNotOptimize(design.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(DesignRecordLegacy)->ArgNames({"commands"})->Arg(1000)->Arg(10000);
+
+/// Records a PlotterDesign with `range(0)` Commands.
+static void DesignRecord(benchmark::State& state)
+{
+    const std::vector<Shape> shapes = produce_shapes(static_cast<size_t>(state.range(0)));
+    PlotterDesign design;
+    run_on_render_thread([&] {
+        for (auto _ : state) {
+            record(design, shapes);
+            benchmark::DoNotOptimize(design.get_buffer_size());
+        }
+    });
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes"] = static_cast<double>(design.get_buffer_size());
+}
+BENCHMARK(DesignRecord)->ArgNames({"commands"})->Arg(1000)->Arg(10000);
+
+/// Replays a Design with `range(0)` Commands, each Command with a payload in its own allocation.
+/// If `range(1)` is not zero, the payloads are scattered across the heap.
+static void DesignReplayLegacy(benchmark::State& state)
+{
+    const std::vector<Shape> shapes = produce_shapes(static_cast<size_t>(state.range(0)));
+    std::vector<legacy::Command> design;
+    std::vector<std::unique_ptr<char[]>> noise;
+    record(design, shapes, state.range(1) ? &noise : nullptr);
+    for (auto _ : state) {
+        M3f xform = M3f::identity();
+        float red = 0;
+        size_t fills = 0;
+        for (const legacy::Command& command : design) {
+            std::visit(overloaded{
+                           [&](const legacy::SetXform& cmd) { xform = cmd.data->xform; },
+                           [&](const legacy::SetPaint& cmd) { red += cmd.data->paint.inner_color.r; },
+                           [&](const legacy::SetPath& cmd) { benchmark::DoNotOptimize(cmd.data->path.get()); },
+                           [&](const legacy::Fill&) { ++fills; },
+                       },
+                       command);
+        }
+        benchmark::DoNotOptimize(xform);
+        benchmark::DoNotOptimize(red);
+        benchmark::DoNotOptimize(fills);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(DesignReplayLegacy)
+    ->ArgNames({"commands", "scattered"})
+    ->Args({1000, 0})
+    ->Args({10000, 0})
+    ->Args({1000, 1})
+    ->Args({10000, 1});
+
+/// Replays a PlotterDesign with `range(0)` Commands.
+static void DesignReplay(benchmark::State& state)
+{
+    const std::vector<Shape> shapes = produce_shapes(static_cast<size_t>(state.range(0)));
+    PlotterDesign design;
+    run_on_render_thread([&] { record(design, shapes); });
+    for (auto _ : state) {
+        M3f xform = M3f::identity();
+        float red = 0;
+        size_t fills = 0;
+        design.replay(overloaded{
+            [&](const PlotterDesign::SetXform& cmd) { xform = cmd.xform; },
+            [&](const PlotterDesign::SetPaint& cmd) { red += cmd.paint.inner_color.r; },
+            [&](const PlotterDesign::SetPath& cmd) { benchmark::DoNotOptimize(cmd.path.get()); },
+            [&](const PlotterDesign::Fill&) { ++fills; },
+            [&](const auto&) {},
+        });
+        benchmark::DoNotOptimize(xform);
+        benchmark::DoNotOptimize(red);
+        benchmark::DoNotOptimize(fills);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(DesignReplay)->ArgNames({"commands"})->Arg(1000)->Arg(10000);
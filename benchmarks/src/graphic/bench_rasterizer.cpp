@@ -0,0 +1,147 @@
+#include "benchmark/benchmark.h"
+
+#include "notf/common/geo/path2.hpp"
+#include "notf/common/random.hpp"
+
+#include "notf/graphic/plotter/rasterizer.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Size of the rendered image.
+const Size2i g_image_size(800, 600);
+
+/// Size of the synthetic font atlas and of each Glyph in it.
+constexpr int g_atlas_size = 256;
+constexpr int g_glyph_size = 16;
+
+/// Random position in the image.
+V2f random_position() {
+    return V2f(random(0.f, static_cast<float>(g_image_size.get_width())),
+               random(0.f, static_cast<float>(g_image_size.get_height())));
+}
+
+/// Random, half-transparent Color.
+Color random_color() { return Color(random(0.f, 1.f), random(0.f, 1.f), random(0.f, 1.f), 0.5f); }
+
+/// Concave star with `count` spikes around the given center.
+Path2Ptr produce_star(const V2f& center, const size_t count, const float radius) {
+    std::vector<V2f> points;
+    for (size_t i = 0; i < count * 2; ++i) {
+        const float angle = static_cast<float>(i) * pi<float>() / static_cast<float>(count);
+        const float distance = i % 2 == 0 ? radius : radius * 0.4f;
+        points.emplace_back(center.x() + std::cos(angle) * distance, center.y() + std::sin(angle) * distance);
+    }
+    Polylinef polyline(std::move(points));
+    polyline.set_closed();
+    return Path2::create(CubicPolyBezier2f(std::move(polyline)));
+}
+
+/// Font atlas filled with Glyphs of `g_glyph_size` pixels, each of which is a filled circle.
+std::vector<uchar> produce_font_atlas() {
+    std::vector<uchar> pixels(g_atlas_size * g_atlas_size);
+    for (int y = 0; y < g_atlas_size; ++y) {
+        for (int x = 0; x < g_atlas_size; ++x) {
+            const float dx = static_cast<float>(x % g_glyph_size) - g_glyph_size / 2.f + 0.5f;
+            const float dy = static_cast<float>(y % g_glyph_size) - g_glyph_size / 2.f + 0.5f;
+            const float distance = std::sqrt(dx * dx + dy * dy);
+            pixels[static_cast<size_t>(y * g_atlas_size + x)]
+                = static_cast<uchar>(clamp(g_glyph_size / 2.f - distance, 0.f, 1.f) * 255);
+        }
+    }
+    return pixels;
+}
+
+/// Line of `count` Glyphs from the synthetic font atlas.
+std::vector<Glyph> produce_line(const size_t count) {
+    constexpr int glyphs_per_row = g_atlas_size / g_glyph_size;
+    std::vector<Glyph> glyphs(count);
+    for (size_t i = 0; i < count; ++i) {
+        const int index = static_cast<int>(i) % (glyphs_per_row * glyphs_per_row);
+        glyphs[i].rect = Glyph::Rect(static_cast<Glyph::coord_t>((index % glyphs_per_row) * g_glyph_size),
+                                     static_cast<Glyph::coord_t>((index / glyphs_per_row) * g_glyph_size),
+                                     g_glyph_size, g_glyph_size);
+        glyphs[i].left = 0;
+        glyphs[i].top = g_glyph_size;
+        glyphs[i].advance_x = g_glyph_size - 6;
+        glyphs[i].advance_y = 0;
+    }
+    return glyphs;
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Fills `range(0)` rectangles of random size and color, items processed are pixels in the image.
+static void RasterizerRects(benchmark::State& state)
+{
+    std::vector<Plotter::PainterState> rects(static_cast<size_t>(state.range(0)));
+    for (auto& rect : rects) {
+        rect.path = Path2::rect(Aabrf(random_position(), random(5.f, 100.f), random(5.f, 100.f)));
+        rect.paint = random_color();
+    }
+    PlotterRasterizer rasterizer(g_image_size);
+    for (auto _ : state) {
+        rasterizer.clear();
+        for (const auto& rect : rects) {
+            rasterizer.fill(rect);
+        }
+        benchmark::DoNotOptimize(rasterizer.get_data());
+    }
+    state.SetItemsProcessed(state.iterations() * g_image_size.get_area());
+}
+BENCHMARK(RasterizerRects)->ArgNames({"rects"})->Arg(100)->Arg(1000);
+
+/// Fills and strokes `range(0)` stars and circles with gradients, items processed are pixels in the image.
+static void RasterizerPaths(benchmark::State& state)
+{
+    std::vector<Plotter::PainterState> paths(static_cast<size_t>(state.range(0)));
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const V2f center = random_position();
+        const float radius = random(10.f, 80.f);
+        paths[i].path = i % 2 == 0 ? produce_star(center, 7, radius) : Path2::circle(center, radius);
+        paths[i].paint = i % 2 == 0 ?
+                             Plotter::Paint::linear_gradient(center, center + V2f(radius, radius), random_color(),
+                                                             random_color()) :
+                             Plotter::Paint::radial_gradient(center, 0, radius, random_color(), random_color());
+        paths[i].stroke_width = 2;
+        paths[i].joint_style = Plotter::JointStyle::ROUND;
+    }
+    PlotterRasterizer rasterizer(g_image_size);
+    for (auto _ : state) {
+        rasterizer.clear();
+        for (const auto& path : paths) {
+            rasterizer.fill(path);
+            rasterizer.stroke(path);
+        }
+        benchmark::DoNotOptimize(rasterizer.get_data());
+    }
+    state.SetItemsProcessed(state.iterations() * g_image_size.get_area());
+}
+BENCHMARK(RasterizerPaths)->ArgNames({"paths"})->Arg(10)->Arg(100);
+
+/// Writes `range(0)` lines of 80 Glyphs each, items processed are pixels in the image.
+static void RasterizerText(benchmark::State& state)
+{
+    const std::vector<Glyph> line = produce_line(80);
+    std::vector<Plotter::PainterState> lines(static_cast<size_t>(state.range(0)));
+    for (size_t i = 0; i < lines.size(); ++i) {
+        lines[i].xform = M3f::translation(V2f(0, static_cast<float>(i % 30) * 20));
+        lines[i].paint = Color::black();
+    }
+    PlotterRasterizer rasterizer(g_image_size);
+    rasterizer.set_font_atlas(produce_font_atlas(), Size2i(g_atlas_size, g_atlas_size));
+    for (auto _ : state) {
+        rasterizer.clear(Color::white());
+        for (const auto& text : lines) {
+            rasterizer.write(line, text);
+        }
+        benchmark::DoNotOptimize(rasterizer.get_data());
+    }
+    state.SetItemsProcessed(state.iterations() * g_image_size.get_area());
+}
+BENCHMARK(RasterizerText)->ArgNames({"lines"})->Arg(30)->Arg(300);
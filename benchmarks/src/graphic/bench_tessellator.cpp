@@ -0,0 +1,124 @@
+#include "benchmark/benchmark.h"
+
+#include "notf/common/geo/path2.hpp"
+#include "notf/common/random.hpp"
+#include "notf/common/thread_pool.hpp"
+
+#include "notf/graphic/plotter/tessellator.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Concave star with `count` spikes.
+Path2Ptr produce_star(const size_t count) {
+    std::vector<V2f> points;
+    for (size_t i = 0; i < count * 2; ++i) {
+        const float angle = static_cast<float>(i) * pi<float>() / static_cast<float>(count);
+        const float radius = i % 2 == 0 ? 100 : 40;
+        points.emplace_back(std::cos(angle) * radius, std::sin(angle) * radius);
+    }
+    Polylinef polyline(std::move(points));
+    polyline.set_closed();
+    return Path2::create(CubicPolyBezier2f(std::move(polyline)));
+}
+
+/// Produces `count` Jobs for circles of random size, half of them filled and the other half stroked.
+std::vector<PathTessellator::Job> produce_jobs(const size_t count) {
+    std::vector<PathTessellator::Job> jobs(count);
+    for (size_t i = 0; i < count; ++i) {
+        jobs[i].path = Path2::circle(V2f::zero(), random(10.f, 200.f));
+        jobs[i].stroke_width = i % 2 == 0 ? 0 : random(1.f, 5.f);
+        jobs[i].joint = Plotter::JointStyle::ROUND;
+    }
+    return jobs;
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Flattens a circle with a radius of `range(0)`.
+static void TessellatorFlatten(benchmark::State& state)
+{
+    const Path2Ptr circle = Path2::circle(V2f::zero(), static_cast<float>(state.range(0)));
+    const PathTessellator tessellator;
+    PathTessellator::Contours contours;
+    for (auto _ : state) {
+        contours.clear();
+        tessellator.flatten(*circle, contours);
+        benchmark::DoNotOptimize(contours.points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(contours.points.size()));
+    state.counters["points"] = static_cast<double>(contours.points.size());
+}
+BENCHMARK(TessellatorFlatten)->ArgNames({"radius"})->Arg(10)->Arg(100)->Arg(1000);
+
+/// Fills a circle with a radius of `range(0)`, which is convex and triangulated as a fan.
+static void TessellatorFillConvex(benchmark::State& state)
+{
+    const Path2Ptr circle = Path2::circle(V2f::zero(), static_cast<float>(state.range(0)));
+    PathTessellator tessellator;
+    PathTessellator::Mesh mesh;
+    for (auto _ : state) {
+        mesh.clear();
+        tessellator.fill(*circle, mesh);
+        benchmark::DoNotOptimize(mesh.indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mesh.get_triangle_count()));
+    state.counters["triangles"] = static_cast<double>(mesh.get_triangle_count());
+}
+BENCHMARK(TessellatorFillConvex)->ArgNames({"radius"})->Arg(10)->Arg(100)->Arg(1000);
+
+/// Fills a star with `range(0)` spikes, which is concave and triangulated by ear clipping.
+static void TessellatorFillConcave(benchmark::State& state)
+{
+    const Path2Ptr star = produce_star(static_cast<size_t>(state.range(0)));
+    PathTessellator tessellator;
+    PathTessellator::Mesh mesh;
+    for (auto _ : state) {
+        mesh.clear();
+        tessellator.fill(*star, mesh);
+        benchmark::DoNotOptimize(mesh.indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mesh.get_triangle_count()));
+    state.counters["triangles"] = static_cast<double>(mesh.get_triangle_count());
+}
+BENCHMARK(TessellatorFillConcave)->ArgNames({"spikes"})->Arg(5)->Arg(50)->Arg(500);
+
+/// Strokes a circle with a radius of 100 and the joint style `range(0)`.
+static void TessellatorStroke(benchmark::State& state)
+{
+    const Path2Ptr circle = Path2::circle(V2f::zero(), 100);
+    const auto joint = static_cast<Plotter::JointStyle>(state.range(0));
+    PathTessellator tessellator;
+    PathTessellator::Mesh mesh;
+    for (auto _ : state) {
+        mesh.clear();
+        tessellator.stroke(*circle, 3, Plotter::CapStyle::BUTT, joint, mesh);
+        benchmark::DoNotOptimize(mesh.indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mesh.get_triangle_count()));
+    state.counters["triangles"] = static_cast<double>(mesh.get_triangle_count());
+}
+BENCHMARK(TessellatorStroke)
+    ->ArgNames({"joint"})
+    ->Arg(to_number(Plotter::JointStyle::BEVEL))
+    ->Arg(to_number(Plotter::JointStyle::ROUND))
+    ->Arg(to_number(Plotter::JointStyle::MITER));
+
+/// Tessellates 1000 Paths on `range(0)` worker threads and the calling thread.
+static void TessellatorParallel(benchmark::State& state)
+{
+    const std::vector<PathTessellator::Job> jobs = produce_jobs(1000);
+    ThreadPool thread_pool(static_cast<size_t>(state.range(0)));
+    std::vector<PathTessellator::Mesh> meshes;
+    for (auto _ : state) {
+        PathTessellator::tessellate(jobs, meshes, thread_pool);
+        benchmark::DoNotOptimize(meshes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(jobs.size()));
+}
+BENCHMARK(TessellatorParallel)->ArgNames({"threads"})->Arg(0)->Arg(1)->Arg(3)->Arg(7)->UseRealTime();
@@ -0,0 +1,114 @@
+#include "benchmark/benchmark.h"
+
+#include "notf/common/random.hpp"
+
+#include "notf/graphic/text/text_layout.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Characters of the labels.
+constexpr const char* g_characters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789      ";
+
+/// Font of all labels.
+const Font::Identifier g_font{"font.ttf", 12};
+
+/// Line height of the synthetic font.
+constexpr int g_line_height = 14;
+
+/// Synthetic Glyphs for every character in `g_characters`, stored like in a Font.
+GlyphTable<Glyph>& get_glyphs() {
+    static GlyphTable<Glyph> glyphs;
+    if (glyphs.is_empty()) {
+        for (const char* character = g_characters; *character != 0; ++character) {
+            const codepoint_t codepoint = static_cast<codepoint_t>(*character);
+            glyphs.emplace(codepoint, Glyph{{static_cast<Glyph::coord_t>(codepoint), 0, 7, 10}, 0, 8,
+                                            static_cast<Glyph::coord_t>(6 + codepoint % 3), 0});
+        }
+    }
+    return glyphs;
+}
+
+/// Looks up a synthetic Glyph.
+const Glyph& get_glyph(const codepoint_t codepoint) { return *get_glyphs().find(codepoint); }
+
+/// Produces `count` random labels of 8 to 40 characters.
+std::vector<std::string> produce_labels(const size_t count) {
+    std::vector<std::string> labels(count);
+    const std::string_view characters(g_characters);
+    for (std::string& label : labels) {
+        label.resize(random<size_t>(8, 40));
+        for (char& character : label) {
+            character = characters[random<size_t>(0, characters.size() - 1)];
+        }
+    }
+    return labels;
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Lays out a page of `range(0)` static labels every frame, items processed are labels.
+static void TextLayoutUncached(benchmark::State& state)
+{
+    const std::vector<std::string> labels = produce_labels(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (const std::string& label : labels) {
+            benchmark::DoNotOptimize(TextLayout(label, 0, g_line_height, get_glyph).get_aabr());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(TextLayoutUncached)->ArgNames({"labels"})->Arg(100)->Arg(1000);
+
+/// Requests the layouts of a page of `range(0)` static labels from a TextLayoutCache every frame, items processed are
+/// labels.
+static void TextLayoutCached(benchmark::State& state)
+{
+    const std::vector<std::string> labels = produce_labels(static_cast<size_t>(state.range(0)));
+    TextLayoutCache cache;
+    for (auto _ : state) {
+        for (const std::string& label : labels) {
+            benchmark::DoNotOptimize(
+                cache.get(g_font, label, 0, [&] { return TextLayout(label, 0, g_line_height, get_glyph); })->get_aabr());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["hit_ratio"] = cache.get_statistics().get_hit_ratio();
+}
+BENCHMARK(TextLayoutCached)->ArgNames({"labels"})->Arg(100)->Arg(1000);
+
+/// Lays out a page of `range(0)` static labels broken into lines of 100 pixels every frame, items processed are labels.
+static void TextLayoutBreakUncached(benchmark::State& state)
+{
+    const std::vector<std::string> labels = produce_labels(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (const std::string& label : labels) {
+            benchmark::DoNotOptimize(TextLayout(label, 100, g_line_height, get_glyph).get_line_breaks());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(TextLayoutBreakUncached)->ArgNames({"labels"})->Arg(100)->Arg(1000);
+
+/// Requests the line breaks of a page of `range(0)` static labels from a TextLayoutCache every frame, items processed
+/// are labels.
+static void TextLayoutBreakCached(benchmark::State& state)
+{
+    const std::vector<std::string> labels = produce_labels(static_cast<size_t>(state.range(0)));
+    TextLayoutCache cache;
+    for (auto _ : state) {
+        for (const std::string& label : labels) {
+            benchmark::DoNotOptimize(
+                cache.get(g_font, label, 100, [&] { return TextLayout(label, 100, g_line_height, get_glyph); })
+                    ->get_line_breaks());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["hit_ratio"] = cache.get_statistics().get_hit_ratio();
+}
+BENCHMARK(TextLayoutBreakCached)->ArgNames({"labels"})->Arg(100)->Arg(1000);
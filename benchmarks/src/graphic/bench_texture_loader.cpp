@@ -0,0 +1,90 @@
+#include "benchmark/benchmark.h"
+
+#include <filesystem>
+#include <thread>
+
+#include "notf/graphic/texture_loader.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Number of images loaded per iteration, like a screen full of thumbnails.
+constexpr size_t g_image_count = 500;
+
+/// Image files of the thumbnails, loaded in turns.
+const std::vector<std::string>& get_image_files() {
+    static const std::vector<std::string> files = [] {
+        const std::filesystem::path directory
+            = std::filesystem::path(__FILE__).parent_path().parent_path().parent_path().parent_path() / "res"
+              / "textures";
+        std::vector<std::string> result;
+        for (const char* name : {"block.png", "block_solid.png", "notf.png", "face.png"}) {
+            result.emplace_back((directory / name).string());
+        }
+        return result;
+    }();
+    return files;
+}
+
+/// Image file of the thumbnail with the given index.
+const std::string& get_image_file(const size_t index) {
+    const std::vector<std::string>& files = get_image_files();
+    return files[index % files.size()];
+}
+
+} // namespace
+
+// benchmark ======================================================================================================== //
+
+/// Loads all thumbnails on the calling thread, with (`range(0)` = 1) or without (`range(0)` = 0) copying the decoded
+/// pixels into an intermediate buffer before the upload. Items processed are images.
+static void TextureLoadBlocking(benchmark::State& state)
+{
+    const bool is_copying = state.range(0) != 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < g_image_count; ++i) {
+            RawImage image(get_image_file(i));
+            if (is_copying) {
+                std::vector<uchar> pixels(image.get_data(),
+                                          image.get_data() + image.get_size().get_area() * image.get_channels());
+                benchmark::DoNotOptimize(pixels.data());
+            } else {
+                benchmark::DoNotOptimize(image.get_data());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(g_image_count));
+}
+BENCHMARK(TextureLoadBlocking)->ArgNames({"copy"})->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+/// Requests all thumbnails from a TextureLoader. The measured time is how long the calling thread is blocked, the
+/// `decoded_ms` counter is the time until all images are decoded and ready for upload. Items processed are images.
+/// The number of iterations is fixed, because the measured time is much shorter than the time each iteration takes.
+static void TextureLoadBackground(benchmark::State& state)
+{
+    double decoded_seconds = 0;
+    for (auto _ : state) {
+        TextureLoader loader;
+        std::vector<std::future<TexturePtr>> textures;
+        textures.reserve(g_image_count);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < g_image_count; ++i) {
+            textures.emplace_back(loader.load(get_image_file(i), "thumbnail"));
+        }
+        const auto requested = std::chrono::steady_clock::now();
+        while (loader.get_decoded_count() < g_image_count) {
+            std::this_thread::yield();
+        }
+        const auto decoded = std::chrono::steady_clock::now();
+
+        state.SetIterationTime(std::chrono::duration<double>(requested - start).count());
+        decoded_seconds += std::chrono::duration<double>(decoded - start).count();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(g_image_count));
+    state.counters["decoded_ms"] = decoded_seconds * 1000. / static_cast<double>(state.iterations());
+}
+BENCHMARK(TextureLoadBackground)->UseManualTime()->Iterations(10)->Unit(benchmark::kMillisecond);
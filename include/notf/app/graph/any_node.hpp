@@ -530,6 +530,15 @@ private:
     /// Unlike in the constructor, you can already create Handles to this Node.
     virtual void _finalize() {}
 
+    /// Called on every new Node instance right after it has been marked as finalized.
+    /// Unlike `_finalize`, this is meant for intermediate base classes that must run for every instance, even if the
+    /// most derived class overrides `_finalize` without calling the base implementation.
+    virtual void _on_finalized() {}
+
+    /// Called on a Node right after it was moved to a new parent (see `_set_parent`).
+    /// @param old_parent   Previous parent of this Node.
+    virtual void _on_parent_changed(AnyNode* /*old_parent*/) {}
+
     /// Marks this Node as finalized.
     /// Called right after this Node's `_finalize` method has returned.
     void _set_finalized();
@@ -695,6 +704,8 @@ class Accessor<AnyNode, AnyWidget> {
 
     static AnyNode* get_parent(const AnyNode& node) { return node._get_parent(); }
 
+    static const std::vector<AnyNodePtr>& read_children(const AnyNode& node) { return node._read_children(); }
+
     static const AnyNode* get_common_ancestor(const AnyNode& node, const AnyNode* other) {
         return node._get_common_ancestor(other);
     }
@@ -81,9 +81,17 @@ public:
     bool is_window_scene() const;
 
 private:
+    /// Area of the window that will look different when the Scene is drawn next, in pixels.
+    /// Nested Scenes always redraw the whole window.
+    Aabri _get_damage();
+
     /// Draw the Scene.
     void _draw();
 
+    /// Called on the UI thread once per frame, right before the Graph is synchronized and the frame is rendered.
+    /// Subclasses can use this to batch up work that would otherwise be done eagerly, like layouting.
+    virtual void _prepare_frame() {}
+
     // fields --------------------------------------------------------------------------------------------------- //
 private:
     /// Visualizer that draws the Scene.
@@ -120,8 +128,14 @@ public:
     SceneHandle(NodeHandle<Derived>&& handle) : NodeHandle<Scene>(std::move(handle)) {}
 
 private:
+    /// Area of the window that will look different when the Scene is drawn next.
+    Aabri _get_damage() const { return _get_node()->_get_damage(); }
+
     /// Draws the Scene.
     void _draw() const { _get_node()->_draw(); }
+
+    /// Lets the Scene prepare the next frame.
+    void _prepare_frame() const { _get_node()->_prepare_frame(); }
 };
 
 // scene handle accessors =========================================================================================== //
@@ -130,8 +144,14 @@ template<>
 class Accessor<SceneHandle, detail::RenderManager> {
     friend detail::RenderManager;
 
+    /// Area of the window that will look different when the Scene is drawn next.
+    static Aabri get_damage(const SceneHandle& scene) { return scene._get_damage(); }
+
     /// Draws the Scene.
     static void draw(const SceneHandle& scene) { scene._draw(); }
+
+    /// Lets the Scene prepare the next frame.
+    static void prepare_frame(const SceneHandle& scene) { scene._prepare_frame(); }
 };
 
 NOTF_CLOSE_NAMESPACE
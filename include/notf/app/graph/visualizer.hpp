@@ -4,6 +4,7 @@
 
 #include "notf/meta/smart_ptr.hpp"
 
+#include "notf/common/geo/aabr.hpp"
 #include "notf/common/geo/size2.hpp"
 
 #include "notf/app/fwd.hpp"
@@ -116,6 +117,12 @@ public:
     /// @param scene    Scene to visualize.
     virtual void visualize(valid_ptr<Scene*> scene) const = 0;
 
+    /// Area of the Scene that will look different from the last frame, in pixels.
+    /// Is called right before the Scene is visualized, only the returned area needs to be redrawn.
+    /// The default implementation redraws everything.
+    /// @param scene    Scene to visualize.
+    virtual Aabri get_damage(valid_ptr<Scene*> /*scene*/) const { return Aabri::largest(); }
+
     /// GraphicsContext of the Window to visualize into.
     GraphicsContext& get_context() const { return m_context; }
 
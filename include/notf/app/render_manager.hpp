@@ -2,6 +2,7 @@
 
 #include <condition_variable>
 #include <deque>
+#include <vector>
 
 #include "notf/meta/singleton.hpp"
 #include "notf/meta/smart_ptr.hpp"
@@ -59,6 +60,10 @@ private:
         /// Windows that need to be re-rendered.
         std::deque<WindowHandle> m_dirty_windows;
 
+        /// Windows that are waiting for background work (like glyph rasterization) and are redrawn periodically
+        /// until it is done.
+        std::vector<WindowHandle> m_waiting_windows;
+
         /// Is true as long at the thread is alive.
         std::atomic_bool m_is_running = true;
     };
@@ -1,14 +1,24 @@
 #pragma once
 
-#include <forward_list>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <list>
 #include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "notf/meta/exception.hpp"
+#include "notf/meta/numeric.hpp"
 #include "notf/meta/smart_ptr.hpp"
+#include "notf/meta/time.hpp"
 #include "notf/meta/typename.hpp"
 
+#include "notf/common/fwd.hpp"
 #include "notf/common/mutex.hpp"
 
 NOTF_OPEN_NAMESPACE
@@ -37,7 +47,10 @@ public:
 
     /// Copy operator.
     /// @param other    ResourceHandle to copy.
-    ResourceHandle& operator=(const ResourceHandle& other) { m_resource = other.m_resource; }
+    ResourceHandle& operator=(const ResourceHandle& other) {
+        m_resource = other.m_resource;
+        return *this;
+    }
 
     /// Move operator.
     /// @param other    ResourceHandle to copy.
@@ -52,17 +65,17 @@ public:
     bool operator==(const ResourceHandle& other) const { return m_resource == other.m_resource; }
 
     /// The managed resource.
-    /// @throws resource_error  If the handle is not valid.
+    /// @throws ResourceError   If the handle is not valid.
     operator T*() {
         if (!is_valid()) {
-            NOTF_THROW(resource_error, "Cannot acces invalid Handle for resource of type \"{}\"", type_name<T>());
+            NOTF_THROW(ResourceError, "Cannot acces invalid Handle for resource of type \"{}\"", type_name<T>());
         }
         return m_resource.get();
     }
     T* operator->() { return operator T*(); }
 
     /// Returns the shared pointer contained in this Resource handle.
-    std::shared_ptr<T> get_shared() { return m_resource; }
+    std::shared_ptr<T> get_shared() const { return m_resource; }
 
     /// Tests if the ResourceHandle is valid.
     bool is_valid() const { return m_resource != nullptr; }
@@ -82,9 +95,61 @@ private:
     std::shared_ptr<T> m_resource;
 };
 
+// resource stats =================================================================================================== //
+
+/// Statistics of a single ResourceType or of all types in the ResourceManager.
+struct ResourceStats {
+    /// Number of lookups that found the requested resource.
+    size_t hits = 0;
+
+    /// Number of lookups that did not find the requested resource.
+    size_t misses = 0;
+
+    /// Number of inactive resources that were removed to stay within a byte budget.
+    size_t evictions = 0;
+
+    /// Number of resources currently held, active or not.
+    size_t resource_count = 0;
+
+    /// Sum of the reported sizes of all resources currently held, in bytes.
+    size_t bytes_resident = 0;
+
+    /// Accumulates the stats of another ResourceType.
+    ResourceStats& operator+=(const ResourceStats& other) {
+        hits += other.hits;
+        misses += other.misses;
+        evictions += other.evictions;
+        resource_count += other.resource_count;
+        bytes_resident += other.bytes_resident;
+        return *this;
+    }
+};
+
 // resource manager ================================================================================================= //
 
+namespace detail {
+
+/// Size of a resource in bytes, as reported by its `get_byte_size()` method.
+/// Resources without such a method have no size and only count towards budgets with zero bytes.
+template<class T, class = void>
+struct ResourceByteSize {
+    static size_t get(const T&) { return 0; }
+};
+template<class T>
+struct ResourceByteSize<T, std::void_t<decltype(std::declval<const T&>().get_byte_size())>> {
+    static size_t get(const T& resource) { return static_cast<size_t>(resource.get_byte_size()); }
+};
+
+} // namespace detail
+
 // TODO: ScopedInstance for ResourceManager
+/// Owns resources by name and keeps inactive ones around as long as they fit into the byte budget of their
+/// ResourceType and the global byte budget of the manager.
+/// A resource is inactive, if it is held only by the ResourceManager. When over budget, inactive resources are evicted
+/// in least recently used order. Active resources are never evicted, but count towards the budgets.
+/// Lookups only take a shared lock on their ResourceType and do not modify the LRU list, instead they note the time of
+/// use in the resource entry. Entries that were used since they were last moved to the front of the LRU list are given
+/// a second chance when they reach its back.
 class ResourceManager {
 
     // types ----------------------------------------------------------------------------------- //
@@ -98,24 +163,38 @@ private:
         /// Destructor.
         virtual ~ResourceTypeBase();
 
+        /// Statistics of this Resource type.
+        virtual ResourceStats get_stats() const = 0;
+
+        /// Removes all inactive resources, ignoring this type's byte budget.
+        virtual void remove_all_inactive() = 0;
+
     private:
-        /// Removes inactive resources.
-        /// @param cache_limit  How many of the most recently loaded inactive resources to retain.
-        virtual void _remove_inactive(const size_t cache_limit) = 0;
+        /// Removes inactive resources until the type is within the given byte budget.
+        /// @param byte_budget  Maximum number of bytes of all resources of this type.
+        virtual void _enforce_budget(const size_t byte_budget) = 0;
+
+        /// Time of the last use of the least recently used inactive resource.
+        /// @returns    The time, or `timepoint_t::max()` if all resources are active.
+        virtual timepoint_t _get_least_recent_use() = 0;
+
+        /// Removes the least recently used inactive resource.
+        /// @returns    True iff a resource was removed.
+        virtual bool _evict_least_recently_used() = 0;
 
         /// Removes all resources, inactive or not.
         virtual void _clear() = 0;
 
-        /// Removes inactive resources as determined by the cache limit.
-        void _cleanup() { _remove_inactive(m_cache_limit); }
+        /// Removes inactive resources as determined by the byte budget.
+        void _cleanup() { _enforce_budget(m_byte_budget); }
 
         // fields ------------------------------------------------------------------------------ //
     protected:
-        /// Number of inactive resources to retain in the cache (defaults to 0).
-        ///     0  = no caching
-        ///     n = caching of n last loaded inactive
-        /// Inactive means that the resource is held only by the ResourceManager.
-        size_t m_cache_limit = 0;
+        /// Maximum number of bytes of all resources of this type (defaults to no limit, so that only the global
+        /// budget of the manager applies and prefetched resources are kept until they are used).
+        ///     0 = no caching of inactive resources
+        ///     n = inactive resources are kept, as long as all resources take up less than n bytes
+        std::atomic<size_t> m_byte_budget = max_v<size_t>;
     };
 
 public:
@@ -123,8 +202,47 @@ public:
     class ResourceType : public ResourceTypeBase {
         friend class ResourceManager;
 
+        /// Entry of a single resource.
+        struct _Entry {
+            /// The resource.
+            std::shared_ptr<T> resource;
+
+            /// Size of the resource in bytes.
+            size_t byte_size = 0;
+
+            /// Time of the last lookup, written by readers holding only a shared lock.
+            mutable std::atomic<timepoint_t::rep> last_use = 0;
+
+            /// Value of `last_use` when the entry was last moved to the front of the LRU list.
+            timepoint_t::rep last_promotion = 0;
+
+            /// Name of the resource, key of this entry in the resource map.
+            const std::string* name = nullptr;
+
+            /// Position of this entry in the LRU list.
+            typename std::list<_Entry*>::iterator position;
+        };
+
         /// Map storing all loaded resources by filename.
-        using ResourceMap = std::map<const std::string, std::shared_ptr<T>>;
+        using ResourceMap = std::unordered_map<std::string, _Entry>;
+
+    public:
+        /// Function loading a resource by its name, called on one of the ResourceManager's worker threads.
+        /// The resource is stored in the ResourceType by the manager, the loader only has to produce it.
+        using Loader = std::function<std::shared_ptr<T>(const std::string& name)>;
+
+        /// Function finishing an asynchronous load, can be called from any thread.
+        /// Is called either with the loaded resource, or with the exception that prevented it from loading.
+        using Completion = std::function<void(std::shared_ptr<T> resource, std::exception_ptr exception)>;
+
+        /// Function starting to load a resource by its name, called on one of the ResourceManager's worker threads.
+        /// Unlike a `Loader`, it does not have to produce the resource before it returns. Instead, it must call the
+        /// given Completion exactly once, which can also be done later by another thread. Use it for resources that
+        /// are finished elsewhere, so that the worker does not have to wait for them.
+        using AsyncLoader = std::function<void(const std::string& name, Completion completion)>;
+
+        /// Future of a resource requested with `get_async`.
+        using Future = std::shared_future<ResourceHandle<T>>;
 
         // methods ----------------------------------------------------------------------------- //
     private:
@@ -166,92 +284,297 @@ public:
             }
         }
 
-        /// Number of inactive resources to retain in the cache.
-        size_t get_cache_limit() const {
-            NOTF_GUARD(std::lock_guard(m_manager.m_mutex));
-            return m_cache_limit;
+        /// Maximum number of bytes of all resources of this type.
+        size_t get_byte_budget() const { return m_byte_budget; }
+
+        /// Updates the byte budget of this Resource type.
+        /// @param byte_budget  Maximum number of bytes of all resources of this type, inactive resources are evicted
+        ///                     until the type is within its budget.
+        void set_byte_budget(const size_t byte_budget) {
+            m_byte_budget = byte_budget;
+            _enforce_budget(byte_budget);
         }
 
-        /// Updates the cache limit of this Resource type.
-        /// @param cache_limit  Number of inactive resources to retain in the cache.
-        void set_cache_limit(const size_t cache_limit) {
-            NOTF_GUARD(std::lock_guard(m_manager.m_mutex));
-            if (cache_limit < m_cache_limit) { _remove_inactive(cache_limit); }
-            m_cache_limit = cache_limit;
+        /// Statistics of this Resource type.
+        ResourceStats get_stats() const final {
+            ResourceStats result;
+            result.hits = m_hits;
+            result.misses = m_misses;
+            NOTF_GUARD(std::shared_lock(m_mutex));
+            result.evictions = m_eviction_count;
+            result.resource_count = m_resources.size();
+            result.bytes_resident = m_byte_count;
+            return result;
         }
 
         /// Returns a cached resource by its filename.
-        /// @param name             Name of the resource.
-        /// @throws resource_error  If there is no resource by the name.
+        /// @param name     Name of the resource.
+        /// @returns        Handle to the resource, is invalid if there is no resource by the name.
         ResourceHandle<T> get(const std::string& name) const {
-            NOTF_GUARD(std::lock_guard(m_manager.m_mutex));
+            NOTF_GUARD(std::shared_lock(m_mutex));
             auto it = m_resources.find(name);
-            if (it != m_resources.end()) { return ResourceHandle<T>(it->second); }
-            return {};
+            if (it == m_resources.end()) {
+                m_misses.fetch_add(1, std::memory_order_relaxed);
+                return {};
+            }
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            it->second.last_use.store(get_now().time_since_epoch().count(), std::memory_order_relaxed);
+            return ResourceHandle<T>(it->second.resource);
         }
 
+        /// Stores a resource under the given name, replacing any previous resource by the same name.
+        /// The size of the resource is determined by its `get_byte_size()` method, if it has one.
+        /// Inactive resources are evicted if the type or the manager are over budget afterwards, the new resource
+        /// itself is only evicted by later calls, once it has become inactive.
+        /// @param name     Name of the resource.
+        /// @param resource Resource to store.
+        /// @returns        Handle to the stored resource.
         ResourceHandle<T> set(const std::string& name, std::shared_ptr<T> resource) {
-            NOTF_GUARD(std::lock_guard(m_manager.m_mutex));
+            const size_t byte_size = resource ? detail::ResourceByteSize<T>::get(*resource) : 0;
+            const timepoint_t::rep now = get_now().time_since_epoch().count();
 
-            auto it = m_resources.find(name);
+            ResourceHandle<T> result;
+            std::vector<std::shared_ptr<T>> evicted; // destroyed after the lock is released
+            {
+                NOTF_GUARD(std::lock_guard(m_mutex));
+                auto [it, is_new] = m_resources.try_emplace(name);
+                _Entry& entry = it->second;
+                if (is_new) {
+                    // create a new resource entry
+                    entry.name = &it->first;
+                    m_lru.push_front(&entry);
+                    entry.position = m_lru.begin();
+                } else {
+                    // update the existing entry and mark it as the most recently used
+                    m_lru.splice(m_lru.begin(), m_lru, entry.position);
+                    _remove_bytes(entry.byte_size);
+                    evicted.emplace_back(std::move(entry.resource));
+                }
+                entry.resource = std::move(resource);
+                entry.byte_size = byte_size;
+                entry.last_use = now;
+                entry.last_promotion = now;
+                _add_bytes(byte_size);
+
+                // the returned handle keeps the new resource active while the budget is enforced
+                result = ResourceHandle<T>(entry.resource);
+                _evict_over_budget(m_byte_budget, evicted);
+            }
+            m_manager._enforce_budget();
+            return result;
+        }
 
-            if (it == m_resources.end()) {
-                // create a new resource entry
-                bool success = false;
-                std::tie(it, success) = m_resources.emplace(name, std::move(resource));
-                NOTF_ASSERT(success);
-
-                m_cache.emplace_front(it);
-                _remove_inactive(m_cache_limit);
-                return ResourceHandle<T>(it->second);
+        /// Registers the function used to load resources of this type by name, replacing the previous one.
+        /// Requests that are already being loaded still use the previous loader.
+        /// @param loader   Loader function, can be empty to disable asynchronous loading.
+        void set_loader(Loader loader) {
+            AsyncLoader async_loader;
+            if (loader) {
+                async_loader = [loader = std::move(loader)](const std::string& name, Completion completion) {
+                    completion(loader(name), nullptr);
+                };
             }
+            set_async_loader(std::move(async_loader));
+        }
+
+        /// Registers the function used to start loading resources of this type by name, replacing the previous one.
+        /// Requests that are already being loaded still use the previous loader.
+        /// @param loader   Loader function, can be empty to disable asynchronous loading.
+        void set_async_loader(AsyncLoader loader) {
+            NOTF_GUARD(std::lock_guard(m_mutex));
+            m_loader = std::move(loader);
+        }
+
+        /// Requests a resource by name, loading it in the background if it is not cached.
+        /// Concurrent requests for the same resource share a single load.
+        /// @param name             Name of the resource.
+        /// Loaders may depend on other threads. Textures, for example, resolve only after the render thread uploaded
+        /// them, so calling `get_async(...).get()` on the render thread deadlocks. Poll the future there instead.
+        /// @returns                Future resolving to the resource. Cached resources resolve immediately, exceptions
+        ///                         thrown by the loader or passed to its Completion are rethrown from the future.
+        /// @throws ResourceError   If the resource is not cached and there is no loader for this type.
+        Future get_async(const std::string& name) {
+            if (ResourceHandle<T> handle = get(name); handle.is_valid()) {
+                return _make_ready_future(std::move(handle));
+            }
+
+            auto promise = std::make_shared<std::promise<ResourceHandle<T>>>();
+            Future result = promise->get_future().share();
+            AsyncLoader loader;
+            {
+                NOTF_GUARD(std::lock_guard(m_mutex));
 
-            else {
-                // remove the existing entry from the list of most recently loaded
-                bool success = false;
-                for (auto prev = m_cache.before_begin(), cache_it = m_cache.begin(), end = m_cache.end();
-                     cache_it != end; prev = ++cache_it) {
-                    if (*cache_it == it) {
-                        m_cache.erase_after(prev);
-                        success = true;
-                        break;
+                // the resource may have been loaded or requested since the lookup
+                if (auto it = m_resources.find(name); it != m_resources.end()) {
+                    it->second.last_use.store(get_now().time_since_epoch().count(), std::memory_order_relaxed);
+                    return _make_ready_future(ResourceHandle<T>(it->second.resource));
+                }
+                if (auto it = m_requests.find(name); it != m_requests.end()) { return it->second; }
+
+                if (!m_loader) {
+                    NOTF_THROW(ResourceError, "Cannot load \"{}\", there is no loader for resources of type \"{}\"",
+                               name, m_name);
+                }
+                loader = m_loader;
+                m_requests.emplace(name, result);
+            }
+
+            // the request is finished by whichever thread completes it
+            Completion completion = [this, name, promise = std::move(promise)](std::shared_ptr<T> resource,
+                                                                               std::exception_ptr exception) {
+                try {
+                    if (exception) { std::rethrow_exception(exception); }
+                    if (!resource) {
+                        NOTF_THROW(ResourceError, "Failed to load \"{}\" of type \"{}\"", name, m_name);
                     }
+                    ResourceHandle<T> handle = set(name, std::move(resource));
+                    _finish_request(name);
+                    promise->set_value(std::move(handle));
+                }
+                catch (...) {
+                    _finish_request(name);
+                    promise->set_exception(std::current_exception());
+                }
+            };
+            m_manager._enqueue([name, completion = std::move(completion), loader = std::move(loader)] {
+                try {
+                    loader(name, completion);
                 }
-                NOTF_ASSERT(success);
+                catch (...) {
+                    completion(nullptr, std::current_exception());
+                }
+            });
+            return result;
+        }
 
-                // update the existing entry
-                it->second = std::move(resource);
-                m_cache.emplace_front(it);
-                return ResourceHandle<T>(it->second);
+        /// Starts loading resources in the background that are about to be used, for example by the next screen.
+        /// Resources that are already cached or requested are skipped.
+        /// Prefetched resources that are not used by the time they are loaded are inactive and subject to eviction,
+        /// make sure that the byte budget is large enough to hold them.
+        /// @param names            Names of the resources to load.
+        /// @throws ResourceError   If a resource is not cached and there is no loader for this type.
+        void prefetch(const std::vector<std::string>& names) {
+            for (const std::string& name : names) {
+                get_async(name);
             }
         }
 
-        /// Removes all inactive resources, ignoring this type's cache limit.
-        void remove_all_inactive() {
-            NOTF_GUARD(std::lock_guard(m_manager.m_mutex));
-            _remove_inactive(0);
+        /// Number of resources of this type that are currently being loaded.
+        size_t get_request_count() const {
+            NOTF_GUARD(std::shared_lock(m_mutex));
+            return m_requests.size();
+        }
+
+        /// Removes all inactive resources, ignoring this type's byte budget.
+        void remove_all_inactive() final {
+            std::vector<std::shared_ptr<T>> evicted;
+            NOTF_GUARD(std::lock_guard(m_mutex));
+            for (auto it = m_lru.begin(); it != m_lru.end();) {
+                _Entry* entry = *(it++);
+                if (entry->resource.use_count() <= 1) { _evict(entry, evicted); }
+            }
         }
 
     private:
-        /// Removes inactive resources.
-        /// @param cache_limit  How many of the most recently loaded inactive resources to retain.
-        void _remove_inactive(const size_t cache_limit) final {
-            NOTF_ASSERT(m_manager.m_mutex.is_locked_by_this_thread());
-            size_t inactive_count = 0;
-            for (auto prev = m_cache.before_begin(), it = m_cache.begin(), end = m_cache.end();; prev = ++it) {
-                while (it != end && (**it).second.unique() && ++inactive_count > cache_limit) {
-                    m_resources.erase(*it);
-                    it = m_cache.erase_after(prev);
-                }
-                if (it == end) { break; }
+        /// Future that is already resolved to the given resource.
+        static Future _make_ready_future(ResourceHandle<T> handle) {
+            std::promise<ResourceHandle<T>> promise;
+            promise.set_value(std::move(handle));
+            return promise.get_future().share();
+        }
+
+        /// Removes a finished request, so that failed requests can be retried.
+        /// @param name     Name of the requested resource.
+        void _finish_request(const std::string& name) {
+            NOTF_GUARD(std::lock_guard(m_mutex));
+            m_requests.erase(name);
+        }
+
+        /// Removes inactive resources until the type is within the given byte budget.
+        /// @param byte_budget  Maximum number of bytes of all resources of this type.
+        void _enforce_budget(const size_t byte_budget) final {
+            std::vector<std::shared_ptr<T>> evicted;
+            NOTF_GUARD(std::lock_guard(m_mutex));
+            _evict_over_budget(byte_budget, evicted);
+        }
+
+        /// Time of the last use of the least recently used inactive resource.
+        timepoint_t _get_least_recent_use() final {
+            NOTF_GUARD(std::lock_guard(m_mutex));
+            if (const _Entry* entry = _find_least_recently_used()) {
+                return timepoint_t(duration_t(entry->last_use.load(std::memory_order_relaxed)));
             }
+            return timepoint_t::max();
+        }
+
+        /// Removes the least recently used inactive resource.
+        bool _evict_least_recently_used() final {
+            std::vector<std::shared_ptr<T>> evicted;
+            NOTF_GUARD(std::lock_guard(m_mutex));
+            if (_Entry* entry = _find_least_recently_used()) {
+                _evict(entry, evicted);
+                return true;
+            }
+            return false;
         }
 
         /// Removes all resources, inactive or not.
         void _clear() final {
-            NOTF_ASSERT(m_manager.m_mutex.is_locked_by_this_thread());
-            m_cache.clear();
-            m_resources.clear();
+            ResourceMap resources;
+            NOTF_GUARD(std::lock_guard(m_mutex));
+            _remove_bytes(m_byte_count);
+            m_lru.clear();
+            m_resources.swap(resources);
+        }
+
+        /// Finds the least recently used inactive resource at the back of the LRU list.
+        /// Entries at the back that were used since their last promotion, or that are still active, are moved to the
+        /// front on the way, so that repeated calls take amortized constant time.
+        /// Looks at every entry at most twice, because all of them might have been used since their last promotion.
+        /// @returns    The least recently used inactive entry, or nullptr if all resources are active.
+        _Entry* _find_least_recently_used() {
+            for (size_t i = 0, end = m_lru.size() * 2; i < end; ++i) {
+                _Entry* entry = m_lru.back();
+                const timepoint_t::rep last_use = entry->last_use.load(std::memory_order_relaxed);
+                if (last_use == entry->last_promotion && entry->resource.use_count() <= 1) { return entry; }
+                entry->last_promotion = last_use;
+                m_lru.splice(m_lru.begin(), m_lru, entry->position);
+            }
+            return nullptr;
+        }
+
+        /// Evicts inactive resources in least recently used order, until the type is within the given byte budget.
+        /// @param byte_budget  Maximum number of bytes of all resources of this type.
+        /// @param evicted      [out] Evicted resources, to be destroyed once the lock is released.
+        void _evict_over_budget(const size_t byte_budget, std::vector<std::shared_ptr<T>>& evicted) {
+            while (m_byte_count > byte_budget) {
+                _Entry* entry = _find_least_recently_used();
+                if (!entry) { break; }
+                _evict(entry, evicted);
+            }
+        }
+
+        /// Removes a single entry.
+        /// @param entry    Entry to remove.
+        /// @param evicted  [out] Evicted resources, to be destroyed once the lock is released.
+        void _evict(_Entry* entry, std::vector<std::shared_ptr<T>>& evicted) {
+            evicted.emplace_back(std::move(entry->resource));
+            _remove_bytes(entry->byte_size);
+            ++m_eviction_count;
+            m_lru.erase(entry->position);
+            m_resources.erase(m_resources.find(*entry->name));
+        }
+
+        /// Adds bytes to the size of this type and the manager.
+        void _add_bytes(const size_t byte_count) {
+            m_byte_count += byte_count;
+            m_manager.m_byte_count += byte_count;
+        }
+
+        /// Removes bytes from the size of this type and the manager.
+        void _remove_bytes(const size_t byte_count) {
+            m_byte_count -= byte_count;
+            m_manager.m_byte_count -= byte_count;
         }
 
         // fields ------------------------------------------------------------------------------ //
@@ -269,19 +592,46 @@ public:
         /// Always ends in a forward slash, if not empty.
         std::string m_path;
 
+        /// Mutex protecting the resources of this type, lookups only require a shared lock.
+        mutable std::shared_mutex m_mutex;
+
         /// Resources by filename.
         ResourceMap m_resources;
 
-        /// List of most recently loaded resources (newer resources are earlier in the list).
-        std::forward_list<typename ResourceMap::iterator> m_cache;
+        /// Resource entries from the most to the least recently used (modulo lookups since the last promotion).
+        std::list<_Entry*> m_lru;
+
+        /// Sum of the sizes of all resources of this type in bytes.
+        size_t m_byte_count = 0;
+
+        /// Number of evicted resources.
+        size_t m_eviction_count = 0;
+
+        /// Number of successful lookups.
+        mutable std::atomic<size_t> m_hits = 0;
+
+        /// Number of failed lookups.
+        mutable std::atomic<size_t> m_misses = 0;
+
+        /// Function loading resources of this type by name.
+        AsyncLoader m_loader;
+
+        /// Futures of all resources that are currently being loaded, by name.
+        std::unordered_map<std::string, Future> m_requests;
     };
 
     // methods --------------------------------------------------------------------------------- //
 private:
     /// Constructor.
-    ResourceManager() = default;
+    ResourceManager();
 
 public:
+    NOTF_NO_COPY_OR_ASSIGN(ResourceManager);
+
+    /// Destructor.
+    /// Waits until all requested resources have finished loading.
+    ~ResourceManager();
+
     /// Returns the global ResourceManager.
     static ResourceManager& get_instance() {
         static ResourceManager instance;
@@ -312,14 +662,38 @@ public:
     /// @throws path_error  If `base_path` is not a directory.
     void set_base_path(const std::string& base_path) { m_base_path = _ensure_is_dir(base_path); }
 
-    /// Deletes all inactive resources.
+    /// Maximum number of bytes of all resources of all types.
+    size_t get_byte_budget() const { return m_byte_budget; }
+
+    /// Updates the global byte budget, which applies in addition to the budgets of the individual types.
+    /// @param byte_budget  Maximum number of bytes of all resources of all types, inactive resources are evicted in
+    ///                     least recently used order (across all types) until the manager is within its budget.
+    void set_byte_budget(const size_t byte_budget) {
+        m_byte_budget = byte_budget;
+        _enforce_budget();
+    }
+
+    /// Statistics of all Resource types combined.
+    ResourceStats get_stats() const;
+
+    /// Deletes all inactive resources that do not fit into the byte budgets.
     void cleanup();
 
+    /// Deletes all inactive resources of all types, ignoring the byte budgets.
+    void remove_all_inactive();
+
     /// Releases ownership of all managed resources.
     /// If a resource is not currently in use by another object owning a shared pointer to it, it is deleted.
     void clear();
 
 private:
+    /// Evicts the least recently used inactive resources of all types until the manager is within its byte budget.
+    void _enforce_budget();
+
+    /// Runs a task on one of the worker threads, which are created on first use.
+    /// @param task     Task to run.
+    void _enqueue(std::function<void()> task);
+
     /// Checks if a given string identifies a directory.
     /// @param path         String potentially identifying a directory.
     /// @returns            String identifying an absolute, normalized directory.
@@ -337,11 +711,21 @@ private:
     /// Absolute path to the root directory of all managed resource files.
     std::string m_base_path;
 
-    /// Mutex protecting the ResourceManager and the ResourceTypes.
+    /// Mutex protecting the ResourceManager and the paths of the ResourceTypes.
+    /// When locked together with the mutex of a ResourceType, this one has to be locked first.
     mutable Mutex m_mutex;
 
     /// All ResourceTypes by their ID.
     mutable std::map<size_t, std::unique_ptr<ResourceTypeBase>> m_types;
+
+    /// Maximum number of bytes of all resources of all types (unlimited by default).
+    std::atomic<size_t> m_byte_budget = max_v<size_t>;
+
+    /// Sum of the sizes of all resources of all types in bytes.
+    std::atomic<size_t> m_byte_count = 0;
+
+    /// Worker threads running the loaders of all types.
+    std::unique_ptr<ThreadPool> m_workers;
 };
 
 NOTF_CLOSE_NAMESPACE
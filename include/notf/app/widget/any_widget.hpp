@@ -7,6 +7,7 @@
 
 #include "notf/app/graph/node.hpp"
 
+#include "notf/app/widget/hit_grid.hpp"
 #include "notf/app/widget/layout.hpp"
 
 NOTF_OPEN_NAMESPACE
@@ -61,12 +62,18 @@ struct WidgetPolicy {
 } // namespace widget_policy
 } // namespace detail
 
+// widget hit grid ================================================================================================= //
+
+/// Hit grid containing the bounding rects of all Widgets in a WidgetScene in window space.
+using WidgetHitGrid = HitGrid<std::weak_ptr<AnyNode>>;
+
 // any widget ======================================================================================================= //
 
 class AnyWidget : public Node<detail::widget_policy::WidgetPolicy> {
 
     friend WidgetHandle;
     friend Accessor<AnyWidget, AnyLayout>;
+    friend Accessor<AnyWidget, WidgetScene>;
 
     // types ----------------------------------------------------------------------------------- //
 private:
@@ -77,6 +84,9 @@ public:
     /// Nested `AccessFor<T>` type.
     NOTF_ACCESS_TYPE(AnyWidget);
 
+    /// Widgets are only allowed to parent other Widgets.
+    using allowed_child_types = std::tuple<AnyWidget>;
+
     /// Error thrown when a requested State transition is impossible.
     NOTF_EXCEPTION_TYPE(BadTransitionError);
 
@@ -116,13 +126,28 @@ public:
     // layout -----------------------------------------------------------------
 public:
     /// Widget's transformation in parent space.
-    M3f get_xform() const { return get<offset_xform>() * m_layout_xform; }
+    M3f get_xform() const {
+        if (!this_thread::is_the_ui_thread()) {
+            return get<offset_xform>() * m_layout_xform; // the renderer always sees the unmodified offset
+        }
+        return m_xform;
+    }
 
     /// Widget's transformation in window space.
     M3f get_window_xform() const {
-        M3f result = M3f::identity();
-        _get_window_xform(result);
-        return result;
+        if (!this_thread::is_the_ui_thread()) {
+            M3f result = M3f::identity();
+            _get_window_xform(result);
+            return result;
+        }
+        return _get_cached_window_xform();
+    }
+
+    /// Inverse of the Widget's transformation in window space.
+    /// Transforms from window space into the local space of this Widget.
+    M3f get_window_xform_inverse() const {
+        if (!this_thread::is_the_ui_thread()) { return get_window_xform().get_inverse(); }
+        return _get_cached_window_xform_inverse();
     }
 
     /// Calculates a transformation from this to another Widget.
@@ -204,30 +229,115 @@ protected:
     }
 
     /// Let subclasses update their Claim whenever they feel like it.
-    /// Every change will cause a chain of updates to propagate up and down the Widget hierarchy. If you can, try to
-    /// limit the number of times this function is called each frame.
+    /// Every change schedules a relayout of the Widget hierarchy, which is performed once before the next frame is
+    /// drawn, no matter how often this function is called in between.
     void _set_claim(WidgetClaim claim);
 
     /// Sets the space a Widget is "granted" in the Layout of its parent Widget.
     /// @param grant    New Grant.
     void _set_grant(Size2f grant);
 
+    /// Called during a layout pass, right before the children of this Widget are laid out.
+    /// Subclasses can override this method to add or update child Widgets, for example depending on their new grant.
+    /// Children that are added or changed in here are laid out right afterwards, without scheduling another relayout.
+    virtual void _prepare_layout() {}
+
+    /// Child Widget by index in draw order.
+    /// @param index    Index of the child Widget, must be smaller than `get_child_count()`.
+    AnyWidget& _get_child_widget(size_t index);
+
     /// Produces a list of Claims of each child widget in draw order.
-    std::pair<std::vector<AnyWidget*>, std::vector<const WidgetClaim*>> _get_claim_list();
+    /// The list is stored in the Widget and re-used, so the reference is only valid until the next call.
+    const std::vector<const WidgetClaim*>& _get_claim_list();
 
 private:
+    /// Schedules a layout update as soon as the Widget has been added to the hierarchy.
+    /// Is final, so that subclasses are free to override `_finalize` without having to call the base implementation.
+    void _on_finalized() final;
+
+    /// Invalidates the cached window transformation and schedules a layout update of the old and the new parent.
+    /// @param old_parent   Previous parent of this Widget.
+    void _on_parent_changed(AnyNode* old_parent) final;
+
+    /// Finds the WidgetScene containing this Widget and updates the cached depth of this Widget in the hierarchy.
+    /// @returns    The WidgetScene containing this Widget or nullptr if there is none.
+    WidgetScene* _find_scene();
+
+    /// Schedules a re-calculation of the implicit Claim of this Widget in the next layout pass.
+    void _request_claim_update();
+
+    /// Schedules a re-layout of the children of this Widget in the next layout pass.
+    void _request_relayout();
+
     /// Changing the Claim or the visiblity of a Widget causes a relayout further up the hierarchy.
     void _relayout_upwards();
 
-    /// Updates the size and transformations of this and all child Widgets.
-    void _relayout_downwards();
+    /// Re-calculates the implicit Claim of this Widget during a layout pass and schedules a relayout of its children.
+    /// @param scene    WidgetScene performing the layout pass.
+    void _update_claim(WidgetScene& scene);
+
+    /// Re-calculates the implicit Claim of this Widget, unless it is explicit.
+    /// If the Claim changed, the parent Widget is scheduled for a Claim update as well.
+    /// @param scene    WidgetScene performing the layout pass.
+    void _update_implicit_claim(WidgetScene& scene);
+
+    /// Updates the size and transformations of all child Widgets during a layout pass.
+    /// Children whose grant changed are scheduled for a relayout themselves.
+    /// @param scene    WidgetScene performing the layout pass.
+    void _relayout_downwards(WidgetScene& scene);
+
+    /// Updates the bounding rect of this Widget during a layout pass.
+    /// If the bounding rect changed, the parent Widget is scheduled for an update as well.
+    /// @param scene    WidgetScene performing the layout pass.
+    void _update_aabr(WidgetScene& scene);
+
+    /// Moving a Widget changes its bounding rect in window space and the bounding rect of its parent.
+    void _on_offset_changed();
+
+    /// Updates the entries of this Widget and all of its descendants in the hit grid of its WidgetScene.
+    /// Invisible Widgets are removed from the grid, together with all of their descendants.
+    /// @param grid     Hit grid to update.
+    void _update_hit_grid(WidgetHitGrid& grid);
+
+    /// Removes this Widget and all of its descendants from the hit grid.
+    /// @param grid     Hit grid to update.
+    void _remove_from_hit_grid(WidgetHitGrid& grid);
+
+    /// Removes this Widget and all of its descendants from the WidgetScene that they were moved out of.
+    /// Their entries in the hit grid of the old Scene are removed and the layout steps they are scheduled for in the
+    /// old Scene are dropped, so that they can be scheduled in the new one.
+    /// @param grid     Hit grid of the old WidgetScene.
+    void _leave_scene(WidgetHitGrid& grid);
+
+    /// Index of this Widget in the list of children of its parent.
+    size_t _get_sibling_index() const;
+
+    /// Checks whether this Widget is drawn in front of another one in the same WidgetScene.
+    /// Widgets are drawn in front of their ancestors and in front of the siblings that come before them.
+    /// @param other    Other Widget.
+    bool _is_in_front_of(const AnyWidget& other) const;
 
     /// Updates (if necessary) and returns the Design of this Widget.
     const PlotterDesign& _get_design();
 
     /// Calculates the transformation of this Widget relative to its Window.
+    /// Is used by the renderer, which cannot use the cached transformation.
     void _get_window_xform(M3f& result) const;
 
+    /// Transformation of this Widget relative to its Window, only updated when the Widget or one of its ancestors
+    /// moved since the last call.
+    const M3f& _get_cached_window_xform() const;
+
+    /// Inverse of the cached transformation of this Widget relative to its Window.
+    const M3f& _get_cached_window_xform_inverse() const;
+
+    /// Updates the cached transformation in parent space after the offset or the layout transformation changed.
+    void _update_xform();
+
+    /// Marks the cached window transformation of this Widget and all of its descendants as dirty.
+    /// If the transformation is already dirty, so are the transformations of all descendants.
+    void _invalidate_window_xform();
+
     // fields ---------------------------------------------------------------------------------- //
 private:
     /// Is true, if the Claim of this Widget is determined by the Widget itself.
@@ -249,6 +359,31 @@ private:
     /// 2D transformation of this Widget as determined by its parent Layout.
     M3f m_layout_xform = M3f::identity();
 
+    /// Combined offset- and layout transformation of this Widget, as seen by the UI thread.
+    M3f m_xform = M3f::identity();
+
+    /// Cached transformation of this Widget relative to its Window.
+    mutable M3f m_window_xform = M3f::identity();
+
+    /// Cached inverse of the transformation of this Widget relative to its Window.
+    mutable M3f m_window_xform_inverse = M3f::identity();
+
+    /// Whether the cached window transformation needs to be re-calculated.
+    mutable bool m_is_window_xform_dirty = true;
+
+    /// Whether the cached inverse window transformation needs to be re-calculated.
+    mutable bool m_is_window_xform_inverse_dirty = true;
+
+    /// All child Widgets in draw order, as collected by the last call to `_get_claim_list`.
+    /// The vectors are kept around between relayouts so they don't need to be re-allocated every time.
+    std::vector<AnyWidget*> m_child_widgets;
+
+    /// Claims of all child Widgets, in the same order as `m_child_widgets`.
+    std::vector<const WidgetClaim*> m_child_claims;
+
+    /// Placements of all child Widgets, in the same order as `m_child_widgets`.
+    std::vector<AnyLayout::Placement> m_child_placements;
+
     /// The union bounding rect of this and all descendant Widgets.
     /// We keep this value around because it is only updated whenever the widget's layout changes but is (probably?)
     /// read more often than that.
@@ -259,6 +394,24 @@ private:
 
     /// Design of this Widget.
     PlotterDesign m_design;
+
+    /// Depth of this Widget in the hierarchy, the root Widget has a depth of zero.
+    size_t m_layout_depth = 0;
+
+    /// Layout steps (see `WidgetScene::LayoutStep`) that this Widget is scheduled for in the next layout pass.
+    uchar m_scheduled_layout_steps = 0;
+
+    /// Is true while the Widget adds or updates its children in `_prepare_layout`.
+    bool m_is_preparing_layout = false;
+
+    /// Whether a child requested a Claim update of this Widget while it was preparing its layout.
+    bool m_is_claim_outdated = false;
+
+    /// Handle of this Widget in the hit grid of its WidgetScene.
+    WidgetHitGrid::Handle m_hit_handle = WidgetHitGrid::invalid_handle;
+
+    /// Cached index of this Widget in the list of children of its parent, is validated before use.
+    mutable size_t m_sibling_index = 0;
 };
 
 // any widget accessors ============================================================================================= //
@@ -268,7 +421,32 @@ class Accessor<AnyWidget, AnyLayout> {
     friend AnyLayout;
 
     /// Forces a re-layout of the Widget even if its grant did not change.
-    static void relayout(AnyWidget& widget) { widget._relayout_downwards(); }
+    static void relayout(AnyWidget& widget) { widget._request_claim_update(); }
+};
+
+template<>
+class Accessor<AnyWidget, WidgetScene> {
+    friend WidgetScene;
+
+    /// Layout steps that the Widget is scheduled for in the next layout pass.
+    static uchar& get_scheduled_layout_steps(AnyWidget& widget) { return widget.m_scheduled_layout_steps; }
+
+    /// Re-calculates the implicit Claim of the Widget.
+    static void update_claim(AnyWidget& widget, WidgetScene& scene) { widget._update_claim(scene); }
+
+    /// Updates the size and transformations of all child Widgets.
+    static void relayout(AnyWidget& widget, WidgetScene& scene) { widget._relayout_downwards(scene); }
+
+    /// Updates the bounding rect of the Widget.
+    static void update_aabr(AnyWidget& widget, WidgetScene& scene) { widget._update_aabr(scene); }
+
+    /// Updates the entries of the Widget and all of its descendants in the hit grid.
+    static void update_hit_grid(AnyWidget& widget, WidgetHitGrid& grid) { widget._update_hit_grid(grid); }
+
+    /// Checks whether a Widget is drawn in front of another one in the same WidgetScene.
+    static bool is_in_front_of(const AnyWidget& widget, const AnyWidget& other) {
+        return widget._is_in_front_of(other);
+    }
 };
 
 // widget handle ==================================================================================================== //
@@ -283,6 +461,7 @@ struct NodeHandleInterface<AnyWidget> : public NodeHandleBaseInterface<AnyWidget
     using AnyWidget::get_aabr;
     using AnyWidget::get_clipping_rect;
     using AnyWidget::get_window_xform;
+    using AnyWidget::get_window_xform_inverse;
     using AnyWidget::get_xform;
     using AnyWidget::get_xform_to;
 
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "notf/meta/assert.hpp"
+#include "notf/meta/numeric.hpp"
+
+#include "notf/common/geo/aabr.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// hit grid ========================================================================================================= //
+
+/// Whether a value in a HitGrid is stale, meaning that its entry can be removed by the grid without being asked to.
+/// By default, values never go stale. Specialize this template for value types that can expire on their own.
+template<class T>
+struct hit_grid_is_stale {
+    constexpr bool operator()(const T&) const noexcept { return false; }
+};
+
+/// Weak pointers go stale once the object that they point to has been destroyed.
+template<class T>
+struct hit_grid_is_stale<std::weak_ptr<T>> {
+    bool operator()(const std::weak_ptr<T>& value) const noexcept { return value.expired(); }
+};
+
+/// Uniform grid of axis-aligned bounding rects, used to find all entries at a given point or within a given rect
+/// without having to test every single entry.
+///
+/// Each entry is stored in every cell that its rect overlaps. Entries that would cover more than a few cells (like the
+/// root Widget of a Scene) are stored in a separate list instead, that is tested on every query. Rects outside the
+/// bounds of the grid are clamped to the border cells, so every rect can be stored, no matter where it is.
+/// Inserting, updating and removing an entry only touches the cells that it overlaps.
+///
+/// Entries whose value has gone stale (see `hit_grid_is_stale`) are purged from all cells that are touched by an insert
+/// or a move, and from the whole grid when it is re-distributed. Stale entries that are never touched might still be
+/// returned by a query, so callers should check the values that they get back.
+///
+/// Queries do not order their results, that is up to the caller.
+/// Rect queries use internal scratch buffers and are therefore not thread-safe, even though they are const.
+template<class T>
+class HitGrid {
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Identifies an entry in the grid.
+    using Handle = uint;
+
+    /// Invalid Handle, returned for entries that are not in the grid.
+    static constexpr Handle invalid_handle = max_v<Handle>;
+
+    /// Entries covering more than this many cells are stored in a separate list.
+    static constexpr size_t max_cells_per_entry = 16;
+
+private:
+    /// An entry in the grid.
+    struct Entry {
+        /// Bounding rect of the entry.
+        Aabrf aabr;
+
+        /// Value of the entry.
+        T value;
+
+        /// Range of cells that the entry is stored in (inclusive), `first_column` is `invalid_handle` if the entry is
+        /// stored in the list of large entries.
+        uint first_column;
+        uint first_row;
+        uint last_column;
+        uint last_row;
+
+        /// Is false if the entry has been removed and its slot is free.
+        bool is_used;
+    };
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    /// Default Constructor, constructs an empty grid with a single cell.
+    HitGrid() { _resize(Aabrf::zero()); }
+
+    /// Value Constructor.
+    /// @param bounds       Area covered by the grid.
+    /// @param cell_size    Width and height of a single cell.
+    HitGrid(const Aabrf& bounds, const float cell_size) : m_cell_size(max(1, cell_size)) { _resize(bounds); }
+
+    /// Number of entries in the grid.
+    size_t get_size() const noexcept { return m_entries.size() - m_free_handles.size(); }
+
+    /// Area covered by the grid.
+    const Aabrf& get_bounds() const noexcept { return m_bounds; }
+
+    /// Changes the area covered by the grid, re-distributes all existing entries.
+    /// @param bounds   New area covered by the grid.
+    void set_bounds(const Aabrf& bounds) {
+        if (bounds == m_bounds) { return; }
+        _resize(bounds);
+        m_large_entries.clear();
+        for (Handle handle = 0; handle < m_entries.size(); ++handle) {
+            Entry& entry = m_entries[handle];
+            if (!entry.is_used) { continue; }
+            if (hit_grid_is_stale<T>{}(entry.value)) {
+                _free(handle);
+            } else {
+                _add_to_cells(handle);
+            }
+        }
+    }
+
+    /// Inserts a new entry into the grid.
+    /// @param aabr     Bounding rect of the entry.
+    /// @param value    Value of the entry.
+    /// @returns        Handle of the new entry.
+    Handle insert(const Aabrf& aabr, T value) {
+        Handle handle;
+        if (m_free_handles.empty()) {
+            handle = static_cast<Handle>(m_entries.size());
+            m_entries.emplace_back(Entry{aabr, std::move(value), 0, 0, 0, 0, true});
+            m_query_stamps.emplace_back(0);
+        } else {
+            handle = m_free_handles.back();
+            m_free_handles.pop_back();
+            m_entries[handle] = Entry{aabr, std::move(value), 0, 0, 0, 0, true};
+        }
+        _add_to_cells(handle);
+        _purge_stale(handle);
+        return handle;
+    }
+
+    /// Moves an existing entry in the grid.
+    /// @param handle   Handle of the entry to move.
+    /// @param aabr     New bounding rect of the entry.
+    void update(const Handle handle, const Aabrf& aabr) {
+        NOTF_ASSERT(handle < m_entries.size() && m_entries[handle].is_used);
+        Entry& entry = m_entries[handle];
+        if (aabr == entry.aabr) { return; }
+
+        // only touch the cells if the entry actually moved to different ones
+        uint first_column, first_row, last_column, last_row;
+        _get_cell_range(aabr, first_column, first_row, last_column, last_row);
+        const bool is_large = _is_large(first_column, first_row, last_column, last_row);
+        if ((is_large && entry.first_column == invalid_handle)
+            || (first_column == entry.first_column && first_row == entry.first_row
+                && last_column == entry.last_column && last_row == entry.last_row)) {
+            entry.aabr = aabr;
+            return;
+        }
+
+        // the cells that the entry leaves are purged as well
+        _collect_stale(handle);
+        _remove_from_cells(handle);
+        entry.aabr = aabr;
+        _add_to_cells(handle);
+        _purge_stale(handle);
+    }
+
+    /// Removes an entry from the grid.
+    /// @param handle   Handle of the entry to remove.
+    void remove(const Handle handle) {
+        NOTF_ASSERT(handle < m_entries.size() && m_entries[handle].is_used);
+        _remove_from_cells(handle);
+        _free(handle);
+    }
+
+    /// Removes all entries from the grid.
+    void clear() {
+        m_entries.clear();
+        m_free_handles.clear();
+        m_query_stamps.clear();
+        m_large_entries.clear();
+        m_stale_handles.clear();
+        for (std::vector<Handle>& cell : m_cells) {
+            cell.clear();
+        }
+    }
+
+    /// Value of an entry in the grid.
+    /// @param handle   Handle of the entry.
+    const T& get_value(const Handle handle) const {
+        NOTF_ASSERT(handle < m_entries.size() && m_entries[handle].is_used);
+        return m_entries[handle].value;
+    }
+
+    /// Finds all entries whose bounding rect contains the given point.
+    /// @param point    Point to test.
+    /// @param result   [OUT] Handles of all entries containing the point, in no particular order.
+    void query(const V2f& point, std::vector<Handle>& result) const {
+        result.clear();
+        const uint column = _get_column(point.x());
+        const uint row = _get_row(point.y());
+        for (const Handle handle : m_cells[row * m_column_count + column]) {
+            if (m_entries[handle].aabr.contains(point)) { result.emplace_back(handle); }
+        }
+        for (const Handle handle : m_large_entries) {
+            if (m_entries[handle].aabr.contains(point)) { result.emplace_back(handle); }
+        }
+    }
+
+    /// Finds all entries whose bounding rect intersects the given rect.
+    /// @param aabr     Rect to test.
+    /// @param result   [OUT] Handles of all entries intersecting the rect, in no particular order.
+    void query(const Aabrf& aabr, std::vector<Handle>& result) const {
+        result.clear();
+
+        // entries can be stored in multiple cells, stamp them to report each one only once
+        if (++m_query_stamp == 0) {
+            std::fill(m_query_stamps.begin(), m_query_stamps.end(), 0);
+            m_query_stamp = 1;
+        }
+
+        uint first_column, first_row, last_column, last_row;
+        _get_cell_range(aabr, first_column, first_row, last_column, last_row);
+        for (uint row = first_row; row <= last_row; ++row) {
+            for (uint column = first_column; column <= last_column; ++column) {
+                for (const Handle handle : m_cells[row * m_column_count + column]) {
+                    if (m_query_stamps[handle] == m_query_stamp) { continue; }
+                    m_query_stamps[handle] = m_query_stamp;
+                    if (m_entries[handle].aabr.intersects(aabr)) { result.emplace_back(handle); }
+                }
+            }
+        }
+        for (const Handle handle : m_large_entries) {
+            if (m_entries[handle].aabr.intersects(aabr)) { result.emplace_back(handle); }
+        }
+    }
+
+private:
+    /// Re-creates all cells to cover the given bounds.
+    void _resize(const Aabrf& bounds) {
+        m_bounds = bounds;
+        m_column_count = max(1, static_cast<uint>(std::ceil(bounds.get_width() / m_cell_size)));
+        m_row_count = max(1, static_cast<uint>(std::ceil(bounds.get_height() / m_cell_size)));
+        m_cells.clear();
+        m_cells.resize(m_column_count * m_row_count);
+    }
+
+    /// Column of the cell containing the given x coordinate, clamped to the grid.
+    uint _get_column(const float x) const {
+        const float column = std::floor((x - m_bounds.get_left()) / m_cell_size);
+        return static_cast<uint>(clamp(column, 0, static_cast<float>(m_column_count - 1)));
+    }
+
+    /// Row of the cell containing the given y coordinate, clamped to the grid.
+    uint _get_row(const float y) const {
+        const float row = std::floor((y - m_bounds.get_bottom()) / m_cell_size);
+        return static_cast<uint>(clamp(row, 0, static_cast<float>(m_row_count - 1)));
+    }
+
+    /// Range of cells (inclusive) overlapped by the given rect.
+    void _get_cell_range(const Aabrf& aabr, uint& first_column, uint& first_row, uint& last_column,
+                         uint& last_row) const {
+        first_column = _get_column(aabr.get_left());
+        first_row = _get_row(aabr.get_bottom());
+        last_column = _get_column(aabr.get_right());
+        last_row = _get_row(aabr.get_top());
+    }
+
+    /// Whether an entry covering the given range of cells is stored in the list of large entries.
+    static bool _is_large(const uint first_column, const uint first_row, const uint last_column, const uint last_row) {
+        return (last_column - first_column + 1) * (last_row - first_row + 1) > max_cells_per_entry;
+    }
+
+    /// Adds an entry to all cells that it overlaps.
+    void _add_to_cells(const Handle handle) {
+        Entry& entry = m_entries[handle];
+        _get_cell_range(entry.aabr, entry.first_column, entry.first_row, entry.last_column, entry.last_row);
+        if (_is_large(entry.first_column, entry.first_row, entry.last_column, entry.last_row)) {
+            entry.first_column = invalid_handle;
+            m_large_entries.emplace_back(handle);
+            return;
+        }
+        for (uint row = entry.first_row; row <= entry.last_row; ++row) {
+            for (uint column = entry.first_column; column <= entry.last_column; ++column) {
+                m_cells[row * m_column_count + column].emplace_back(handle);
+            }
+        }
+    }
+
+    /// Removes an entry from all cells that it is stored in.
+    void _remove_from_cells(const Handle handle) {
+        const Entry& entry = m_entries[handle];
+        if (entry.first_column == invalid_handle) {
+            _remove_from(m_large_entries, handle);
+            return;
+        }
+        for (uint row = entry.first_row; row <= entry.last_row; ++row) {
+            for (uint column = entry.first_column; column <= entry.last_column; ++column) {
+                _remove_from(m_cells[row * m_column_count + column], handle);
+            }
+        }
+    }
+
+    /// Marks the slot of an entry that is no longer stored in any cell as free.
+    void _free(const Handle handle) {
+        m_entries[handle].is_used = false;
+        m_entries[handle].value = T{};
+        m_free_handles.emplace_back(handle);
+    }
+
+    /// Collects all stale entries that share a cell with the given entry.
+    /// @param handle   Entry whose cells to search, is never collected itself.
+    void _collect_stale(const Handle handle) {
+        const Entry& entry = m_entries[handle];
+        const hit_grid_is_stale<T> is_stale;
+        if (entry.first_column == invalid_handle) {
+            for (const Handle other : m_large_entries) {
+                if (other != handle && is_stale(m_entries[other].value)) { m_stale_handles.emplace_back(other); }
+            }
+            return;
+        }
+        for (uint row = entry.first_row; row <= entry.last_row; ++row) {
+            for (uint column = entry.first_column; column <= entry.last_column; ++column) {
+                for (const Handle other : m_cells[row * m_column_count + column]) {
+                    if (other != handle && is_stale(m_entries[other].value)) { m_stale_handles.emplace_back(other); }
+                }
+            }
+        }
+    }
+
+    /// Removes all stale entries that share a cell with the given entry, or that were collected before.
+    /// @param handle   Entry whose cells to purge, is never removed itself.
+    void _purge_stale(const Handle handle) {
+        _collect_stale(handle);
+        if (m_stale_handles.empty()) { return; }
+
+        // entries stored in multiple cells are collected multiple times
+        std::sort(m_stale_handles.begin(), m_stale_handles.end());
+        m_stale_handles.erase(std::unique(m_stale_handles.begin(), m_stale_handles.end()), m_stale_handles.end());
+        for (const Handle stale : m_stale_handles) {
+            remove(stale);
+        }
+        m_stale_handles.clear();
+    }
+
+    /// Removes a single handle from an unordered list of handles.
+    static void _remove_from(std::vector<Handle>& handles, const Handle handle) {
+        for (size_t i = 0; i < handles.size(); ++i) {
+            if (handles[i] == handle) {
+                handles[i] = handles.back();
+                handles.pop_back();
+                return;
+            }
+        }
+        NOTF_ASSERT(false);
+    }
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// All entries, indexed by their Handle.
+    std::vector<Entry> m_entries;
+
+    /// Handles of removed entries that can be re-used.
+    std::vector<Handle> m_free_handles;
+
+    /// Handles of all entries in each cell, row by row.
+    std::vector<std::vector<Handle>> m_cells;
+
+    /// Handles of all entries that cover too many cells to be stored in them.
+    std::vector<Handle> m_large_entries;
+
+    /// Scratch buffer for stale entries found while inserting or moving an entry.
+    std::vector<Handle> m_stale_handles;
+
+    /// Last query stamp of each entry, used to report each entry only once in rect queries.
+    mutable std::vector<uint> m_query_stamps;
+
+    /// Stamp of the current rect query.
+    mutable uint m_query_stamp = 0;
+
+    /// Area covered by the grid.
+    Aabrf m_bounds = Aabrf::zero();
+
+    /// Width and height of a single cell.
+    float m_cell_size = 64;
+
+    /// Number of cells in horizontal direction.
+    uint m_column_count = 1;
+
+    /// Number of cells in vertical direction.
+    uint m_row_count = 1;
+};
+
+NOTF_CLOSE_NAMESPACE
@@ -2,6 +2,7 @@
 
 #include <vector>
 
+#include "notf/common/geo/aabr.hpp"
 #include "notf/common/geo/alignment.hpp"
 #include "notf/common/geo/matrix3.hpp"
 #include "notf/common/geo/padding.hpp"
@@ -33,9 +34,14 @@ public:
 
     // methods --------------------------------------------------------------------------------- //
 public:
+    /// Default Constructor.
+    /// Creates a free-standing Layout that is not attached to a Widget. It can be used to calculate Placements
+    /// (for example in benchmarks), but will never cause a relayout.
+    AnyLayout() = default;
+
     /// Value Constructor.
     /// @param widget   Widget owning this Subscriber.
-    AnyLayout(AnyWidget& widget) : m_widget(widget) {}
+    AnyLayout(AnyWidget& widget) : m_widget(&widget) {}
 
     /// Destructor.
     virtual ~AnyLayout();
@@ -45,13 +51,18 @@ public:
 
     /// Calculates the combined Claim of all of the Widget's children as determined by this Layout.
     /// @param claims   Claims of all child widgets that need to be combined into a single Claim.
-    virtual WidgetClaim calculate_claim(const std::vector<const WidgetClaim*> claims) const = 0;
+    virtual WidgetClaim calculate_claim(const std::vector<const WidgetClaim*>& claims) const = 0;
 
     // TODO: replace the vector of pointers with a vector of valid_ptr?
 
-    /// @param grant    Size available for the Layout to place the child widgets.
-    /// @returns        The bounding rect of all descendants of this Widget.
-    virtual std::vector<Placement> update(const std::vector<const WidgetClaim*> claims, const Size2f& grant) const = 0;
+    /// Calculates the Placement of each child widget.
+    /// The output vector is resized to match the number of Claims, existing capacity is re-used so that a relayout
+    /// does not need to allocate any memory once the vector has grown large enough.
+    /// @param placements   [OUT] One Placement for each Claim, in the same order.
+    /// @param claims       Claims of all child widgets.
+    /// @param grant        Size available for the Layout to place the child widgets.
+    virtual void update(std::vector<Placement>& placements, const std::vector<const WidgetClaim*>& claims,
+                        const Size2f& grant) const = 0;
 
     /// Padding around the Layout's borders.
     const Paddingf& get_padding() const noexcept { return m_padding; }
@@ -68,12 +79,13 @@ public:
 
 protected:
     /// Lets the Widget know to relayout downwards because something about its layout changed.
+    /// Does nothing if this Layout is free-standing.
     void _relayout();
 
     // fields ---------------------------------------------------------------------------------- //
 protected:
-    /// Widget whose children are transformed using this Layout.
-    AnyWidget& m_widget;
+    /// Widget whose children are transformed using this Layout, is empty if the Layout is free-standing.
+    AnyWidget* m_widget = nullptr;
 
     /// Padding around the Layout's borders.
     Paddingf m_padding = Paddingf::none();
@@ -86,6 +98,9 @@ protected:
 class OverLayout : public AnyLayout {
 
 public:
+    /// Default Constructor, creates a free-standing OverLayout.
+    OverLayout() = default;
+
     /// Constructor.
     /// @param widget   Widget owning this Layout.
     OverLayout(AnyWidget& widget) : AnyLayout(widget) {}
@@ -95,11 +110,14 @@ public:
 
     /// The combined claim of an OverLayout is the maximum Claim of all of its children.
     /// @param claims   Claims of all child widgets that need to be combined into a single Claim.
-    WidgetClaim calculate_claim(const std::vector<const WidgetClaim*> claims) const final;
+    WidgetClaim calculate_claim(const std::vector<const WidgetClaim*>& claims) const final;
 
-    /// @param grant    Size available for the Layout to place the child widgets.
-    /// @returns        The bounding rect of all descendants of this Widget.
-    std::vector<Placement> update(const std::vector<const WidgetClaim*> claims, const Size2f& grant) const final;
+    /// Calculates the Placement of each child widget.
+    /// @param placements   [OUT] One Placement for each Claim, in the same order.
+    /// @param claims       Claims of all child widgets.
+    /// @param grant        Size available for the Layout to place the child widgets.
+    void update(std::vector<Placement>& placements, const std::vector<const WidgetClaim*>& claims,
+                const Size2f& grant) const final;
 
     /// Alignment of items in the Layout relative to the parent.
     const Alignment& get_alignment() const noexcept { return m_alignment; }
@@ -165,6 +183,9 @@ public:
 
     // methods --------------------------------------------------------------------------------- //
 public:
+    /// Default Constructor, creates a free-standing FlexLayout.
+    FlexLayout() = default;
+
     /// Constructor.
     /// @param widget   Widget owning this Layout.
     FlexLayout(AnyWidget& widget) : AnyLayout(widget) {}
@@ -174,11 +195,14 @@ public:
 
     /// The combined claim of an OverLayout is the maximum Claim of all of its children.
     /// @param claims   Claims of all child widgets that need to be combined into a single Claim.
-    WidgetClaim calculate_claim(const std::vector<const WidgetClaim*> claims) const final;
+    WidgetClaim calculate_claim(const std::vector<const WidgetClaim*>& claims) const final;
 
-    /// @param grant    Size available for the Layout to place the child widgets.
-    /// @returns        The bounding rect of all descendants of this Widget.
-    std::vector<Placement> update(const std::vector<const WidgetClaim*> claims, const Size2f& grant) const final;
+    /// Calculates the Placement of each child widget.
+    /// @param placements   [OUT] One Placement for each Claim, in the same order.
+    /// @param claims       Claims of all child widgets.
+    /// @param grant        Size available for the Layout to place the child widgets.
+    void update(std::vector<Placement>& placements, const std::vector<const WidgetClaim*>& claims,
+                const Size2f& grant) const final;
 
     /// Direction in which items are stacked.
     Direction get_direction() const { return m_direction; }
@@ -319,4 +343,186 @@ private:
     Alignment m_stack_alignment = Alignment::START;
 };
 
+// list layout ====================================================================================================== //
+
+/// The ListLayout arranges a (potentially very large) number of items in a vertical list, from top to bottom.
+///
+/// Unlike other Layouts, the ListLayout does not have a child widget for every item in the list. Instead, it only knows
+/// the number of items and an estimated Claim that is used for all of them. Only items that are visible in the current
+/// viewport are assigned to a "row", which is a child widget displaying the item. When the list is scrolled, rows whose
+/// items are no longer visible are recycled to display the items that became visible instead.
+/// This way, the memory and time required to lay out a list only depends on the number of visible items, not on the
+/// total number of items in the list.
+///
+/// Claim
+/// =====
+/// The horizontal Claim of a ListLayout is the horizontal part of the estimated row Claim. Its vertical Claim prefers
+/// the height of all items combined, but can be shrunk down to zero, since the list is expected to be scrolled.
+/// The Claims of the child widgets are ignored.
+class ListLayout : public AnyLayout {
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Item index of a row that is currently not assigned to any item.
+    static constexpr size_t no_item = max_v<size_t>;
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    /// Default Constructor, creates a free-standing ListLayout.
+    ListLayout() = default;
+
+    /// Constructor.
+    /// @param widget   Widget owning this Layout.
+    ListLayout(AnyWidget& widget) : AnyLayout(widget) {}
+
+    /// The name of this type of Layout.
+    std::string_view get_type_name() const final { return "ListLayout"; }
+
+    /// The Claim of a ListLayout is determined by the number of items and the estimated row Claim.
+    /// @param claims   Claims of all child widgets (ignored).
+    WidgetClaim calculate_claim(const std::vector<const WidgetClaim*>& claims) const final;
+
+    /// Calculates the Placement of each row.
+    /// Rows that are not assigned to an item are granted no space at all.
+    /// @param placements   [OUT] One Placement for each Claim, in the same order.
+    /// @param claims       Claims of all child widgets, one for each row.
+    /// @param grant        Size available for the Layout to place the child widgets.
+    void update(std::vector<Placement>& placements, const std::vector<const WidgetClaim*>& claims,
+                const Size2f& grant) const final;
+
+    /// Number of items in the list.
+    size_t get_item_count() const noexcept { return m_item_count; }
+
+    /// Defines the number of items in the list.
+    /// @param count    New item count.
+    /// @param relayout Whether or not to force a relayout of the Widget after this change. Set this to false if you
+    ///                 are changing more than one value and don't want to relayout multiple times.
+    void set_item_count(const size_t count, bool relayout = true) {
+        if (count == m_item_count) { return; }
+        m_item_count = count;
+        set_scroll_position(m_scroll_item, m_scroll_remainder, /* relayout = */ false); // clamp to the new count
+        if (relayout) { _relayout(); }
+    }
+
+    /// Estimated Claim of a single item in the list.
+    const WidgetClaim& get_row_claim() const noexcept { return m_row_claim; }
+
+    /// Defines the estimated Claim of a single item in the list.
+    /// All rows are as high as the preferred vertical size of this Claim.
+    /// @param claim    New row Claim.
+    /// @param relayout Whether or not to force a relayout of the Widget after this change. Set this to false if you
+    ///                 are changing more than one value and don't want to relayout multiple times.
+    void set_row_claim(WidgetClaim claim, bool relayout = true) {
+        if (claim == m_row_claim) { return; }
+        m_row_claim = std::move(claim);
+        if (relayout) { _relayout(); }
+    }
+
+    /// Additional spacing between items.
+    float get_spacing() const { return m_spacing; }
+
+    /// Defines additional spacing between items.
+    /// @param spacing  New spacing.
+    /// @param relayout Whether or not to force a relayout of the Widget after this change. Set this to false if you
+    ///                 are changing more than one value and don't want to relayout multiple times.
+    void set_spacing(float spacing, bool relayout = true) {
+        spacing = spacing < 0 ? 0 : spacing;
+        if (is_approx(spacing, m_spacing)) { return; }
+        m_spacing = spacing;
+        if (relayout) { _relayout(); }
+    }
+
+    /// Distance that the list is scrolled down from the top.
+    /// A float cannot represent every pixel of a list that is longer than 2^24 pixels, use `get_scroll_item` and
+    /// `get_scroll_remainder` for the exact scroll position.
+    float get_scroll_offset() const {
+        return static_cast<float>(static_cast<double>(m_scroll_item) * _get_pitch() + m_scroll_remainder);
+    }
+
+    /// Scrolls the list.
+    /// A float cannot represent every pixel of a list that is longer than 2^24 pixels, use `set_scroll_position` or
+    /// `scroll_by` to scroll those precisely.
+    /// @param offset   Distance from the top, is clamped to the height of all items.
+    /// @param relayout Whether or not to force a relayout of the Widget after this change. Set this to false if you
+    ///                 are changing more than one value and don't want to relayout multiple times.
+    void set_scroll_offset(float offset, bool relayout = true);
+
+    /// Index of the item that the list is scrolled to.
+    size_t get_scroll_item() const noexcept { return m_scroll_item; }
+
+    /// Distance that the list is scrolled down from the top of the scroll item, is always smaller than the distance
+    /// from one item to the next.
+    float get_scroll_remainder() const noexcept { return m_scroll_remainder; }
+
+    /// Scrolls the list to a distance from the top of the given item.
+    /// @param item     Index of the item to scroll to.
+    /// @param offset   Distance from the top of the item, can be negative or larger than a single item.
+    /// @param relayout Whether or not to force a relayout of the Widget after this change. Set this to false if you
+    ///                 are changing more than one value and don't want to relayout multiple times.
+    void set_scroll_position(size_t item, float offset = 0, bool relayout = true);
+
+    /// Scrolls the list relative to its current scroll position.
+    /// @param delta    Distance to scroll, positive values scroll down.
+    /// @param relayout Whether or not to force a relayout of the Widget after this change. Set this to false if you
+    ///                 are changing more than one value and don't want to relayout multiple times.
+    void scroll_by(const float delta, bool relayout = true) {
+        set_scroll_position(m_scroll_item, m_scroll_remainder + delta, relayout);
+    }
+
+    /// Height of all items in the list combined, including spacing.
+    float get_content_height() const {
+        if (m_item_count == 0) { return 0; }
+        return static_cast<float>(m_item_count) * _get_pitch() - m_spacing;
+    }
+
+    /// Range of items that intersect the given viewport.
+    /// @param grant    Size granted to the Layout.
+    /// @param viewport Visible area in the Layout's local space.
+    /// @returns        Index of the first visible item and one past the last visible item.
+    std::pair<size_t, size_t> get_visible_items(const Size2f& grant, const Aabrf& viewport) const;
+
+    /// Item displayed by each row, `no_item` if the row is unused.
+    const std::vector<size_t>& get_row_items() const noexcept { return m_row_items; }
+
+    /// Assigns all items visible in the given viewport to a row.
+    /// Rows that already display a visible item keep it, all others are recycled to display the newly visible items.
+    /// New rows are only added if there are not enough rows to display all visible items.
+    /// @param grant    Size granted to the Layout.
+    /// @param viewport Visible area in the Layout's local space.
+    /// @param changed  [OUT] Indices of all rows whose item changed and need to be updated.
+    void assign_rows(const Size2f& grant, const Aabrf& viewport, std::vector<size_t>& changed);
+
+private:
+    /// Distance from the top of one item to the top of the next one.
+    float _get_pitch() const { return m_row_claim.get_vertical().get_preferred() + m_spacing; }
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Estimated Claim of a single item in the list.
+    WidgetClaim m_row_claim;
+
+    /// Item displayed by each row, `no_item` if the row is unused.
+    std::vector<size_t> m_row_items;
+
+    /// Item displayed by each row before the last call to `assign_rows`.
+    std::vector<size_t> m_previous_row_items;
+
+    /// Whether each item in the visible range is already displayed by a row, only used in `assign_rows`.
+    std::vector<bool> m_is_item_displayed;
+
+    /// Number of items in the list.
+    size_t m_item_count = 0;
+
+    /// Additional spacing between items.
+    float m_spacing = 0;
+
+    /// Index of the item that the list is scrolled to.
+    /// Rows are placed relative to this item, so their positions are precise even if the list is millions of pixels
+    /// long.
+    size_t m_scroll_item = 0;
+
+    /// Distance that the list is scrolled down from the top of the scroll item.
+    float m_scroll_remainder = 0;
+};
+
 NOTF_CLOSE_NAMESPACE
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "notf/app/widget/widget.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// list widget ====================================================================================================== //
+
+/// Base class for Widgets displaying a (potentially very large) number of items in a vertical list.
+///
+/// A ListWidget does not create a child Widget for every item in the list, but only for those items that are visible.
+/// Child Widgets, called "rows", are created on demand through `_create_row` and are never removed. Instead, when the
+/// list is scrolled, rows whose items are no longer visible are re-used to display the newly visible items through
+/// `_bind_row`. Rows that are not needed to display an item are hidden.
+/// The number of rows is therefore determined by how many items fit into the visible area of the list, not by the
+/// total number of items.
+///
+/// Subclasses must not add any other children besides rows, or change the Layout of the Widget.
+template<class Policy>
+class ListWidget : public Widget<Policy> {
+
+    // methods --------------------------------------------------------------------------------- //
+protected:
+    /// Value constructor.
+    /// @param parent   Parent of this Node.
+    ListWidget(valid_ptr<AnyNode*> parent)
+        : Widget<Policy>(parent), m_list_layout(&this->template _set_layout<ListLayout>()) {}
+
+public:
+    /// Number of items in the list.
+    size_t get_item_count() const noexcept { return m_list_layout->get_item_count(); }
+
+    /// Defines the number of items in the list.
+    /// @param count    New item count.
+    void set_item_count(const size_t count) { m_list_layout->set_item_count(count); }
+
+    /// Estimated Claim of a single item in the list.
+    const WidgetClaim& get_row_claim() const noexcept { return m_list_layout->get_row_claim(); }
+
+    /// Defines the estimated Claim of a single item in the list.
+    /// All rows are as high as the preferred vertical size of this Claim.
+    /// @param claim    New row Claim.
+    void set_row_claim(WidgetClaim claim) { m_list_layout->set_row_claim(std::move(claim)); }
+
+    /// Distance that the list is scrolled down from the top.
+    /// Is only approximate for lists that are longer than 2^24 pixels (see `ListLayout::get_scroll_offset`).
+    float get_scroll_offset() const { return m_list_layout->get_scroll_offset(); }
+
+    /// Scrolls the list.
+    /// Is only approximate for lists that are longer than 2^24 pixels (see `ListLayout::set_scroll_offset`).
+    /// @param offset   Distance from the top, is clamped to the height of all items.
+    void set_scroll_offset(const float offset) { m_list_layout->set_scroll_offset(offset); }
+
+    /// Index of the item that the list is scrolled to.
+    size_t get_scroll_item() const noexcept { return m_list_layout->get_scroll_item(); }
+
+    /// Scrolls the list to a distance from the top of the given item.
+    /// @param item     Index of the item to scroll to.
+    /// @param offset   Distance from the top of the item, can be negative or larger than a single item.
+    void set_scroll_position(const size_t item, const float offset = 0) {
+        m_list_layout->set_scroll_position(item, offset);
+    }
+
+    /// Scrolls the list relative to its current scroll position.
+    /// @param delta    Distance to scroll, positive values scroll down.
+    void scroll_by(const float delta) { m_list_layout->scroll_by(delta); }
+
+protected:
+    /// Creates a new row as a child of this Widget.
+    /// Is called whenever there are not enough rows to display all visible items.
+    virtual void _create_row() = 0;
+
+    /// Updates a row to display the given item.
+    /// The row might have displayed another item before, so all of its item-dependent Properties must be updated.
+    /// @param row  Row to update.
+    /// @param item Index of the item to display.
+    virtual void _bind_row(AnyWidget& row, size_t item) = 0;
+
+private:
+    /// Assigns all visible items to a row before the rows are laid out.
+    void _prepare_layout() final {
+        // the visible area of the list is its grant, clipped by the clipping rect in local space
+        Aabrf viewport = transform_by(this->get_clipping_rect(), this->get_window_xform_inverse());
+        viewport.intersect(Aabrf(this->get_grant()));
+
+        m_list_layout->assign_rows(this->get_grant(), viewport, m_changed_rows);
+        const std::vector<size_t>& row_items = m_list_layout->get_row_items();
+
+        // create missing rows
+        for (size_t row_count = this->get_child_count(); row_count < row_items.size(); ++row_count) {
+            _create_row();
+            NOTF_ASSERT(this->get_child_count() == row_count + 1);
+        }
+
+        // bind recycled rows to their new items and hide unused ones
+        for (const size_t row_index : m_changed_rows) {
+            AnyWidget& row = this->_get_child_widget(row_index);
+            const size_t item = row_items[row_index];
+            if (item == ListLayout::no_item) {
+                if (row.get<AnyWidget::visibility>()) { row.set<AnyWidget::visibility>(false); }
+            } else {
+                if (!row.get<AnyWidget::visibility>()) { row.set<AnyWidget::visibility>(true); }
+                _bind_row(row, item);
+            }
+        }
+    }
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Layout of this Widget.
+    ListLayout* m_list_layout;
+
+    /// Indices of all rows whose item changed in the last layout pass.
+    std::vector<size_t> m_changed_rows;
+};
+
+NOTF_CLOSE_NAMESPACE
@@ -252,7 +252,7 @@ public:
         vertical.set_fixed(height);
         return {horizontal, vertical};
     }
-    static WidgetClaim fixed(const Size2f& size) { return fixed(size.width(), size.height()); }
+    static WidgetClaim fixed(const Size2f& size) { return fixed(size.get_width(), size.get_height()); }
     ///@}
 
     /// Returns a Claim with all limits set to zero.
@@ -285,7 +285,7 @@ public:
         m_horizontal.set_min(width);
         m_vertical.set_min(height);
     }
-    void set_min(const Size2f& size) { set_min(size.width(), size.height()); }
+    void set_min(const Size2f& size) { set_min(size.get_width(), size.get_height()); }
     ///@}
 
     ///@{
@@ -295,7 +295,7 @@ public:
         m_horizontal.set_preferred(width);
         m_vertical.set_preferred(height);
     }
-    void set_preferred(const Size2f& size) { set_preferred(size.width(), size.height()); }
+    void set_preferred(const Size2f& size) { set_preferred(size.get_width(), size.get_height()); }
     ///@}
 
     ///@{
@@ -305,7 +305,7 @@ public:
         m_horizontal.set_max(width);
         m_vertical.set_max(height);
     }
-    void set_max(const Size2f& size) { set_max(size.width(), size.height()); }
+    void set_max(const Size2f& size) { set_max(size.get_width(), size.get_height()); }
     ///@}
 
     /// Sets the the scale factor of both Stretches.
@@ -330,7 +330,7 @@ public:
         m_horizontal.set_fixed(width);
         m_vertical.set_fixed(height);
     }
-    void set_fixed(const Size2f& size) { set_fixed(size.width(), size.height()); }
+    void set_fixed(const Size2f& size) { set_fixed(size.get_width(), size.get_height()); }
     ///@}
 
     /// Adds a positive offset to the min, max and preferred value.
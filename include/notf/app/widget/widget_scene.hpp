@@ -13,11 +13,53 @@ NOTF_OPEN_NAMESPACE
 
 class WidgetScene : public Scene {
 
+    friend Accessor<WidgetScene, AnyWidget>;
+
     // types ----------------------------------------------------------------------------------- //
 public:
+    /// Nested `AccessFor<T>` type.
+    NOTF_ACCESS_TYPE(WidgetScene);
+
     /// WidgetScenes are only allowed to parent a single Widget.
     using allowed_child_types = std::tuple<AnyWidget>;
 
+    /// Steps of a layout pass, in order.
+    /// Used as bit flags on each Widget to mark which steps it is already scheduled for.
+    enum class LayoutStep : uchar {
+        CLAIM = 1u << 0,    // re-calculates the implicit Claim of a Widget, from the bottom up
+        RELAYOUT = 1u << 1, // re-calculates the Placement of the children of a Widget, from the top down
+        AABR = 1u << 2,     // re-calculates the bounding rect of a Widget, from the bottom up
+        HIT_GRID = 1u << 3, // updates a Widget and its descendants in the hit grid, from the top down
+    };
+
+    /// Statistics about the layout passes of this WidgetScene, accumulated over its lifetime.
+    struct LayoutStatistics {
+
+        /// Number of layout passes that had any work to do.
+        size_t pass_count = 0;
+
+        /// Number of implicit Claims that were re-calculated.
+        size_t claim_update_count = 0;
+
+        /// Number of Widgets whose children were laid out.
+        size_t relayout_count = 0;
+
+        /// Number of requests to update the Claim or layout of a Widget that was already scheduled for an update.
+        /// Without batching, each one of these requests would have caused at least one additional relayout.
+        size_t avoided_relayout_count = 0;
+    };
+
+private:
+    /// A Widget that is scheduled for an update in one of the steps of the next layout pass.
+    struct LayoutRequest {
+
+        /// Depth of the Widget in the hierarchy, the root Widget has a depth of zero.
+        size_t depth;
+
+        /// Widget to update, is weak in case the Widget is removed before the next layout pass.
+        std::weak_ptr<AnyNode> widget;
+    };
+
     // methods ------------------------------------------------------------------------------------------------------ //
 public:
     /// Constructor, constructs a full-screen, visible WidgetScene.
@@ -29,6 +71,7 @@ public:
     template<class T, class... Args, class = std::enable_if_t<std::is_base_of_v<AnyWidget, T>>>
     auto set_widget(Args&&... args) {
         _clear_children();
+        m_hit_grid.clear();
 
         // create the new widget and resize it to fit the scene
         auto widget = _create_child<T>(this, std::forward<Args>(args)...).to_handle();
@@ -44,6 +87,51 @@ public:
     /// Outermost clipping rect, encompasses the entire Scene.
     const Aabrf& get_clipping_rect() const { return m_clipping; }
 
+    /// Updates the layout of all Widgets in this Scene.
+    /// Changing the Claim, grant or Layout of a Widget does not cause an immediate relayout. Instead, the Widget is
+    /// scheduled for an update and all scheduled Widgets are updated in a single pass: first all implicit Claims from
+    /// the bottom up, then all layouts from the top down (parents before children) and finally all bounding rects.
+    /// Each Widget is updated at most once per step.
+    /// This method is called automatically before every frame, but you can call it manually if you require
+    /// up-to-date layout information right away.
+    void update_layout();
+
+    /// Statistics about the layout passes of this WidgetScene.
+    const LayoutStatistics& get_layout_statistics() const noexcept { return m_layout_statistics; }
+
+    /// All visible Widgets whose bounding rect contains the given position, ordered from front to back.
+    /// Brings the layout up to date before the query.
+    /// @param window_pos   Position in window space.
+    std::vector<WidgetHandle> get_widgets_at(const V2f& window_pos);
+
+    /// All visible Widgets whose bounding rect intersects the given rect, ordered from front to back.
+    /// Brings the layout up to date before the query.
+    /// @param window_rect  Rect in window space.
+    std::vector<WidgetHandle> get_widgets_in(const Aabrf& window_rect);
+
+private:
+    /// Runs the layout pass before the next frame is rendered.
+    void _prepare_frame() override { update_layout(); }
+
+    /// Schedules a Widget for an update in the given step of the next layout pass.
+    /// If the Widget is already scheduled for the step, this method does nothing.
+    /// @param step     Layout step in which to update the Widget.
+    /// @param widget   Widget to update.
+    /// @param depth    Depth of the Widget in the hierarchy.
+    void _schedule(LayoutStep step, AnyWidget& widget, size_t depth);
+
+    /// Removes the next Widget from the queue of the given step.
+    /// Widgets that have been removed since they were scheduled are skipped.
+    /// @param step     Layout step of the queue to pop from.
+    /// @returns        The next Widget to update, is empty if the queue is empty.
+    AnyWidgetPtr _pop_scheduled(LayoutStep step);
+
+    /// The queue of Widgets scheduled for the given step.
+    std::vector<LayoutRequest>& _get_queue(LayoutStep step);
+
+    /// Produces a list of all Widgets found by the last hit grid query, ordered from front to back.
+    std::vector<WidgetHandle> _collect_hits();
+
     // fields ------------------------------------------------------------------------------------------------------- //
 private:
     /// The Widget underneath the root of this Scene.
@@ -51,6 +139,50 @@ private:
 
     /// Outermost clipping rect, encompasses the entire Scene.
     Aabrf m_clipping;
+
+    /// Widgets scheduled for a Claim update, as a heap with the deepest Widget at the front.
+    std::vector<LayoutRequest> m_claim_queue;
+
+    /// Widgets scheduled for a relayout, as a heap with the Widget closest to the root at the front.
+    std::vector<LayoutRequest> m_relayout_queue;
+
+    /// Widgets scheduled for a bounding rect update, as a heap with the deepest Widget at the front.
+    std::vector<LayoutRequest> m_aabr_queue;
+
+    /// Widgets scheduled for a hit grid update, as a heap with the Widget closest to the root at the front.
+    std::vector<LayoutRequest> m_hit_grid_queue;
+
+    /// Bounding rects of all visible Widgets in window space.
+    WidgetHitGrid m_hit_grid;
+
+    /// Handles of all entries found by the last hit grid query.
+    std::vector<WidgetHitGrid::Handle> m_hits;
+
+    /// Widgets found by the last hit grid query.
+    std::vector<AnyWidgetPtr> m_hit_widgets;
+
+    /// Statistics about the layout passes of this WidgetScene.
+    LayoutStatistics m_layout_statistics;
+};
+
+// widget scene accessors =========================================================================================== //
+
+template<>
+class Accessor<WidgetScene, AnyWidget> {
+    friend AnyWidget;
+
+    /// Schedules a Widget for an update in the given step of the next layout pass.
+    /// @param scene    WidgetScene containing the Widget.
+    /// @param step     Layout step in which to update the Widget.
+    /// @param widget   Widget to update.
+    /// @param depth    Depth of the Widget in the hierarchy.
+    static void schedule(WidgetScene& scene, WidgetScene::LayoutStep step, AnyWidget& widget, size_t depth) {
+        scene._schedule(step, widget, depth);
+    }
+
+    /// Hit grid of the WidgetScene.
+    /// @param scene    WidgetScene containing the hit grid.
+    static WidgetHitGrid& get_hit_grid(WidgetScene& scene) { return scene.m_hit_grid; }
 };
 
 // widget scene handle ============================================================================================== //
@@ -60,8 +192,12 @@ namespace detail {
 template<>
 struct NodeHandleInterface<WidgetScene> : public NodeHandleBaseInterface<WidgetScene> {
 
+    using WidgetScene::get_layout_statistics;
     using WidgetScene::get_widget;
+    using WidgetScene::get_widgets_at;
+    using WidgetScene::get_widgets_in;
     using WidgetScene::set_widget;
+    using WidgetScene::update_layout;
 };
 
 } // namespace detail
@@ -22,10 +22,27 @@ public:
     /// @param scene    Scene providing Properties matching the Shader's uniforms.
     void visualize(valid_ptr<Scene*> scene) const override;
 
+    /// Parses the Designs of all Widgets and returns the area covered by all Widgets that changed since the last frame.
+    /// The Designs are not parsed again when the Scene is visualized right afterwards.
+    /// @param scene    Scene to visualize.
+    Aabri get_damage(valid_ptr<Scene*> scene) const override;
+
+private:
+    /// Parses the Designs of all Widgets in the given Scene.
+    /// @param scene    Scene to visualize.
+    /// @returns        False if the Scene is not a WidgetScene.
+    bool _parse(valid_ptr<Scene*> scene) const;
+
     // fields ---------------------------------------------------------------------------------- //
 private:
     /// Plotter to use for visualization.
     PlotterPtr m_plotter;
+
+    /// Threads used to parse the Designs of all Widgets in parallel.
+    std::unique_ptr<ThreadPool> m_thread_pool;
+
+    /// Whether the Designs were already parsed by `get_damage` and are waiting to be visualized.
+    mutable bool m_is_parsed = false;
 };
 
 NOTF_CLOSE_NAMESPACE
@@ -45,6 +45,9 @@ class MsgPack;
 // thread.hpp
 class Thread;
 
+// thread_pool.hpp
+class ThreadPool;
+
 // uuid.hpp
 class Uuid;
 
@@ -70,7 +70,8 @@ public:
     /// @param other    Aabr to copy from.
     template<class T>
     constexpr Aabr(const Aabr<T>& other) noexcept
-        : Aabr(other.get_left(), other.get_bottom(), other.get_right(), other.get_top()) {}
+        : super_t(component_t(static_cast<element_t>(other.get_left()), static_cast<element_t>(other.get_bottom())),
+                  component_t(static_cast<element_t>(other.get_right()), static_cast<element_t>(other.get_top()))) {}
 
     /// Constructs the Aabr from two of its corners.
     /// The corners don't need to be specific, the constructor figures out how to construct an Aabr from them.
@@ -78,8 +78,17 @@ public:
         return _create_shared(std::vector<CubicPolyBezier2f>{std::move(path)});
     }
 
+    /// Multi Path constructor.
+    /// @param subpaths All subpaths.
+    static Path2Ptr create(std::vector<CubicPolyBezier2f> subpaths) { return _create_shared(std::move(subpaths)); }
+
     /// Rectangle.
     static Path2Ptr rect(const Aabrf& aabr);
+
+    /// Circle, approximated by four bezier segments.
+    /// @param center   Center of the circle.
+    /// @param radius   Radius of the circle.
+    static Path2Ptr circle(const V2f& center, float radius);
     // TODO: other primitive Path2 shapes (rounded rect, ellipse etc.).
 
     /// Whether or not this Path2 contains any subpaths.
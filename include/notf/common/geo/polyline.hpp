@@ -195,6 +195,7 @@ public:
                && Triangle<element_t>(m_vertices[0], m_vertices[1], m_vertices[index]).is_degenerate()) {
             ++index;
         }
+        if (index == m_vertices.size()) { return true; } // all vertices are on a single line
         const Orientation first_orientation
             = Triangle<element_t>(m_vertices[0], m_vertices[1], m_vertices[index]).get_orientation();
 
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <future>
 #include <vector>
 
+#include "notf/meta/assert.hpp"
 #include "notf/meta/exception.hpp"
 
 #include "notf/common/delegate.hpp"
@@ -36,16 +39,19 @@ public:
     /// Finishes all outstanding tasks before returning.
     ~ThreadPool();
 
+    /// Number of worker threads in the pool.
+    size_t get_thread_count() const noexcept { return m_workers.size(); }
+
     /// Enqueues a new task without return value.
     /// @param function     Function returning void.
     /// @param args         Arguments forwareded to the function when the tasks is executed.
     /// @throws             thread_pool_finished When the thread pool has already finished.
-    template<class Function, class... Args, class return_t = std::invoke_result_t<Function(Args...)>>
+    template<class Function, class... Args, class return_t = std::invoke_result_t<Function, Args...>>
     std::enable_if_t<std::is_same_v<void, return_t>, void> enqueue(Function&& function, Args&&... args) {
         { // enqueue the new task, unless the pool has already finished
             std::lock_guard<std::mutex> lock(m_queue_mutex);
             if (NOTF_UNLIKELY(m_is_finished)) {
-                NOTF_THROW(thread_pool_finished_error, "Cannot enqueue a new task into an already finished ThreadPool");
+                NOTF_THROW(FinishedError, "Cannot enqueue a new task into an already finished ThreadPool");
             }
             m_tasks.emplace_back(
                 [function{std::forward<Function>(function)}, &args...] { function(std::forward<Args>(args)...); });
@@ -63,7 +69,7 @@ public:
     /// @param args         Arguments forwareded to the function when the tasks is executed.
     /// @returns            Future containing the result of the function once it finished execution.
     /// @throws             thread_pool_finished When the thread pool has already finished.
-    template<class Function, class... Args, class return_t = std::invoke_result_t<Function(Args...)>>
+    template<class Function, class... Args, class return_t = std::invoke_result_t<Function, Args...>>
     NOTF_NODISCARD std::enable_if_t<!std::is_same_v<void, return_t>, std::future<return_t>>
     enqueue(Function&& function, Args&&... args) {
         // create the new task
@@ -83,6 +89,58 @@ public:
         return result;
     }
 
+    /// Calls a function for all indices in [0, count), split into chunks that are processed in parallel by the workers
+    /// of this pool and the calling thread.
+    /// There are a few more chunks than threads, so that threads that finish early can pick up the remaining work.
+    /// Returns once all chunks are processed. If the function throws, the first exception is rethrown after all threads
+    /// have stopped.
+    /// @param count                Number of indices.
+    /// @param min_chunk_size       Minimum number of indices in a chunk.
+    /// @param chunks_per_thread    Maximum number of chunks per thread.
+    /// @param function             Function called with the first and one-past-the-last index of each chunk.
+    template<class Function>
+    void for_each_chunk(const size_t count, const size_t min_chunk_size, const size_t chunks_per_thread,
+                        Function&& function) {
+        NOTF_ASSERT(min_chunk_size > 0 && chunks_per_thread > 0);
+        if (count == 0) { return; }
+        const size_t thread_count = get_thread_count() + 1; // the calling thread helps out
+        const size_t chunk_count
+            = std::min((count + min_chunk_size - 1) / min_chunk_size, thread_count * chunks_per_thread);
+        const size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+
+        std::atomic<size_t> next_chunk = 0;
+        const auto process_chunks = [&]() -> size_t {
+            size_t processed_chunks = 0;
+            for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++) {
+                function(std::min(count, chunk * chunk_size), std::min(count, (chunk + 1) * chunk_size));
+                ++processed_chunks;
+            }
+            return processed_chunks;
+        };
+
+        // all workers must have finished before returning, because they reference the function and the counter
+        std::vector<std::future<size_t>> workers;
+        for (size_t i = 1, end = std::min(thread_count, chunk_count); i < end; ++i) {
+            workers.emplace_back(enqueue(process_chunks));
+        }
+        std::exception_ptr exception;
+        size_t processed_chunks = 0;
+        try {
+            processed_chunks += process_chunks();
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+        for (std::future<size_t>& worker : workers) {
+            worker.wait();
+        }
+        if (exception) { std::rethrow_exception(exception); }
+        for (std::future<size_t>& worker : workers) {
+            processed_chunks += worker.get();
+        }
+        NOTF_ASSERT(processed_chunks == chunk_count);
+    }
+
     // fields ---------------------------------------------------------------------------------- //
 private:
     /// Worker threads.
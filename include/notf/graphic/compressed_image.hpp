@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+
+#include "glad.h"
+
+#include "notf/common/geo/size2.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// compressed image ================================================================================================= //
+
+/// Block-compressed image in a container file, that can be uploaded to OpenGL without being decompressed.
+///
+/// Supported containers are:
+///     * `.astc` files, as written by the ARM ASTC encoder. They contain a single 2D image of any ASTC block size.
+///     * KTX2 files (https://github.khronos.org/KTX-Specification/) with a 2D image in ASTC or ETC2 format, without
+///       supercompression. All mip levels stored in the file are available.
+/// The container is detected from the contents of the file, not from its name.
+///
+/// The file is memory-mapped instead of read, so the image data is only paged in from disk when it is uploaded.
+class CompressedImage {
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Container format of the file.
+    enum class Container {
+        ASTC, ///< `.astc` file
+        KTX2, ///< Khronos Texture 2
+    };
+
+    /// A single mip level of the image.
+    struct Level {
+        /// Size of the level in pixels.
+        Size2i size;
+
+        /// Compressed blocks of the level, points into the mapped file.
+        const uchar* data;
+
+        /// Number of bytes in `data`.
+        size_t length;
+    };
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    NOTF_NO_COPY_OR_ASSIGN(CompressedImage);
+
+    /// Value Constructor.
+    /// @param image_path       Path to the image file.
+    /// @param is_srgb          Whether the colors in `.astc` files are in sRGB color space, because the files do not
+    ///                         store their color space themselves. Is ignored for KTX2 files.
+    /// @throw ResourceError    If the file cannot be read, is no supported container or is malformed.
+    CompressedImage(std::string image_path, const bool is_srgb = true);
+
+    /// Destructor.
+    ~CompressedImage();
+
+    /// Path to the file from which the image was loaded.
+    const std::string& get_filepath() const { return m_filepath; }
+
+    /// Container format of the file.
+    Container get_container() const { return m_container; }
+
+    /// Size of the largest mip level in pixels.
+    const Size2i& get_size() const { return m_levels.front().size; }
+
+    /// Size of a single compressed block in pixels.
+    const Size2i& get_block_size() const { return m_block_size; }
+
+    /// Whether the colors are in sRGB color space.
+    bool is_srgb() const { return m_is_srgb; }
+
+    /// OpenGL internal format of the compressed image.
+    GLenum get_internal_format() const { return m_internal_format; }
+
+    /// All mip levels in the image, starting with the largest one. Contains at least one level.
+    const std::vector<Level>& get_levels() const { return m_levels; }
+
+    /// Combined length of the compressed data of all mip levels in bytes.
+    size_t get_data_length() const;
+
+    /// Reads the whole file into memory, so that a later upload does not have to wait for the disk.
+    /// Use this when the image is loaded on a different thread than the one uploading it.
+    void page_in() const;
+
+private:
+    /// Parses an `.astc` file.
+    void _parse_astc();
+
+    /// Parses a KTX2 file.
+    void _parse_ktx2();
+
+    /// Adds a new mip level after checking that it fits into the file and contains all of its blocks.
+    /// @param size             Size of the level in pixels.
+    /// @param offset           Offset of the level data from the start of the file.
+    /// @param length           Number of bytes in the level data.
+    /// @param block_length     Number of bytes per compressed block.
+    /// @throw ResourceError    If the level data is invalid.
+    void _add_level(Size2i size, const uint64_t offset, const uint64_t length, const size_t block_length);
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Path to the file from which the image was loaded.
+    const std::string m_filepath;
+
+    /// Memory-mapped contents of the file.
+    uchar* m_file = nullptr;
+
+    /// Size of the file in bytes.
+    size_t m_file_size = 0;
+
+    /// Container format of the file.
+    Container m_container;
+
+    /// Size of a single compressed block in pixels.
+    Size2i m_block_size;
+
+    /// Whether the colors are in sRGB color space.
+    bool m_is_srgb;
+
+    /// OpenGL internal format of the compressed image.
+    GLenum m_internal_format = 0;
+
+    /// All mip levels in the image, starting with the largest one.
+    std::vector<Level> m_levels;
+};
+
+NOTF_CLOSE_NAMESPACE
@@ -17,9 +17,7 @@ struct DrawElementsIndirectCommand {
     uint instance_count; // number of instances to render
     uint first_index;    // first entry in the index buffer
     int first_vertex;    // first entry in the vertex buffer, addressable by index = 0
-
-private:
-    NOTF_UNUSED const uint _reserved = 0; // must be zero (for some reason)
+    uint reserved = 0;   // base instance in desktop OpenGL, must be zero in OpenGL ES
 };
 
 } // namespace detail
@@ -59,9 +57,19 @@ public:
 /// @param name         Human-readable name of this OpenGLBuffer.
 /// @param usage_hint   The expected usage of the data stored in this buffer.
 /// @throws OpenGLError If the buffer could not be allocated.
-auto make_drawcall_buffer(std::string name,
-                          const DrawCallBuffer::UsageHint usage_hint = AnyIndexBuffer::UsageHint::DEFAULT) {
+inline auto make_drawcall_buffer(std::string name,
+                                 const DrawCallBuffer::UsageHint usage_hint = DrawCallBuffer::UsageHint::DEFAULT) {
     return DrawCallBuffer::create(std::move(name), usage_hint);
 }
 
 NOTF_CLOSE_NAMESPACE
+
+// std::hash ======================================================================================================== //
+
+/// std::hash specialization for DrawElementsIndirectCommand.
+template<>
+struct std::hash<notf::detail::DrawElementsIndirectCommand> {
+    size_t operator()(const notf::detail::DrawElementsIndirectCommand& command) const {
+        return notf::hash(command.index_count, command.instance_count, command.first_index, command.first_vertex);
+    }
+};
@@ -48,8 +48,7 @@ class TypedOpenGLBuffer;
 
 // drawcall_buffer.hpp ----------------------------------------------------- //
 
-using DrawCallBuffer = detail::TypedOpenGLBuffer<detail::OpenGLBufferType::DRAWCALL>;
-NOTF_DECLARE_SHARED_POINTERS_ONLY(DrawCallBuffer);
+NOTF_DECLARE_SHARED_POINTERS(class, DrawCallBuffer);
 
 // index_buffer.hpp -------------------------------------------------------- //
 
@@ -79,6 +78,10 @@ class UniformBlock;
 } // namespace detail
 NOTF_DECLARE_SHARED_POINTERS(class, Texture);
 
+// texture_loader.hpp ------------------------------------------------------ //
+
+NOTF_DECLARE_SHARED_POINTERS(class, TextureLoader);
+
 // vertex_object.hpp ------------------------------------------------------- //
 
 NOTF_DECLARE_SHARED_POINTERS(class, VertexObject);
@@ -115,6 +118,10 @@ NOTF_DECLARE_SHARED_POINTERS(class, Font);
 
 NOTF_DECLARE_UNIQUE_POINTERS(class, FontManager);
 
+// text/text_layout.hpp ---------------------------------------------------- //
+
+NOTF_DECLARE_SHARED_POINTERS(class, TextLayout);
+
 
 NOTF_CLOSE_NAMESPACE
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <map>
 #include <optional>
 #include <vector>
@@ -157,6 +158,30 @@ private:
         CullFace m_mode = CullFace::NONE; // culling is disabled by default in OpenGL
     };
 
+    // scissor ----------------------------------------------------------------
+
+    struct _Scissor {
+        NOTF_NO_COPY_OR_ASSIGN(_Scissor);
+
+        /// Default constructor.
+        _Scissor() = default;
+
+        /// Assignment operator.
+        /// @param area New scissor area, an invalid Aabri disables the scissor test.
+        void operator=(const Aabri& area);
+
+        /// Current scissor area, is invalid if the scissor test is disabled.
+        operator const Aabri&() const { return m_area; }
+
+        /// Whether the scissor test is enabled.
+        bool is_enabled() const { return m_area.is_valid(); }
+
+        // fields ---------------------------------------------------------- //
+    private:
+        /// Current scissor area.
+        Aabri m_area = Aabri::wrongest(); // the scissor test is disabled by default in OpenGL
+    };
+
     // framebuffer binding ----------------------------------------------------
 
     /// Generic "framebuffer" state.
@@ -543,6 +568,9 @@ private:
         /// Stencil mask.
         _StencilMask stencil_mask;
 
+        /// Scissor area.
+        _Scissor scissor;
+
         /// Bound Framebuffer.
         _FrameBuffer framebuffer;
 
@@ -568,6 +596,27 @@ private:
         Aabri _render_area;
     };
 
+public:
+    // statistics -------------------------------------------------------------
+
+    /// Counters describing the last frame that was rendered.
+    struct FrameStatistics {
+
+        /// Number of pixels that were cleared and redrawn.
+        size_t pixels_redrawn = 0;
+
+        /// Number of pixels in the frame.
+        size_t pixels_total = 0;
+
+        /// Number of frames that the back buffer was behind before it was redrawn, zero if unknown.
+        int buffer_age = 0;
+
+        /// Ratio of pixels that were redrawn.
+        float get_redraw_ratio() const noexcept {
+            return pixels_total == 0 ? 0 : static_cast<float>(pixels_redrawn) / static_cast<float>(pixels_total);
+        }
+    };
+
     // methods --------------------------------------------------------------------------------- //
 public:
     NOTF_NO_COPY_OR_ASSIGN(GraphicsContext);
@@ -598,11 +647,20 @@ public:
     Guard make_current(bool assume_is_current = true);
 
     /// Begins the render of a frame.
-    void begin_frame();
+    /// Only the damaged area of the frame is cleared and redrawn, the scissor test is enabled for the duration of the
+    /// frame. After the buffers were swapped, the back buffer contains an older frame, so the areas that changed in all
+    /// frames since then are redrawn as well. The age of the back buffer is queried through EGL_EXT_buffer_age or
+    /// GLX_EXT_buffer_age, if neither is available or the size of the frame changed, the whole frame is redrawn.
+    /// @param damage   Area of the frame that changed since the last frame, by default the whole frame is redrawn.
+    /// @returns        False if nothing needs to be redrawn, in which case the frame must not be rendered or finished.
+    bool begin_frame(const Aabri& damage = Aabri::largest());
 
     /// Finishes the render of a frame.
     void finish_frame();
 
+    /// Counters describing the last frame that was rendered.
+    const FrameStatistics& get_frame_statistics() const { return m_frame_statistics; }
+
     /// @{
     /// Access to the GraphicsContext's state.
     /// @throws OpenGLError If the context is not current.
@@ -648,6 +706,18 @@ private:
     /// The current state of the context.
     _State m_state;
 
+    /// Area of the last frame, in pixels.
+    Aabri m_frame_area = Aabri::zero();
+
+    /// Damaged areas of the last frames, most recent first.
+    std::vector<Aabri> m_past_damage;
+
+    /// Queries the age of the back buffer, is empty if the age cannot be determined.
+    std::function<int()> m_buffer_age_query;
+
+    /// Counters describing the last frame that was rendered.
+    FrameStatistics m_frame_statistics;
+
     // resources --------------------------------------------------------------
 
     /// All FrameBuffers managed by this GraphicsContext.
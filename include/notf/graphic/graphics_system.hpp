@@ -90,6 +90,9 @@ public:
         /// Maximum height and width of a render buffer in pixels.
         GLuint max_render_buffer_size;
 
+        /// Maximum height and width of a texture in pixels.
+        GLuint max_texture_size;
+
         /// Number of available color attachments for a frame buffer.
         GLuint color_attachment_count;
 
@@ -146,6 +149,14 @@ public:
     const FontManager& get_font_manager() const { return *m_font_manager; }
     ///@}
 
+    ///@{
+    /// TextureLoader used to load Textures in the background.
+    /// Textures requested with `ResourceManager::get_type<Texture>().get_async` are loaded with it as well. They are
+    /// only ready after the render thread uploaded them, so the render thread must never wait for such a future.
+    TextureLoader& get_texture_loader() { return *m_texture_loader; }
+    const TextureLoader& get_texture_loader() const { return *m_texture_loader; }
+    ///@}
+
     /// Call this function after the last shader has been compiled.
     /// Might cause the driver to release the resources allocated for the compiler to free up some space, but is not
     /// guaranteed to do so.
@@ -195,6 +206,9 @@ private:
     /// The FontManager.
     FontManagerPtr m_font_manager;
 
+    /// The TextureLoader.
+    TextureLoaderPtr m_texture_loader;
+
     // resources --------------------------------------------------------------
 
     /// All Textures managed by the GraphicsSystem.
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "notf/common/geo/size2.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// image kernels ==================================================================================================== //
+
+/// Set of implementations used by the image kernels.
+/// By default, the best set supported by the CPU is used. Other sets can be chosen to compare their results or
+/// performance. All sets produce the same results, except for `downsample_lanczos`, which may differ by one in rare
+/// cases because of the order of floating point operations.
+enum class ImageKernelSet {
+    SCALAR, ///< Plain C++, available everywhere.
+    SSE2,   ///< 128 bit vectors, available on all x86-64 CPUs.
+    AVX2,   ///< 256 bit vectors, detected at runtime.
+};
+
+/// The best set of image kernel implementations supported by the CPU.
+ImageKernelSet get_best_image_kernel_set();
+
+/// The set of image kernel implementations currently in use.
+ImageKernelSet get_image_kernel_set();
+
+/// Chooses the set of image kernel implementations to use from now on.
+/// @throws ValueError  If the CPU does not support the set.
+void set_image_kernel_set(const ImageKernelSet set);
+
+/// Multiplies the color channels of RGBA pixels with their alpha, in-place.
+/// @param pixels       RGBA pixels with 8 bits per channel.
+/// @param pixel_count  Number of pixels.
+void premultiply_alpha(uchar* pixels, const size_t pixel_count);
+
+/// Divides the color channels of premultiplied RGBA pixels by their alpha, in-place.
+/// Fully transparent pixels become transparent black.
+/// @param pixels       Premultiplied RGBA pixels with 8 bits per channel.
+/// @param pixel_count  Number of pixels.
+void unpremultiply_alpha(uchar* pixels, const size_t pixel_count);
+
+/// Reorders the channels of RGBA pixels, in-place, for example to convert between RGBA and BGRA.
+/// @param pixels       Pixels with 4 channels of 8 bits each.
+/// @param pixel_count  Number of pixels.
+/// @param order        For each channel of the result, the index of the channel it is copied from.
+/// @throws ValueError  If an index is not in [0, 3].
+void swizzle_channels(uchar* pixels, const size_t pixel_count, const std::array<int, 4>& order);
+
+/// Converts the color channels of pixels from sRGB to linear color space, in-place.
+/// Note that 8 bits are not enough to store dark linear colors without banding, convert to linear color space only
+/// right before processing the image and back right after.
+/// @param pixels       Pixels with 8 bits per channel.
+/// @param pixel_count  Number of pixels.
+/// @param channels     Number of channels per pixel, the last channel is alpha and left untouched if there are 2 or 4.
+void decode_srgb(uchar* pixels, const size_t pixel_count, const int channels);
+
+/// Converts the color channels of pixels from linear to sRGB color space, in-place.
+/// @param pixels       Pixels with 8 bits per channel.
+/// @param pixel_count  Number of pixels.
+/// @param channels     Number of channels per pixel, the last channel is alpha and left untouched if there are 2 or 4.
+void encode_srgb(uchar* pixels, const size_t pixel_count, const int channels);
+
+/// Halves the size of an image by averaging blocks of 2x2 pixels.
+/// Images with an odd width or height drop their last column or row, images that are a single pixel wide or high stay
+/// that way.
+/// @param pixels       Pixels with 8 bits per channel, row by row without padding.
+/// @param size         Size of the image in pixels.
+/// @param channels     Number of channels per pixel.
+/// @param is_srgb      Whether the color channels are in sRGB color space and have to be averaged in linear space.
+/// @returns            Pixels of the downsampled image, with a size of `get_mip_size(size, 1)`.
+std::vector<uchar> downsample_box(const uchar* pixels, const Size2i& size, const int channels,
+                                  const bool is_srgb = false);
+
+/// Resizes an image with a Lanczos filter (a = 3), which keeps the image sharper than a box filter.
+/// @param pixels       Pixels with 8 bits per channel, row by row without padding.
+/// @param size         Size of the image in pixels.
+/// @param channels     Number of channels per pixel.
+/// @param target_size  Size of the resized image, may be larger than the image as well.
+/// @param is_srgb      Whether the color channels are in sRGB color space and have to be filtered in linear space.
+/// @returns            Pixels of the resized image.
+std::vector<uchar> downsample_lanczos(const uchar* pixels, const Size2i& size, const int channels,
+                                      const Size2i& target_size, const bool is_srgb = false);
+
+/// Size of a mip level of an image, every level is half as large as the previous one, but at least one pixel.
+/// @param size     Size of the image.
+/// @param level    Mip level, 0 is the image itself.
+Size2i get_mip_size(const Size2i& size, const int level);
+
+/// Produces all mip levels of an image with `downsample_box`, from half its size down to a single pixel.
+/// @param pixels       Pixels with 8 bits per channel, row by row without padding.
+/// @param size         Size of the image in pixels.
+/// @param channels     Number of channels per pixel.
+/// @param is_srgb      Whether the color channels are in sRGB color space and have to be averaged in linear space.
+/// @returns            Pixels of all mip levels but the image itself, starting with level 1.
+std::vector<std::vector<uchar>> produce_mip_chain(const uchar* pixels, const Size2i& size, const int channels,
+                                                  const bool is_srgb = false);
+
+NOTF_CLOSE_NAMESPACE
@@ -79,7 +79,8 @@ public:
 
     /// Updates the server data with the client's.
     /// If no change occured or the client's data is empty, this method does nothing.
-    virtual void upload() = 0;
+    /// @returns    Number of bytes uploaded to the server.
+    virtual size_t upload() = 0;
 
 protected:
     /// Numeric OpenGL handle of this buffer.
@@ -212,8 +213,9 @@ public:
 
     /// Updates the server data with the client's.
     /// If no change occured or the client's data is empty, this method does nothing.
-    void upload() final {
-        if (is_empty()) { return; }
+    /// @returns    Number of bytes uploaded to the server.
+    size_t upload() final {
+        if (is_empty()) { return 0; }
 
         const GLsizei buffer_size = m_buffer.size() * get_element_size();
 
@@ -241,7 +243,7 @@ public:
         }
 
         // do nothing if the data on the server is still current
-        if (m_local_hash == m_server_hash) { return; }
+        if (m_local_hash == m_server_hash) { return 0; }
 
         // bind and eventually unbind the index buffer
         NOTF_GUARD(detail::OpenGLBufferGuard(*this));
@@ -268,6 +270,50 @@ public:
         //      glBufferSubData, especially from the specific region being updated, that rendering must drain from the
         //      pipeline before the data store can be updated.
         //
+        return static_cast<size_t>(buffer_size);
+    }
+
+    /// Updates the server data with the client's, starting at the given element.
+    /// All elements in front of `first` must be unchanged since the last upload. This allows buffers that keep a
+    /// stable prefix across frames and only change at the end to upload just the part that actually changed.
+    /// If the server buffer is too small, it is re-allocated to the client's capacity and filled completely.
+    /// @param first    Index of the first element that might have changed.
+    /// @returns        Number of bytes uploaded to the server.
+    size_t upload_from(const uint first) {
+        // partial uploads do not work with the padding hack in `upload`
+        NOTF_ASSERT(get_element_size() == sizeof(data_t));
+        if (is_empty()) { return 0; }
+
+        NOTF_GUARD(detail::OpenGLBufferGuard(*this));
+        const GLenum gl_type = this->to_gl_type(this->get_type());
+        const size_t buffer_size = m_buffer.size() * sizeof(data_t);
+        size_t uploaded_size = 0;
+
+        // grow the server buffer along with the client's capacity, so appending does not re-allocate every time
+        if (buffer_size > m_server_size) {
+            const size_t capacity = m_buffer.capacity() * sizeof(data_t);
+            NOTF_CHECK_GL(glBufferData(gl_type, narrow_cast<GLsizei>(capacity), nullptr,
+                                       this->_to_gl_usage(this->get_usage_hint())));
+            NOTF_CHECK_GL(
+                glBufferSubData(gl_type, /*offset = */ 0, narrow_cast<GLsizei>(buffer_size), &m_buffer.front()));
+            m_server_size = capacity;
+            this->_log_buffer_size(capacity);
+            uploaded_size = buffer_size;
+        }
+
+        // only upload the tail
+        else if (first < m_buffer.size()) {
+            const size_t offset = first * sizeof(data_t);
+            NOTF_CHECK_GL(glBufferSubData(gl_type, narrow_cast<GLintptr>(offset),
+                                          narrow_cast<GLsizei>(buffer_size - offset), &m_buffer[first]));
+            uploaded_size = buffer_size - offset;
+        }
+
+        // the hash of the server data is unknown, the next call to `upload` will upload everything
+        m_local_hash = 0;
+        m_server_hash = 0;
+
+        return uploaded_size;
     }
 
     // fields ---------------------------------------------------------------------------------- //
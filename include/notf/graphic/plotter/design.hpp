@@ -1,10 +1,11 @@
 #pragma once
 
 #include <atomic>
+#include <cstring>
+#include <new>
+#include <string_view>
 
-#include "notf/meta/concept.hpp"
-
-#include "notf/common/variant.hpp"
+#include "notf/meta/types.hpp"
 
 #include "notf/graphic/plotter/plotter.hpp"
 
@@ -12,6 +13,14 @@ NOTF_OPEN_NAMESPACE
 
 // widget design ==================================================================================================== //
 
+/// A sequence of Commands recorded by a Painter and replayed by the Plotter.
+///
+/// Commands are encoded into a single, linear buffer of bytes: each Command is a tag, immediately followed by its
+/// payload (if it has one). Payloads that are trivially copyable are stored inline, all others (Paints, Paths, Fonts
+/// and texts) are stored out-of-line in per-Design arenas and only referenced by index from the buffer. Every value in
+/// the buffer is padded to a multiple of 4 bytes, so that inline payloads can be referenced in place when replayed.
+/// Re-recording a Design re-uses the memory of the buffer and the arenas, so recording a Design does not allocate once
+/// the buffers have grown large enough, and replaying it reads the buffer from front to back.
 class PlotterDesign {
 
     friend Accessor<PlotterDesign, Painter>;
@@ -28,34 +37,19 @@ public:
     struct PushState {};
     struct PopState {};
     struct SetXform {
-        struct Data {
-            M3f xform;
-        };
-        std::unique_ptr<Data> data;
+        const M3f& xform;
     };
     struct SetPaint {
-        struct Data {
-            Plotter::Paint paint;
-        };
-        std::unique_ptr<Data> data;
+        const Plotter::Paint& paint;
     };
     struct SetPath {
-        struct Data {
-            Path2Ptr path;
-        };
-        std::unique_ptr<Data> data;
+        const Path2Ptr& path;
     };
     struct SetClip {
-        struct Data {
-            Aabrf clip;
-        };
-        std::unique_ptr<Data> data;
+        const Aabrf& clip;
     };
     struct SetFont {
-        struct Data {
-            FontPtr font;
-        };
-        std::unique_ptr<Data> data;
+        const FontPtr& font;
     };
     struct SetAlpha {
         float alpha;
@@ -75,19 +69,38 @@ public:
     struct Fill {};
     struct Stroke {};
     struct Write {
-        struct Data {
-            std::string text;
-        };
-        std::unique_ptr<Data> data;
+        std::string_view text;
     };
-    using Command = std::variant<ResetState, PushState, PopState, SetXform, SetPaint, SetPath, SetClip, SetFont,
-                                 SetAlpha, SetStrokeWidth, SetBlendMode, SetLineCap, SetLineJoin, Fill, Stroke, Write>;
 
 private:
-    NOTF_CREATE_FIELD_DETECTOR(data);
-    static_assert(sizeof(Command) == (sizeof(std::unique_ptr<void>) * 2),
-                  "Make sure to wrap supplementary data of your Command type in a unique_ptr<>, "
-                  "so it doesn't inflate the size of the Command variant");
+    /// Identifies the type of a Command in the buffer.
+    enum class _Tag : uint8_t {
+        RESET_STATE,
+        PUSH_STATE,
+        POP_STATE,
+        SET_XFORM,
+        SET_PAINT,
+        SET_PATH,
+        SET_CLIP,
+        SET_FONT,
+        SET_ALPHA,
+        SET_STROKE_WIDTH,
+        SET_BLEND_MODE,
+        SET_LINE_CAP,
+        SET_LINE_JOIN,
+        FILL,
+        STROKE,
+        WRITE,
+    };
+
+    /// Alignment of all values in the buffer.
+    static constexpr size_t g_alignment = 4;
+
+    /// Range of characters in the text arena.
+    struct _TextRange {
+        uint offset;
+        uint size;
+    };
 
     // methods --------------------------------------------------------------------------------- //
 public:
@@ -97,25 +110,137 @@ public:
     /// Marks this Design as dirty.
     void set_dirty() { m_is_dirty.store(true, std::memory_order_release); }
 
-    /// The Design's buffer of untyped Command instances.
-    const std::vector<Command>& get_buffer() const { return m_buffer; }
+    /// Number of Commands in the Design.
+    size_t get_command_count() const { return m_command_count; }
+
+    /// Size of the encoded Commands in bytes, not counting out-of-line payloads.
+    size_t get_buffer_size() const { return m_buffer.size(); }
+
+    /// Generation of the Design, changes every time that the Design is re-recorded.
+    /// Generations are unique across all Designs, which allows the Plotter to identify a Design's Commands by the
+    /// address and generation of the Design alone. Is zero for Designs that were never recorded.
+    size_t get_generation() const { return m_generation; }
+
+    /// Replays all Commands in the order in which they were recorded.
+    /// Commands reference their payload in the Design and are only valid during the call to the visitor.
+    /// @param visitor  Callable that is invoked with every Command, must accept all Command types.
+    template<class Visitor>
+    void replay(Visitor&& visitor) const {
+        const std::byte* itr = m_buffer.data();
+        const std::byte* const end = itr + m_buffer.size();
+        const Plotter::Paint* const paints = m_paints.data();
+        const Path2Ptr* const paths = m_paths.data();
+        const FontPtr* const fonts = m_fonts.data();
+        const char* const texts = m_texts.data();
+        while (itr != end) {
+            switch (_read<_Tag>(itr)) {
+            case _Tag::RESET_STATE: visitor(ResetState{}); break;
+            case _Tag::PUSH_STATE: visitor(PushState{}); break;
+            case _Tag::POP_STATE: visitor(PopState{}); break;
+            case _Tag::SET_XFORM: visitor(SetXform{_read<M3f>(itr)}); break;
+            case _Tag::SET_PAINT: visitor(SetPaint{paints[_read<uint>(itr)]}); break;
+            case _Tag::SET_PATH: visitor(SetPath{paths[_read<uint>(itr)]}); break;
+            case _Tag::SET_CLIP: visitor(SetClip{_read<Aabrf>(itr)}); break;
+            case _Tag::SET_FONT: visitor(SetFont{fonts[_read<uint>(itr)]}); break;
+            case _Tag::SET_ALPHA: visitor(SetAlpha{_read<float>(itr)}); break;
+            case _Tag::SET_STROKE_WIDTH: visitor(SetStrokeWidth{_read<float>(itr)}); break;
+            case _Tag::SET_BLEND_MODE: visitor(SetBlendMode{_read<BlendMode>(itr)}); break;
+            case _Tag::SET_LINE_CAP: visitor(SetLineCap{_read<Plotter::CapStyle>(itr)}); break;
+            case _Tag::SET_LINE_JOIN: visitor(SetLineJoin{_read<Plotter::JointStyle>(itr)}); break;
+            case _Tag::FILL: visitor(Fill{}); break;
+            case _Tag::STROKE: visitor(Stroke{}); break;
+            case _Tag::WRITE: {
+                const _TextRange& range = _read<_TextRange>(itr);
+                visitor(Write{std::string_view(texts + range.offset, range.size)});
+                break;
+            }
+            }
+        }
+    }
 
 private:
-    /// Clears the content of the buffer and the vault.
-    void _reset() { m_buffer.clear(); }
+    /// Clears the content of the buffer and the arenas.
+    void _reset() {
+        m_buffer.clear();
+        m_paints.clear();
+        m_paths.clear();
+        m_fonts.clear();
+        m_texts.clear();
+        m_command_count = 0;
+    }
 
-    /// @{
     /// Pushes a new Command onto the buffer.
-    /// @param args Arguments used to initialize the data of the given Command.
+    /// @param args Arguments used to initialize the payload of the given Command.
     template<class T, class... Args>
-    std::enable_if_t<_has_data_v<T>> _add_command(Args&&... args) {
-        m_buffer.emplace_back(T{make_unique_aggregate<typename T::Data>(std::forward<Args>(args)...)});
+    void _add_command(Args&&... args) {
+        if constexpr (std::is_same_v<T, ResetState>) {
+            _write(_Tag::RESET_STATE);
+        } else if constexpr (std::is_same_v<T, PushState>) {
+            _write(_Tag::PUSH_STATE);
+        } else if constexpr (std::is_same_v<T, PopState>) {
+            _write(_Tag::POP_STATE);
+        } else if constexpr (std::is_same_v<T, SetXform>) {
+            _write(_Tag::SET_XFORM, M3f(std::forward<Args>(args)...));
+        } else if constexpr (std::is_same_v<T, SetPaint>) {
+            _write(_Tag::SET_PAINT, narrow_cast<uint>(m_paints.size()));
+            m_paints.emplace_back(std::forward<Args>(args)...);
+        } else if constexpr (std::is_same_v<T, SetPath>) {
+            _write(_Tag::SET_PATH, narrow_cast<uint>(m_paths.size()));
+            m_paths.emplace_back(std::forward<Args>(args)...);
+        } else if constexpr (std::is_same_v<T, SetClip>) {
+            _write(_Tag::SET_CLIP, Aabrf(std::forward<Args>(args)...));
+        } else if constexpr (std::is_same_v<T, SetFont>) {
+            _write(_Tag::SET_FONT, narrow_cast<uint>(m_fonts.size()));
+            m_fonts.emplace_back(std::forward<Args>(args)...);
+        } else if constexpr (std::is_same_v<T, SetAlpha>) {
+            _write(_Tag::SET_ALPHA, static_cast<float>(args)...);
+        } else if constexpr (std::is_same_v<T, SetStrokeWidth>) {
+            _write(_Tag::SET_STROKE_WIDTH, static_cast<float>(args)...);
+        } else if constexpr (std::is_same_v<T, SetBlendMode>) {
+            _write(_Tag::SET_BLEND_MODE, BlendMode(std::forward<Args>(args)...));
+        } else if constexpr (std::is_same_v<T, SetLineCap>) {
+            _write(_Tag::SET_LINE_CAP, static_cast<Plotter::CapStyle>(args)...);
+        } else if constexpr (std::is_same_v<T, SetLineJoin>) {
+            _write(_Tag::SET_LINE_JOIN, static_cast<Plotter::JointStyle>(args)...);
+        } else if constexpr (std::is_same_v<T, Fill>) {
+            _write(_Tag::FILL);
+        } else if constexpr (std::is_same_v<T, Stroke>) {
+            _write(_Tag::STROKE);
+        } else if constexpr (std::is_same_v<T, Write>) {
+            const std::string_view text(std::forward<Args>(args)...);
+            _write(_Tag::WRITE, _TextRange{narrow_cast<uint>(m_texts.size()), narrow_cast<uint>(text.size())});
+            m_texts.insert(m_texts.end(), text.begin(), text.end());
+        } else {
+            static_assert(always_false_v<T>, "Unknown PlotterDesign Command type");
+        }
+        ++m_command_count;
     }
-    template<class T, class... Args>
-    std::enable_if_t<!_has_data_v<T>> _add_command(Args&&... args) {
-        m_buffer.emplace_back(T{std::forward<Args>(args)...});
+
+    /// Size of a value in the buffer, including padding.
+    template<class T>
+    static constexpr size_t _get_padded_size() {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= g_alignment);
+        return ((sizeof(T) + g_alignment - 1) / g_alignment) * g_alignment;
+    }
+
+    /// Appends the given values to the end of the buffer.
+    /// @param values   Trivially copyable values to write.
+    template<class... Ts>
+    void _write(const Ts&... values) {
+        size_t offset = m_buffer.size();
+        m_buffer.resize(offset + (_get_padded_size<Ts>() + ...));
+        ((std::memcpy(&m_buffer[offset], &values, sizeof(Ts)), offset += _get_padded_size<Ts>()), ...);
+    }
+
+    /// Reads a value from the buffer and advances the iterator past it.
+    /// @param itr  Position in the buffer to read from.
+    /// @returns    The value in the buffer.
+    template<class T>
+    static const T& _read(const std::byte*& itr) {
+        const T* result = std::launder(reinterpret_cast<const T*>(itr));
+        itr += _get_padded_size<T>();
+        return *result;
     }
-    /// @}
 
     /// Finishes and performs basic optimization on the buffer.
     /// The performed optimizations do not affect the Design, only remove unnecessary Commands.
@@ -130,8 +255,22 @@ private:
     // TODO: I don't know why this would have to be atomic, also we can move it into AnyWidget and put it into the
     //       padding introduced after the Node baseclass for zero additional space requirements
 
-    /// Buffer of untyped Command instances.
-    std::vector<Command> m_buffer;
+    /// Encoded Commands, each one a tag followed by its inline payload.
+    std::vector<std::byte> m_buffer;
+
+    /// Out-of-line payloads, referenced by index from the buffer.
+    std::vector<Plotter::Paint> m_paints;
+    std::vector<Path2Ptr> m_paths;
+    std::vector<FontPtr> m_fonts;
+
+    /// Characters of all written texts, referenced by range from the buffer.
+    std::vector<char> m_texts;
+
+    /// Number of Commands in the buffer.
+    size_t m_command_count = 0;
+
+    /// Generation of the Design, is updated when the Design is completed.
+    size_t m_generation = 0;
 };
 
 // accessors ======================================================================================================== //
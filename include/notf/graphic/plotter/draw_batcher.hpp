@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "notf/meta/assert.hpp"
+#include "notf/meta/numeric.hpp"
+
+#include "notf/common/geo/aabr.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// draw batcher ===================================================================================================== //
+
+/// Groups a sequence of draws into batches, so that each batch can be rendered with a single draw call.
+///
+/// Two draws can share a batch if they have the same Key, which should contain all state that must not differ within a
+/// single draw call. In order to find more matching draws, a draw may be moved forward into an earlier batch, but only
+/// if it does not overlap any of the batches that are rendered in-between, so that the rendered result is the same as
+/// if all draws were rendered one by one, in order. Draws within a batch keep their original order.
+///
+/// Overlap is tested against a coarse grid of cells covering the drawn area. Each batch knows which cells its draws
+/// touch, which is a lot more precise than the union of their bounds once a batch contains draws from all over the
+/// screen. Draws outside the area are clamped to its border cells, which is always safe, but might prevent batching.
+/// The number of batches that a draw is allowed to skip is limited, to keep the cost of adding a draw constant.
+template<class Key>
+class DrawBatcher {
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Index of a draw, in the order in which the draws were added.
+    using DrawIndex = uint;
+
+    /// Invalid DrawIndex, marks the end of a batch.
+    static constexpr DrawIndex no_draw = max_v<DrawIndex>;
+
+    /// Default number of batches that a draw is allowed to skip.
+    static constexpr size_t default_lookback = 32;
+
+    /// Default width and height of a single cell.
+    static constexpr float default_cell_size = 32;
+
+    /// A batch of draws.
+    struct Batch {
+        /// State shared by all draws in the batch.
+        Key key;
+
+        /// Union of the bounds of all draws in the batch.
+        Aabrf bounds;
+
+        /// First and last draw in the batch.
+        DrawIndex first_draw;
+        DrawIndex last_draw;
+
+        /// Number of draws in the batch.
+        uint draw_count;
+    };
+
+private:
+    /// Cells are stored as one bit each.
+    using Word = uint64_t;
+
+    /// Number of cells in a Word.
+    static constexpr uint cells_per_word = sizeof(Word) * 8;
+
+    /// Range of cells (inclusive).
+    struct CellRange {
+        uint first_column;
+        uint first_row;
+        uint last_column;
+        uint last_row;
+    };
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    /// Constructor.
+    /// @param cell_size    Width and height of a single cell.
+    /// @param lookback     Number of batches that a draw is allowed to skip.
+    explicit DrawBatcher(const float cell_size = default_cell_size, const size_t lookback = default_lookback)
+        : m_cell_size(max(1, cell_size)), m_lookback(lookback) {}
+
+    /// All batches, in the order in which they need to be rendered.
+    const std::vector<Batch>& get_batches() const noexcept { return m_batches; }
+
+    /// Number of draws added since the last call to `clear`.
+    size_t get_draw_count() const noexcept { return m_next_draw.size(); }
+
+    /// Removes all draws and batches.
+    /// @param area     Area that is covered by the grid of cells until the next call to `clear`.
+    void clear(const Aabrf& area) {
+        m_batches.clear();
+        m_next_draw.clear();
+        m_cells.clear();
+        m_area = area;
+        m_column_count = max(1, static_cast<uint>(std::ceil(area.get_width() / m_cell_size)));
+        m_row_count = max(1, static_cast<uint>(std::ceil(area.get_height() / m_cell_size)));
+        m_words_per_batch = ((m_column_count * m_row_count) + cells_per_word - 1) / cells_per_word;
+    }
+
+    /// Adds a new draw.
+    /// @param key      State of the draw.
+    /// @param bounds   Area covered by the draw.
+    /// @returns        Index of the batch that the draw was added to.
+    size_t add(const Key& key, const Aabrf& bounds) {
+        const DrawIndex draw = narrow_cast<DrawIndex>(m_next_draw.size());
+        m_next_draw.emplace_back(no_draw);
+        const CellRange cells = _get_cell_range(bounds);
+
+        // find the nearest batch with the same key that the draw can be moved into, without passing a batch it overlaps
+        const size_t last_candidate = m_batches.size() > m_lookback ? m_batches.size() - m_lookback : 0;
+        for (size_t index = m_batches.size(); index > last_candidate; --index) {
+            Batch& batch = m_batches[index - 1];
+            if (batch.key == key) {
+                m_next_draw[batch.last_draw] = draw;
+                batch.last_draw = draw;
+                batch.bounds.unite(bounds);
+                ++batch.draw_count;
+                _set_cells(index - 1, cells);
+                return index - 1;
+            }
+
+            // the draw cannot be moved in front of a batch that it overlaps
+            if (batch.bounds.intersects(bounds) && _test_cells(index - 1, cells)) { break; }
+        }
+
+        // start a new batch
+        m_batches.emplace_back(Batch{key, bounds, draw, draw, 1});
+        m_cells.resize(m_cells.size() + m_words_per_batch, 0);
+        _set_cells(m_batches.size() - 1, cells);
+        return m_batches.size() - 1;
+    }
+
+    /// Calls the given function with the index of every draw in the given batch, in order.
+    /// @param batch    Batch to iterate.
+    /// @param function Function to call with each DrawIndex.
+    template<class Function>
+    void for_each_draw(const Batch& batch, Function&& function) const {
+        for (DrawIndex draw = batch.first_draw; draw != no_draw; draw = m_next_draw[draw]) {
+            function(draw);
+        }
+    }
+
+private:
+    /// Range of cells (inclusive) overlapped by the given rect, clamped to the grid.
+    CellRange _get_cell_range(const Aabrf& aabr) const {
+        const auto to_cell = [&](const float value, const float origin, const uint count) {
+            const float cell = std::floor((value - origin) / m_cell_size);
+            return static_cast<uint>(clamp(cell, 0, static_cast<float>(count - 1)));
+        };
+        return {to_cell(aabr.get_left(), m_area.get_left(), m_column_count),
+                to_cell(aabr.get_bottom(), m_area.get_bottom(), m_row_count),
+                to_cell(aabr.get_right(), m_area.get_left(), m_column_count),
+                to_cell(aabr.get_top(), m_area.get_bottom(), m_row_count)};
+    }
+
+    /// Marks all cells in the given range as touched by the given batch.
+    void _set_cells(const size_t batch, const CellRange& range) {
+        Word* words = &m_cells[batch * m_words_per_batch];
+        for (uint row = range.first_row; row <= range.last_row; ++row) {
+            for (uint column = range.first_column; column <= range.last_column; ++column) {
+                const uint cell = row * m_column_count + column;
+                words[cell / cells_per_word] |= Word(1) << (cell % cells_per_word);
+            }
+        }
+    }
+
+    /// Tests whether the given batch touches any cell in the given range.
+    bool _test_cells(const size_t batch, const CellRange& range) const {
+        const Word* words = &m_cells[batch * m_words_per_batch];
+        for (uint row = range.first_row; row <= range.last_row; ++row) {
+            for (uint column = range.first_column; column <= range.last_column; ++column) {
+                const uint cell = row * m_column_count + column;
+                if (words[cell / cells_per_word] & (Word(1) << (cell % cells_per_word))) { return true; }
+            }
+        }
+        return false;
+    }
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// All batches, in the order in which they need to be rendered.
+    std::vector<Batch> m_batches;
+
+    /// For each draw, the index of the next draw in the same batch.
+    std::vector<DrawIndex> m_next_draw;
+
+    /// Cells touched by each batch, `m_words_per_batch` words per batch.
+    std::vector<Word> m_cells;
+
+    /// Area covered by the grid of cells.
+    Aabrf m_area = Aabrf::zero();
+
+    /// Width and height of a single cell.
+    float m_cell_size;
+
+    /// Number of cells in horizontal direction.
+    uint m_column_count = 1;
+
+    /// Number of cells in vertical direction.
+    uint m_row_count = 1;
+
+    /// Number of words required to store the cells of a single batch.
+    size_t m_words_per_batch = 1;
+
+    /// Number of batches that a draw is allowed to skip.
+    size_t m_lookback;
+};
+
+NOTF_CLOSE_NAMESPACE
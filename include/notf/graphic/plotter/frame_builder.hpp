@@ -0,0 +1,415 @@
+#pragma once
+
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+#include "notf/graphic/drawcall_buffer.hpp"
+#include "notf/graphic/plotter/plotter.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// plotter frame builder ============================================================================================ //
+
+/// CPU side of the Plotter, builds the content of all of its buffers from the Designs drawn in a frame.
+///
+/// Designs are parsed into Fragments, which are retained across frames and merged again as long as their Design does
+/// not change. Merging stores the Paths of all draw calls in the vertex- and index buffer, where they stay resident for
+/// as long as they are drawn, and interns paints and clips. Once all Designs are merged, the draw calls are grouped
+/// into batches, each of which receives an indirect draw command and the per-instance parameters of its draw calls.
+///
+/// The FrameBuilder does not touch OpenGL, it writes into client-side buffers owned by the caller. The Plotter passes
+/// in the local data of its OpenGL buffers, uploads them and renders the batches. Without a Plotter, the FrameBuilder
+/// can be used to test and benchmark everything that happens before the upload.
+class Plotter::FrameBuilder {
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Vertex in the vertex buffer.
+    using Vertex = Vertices::vertex_t;
+
+    /// Index in the index buffer, relative to the first vertex of its Path.
+    using Index = Indices::index_t;
+
+    /// Paint uniform block in the paint buffer.
+    using PaintBlock = _PaintBlock;
+
+    /// Per-instance parameters of a single draw call.
+    using Instance = InstanceBuffer::vertex_t;
+
+    /// Indirect draw command of a single batch.
+    using Command = DrawCallBuffer::DrawCall;
+
+    /// Batch of draw calls that is rendered with a single OpenGL draw call.
+    using Batch = DrawBatcher<_BatchKey>::Batch;
+
+private:
+    /// A Path that is kept resident in the vertex- and index buffer across frames.
+    struct _ResidentPath {
+
+        /// Location of the Path in the buffers.
+        Path path;
+
+        /// Number of vertices of the Path in the vertex buffer.
+        uint vertex_count;
+
+        /// Number of frames in which the Path was drawn.
+        uint use_count = 0;
+
+        /// Last frame in which the Path was drawn.
+        size_t last_frame = 0;
+
+        /// Index of the Path in `m_paths`, only valid during `last_frame`.
+        uint frame_index = 0;
+    };
+
+    /// Text of a write call.
+    /// Glyphs are only looked up once the text is merged into the frame, because that might render new glyphs into
+    /// the font atlas, which must happen on the render thread.
+    struct _Text {
+
+        /// Index of the first character of the text in the `characters` of its Fragment.
+        uint first_character;
+
+        /// Number of characters (bytes) in the text.
+        uint character_count;
+
+        /// Font to write the text in.
+        FontPtr font;
+    };
+
+    /// Everything produced by parsing one or more PlotterDesigns, before it is merged into the frame.
+    /// Parsing reads from the Designs and writes into a Fragment only, so multiple Fragments can be produced in
+    /// parallel. All indices in the draw calls are local to the Fragment until it is merged.
+    struct _Fragment {
+
+        /// The current PainterState.
+        PainterState& get_state() {
+            NOTF_ASSERT(!states.empty());
+            return states.back();
+        }
+
+        /// Pops the current PainterState from the stack.
+        void pop_state() {
+            if (states.size() > 1) {
+                states.pop_back();
+            } else {
+                get_state() = {};
+            }
+        }
+
+        /// The characters of a text in this Fragment.
+        /// @param text     Text to look up.
+        std::string_view get_characters(const _Text& text) const {
+            return std::string_view(characters).substr(text.first_character, text.character_count);
+        }
+
+        /// Removes all content from the Fragment, but keeps the allocated memory around.
+        void clear() {
+            paths.clear();
+            texts.clear();
+            characters.clear();
+            xforms.clear();
+            clips.clear();
+            paints.clear();
+            drawcalls.clear();
+            states.clear();
+        }
+
+        /// Paths of all fill- and stroke calls.
+        std::vector<Path2Ptr> paths;
+
+        /// Texts of all write calls.
+        std::vector<_Text> texts;
+
+        /// Characters of all texts, so that storing a text does not allocate once the Fragment has grown.
+        std::string characters;
+
+        /// Transformations, referenced by the drawcalls.
+        std::vector<M3f> xforms;
+
+        /// Clips, referenced by the drawcalls.
+        std::vector<Aabrf> clips;
+
+        /// Paints, referenced by the drawcalls.
+        std::vector<FragmentPaint> paints;
+
+        /// Draw Calls.
+        std::vector<DrawCall> drawcalls;
+
+        /// State stack of the Design that is currently being parsed.
+        std::vector<PainterState> states;
+    };
+
+    /// Fragment of a single Design that is retained across frames.
+    /// As long as the Design is not re-recorded and drawn with the same base transformation and clip, its Fragment can
+    /// be merged again as it is. If only the translation of the base transformation changed, all transformations in the
+    /// Fragment are moved by the difference, which has the same result as parsing the Design again.
+    struct _RetainedFragment {
+
+        /// Generation of the Design when it was parsed.
+        size_t generation = 0;
+
+        /// Base transformation that the Design was parsed with.
+        M3f base_xform;
+
+        /// Clip that the Design was parsed with.
+        Aabrf clip;
+
+        /// Last frame in which the Fragment was merged.
+        size_t last_frame = 0;
+
+        /// The parsed Design.
+        _Fragment fragment;
+    };
+
+    /// A Design drawn in a frame, used to find the area that changed from one frame to the next.
+    struct _DrawnDesign {
+
+        /// The drawn Design.
+        const PlotterDesign* design;
+
+        /// Area covered by all draw calls of the Design, in screen space.
+        Aabrf bounds = Aabrf::wrongest();
+
+        /// Whether the Design was parsed or moved in this frame.
+        bool is_changed;
+
+        /// Whether the Design contains text with Glyphs that are still rasterized in the background.
+        /// The Design is damaged in the following frame, when the Glyphs are (hopefully) ready.
+        bool has_pending_glyphs = false;
+    };
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    NOTF_NO_COPY_OR_ASSIGN(FrameBuilder);
+
+    /// Constructor.
+    /// All buffers must outlive the FrameBuilder. The vertex- and index buffer keep the resident Paths across frames
+    /// and must not be modified by anyone else, all other buffers are re-written in every frame.
+    /// @param vertices     Vertex buffer.
+    /// @param indices      Index buffer.
+    /// @param paints       Paint buffer.
+    /// @param instances    Instance buffer, receives the per-instance parameters of all batches.
+    /// @param commands     Indirect draw buffer, receives one draw command per batch.
+    FrameBuilder(std::vector<Vertex>& vertices, std::vector<Index>& indices, std::vector<PaintBlock>& paints,
+                 std::vector<Instance>& instances, std::vector<Command>& commands);
+
+    /// Restores the FrameBuilder into a neutral state before parsing any designs.
+    void start_frame();
+
+    /// Paints the Design of the given Widget.
+    /// @param design       Design to parse.
+    /// @param base_xform   Base widget transformation.
+    /// @param clip         Clipping Aabr, in space transformed by `base_xform`.
+    void parse(const PlotterDesign& design, const M3f& base_xform, const Aabrf& clip = Aabrf::wrongest());
+
+    /// Paints the Designs of multiple Widgets, in order.
+    /// Designs that need to be parsed are split into chunks that are parsed in parallel on the given ThreadPool (and
+    /// the calling thread), before the results are merged in order. The result is the same as calling `parse` with
+    /// each Design in turn.
+    /// @param designs      Designs to parse.
+    /// @param thread_pool  ThreadPool to parse the Designs on.
+    void parse(const std::vector<DesignInstance>& designs, ThreadPool& thread_pool);
+
+    /// Area of the screen that differs from the last frame, call after parsing the last design.
+    /// Contains the old and new bounds of all Designs that were added, removed, changed or moved since the last frame.
+    /// Designs are compared in draw order, so Designs that are drawn in a different order count as changed as well.
+    /// @returns    The damaged area in pixels, is zero if the frame looks exactly like the last one.
+    Aabri get_damage();
+
+    /// Call after parsing the last design.
+    /// Appends the text of this frame to the buffers, groups all draw calls into batches and writes the instance- and
+    /// indirect draw buffer.
+    /// @param render_area  Area covered by the grid of the DrawBatcher.
+    /// @param visible_area Draw calls outside of this area are removed.
+    void finish_frame(const Aabrf& render_area, const Aabrf& visible_area = Aabrf::largest());
+
+    /// All draw calls stored in this frame, after `finish_frame` only those that were not culled.
+    /// The draws of the batches index into this vector.
+    const std::vector<DrawCall>& get_drawcalls() const { return m_drawcalls; }
+
+    /// All Paths referenced by the draw calls of this frame.
+    const std::vector<Path>& get_paths() const { return m_paths; }
+
+    /// All batches of this frame, in the order in which they need to be rendered.
+    /// Batch `i` is rendered with the draw command at index `i`.
+    const std::vector<Batch>& get_batches() const { return m_batcher.get_batches(); }
+
+    /// First vertex in the vertex buffer that changed since the last call to `clear_dirty`.
+    uint get_dirty_vertex() const { return m_dirty_vertex; }
+
+    /// First index in the index buffer that changed since the last call to `clear_dirty`.
+    uint get_dirty_index() const { return m_dirty_index; }
+
+    /// Call after all changed vertices and indices were uploaded.
+    void clear_dirty() {
+        m_dirty_vertex = m_resident_vertex_count;
+        m_dirty_index = m_resident_index_count;
+    }
+
+    /// @{
+    /// Counters describing the work done in the last frame.
+    const FrameStatistics& get_statistics() const { return m_statistics; }
+    FrameStatistics& get_statistics() { return m_statistics; }
+    /// @}
+
+    /// Tessellates a Path2 into the given vertex- and index buffers.
+    /// @param path     Path2 to tessellate.
+    /// @param vertices Vertex buffer to append to.
+    /// @param indices  Index buffer to append to.
+    /// @returns        Location of the new Path in the given buffers.
+    static Path tessellate_path(const Path2& path, std::vector<Vertex>& vertices, std::vector<Index>& indices);
+
+private:
+    /// Removes all resident Paths that were not drawn for too long.
+    void _evict_paths();
+
+    /// Moves all resident Paths to the front of the buffers, ordered by how often they were drawn.
+    void _compact_paths();
+
+    /// Stores a path or returns the index of an existing path.
+    uint _store_path(const Path2Ptr& path);
+
+    /// Looks up the Fragment retained for the given Design and patches it, if it can be re-used in this frame.
+    /// @param design   Design to find the Fragment for.
+    /// @returns        Fragment of the Design and whether the Design needs to be parsed into it first.
+    std::pair<_Fragment*, bool> _retain_fragment(const DesignInstance& design);
+
+    /// Parses a single Design into the given Fragment.
+    /// Does not touch the FrameBuilder and can be called from any thread.
+    /// @param design   Design to parse.
+    /// @param fragment Fragment to append to.
+    static void _parse(const DesignInstance& design, _Fragment& fragment);
+
+    /// Stores all basic call information in the passed call.
+    static void _store_call_base(_Fragment& fragment, _CallBase& call);
+
+    /// Store a new fill call.
+    static void _store_fill_call(_Fragment& fragment);
+
+    /// Store a new stroke call.
+    static void _store_stroke_call(_Fragment& fragment);
+
+    /// Store a new write call.
+    static void _store_write_call(_Fragment& fragment, std::string_view text);
+
+    /// Appends all draw calls of the given Fragment to the ones of this frame.
+    /// Paths, paints and texts of the Fragment are stored in the buffers, and all indices are updated to match.
+    /// @param fragment Fragment to merge.
+    /// @param drawn    Entry of the Design in `m_drawn_designs`, receives the bounds of the Fragment.
+    void _merge_fragment(const _Fragment& fragment, _DrawnDesign& drawn);
+
+    /// Stores a paint or returns the index of an equal paint stored earlier in this frame.
+    uint _store_paint(const FragmentPaint& paint);
+
+    /// Stores a clip or returns the index of an equal clip stored earlier in this frame.
+    uint _store_clip(const Aabrf& clip);
+
+    /// Creates the glyph quads of a text and stores them as a new Path.
+    /// @param text         UTF-8 encoded text to store.
+    /// @param font         Font to write the text in.
+    /// @param xform        Transformation of the text, glyphs are only translated.
+    /// @param has_pending  Is set to true if the text contains Glyphs that are still rasterized in the background.
+    /// @returns            Index of the new Path in `m_paths`.
+    uint _store_text(std::string_view text, const Font& font, const M3f& xform, bool& has_pending);
+
+    /// Area covered by a draw call in screen space.
+    Aabrf _get_bounds(const DrawCall& drawcall) const;
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Vertices used to construct paths and glyphs.
+    std::vector<Vertex>& m_vertices;
+
+    /// Indices into the vertex buffer.
+    std::vector<Index>& m_indices;
+
+    /// Paint uniform blocks.
+    std::vector<PaintBlock>& m_paint_blocks;
+
+    /// Per-instance draw parameters, grouped by batch.
+    std::vector<Instance>& m_instances;
+
+    /// Indirect draw commands, one for each batch.
+    std::vector<Command>& m_commands;
+
+    /// Index of each FragmentPaint in the paint buffer.
+    /// Paints are interned per frame, so that all draw calls with the same paint share a single entry in the buffer.
+    std::unordered_map<FragmentPaint, uint, _FragmentPaintHash> m_paint_indices;
+
+    /// All paths, referenced by the drawcalls.
+    std::vector<Path> m_paths;
+
+    /// Paths resident in the vertex- and index buffer.
+    /// Paths are stored in local space, tessellated and uploaded once, no matter how often or with how many different
+    /// transformations they are drawn. They are only evicted after they haven't been drawn for a number of frames,
+    /// which increases with the number of frames in which they were drawn.
+    std::unordered_map<Path2Ptr, _ResidentPath> m_resident_paths;
+
+    /// Number of vertices and indices at the front of the buffers that are occupied by resident Paths (and holes left
+    /// by evicted ones). Everything after that is re-written every frame.
+    uint m_resident_vertex_count = 0;
+    uint m_resident_index_count = 0;
+
+    /// Number of vertices and indices in the resident part of the buffers that belong to evicted Paths.
+    uint m_evicted_vertex_count = 0;
+    uint m_evicted_index_count = 0;
+
+    /// First vertex and index that needs to be uploaded at the end of this frame.
+    uint m_dirty_vertex = 0;
+    uint m_dirty_index = 0;
+
+    /// Vertices and indices of all text in this frame, are appended to the buffers after all resident Paths.
+    std::vector<Vertex> m_text_vertices;
+    std::vector<Index> m_text_indices;
+
+    /// Indices in `m_paths` of all text Paths, whose offsets are relative to the start of the text buffers.
+    std::vector<uint> m_text_paths;
+
+    /// Number of the current frame, used to determine the age of resident Paths.
+    size_t m_frame = 0;
+
+    /// Counters describing the work done in the last frame.
+    FrameStatistics m_statistics;
+
+    /// Transformations, referenced by the drawcalls.
+    std::vector<M3f> m_xforms;
+
+    /// Clips, referenced by the drawcalls
+    std::vector<Aabrf> m_clips;
+
+    /// Index of each clip in `m_clips`.
+    /// Like paints, clips are interned per frame, so that draw calls of different Designs can be batched.
+    std::unordered_map<Aabrf, uint> m_clip_indices;
+
+    /// Interned index of each clip of the Fragment that is currently being merged.
+    std::vector<uint> m_fragment_clips;
+
+    /// Draw Calls.
+    std::vector<DrawCall> m_drawcalls;
+
+    /// Groups the draw calls into batches that are rendered with a single OpenGL draw call each.
+    DrawBatcher<_BatchKey> m_batcher;
+
+    /// Fragments of all Designs drawn in the last frame, retained until their Design is no longer drawn.
+    std::unordered_map<const PlotterDesign*, _RetainedFragment> m_retained_fragments;
+
+    /// Fragments for Designs that are drawn more than once per frame with a different base transformation or clip.
+    /// Are kept around between frames so their memory can be re-used.
+    std::deque<_Fragment> m_extra_fragments;
+
+    /// Number of extra Fragments used in this frame.
+    size_t m_extra_fragment_count = 0;
+
+    /// All Designs drawn in this frame, in draw order.
+    std::vector<_DrawnDesign> m_drawn_designs;
+
+    /// All Designs drawn in the last frame, in draw order.
+    std::vector<_DrawnDesign> m_last_drawn_designs;
+
+    /// Whether the last parsed frame was finished, frames without damage are parsed but never rendered.
+    bool m_is_frame_finished = true;
+};
+
+NOTF_CLOSE_NAMESPACE
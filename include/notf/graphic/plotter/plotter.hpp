@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unordered_map>
+#include <memory>
 
 #include "notf/common/color.hpp"
 #include "notf/common/geo/aabr.hpp"
@@ -9,7 +9,9 @@
 #include "notf/common/geo/polyline.hpp"
 #include "notf/common/geo/size2.hpp"
 #include "notf/common/geo/triangle.hpp"
+#include "notf/common/geo/vector4.hpp"
 
+#include "notf/graphic/plotter/draw_batcher.hpp"
 #include "notf/graphic/vertex_object.hpp"
 
 NOTF_OPEN_NAMESPACE
@@ -40,6 +42,10 @@ private:
         using type = M3f;
     };
 
+    struct _StrokeAttribute {
+        using type = V4f;
+    };
+
 public:
     // internal buffers -------------------------------------------------------
 
@@ -51,9 +57,10 @@ public:
     using Indices = IndexBuffer<GLuint>;
     using IndicesPtr = std::shared_ptr<Indices>;
 
-    /// OpenGL buffer holding per-instance 2D transformations.
-    using XformBuffer = vertex_buffer_t<_XformAttribute>;
-    using XformBufferPtr = std::shared_ptr<XformBuffer>;
+    /// OpenGL buffer holding per-instance draw parameters.
+    /// Each instance consists of a 2D transformation and the stroke width, cap- and joint style as floats.
+    using InstanceBuffer = vertex_buffer_t<_XformAttribute, _StrokeAttribute>;
+    using InstanceBufferPtr = std::shared_ptr<InstanceBuffer>;
 
     // paint ------------------------------------------------------------------
 
@@ -162,7 +169,7 @@ public:
         M3f xform = M3f::identity();
 
         /// Clipping rect (in painter space).
-        Aabrf clip;
+        Aabrf clip = Aabrf::zero();
 
         /// Global alpha of the painter, is multiplied on top of the Paint's alpha.
         float alpha = 1;
@@ -184,6 +191,102 @@ public:
     };
     static_assert(sizeof(PainterState) == 176);
 
+    // statistics -------------------------------------------------------------
+
+    /// Counters describing the work done by the Plotter in the last frame.
+    struct FrameStatistics {
+
+        /// Number of bytes uploaded into all server buffers.
+        size_t bytes_uploaded = 0;
+
+        /// Number of Paths that were drawn from the server buffers without being uploaded again.
+        uint paths_reused = 0;
+
+        /// Number of Paths that were tessellated and added to the server buffers.
+        uint paths_added = 0;
+
+        /// Number of Paths that were evicted from the server buffers because they were not drawn for too long.
+        uint paths_evicted = 0;
+
+        /// Number of Paths resident in the server buffers.
+        uint paths_resident = 0;
+
+        /// Number of draw calls stored while parsing.
+        uint calls_stored = 0;
+
+        /// Number of OpenGL draw calls issued to render all stored calls.
+        uint draw_calls = 0;
+
+        /// Number of stored draw calls that were skipped, because they are outside the scissor area.
+        uint calls_culled = 0;
+
+        /// Number of OpenGL calls issued to change the server state in-between draw calls.
+        uint state_changes = 0;
+
+        /// Number of paints referenced by the stored draw calls.
+        uint paints_stored = 0;
+
+        /// Number of unique paints uploaded into the paint buffer.
+        uint paints_uploaded = 0;
+
+        /// Number of Designs whose retained Fragment was re-used without changes.
+        uint designs_reused = 0;
+
+        /// Number of Designs whose retained Fragment was re-used after moving it to a new base transformation.
+        uint designs_patched = 0;
+
+        /// Number of Designs that had to be parsed.
+        uint designs_parsed = 0;
+
+        /// Number of Designs that were added, removed, changed or moved since the last frame.
+        uint designs_damaged = 0;
+
+        /// Number of texts whose layout was found in the TextLayoutCache.
+        uint text_layouts_reused = 0;
+
+        /// Number of texts that had to be laid out.
+        uint text_layouts_created = 0;
+
+        /// Ratio of Designs that did not have to be parsed.
+        float get_design_hit_ratio() const noexcept {
+            const uint hits = designs_reused + designs_patched;
+            const uint total = hits + designs_parsed;
+            return total == 0 ? 1 : static_cast<float>(hits) / static_cast<float>(total);
+        }
+
+        /// Ratio of texts whose layout did not have to be computed.
+        float get_text_layout_hit_ratio() const noexcept {
+            const uint total = text_layouts_reused + text_layouts_created;
+            return total == 0 ? 1 : static_cast<float>(text_layouts_reused) / static_cast<float>(total);
+        }
+
+        /// How many draw calls share a single uploaded paint on average.
+        float get_paint_dedup_ratio() const noexcept {
+            return paints_uploaded == 0 ? 1 : static_cast<float>(paints_stored) / static_cast<float>(paints_uploaded);
+        }
+    };
+
+    // design instance --------------------------------------------------------
+
+    /// A PlotterDesign together with the auxiliary information required to parse it.
+    struct DesignInstance {
+
+        /// Design to parse.
+        const PlotterDesign* design;
+
+        /// Base widget transformation.
+        M3f base_xform = M3f::identity();
+
+        /// Clipping Aabr, in space transformed by `base_xform`.
+        Aabrf clip = Aabrf::wrongest();
+    };
+
+    // frame builder ----------------------------------------------------------
+
+    /// CPU side of the Plotter, builds the content of its buffers without an OpenGL context.
+    /// Defined in `frame_builder.hpp`.
+    class FrameBuilder;
+
 private:
     /// Type of the patch to draw.
     enum PatchType : int {
@@ -200,18 +303,9 @@ private:
         /// Global alpha of the painter, is multiplied on top of the Paint's alpha.
         float alpha = -1;
 
-        /// Width of a stroked line.
-        float stroke_width = -1;
-
         /// How the paint is blended with the existing image underneath.
         BlendMode blend_mode = BlendMode::_DEFAULT;
 
-        /// Shape at the end of a line.
-        CapStyle cap_style = CapStyle::_CURRENT;
-
-        /// How different line segments are connected.
-        JointStyle joint_style = JointStyle::_CURRENT;
-
         /// Screen size.
         Size2i screen_size = Size2i::zero();
 
@@ -228,8 +322,8 @@ private:
         /// Index at which the paint buffer is bound.
         uint paint_index = 0;
 
-        /// Index at which the xform buffer is bound.
-        uint xform_index = 0;
+        /// Index of the first element in the instance buffer that the per-instance attributes read from.
+        uint instance_index = max_v<uint>;
 
         /// Index at which the clip buffer is bound.
         uint clip_index = 0;
@@ -251,6 +345,9 @@ private:
         /// Center of this Path in local space.
         V2f center;
 
+        /// Bounds of this Path in local space.
+        Aabrf bounds;
+
         /// Whether this Path is convex or concave.
         bool is_convex;
     };
@@ -262,7 +359,7 @@ private:
         /// Index in `m_paths` of the Path to draw.
         uint path;
 
-        /// Index in `m_xform_buffer` of the 2D transformation to apply to the path.
+        /// Index in `m_xforms` of the 2D transformation to apply to the path.
         uint xform;
 
         /// Index of the FragmentPaint in `m_paint_buffer`.
@@ -295,6 +392,33 @@ private:
 
     using DrawCall = std::variant<_StrokeCall, _FillCall, _WriteCall>;
 
+    /// All state that must be equal for two draw calls to be rendered with a single OpenGL draw call.
+    /// Transformation and stroke parameters are per-instance attributes and can differ.
+    struct _BatchKey {
+
+        /// Equality operator.
+        /// @param other    Key to compare against.
+        bool operator==(const _BatchKey& other) const {
+            return type == other.type && path == other.path && paint == other.paint && clip == other.clip
+                   && blend_mode == other.blend_mode;
+        }
+
+        /// Index of the DrawCall type in the variant.
+        size_t type;
+
+        /// Index in `m_paths` of the Path to draw.
+        uint path;
+
+        /// Index of the FragmentPaint in `m_paint_buffer`.
+        uint paint;
+
+        /// Index in `m_clips` of the Clip to apply.
+        uint clip;
+
+        /// How the paint is blended with the existing image underneath.
+        BlendMode blend_mode;
+    };
+
     static_assert(sizeof(_FillCall) == 24);
     static_assert(sizeof(_WriteCall) == 24);
     static_assert(sizeof(_StrokeCall) == 28);
@@ -323,6 +447,11 @@ private:
         FragmentPaint(const Paint& paint, const Type type = Type::GRADIENT) : FragmentPaint(paint, {}, 0, type) {}
         /// @}
 
+        /// Equality comparison operator.
+        /// Unlike Paint, FragmentPaints are compared exactly, so that equal FragmentPaints also have the same hash.
+        /// @param other    FragmentPaint to compare against.
+        bool operator==(const FragmentPaint& other) const noexcept;
+
         // fields ---------------------------------------------------------------------------------- //
     public:                                          // offset in basic machine units
         std::array<float, 4> paint_rotation = {};    //  0 (size = 4)
@@ -340,6 +469,28 @@ private:
     };                                               // total size is: 28
     friend ::std::hash<FragmentPaint>;
 
+    /// Hash functor for FragmentPaints, forwards to the std::hash specialization.
+    /// The specialization itself cannot be declared before it is used in the definition of the Plotter.
+    struct _FragmentPaintHash {
+        size_t operator()(const FragmentPaint& paint) const;
+    };
+
+    /// FragmentPaint in the paint buffer, padded so that every block starts at an offset that can be bound on its own.
+    /// OpenGL ES does not allow a GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT of more than 256 bytes.
+    struct _PaintBlock {
+
+        /// Constructor.
+        /// @param paint    Paint to store in the block.
+        explicit _PaintBlock(const FragmentPaint& paint) : paint(paint) {}
+
+        /// Paint read by the shader.
+        FragmentPaint paint;
+
+        /// Padding up to the largest possible uniform buffer offset alignment.
+        std::array<char, 256 - sizeof(FragmentPaint)> padding = {};
+    };
+    friend ::std::hash<_PaintBlock>;
+
     // methods --------------------------------------------------------------------------------- //
 public:
     NOTF_NO_COPY_OR_ASSIGN(Plotter);
@@ -361,50 +512,50 @@ public:
     /// @param clip         Clipping Aabr, in space transformed by `base_xform`.
     void parse(const PlotterDesign& design, const M3f& base_xform, const Aabrf& clip = Aabrf::wrongest());
 
-    /// Call after parsing the last design.
-    /// Uploads all buffers to the GPU and enqueues all draw calls
-    void finish_parsing();
-
-private:
-    /// The current PainterState.
-    const PainterState& _get_state() const {
-        NOTF_ASSERT(!m_states.empty());
-        return m_states.back();
-    }
-    PainterState& _get_state() { return NOTF_FORWARD_CONST_AS_MUTABLE(_get_state()); }
-
-    /// Pops the current PainterState from the stack.
-    void _pop_state() {
-        if (m_states.size() > 1) {
-            m_states.pop_back();
-        } else {
-            _get_state() = {};
-        }
-    }
-
-    /// Stores a path or returns the index of an existing path.
-    uint _store_path(const Path2Ptr& path);
+    /// Paints the Designs of multiple Widgets, in order.
+    /// Designs that need to be parsed are split into chunks that are parsed in parallel on the given ThreadPool (and
+    /// the calling thread), before the results are merged in order. The result is the same as calling `parse` with
+    /// each Design in turn.
+    /// @param designs      Designs to parse.
+    /// @param thread_pool  ThreadPool to parse the Designs on.
+    void parse(const std::vector<DesignInstance>& designs, ThreadPool& thread_pool);
 
-    /// Stores all basic call information in the passed call.
-    void _store_call_base(_CallBase& call);
+    /// Area of the screen that differs from the last frame, call after parsing the last design.
+    /// Contains the old and new bounds of all Designs that were added, removed, changed or moved since the last frame.
+    /// Designs are compared in draw order, so Designs that are drawn in a different order count as changed as well.
+    /// @returns    The damaged area in pixels, is zero if the frame looks exactly like the last one.
+    Aabri get_damage();
 
-    /// Store a new fill call.
-    void _store_fill_call();
+    /// Call after parsing the last design.
+    /// Uploads all buffers to the GPU and enqueues all draw calls.
+    /// If the scissor test is enabled, draw calls outside of the scissor area are skipped.
+    void finish_parsing();
 
-    /// Store a new stroke call.
-    void _store_stroke_call();
+    /// Counters describing the work done by the Plotter in the last frame.
+    const FrameStatistics& get_statistics() const;
 
-    /// Store a new write call.
-    void _store_write_call(std::string text);
+private:
+    /// Makes sure that the per-instance attributes are read starting at the given index in the instance buffer.
+    /// @param instance_index   Index of the first instance of the next draw call.
+    void _bind_instances(uint instance_index);
 
     /// Fill implementation.
-    void _render_fill(const _FillCall& call);
+    /// @param call             First call in the batch.
+    /// @param first_instance   Index of the first instance of the batch in the instance buffer.
+    /// @param command          Index of the batch in the drawcall buffer.
+    void _render_fill(const _FillCall& call, uint first_instance, size_t command);
 
     /// Stroke implementation.
-    void _render_stroke(const _StrokeCall& call);
+    /// @param call             First call in the batch.
+    /// @param first_instance   Index of the first instance of the batch in the instance buffer.
+    /// @param command          Index of the batch in the drawcall buffer.
+    void _render_stroke(const _StrokeCall& call, uint first_instance, size_t command);
 
     /// Write implementation.
-    void _render_text(const _WriteCall& call);
+    /// @param call             First call in the batch.
+    /// @param first_instance   Index of the first instance of the batch in the instance buffer.
+    /// @param command          Index of the batch in the drawcall buffer.
+    void _render_text(const _WriteCall& call, uint first_instance, size_t command);
 
     // fields ---------------------------------------------------------------------------------- //
 private:
@@ -421,31 +572,20 @@ private:
     /// Indices into the vertex buffer.
     IndicesPtr m_index_buffer;
 
-    /// Buffer containing per-instance transformations.
-    XformBufferPtr m_xform_buffer;
+    /// Buffer containing per-instance draw parameters, grouped by batch.
+    InstanceBufferPtr m_instance_buffer;
+
+    /// Indirect draw commands, one for each batch.
+    DrawCallBufferPtr m_drawcall_buffer;
 
     /// Internal vertex object managing attribute- and buffer bindings.
     VertexObjectPtr m_vertex_object;
 
     /// Uniform buffer containing the paint uniform blocks.
-    UniformBufferPtr<FragmentPaint> m_paint_buffer;
-
-    /// All paths, referenced by the drawcalls.
-    std::vector<Path> m_paths;
-
-    /// Quick map from an existing Path to an index in `m_paths`.
-    std::unordered_map<Path2Ptr, uint> m_path_lookup;
-
-    /// Clips, referenced by the drawcalls
-    std::vector<Aabrf> m_clips;
-
-    /// Draw Calls.
-    std::vector<DrawCall> m_drawcalls;
+    UniformBufferPtr<_PaintBlock> m_paint_buffer;
 
-    /// State of the next draw call.
-    /// Is controlled by a parsed Design and can cheaply be updated as no OpenGL calls are made until the next stroke,
-    /// fill or write-call at which the current state is matched against the server state.
-    std::vector<PainterState> m_states;
+    /// Builds the content of all buffers from the parsed Designs.
+    std::unique_ptr<FrameBuilder> m_frame_builder;
 
     /// Actual GPU state.
     InternalState m_server_state;
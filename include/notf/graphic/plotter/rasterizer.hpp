@@ -0,0 +1,148 @@
+#pragma once
+
+#include "notf/graphic/plotter/tessellator.hpp"
+#include "notf/graphic/text/font.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// plotter rasterizer =============================================================================================== //
+
+/// Renders PlotterDesigns into an image in memory, without a window or an OpenGL context.
+///
+/// The image has the same layout as a RawImage with 4 channels: 8 bits per channel in RGBA order, premultiplied with
+/// alpha, and the first row of pixels is the top row of the image. Like the Plotter, the Rasterizer uses a coordinate
+/// system with its origin in the bottom-left corner of the image and the y-axis pointing up.
+///
+/// Fills and strokes are flattened by a PathTessellator. Their coverage is computed exactly per pixel from the signed
+/// area of all edges in a pixel, accumulated from left to right. Overlapping areas (like the joints of a stroke or
+/// subpaths with the same orientation) follow the non-zero rule, and the absolute winding number is clamped to one.
+/// Coverage is then blended into the image one span of pixels at a time, using the Paint and BlendMode of the Painter.
+///
+/// Textures live on the GPU, so textured Paints are drawn with their inner color. Glyphs are rendered from a copy of
+/// the font atlas that has to be provided by the user with `set_font_atlas`, without it text is not drawn at all.
+/// Bitmap Glyphs are copied onto the pixel grid and can only be translated, distance field Glyphs follow the full
+/// transformation of the Painter.
+class PlotterRasterizer {
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    /// Constructor.
+    /// @param size         Size of the image in pixels.
+    /// @param tolerance    Maximum distance between a curve and its approximation, in pixels.
+    /// @throws ValueError  If the size is not valid.
+    explicit PlotterRasterizer(const Size2i& size, float tolerance = PathTessellator::default_tolerance);
+
+    /// Size of the image in pixels.
+    const Size2i& get_size() const { return m_size; }
+
+    /// Number of channels per pixel.
+    static constexpr int get_channels() { return 4; }
+
+    /// Raw image data.
+    const uchar* get_data() const { return m_pixels.data(); }
+
+    /// Fills the whole image with a single color.
+    /// @param color    Color to clear the image with.
+    void clear(const Color& color = Color::transparent());
+
+    /// Sets the font atlas used to render text.
+    /// Has the same content as the texture of the FontAtlas: one byte of coverage per pixel, with each Glyph stored at
+    /// its `Glyph::rect` and the first row of its bitmap at the lowest y-coordinate.
+    /// @param pixels       Coverage of all pixels in the atlas, row by row.
+    /// @param size         Size of the atlas in pixels.
+    /// @throws ValueError  If the number of pixels does not match the size of the atlas.
+    void set_font_atlas(std::vector<uchar> pixels, const Size2i& size);
+
+    /// Renders all Commands of a Design into the image.
+    /// @param design       Design to render.
+    /// @param base_xform   Base transformation of the Design.
+    /// @param clip         Clipping Aabr, in space transformed by `base_xform`.
+    void draw(const PlotterDesign& design, const M3f& base_xform = M3f::identity(),
+              const Aabrf& clip = Aabrf::wrongest());
+
+    /// Fills the Path of the given state.
+    /// @param state    State to fill, its clip is in image space.
+    void fill(const Plotter::PainterState& state);
+
+    /// Strokes the Path of the given state.
+    /// @param state    State to stroke, its clip is in image space.
+    void stroke(const Plotter::PainterState& state);
+
+    /// Writes a sequence of Glyphs, starting at the origin of the given state.
+    /// @param glyphs               Glyphs to write.
+    /// @param state                State to write with, its clip is in image space.
+    /// @param is_distance_field    Whether the Glyphs are signed distance fields (see `Font::is_distance_field`).
+    void write(const std::vector<Glyph>& glyphs, const Plotter::PainterState& state,
+               const bool is_distance_field = false);
+
+private:
+    /// Writes a sequence of distance field Glyphs, transformed by the transformation of the given state.
+    /// @param glyphs   Glyphs to write.
+    /// @param state    State to write with, its clip is in image space.
+    void _write_distance_field(const std::vector<Glyph>& glyphs, const Plotter::PainterState& state);
+
+    /// Intersects the given bounds with the image and the clip of the state.
+    /// @param bounds   Bounds of the geometry to render, in image space.
+    /// @param state    Current state.
+    /// @returns        The pixels to render, is empty if nothing is visible.
+    Aabri _get_region(const Aabrf& bounds, const Plotter::PainterState& state) const;
+
+    /// Prepares the coverage buffer for rendering the given region.
+    /// @param region   Pixels to render.
+    void _begin_coverage(const Aabri& region);
+
+    /// Adds the signed area of a single edge to the coverage buffer.
+    /// @param from     Start of the edge in image space.
+    /// @param to       End of the edge in image space.
+    void _add_edge(V2f from, V2f to);
+
+    /// Blends the Paint of the given state into all pixels in the current region, weighted by their coverage.
+    /// Leaves the coverage buffer empty.
+    /// @param state    Current state.
+    void _end_coverage(const Plotter::PainterState& state);
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Size of the image in pixels.
+    Size2i m_size;
+
+    /// Pixels of the image, 4 bytes per pixel.
+    std::vector<uchar> m_pixels;
+
+    /// Coverage of all pixels in the font atlas.
+    std::vector<uchar> m_font_atlas;
+
+    /// Size of the font atlas in pixels.
+    Size2i m_font_atlas_size = Size2i::zero();
+
+    /// Maximum distance between a curve and its approximation, in pixels.
+    float m_tolerance;
+
+    /// Tessellator used to flatten and stroke Paths.
+    PathTessellator m_tessellator;
+
+    /// Flattened Path that is currently filled.
+    PathTessellator::Contours m_contours;
+
+    /// Mesh of the stroke that is currently rendered.
+    PathTessellator::Mesh m_mesh;
+
+    /// Pixels covered by the current fill, stroke or write.
+    Aabri m_region;
+
+    /// Signed area of all edges per pixel in the current region, with two additional pixels per row.
+    /// Is all zeros in-between renders.
+    std::vector<float> m_coverage;
+
+    /// Coverage and colors of a single row of pixels, used while blending.
+    std::vector<float> m_row_coverage;
+    std::vector<float> m_row_colors;
+
+    /// State stack used while drawing a Design.
+    std::vector<Plotter::PainterState> m_states;
+
+    /// Glyphs of the text that is currently written.
+    std::vector<Glyph> m_glyphs;
+};
+
+NOTF_CLOSE_NAMESPACE
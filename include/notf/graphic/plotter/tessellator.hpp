@@ -0,0 +1,212 @@
+#pragma once
+
+#include "notf/graphic/plotter/plotter.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// path tessellator ================================================================================================= //
+
+/// Turns Path2s into triangles on the CPU.
+/// Is used by the PlotterRasterizer, the OpenGL Plotter still tessellates its Paths with tessellation shaders.
+///
+/// Bezier segments are flattened into line segments, with the number of line segments chosen so that the distance
+/// between the curve and its approximation never exceeds the tolerance. Fills are triangulated as a fan if the Path is
+/// convex, by ear clipping if it consists of a single concave subpath and as a stencil fan (see `Mesh::needs_stencil`)
+/// otherwise. Strokes are made up of one quad per line segment, plus the triangles of all joints and caps.
+///
+/// All Meshes are produced in the space of the Path, so the tolerance and the stroke width have to be given in that
+/// space as well. A Tessellator keeps its intermediate buffers around, so re-using a Tessellator does not allocate
+/// once its buffers have grown large enough. Tessellators are not thread-safe, use one Tessellator per thread instead.
+class PathTessellator {
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Triangle mesh.
+    struct Mesh {
+
+        /// Removes all triangles, but keeps the allocated memory around.
+        void clear() {
+            vertices.clear();
+            indices.clear();
+            needs_stencil = false;
+        }
+
+        /// Number of triangles in the Mesh.
+        size_t get_triangle_count() const { return indices.size() / 3; }
+
+        /// Vertices of the Mesh.
+        std::vector<V2f> vertices;
+
+        /// Three indices per triangle.
+        std::vector<uint> indices;
+
+        /// If false, no two triangles overlap and the Mesh can be drawn as is.
+        /// Otherwise the Mesh covers all points with a non-zero winding number, where counterclockwise triangles count
+        /// +1 and clockwise triangles -1. Such a Mesh has to be drawn into the stencil buffer first.
+        bool needs_stencil = false;
+    };
+
+    /// Flattened subpaths of a Path2.
+    struct Contours {
+
+        /// A single flattened subpath.
+        struct Contour {
+
+            /// Index of the first point of the Contour.
+            uint first_point;
+
+            /// Number of points in the Contour.
+            uint point_count;
+
+            /// Whether the last point is connected to the first one.
+            bool is_closed;
+        };
+
+        /// Removes all Contours, but keeps the allocated memory around.
+        void clear() {
+            points.clear();
+            contours.clear();
+        }
+
+        /// Points of all Contours.
+        std::vector<V2f> points;
+
+        /// All Contours.
+        std::vector<Contour> contours;
+    };
+
+    /// A Path2 to tessellate with `tessellate`.
+    struct Job {
+
+        /// Path to tessellate.
+        Path2Ptr path;
+
+        /// Width of the stroke, if zero the Path is filled.
+        float stroke_width = 0;
+
+        /// Shape at the end of a stroked line.
+        Plotter::CapStyle cap = Plotter::CapStyle::BUTT;
+
+        /// How the line segments of a stroke are connected.
+        Plotter::JointStyle joint = Plotter::JointStyle::MITER;
+    };
+
+    /// Default tolerance, a quarter of a pixel if the Path is drawn without scaling.
+    static constexpr float default_tolerance = 0.25f;
+
+    /// Default ratio between the length of a miter and the stroke width, above which a miter is drawn as a bevel.
+    static constexpr float default_miter_limit = 4;
+
+    /// Maximum number of line segments that a single bezier segment is flattened into.
+    static constexpr uint max_segment_subdivisions = 256;
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    /// Constructor.
+    /// @param tolerance    Maximum distance between a curve and its approximation.
+    /// @param miter_limit  Ratio between the length of a miter and the stroke width, above which a miter is beveled.
+    explicit PathTessellator(float tolerance = default_tolerance, float miter_limit = default_miter_limit);
+
+    /// Maximum distance between a curve and its approximation.
+    float get_tolerance() const noexcept { return m_tolerance; }
+
+    /// Changes the maximum distance between a curve and its approximation.
+    /// @param tolerance    New tolerance.
+    void set_tolerance(const float tolerance) noexcept { m_tolerance = max(tolerance, precision_low<float>()); }
+
+    /// Number of line segments required to approximate the given bezier segment within the given tolerance.
+    /// @param segment      Bezier segment to approximate.
+    /// @param tolerance    Maximum distance between the curve and its approximation.
+    static uint get_subdivision_count(const CubicBezier2f& segment, float tolerance);
+
+    /// Flattens a single bezier segment.
+    /// @param segment      Bezier segment to flatten.
+    /// @param tolerance    Maximum distance between the curve and its approximation.
+    /// @param points       All points of the approximation except the first one are appended to this vector.
+    static void flatten(const CubicBezier2f& segment, float tolerance, std::vector<V2f>& points);
+
+    /// Flattens all subpaths of a Path2.
+    /// Consecutive points that are too close to each other to make a difference are merged.
+    /// @param path     Path to flatten.
+    /// @param contours Contours to append to.
+    void flatten(const Path2& path, Contours& contours) const;
+
+    /// Triangulates the area inside the given Path2.
+    /// Open subpaths are filled as if they were closed.
+    /// @param path     Path to fill.
+    /// @param mesh     Mesh to append to.
+    void fill(const Path2& path, Mesh& mesh);
+
+    /// Triangulates the outline of the given Path2.
+    /// All triangles of a stroke are counterclockwise, so that the Mesh covers the union of all triangles when drawn
+    /// with the stencil buffer.
+    /// @param path     Path to stroke.
+    /// @param width    Width of the stroke.
+    /// @param cap      Shape at the end of a line.
+    /// @param joint    How different line segments are connected.
+    /// @param mesh     Mesh to append to.
+    void stroke(const Path2& path, float width, Plotter::CapStyle cap, Plotter::JointStyle joint, Mesh& mesh);
+
+    /// Tessellates multiple Paths in parallel.
+    /// Jobs are split into chunks that are tessellated on the given ThreadPool (and the calling thread), each with its
+    /// own Tessellator.
+    /// @param jobs         Paths to tessellate.
+    /// @param meshes       One Mesh per Job, is resized to match the number of Jobs.
+    /// @param thread_pool  ThreadPool to tessellate on.
+    /// @param tolerance    Maximum distance between a curve and its approximation.
+    static void tessellate(const std::vector<Job>& jobs, std::vector<Mesh>& meshes, ThreadPool& thread_pool,
+                           float tolerance = default_tolerance);
+
+private:
+    /// Triangulates a single concave Contour by ear clipping.
+    /// @param contour  Contour to triangulate.
+    /// @param mesh     Mesh to append to.
+    /// @returns        False if the Contour is self-intersecting or has no area, and must be drawn as a stencil fan.
+    bool _clip_ears(const Contours::Contour& contour, Mesh& mesh);
+
+    /// Triangulates a single Contour as a fan around its first point.
+    /// @param contour  Contour to triangulate.
+    /// @param mesh     Mesh to append to.
+    void _add_fan(const Contours::Contour& contour, Mesh& mesh) const;
+
+    /// Adds the joint between two line segments of a stroke.
+    /// @param point        Point shared by both line segments.
+    /// @param in           Direction of the incoming line segment (normalized).
+    /// @param out          Direction of the outgoing line segment (normalized).
+    /// @param half_width   Half the width of the stroke.
+    /// @param joint        Joint style.
+    /// @param mesh         Mesh to append to.
+    void _add_joint(const V2f& point, const V2f& in, const V2f& out, float half_width, Plotter::JointStyle joint,
+                    Mesh& mesh) const;
+
+    /// Adds a cap at the end of an open stroke.
+    /// @param point        End point of the line.
+    /// @param direction    Direction pointing away from the line (normalized).
+    /// @param half_width   Half the width of the stroke.
+    /// @param cap          Cap style.
+    /// @param mesh         Mesh to append to.
+    void _add_cap(const V2f& point, const V2f& direction, float half_width, Plotter::CapStyle cap, Mesh& mesh) const;
+
+    /// Adds a fan of triangles approximating a circular arc around a center point.
+    /// @param center       Center of the arc.
+    /// @param from         Offset of the start of the arc from the center.
+    /// @param angle        Counterclockwise angle of the arc in radians.
+    /// @param mesh         Mesh to append to.
+    void _add_arc(const V2f& center, const V2f& from, float angle, Mesh& mesh) const;
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Maximum distance between a curve and its approximation.
+    float m_tolerance;
+
+    /// Ratio between the length of a miter and the stroke width, above which a miter is drawn as a bevel.
+    float m_miter_limit;
+
+    /// Flattened Path that is currently tessellated.
+    Contours m_contours;
+
+    /// Indices of the points that are not yet clipped, used during ear clipping.
+    std::vector<uint> m_polygon;
+};
+
+NOTF_CLOSE_NAMESPACE
@@ -9,10 +9,13 @@ NOTF_OPEN_NAMESPACE
 /// Helper structure around raw image data.
 /// Raw images are usually loaded from disk, have their data copied into another object and are then destroyed again.
 /// Use-cases include loading OpenGL textures and Window icons.
+/// Images can be loaded on any thread, for example by the TextureLoader.
 class RawImage {
 
     // methods --------------------------------------------------------------------------------- //
 public:
+    NOTF_NO_COPY_OR_ASSIGN(RawImage);
+
     /// Value Constructor.
     /// @param image_path       Absolute path to the Image file.
     /// @param force_format     Number of bytes per pixel, default is 0 (=> use format defined in file).
@@ -34,6 +37,9 @@ public:
     /// Raw image data.
     const uchar* get_data() const { return m_data; }
 
+    /// Raw image data, for in-place processing with the image kernels.
+    uchar* get_data() { return m_data; }
+
     /// Tests if the image is valid or not.
     explicit operator bool() const { return static_cast<bool>(m_data); }
 
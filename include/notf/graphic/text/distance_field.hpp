@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "notf/graphic/text/font.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// distance field =================================================================================================== //
+
+/// Produces a signed distance field from the coverage bitmap of a Glyph.
+///
+/// Each pixel of the field stores the distance of its center to the outline of the Glyph, mapped from
+/// [-spread, spread] pixels onto [0, 255]. Pixels inside the Glyph are larger than 127.5, pixels outside smaller, so the
+/// outline itself lies at 127.5. Because the distance is stored instead of the coverage, the field can be sampled at
+/// any scale or rotation and still produce a sharp and anti-aliased outline.
+///
+/// Distances are computed with an exact euclidean distance transform (Felzenszwalb & Huttenlocher, "Distance Transforms
+/// of Sampled Functions", 2012) on the pixels that are more than half covered. Pixels on the outline use their coverage
+/// to place the outline between pixel centers.
+///
+/// @param coverage     Coverage of each pixel of the bitmap, the first row is the top row of the Glyph.
+/// @param width        Width of the bitmap in pixels.
+/// @param height       Height of the bitmap in pixels.
+/// @param pitch        Number of bytes between the start of two rows in the bitmap.
+/// @param spread       Largest distance that can be expressed in the field, in pixels. The field is padded by this
+///                     many pixels on each side, so it is `spread * 2` pixels wider and higher than the bitmap.
+/// @returns            Distance field, one byte per pixel without padding between rows, in the same row order.
+std::vector<uchar> produce_distance_field(const uchar* coverage, const int width, const int height, const int pitch,
+                                          const int spread);
+
+/// Replaces the coverage bitmap of a Glyph with its signed distance field (see `produce_distance_field`).
+/// The Glyph's rect grows by the padding of the field, its `left` and `top` are moved outwards so that the outline stays
+/// at the same position relative to the origin. Glyphs without pixels are left unchanged.
+/// @param glyph        Glyph to convert, its rect contains the size of the bitmap.
+/// @param bitmap       Coverage of the Glyph, one byte per pixel without padding. Is replaced by the distance field.
+/// @param spread       Largest distance that can be expressed in the field, in pixels.
+void convert_to_distance_field(Glyph& glyph, std::vector<uchar>& bitmap, const int spread);
+
+NOTF_CLOSE_NAMESPACE
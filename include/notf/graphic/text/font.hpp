@@ -2,21 +2,20 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include "notf/meta/hash.hpp"
 #include "notf/meta/smart_ptr.hpp"
 
 #include "notf/graphic/fwd.hpp"
+#include "notf/graphic/text/glyph_table.hpp"
 
 struct FT_FaceRec_;
 typedef struct FT_FaceRec_* FT_Face;
 
 NOTF_OPEN_NAMESPACE
 
-/// Data type to identify a single Glyph.
-using codepoint_t = uint32_t;
-
 // glyph ============================================================================================================ //
 
 /// A Glyph contains information about how to render a single character from a font atlas.
@@ -103,16 +102,22 @@ public:
 
 /// A Font is a manger object for a given font face in the FontManager.
 /// It knows where its Glyphs reside in the FontManager's Font Atlas.
-/// At the moment, a Font renders all renderable ascii Glyphs to begin with and adds new Glyphs should they be
-/// requested.
+/// A Font pre-warms all renderable ascii Glyphs to begin with, more can be added with `prewarm`. All other Glyphs are
+/// added should they be requested.
+/// Glyphs that have not been used in a while may be evicted from the Atlas by the FontManager, in which case they are
+/// rendered again the next time they are requested.
 class Font {
 
     friend class FontManager;
 
 public: // types
+    /// Nested `AccessFor<T>` type.
+    NOTF_ACCESS_TYPE(Font);
+
     using pixel_size_t = ushort;
 
-    /// Every Font is uniquely identified by its file and the Font size in pixels.
+    /// Every Font is uniquely identified by its file, the Font size in pixels and whether its Glyphs are distance
+    /// fields.
     struct Identifier {
 
         /// Filename of the loaded Font.
@@ -121,21 +126,45 @@ public: // types
         /// Pixel size of this Font.
         pixel_size_t pixel_size;
 
+        /// Whether the Glyphs of this Font are signed distance fields instead of coverage bitmaps.
+        bool is_distance_field = false;
+
         /// Equality test operator.
         bool operator==(const Identifier& rhs) const {
-            return filename == rhs.filename && pixel_size == rhs.pixel_size;
+            return filename == rhs.filename && pixel_size == rhs.pixel_size
+                   && is_distance_field == rhs.is_distance_field;
         }
     };
 
+    /// Pixel size at which the Glyphs of distance field Fonts are rasterized.
+    static constexpr pixel_size_t distance_field_size = 32;
+
+    /// Largest distance to the outline of a Glyph that can be expressed in a distance field, in pixels at
+    /// `distance_field_size`. Distance field Glyphs are padded by this many pixels on each side.
+    static constexpr int distance_field_spread = 4;
+
+private: // types
+    /// A Glyph in the Atlas, together with the frame in which it was last requested.
+    struct _AtlasGlyph {
+        /// The Glyph.
+        Glyph glyph;
+
+        /// Frame in which the Glyph was last requested, used to find the least recently used Glyphs for eviction.
+        size_t last_use;
+
+        /// Whether the Glyph is still rasterized in the background and only an empty placeholder until then.
+        bool is_pending = false;
+    };
+
     // methods --------------------------------------------------------------------------------- //
 private:
     NOTF_CREATE_SMART_FACTORIES(Font);
 
     /// Constructor.
     /// @param manager       Font manager.
-    /// @param filename      File from which to load the font.
-    /// @param pixel_size    Font base size in pixels.
-    Font(FontManager& manager, const std::string& filename, const pixel_size_t pixel_size);
+    /// @param identifier    File from which to load the font, its base size in pixels and whether its Glyphs are
+    ///                      distance fields.
+    Font(FontManager& manager, Identifier identifier);
 
 public:
     /// Loads a new Font or returns a pointer to an existing font if a font with the same filename /
@@ -145,30 +174,66 @@ public:
     /// @param pixel_size       Nominal size of the loaded Font in pixels.
     static FontPtr load(FontManager& font_manager, const std::string& filename, const pixel_size_t pixel_size);
 
+    /// Loads a new distance field Font or returns a pointer to an existing one with the same filename.
+    /// The Glyphs of a distance field Font are rasterized once at `distance_field_size` and stored as signed distance
+    /// fields, which can be drawn at any size, rotation or zoom without being rasterized again. Its metrics are those of
+    /// `distance_field_size`, to write text of another size, scale the transformation by `size / distance_field_size`.
+    /// For now, only the PlotterRasterizer can draw distance field Fonts, the Plotter skips text written with them.
+    /// @param font_manager     Manager of the loaded Font.
+    /// @param filename         File from which the Font is loaded.
+    static FontPtr load_distance_field(FontManager& font_manager, const std::string& filename);
+
     /// Name of the Font.
     const std::string& name() const { return m_name; }
 
+    /// Whether the Glyphs of this Font are signed distance fields instead of coverage bitmaps.
+    bool is_distance_field() const { return m_identifier.is_distance_field; }
+
     /// Returns true if this Font is valid.
     /// If the file used to initialize the Font could not be loaded, the Font is invalid.
     bool is_valid() const { return m_face; }
 
     /// Returns the requested Glyph, or an invalid Glyph if the given codepoint is not known.
+    /// Glyphs that are requested for the first time are rasterized in the background, until then an empty placeholder
+    /// is returned that only advances the text origin.
     const Glyph& get_glyph(const codepoint_t codepoint) const;
 
+    /// Whether the given Glyph is still being rasterized in the background.
+    bool is_pending(const codepoint_t codepoint) const {
+        const _AtlasGlyph* atlas_glyph = m_glyphs.find(codepoint);
+        return atlas_glyph && atlas_glyph->is_pending;
+    }
+
+    /// Rasterizes all given characters right away and packs them into the Atlas in a single batch, which produces a
+    /// tighter fit than adding them one by one as they are requested.
+    /// Use this when the Font is loaded for all characters that you expect to draw, characters that are already known
+    /// to the Font are ignored.
+    /// @param characters   UTF-8 encoded characters to pre-warm.
+    void prewarm(const std::string& characters);
+
+    /// Returns the layout of the given text, which is cached by the FontManager so repeated calls with the same text
+    /// do not have to look up each Glyph again.
+    /// @param text     UTF-8 encoded text to lay out.
+    /// @param width    Width at which lines are broken, zero means that the text is laid out in a single line.
+    TextLayoutConstPtr get_layout(std::string_view text, const int width = 0) const;
+
     /// Font base size in pixels.
     pixel_size_t pixel_size() const { return m_identifier.pixel_size; }
 
     /// The vertical distance from the horizontal baseline to the hightest ‘character’ coordinate in a font face.
-    pixel_size_t ascender() { return m_ascender; }
+    pixel_size_t ascender() const { return m_ascender; }
 
     /// The vertical distance from the horizontal baseline to the lowest ‘character’ coordinate in a font face.
-    pixel_size_t descender() { return m_descender; }
+    pixel_size_t descender() const { return m_descender; }
 
     /// Default vertical baseline-to-baseline distance.
-    pixel_size_t line_height() { return m_line_height; }
+    pixel_size_t line_height() const { return m_line_height; }
 
 private:
-    /// Renders and returns a new Glyph.
+    /// Loads a new Font or returns a pointer to an existing font with the same identifier.
+    static FontPtr _load(FontManager& font_manager, Identifier identifier);
+
+    /// Creates and returns a placeholder for a new Glyph and requests the Glyph to be rasterized in the background.
     const Glyph& _allocate_glyph(const codepoint_t codepoint) const;
 
     // fields ---------------------------------------------------------------------------------- //
@@ -196,8 +261,8 @@ private:
     /// height.
     pixel_size_t m_line_height;
 
-    /// Glyphs indixed by code point.
-    mutable std::unordered_map<codepoint_t, Glyph> m_glyphs;
+    /// Glyphs indexed by code point.
+    mutable GlyphTable<_AtlasGlyph> m_glyphs;
 };
 
 NOTF_CLOSE_NAMESPACE
@@ -207,5 +272,7 @@ NOTF_CLOSE_NAMESPACE
 /// std::hash specialization for Font::Identifier.
 template<>
 struct std::hash<notf::Font::Identifier> {
-    size_t operator()(const notf::Font::Identifier& id) const { return notf::hash(id.filename, id.pixel_size); }
+    size_t operator()(const notf::Font::Identifier& id) const {
+        return notf::hash(id.filename, id.pixel_size, id.is_distance_field);
+    }
 };
@@ -22,6 +22,13 @@ NOTF_OPEN_NAMESPACE
 /// However, the reference implementation above does include rotation, so if you want, implement it and see if it makes
 /// a difference.
 ///
+/// The Atlas starts out small and grows on demand, alternating between doubling its width and its height, until it has
+/// reached its maximum size. Glyph rectangles keep their position when the Atlas grows, only the texture is replaced.
+/// Once the Atlas cannot grow any further, the FontManager makes room by evicting the least recently used Glyphs and
+/// returning their rectangles to the Atlas with `release_rect`. Released rectangles are re-used only by rectangles that
+/// fit into them, so over time, the free space is scattered over many small holes. If there is enough free space for a
+/// new rectangle in total, but no single place large enough, the FontManager defragments the Atlas with `repack`.
+///
 /// Note that in the Atlas, just as with any other OpenGL texture, y grows up.
 class FontAtlas {
 
@@ -44,6 +51,27 @@ public:
         coord_t height;
     };
 
+    /// Statistics about the use of the Atlas over its lifetime.
+    struct Statistics {
+        /// Number of rectangles currently placed in the Atlas.
+        size_t rect_count = 0;
+
+        /// Number of rectangles that were released from the Atlas again, usually by evicting their Glyphs.
+        size_t rects_released = 0;
+
+        /// How often the Atlas texture had to grow.
+        size_t growth_count = 0;
+
+        /// Number of transfers of changed Atlas regions to the GPU.
+        size_t upload_count = 0;
+
+        /// Number of rectangles that could not be placed, even with the Atlas at its maximum size.
+        size_t failed_count = 0;
+
+        /// How often the Atlas was repacked to reclaim its fragmented free space.
+        size_t repack_count = 0;
+    };
+
 private:
     /// Helper data structure to keep track of the free space of the bin where rectangles may be placed.
     class WasteMap {
@@ -52,8 +80,8 @@ private:
         /// Constructor.
         WasteMap() = default;
 
-        /// (Re-)initializes the WasteMap.
-        void initialize(const coord_t width, const coord_t height);
+        /// Removes all waste.
+        void clear();
 
         /// Registers a new rectangle as "waste".
         void add_waste(Glyph::Rect rect);
@@ -110,22 +138,50 @@ public:
     /// Computes the ratio of used atlas area, returns value in range [0, 1].
     float get_occupancy() const { return static_cast<float>(m_used_area) / (m_width * m_height); }
 
+    /// Area of the Atlas that is not covered by any rectangle, but not necessarily in one piece.
+    area_t get_free_area() const { return static_cast<area_t>(m_width * m_height) - m_used_area; }
+
+    /// Statistics about the use of the Atlas.
+    const Statistics& get_statistics() const { return m_statistics; }
+
+    /// Whether the Atlas has reached its maximum size and cannot grow any further.
+    bool is_at_max_size() const { return m_width >= m_max_size && m_height >= m_max_size; }
+
     /// The Atlas Texture.
+    /// Note that the Texture is replaced whenever the Atlas grows.
     TexturePtr get_texture() const { return m_texture; }
 
     /// Places and returns a single rectangle into the Atlas.
     /// If you want to insert multiple known rects, calling `insert_rects` will likely yield a tighter result than
     /// multiple calls to `insert_rect`.
+    /// @returns    The placed rectangle, has zero width and height if the rect did not fit, even at the Atlas'
+    ///             maximum size.
     Glyph::Rect insert_rect(const coord_t width, const coord_t height);
 
     /// Places and returns multiple rectangles into the Atlas.
     /// Produces a better fit than multiple calls to `insert_rect`.
+    /// Requests that could not be fit, even at the Atlas' maximum size, are missing from the result.
     std::vector<ProtoGlyph> insert_rects(std::vector<FitRequest> named_extends);
 
+    /// Returns a rectangle to the Atlas, so its space can be re-used by future insertions.
+    /// The pixels of the rectangle stay in the Atlas until they are overwritten.
+    void release_rect(const Glyph::Rect& rect);
+
+    /// Places all given rectangles anew into an empty Atlas, together with their pixels.
+    /// Reclaims all free space that was scattered between the rectangles, without changing the size of the Atlas.
+    /// @param rects    All rectangles that are placed in the Atlas, all others are removed.
+    /// @returns        The new position of each rectangle, in the same order. Has zero width and height for rectangles
+    ///                 that did not fit anymore.
+    std::vector<Glyph::Rect> repack(const std::vector<Glyph::Rect>& rects);
+
     /// Fills a rect in the Atlas with the given data.
     /// Does not check whether the rect corresponds to a node in the atlas, I trust you know what you are doing.
+    /// Only changes the client-side copy of the Atlas, call `upload` to transfer the changes to the GPU.
     void fill_rect(const Glyph::Rect& rect, const uchar* data);
 
+    /// Uploads the region of the Atlas that was changed since the last upload to the GPU in a single transfer.
+    void upload();
+
 private:
     /// Finds and returns a free rectangle in the Atlas of the requested size.
     /// Also returns information about the generated waste allowing the 'insert' functions to optimize the order in
@@ -135,6 +191,13 @@ private:
     /// Creates a new Skyline node just left of the given node index.
     void _add_node(const size_t node_index, const Glyph::Rect& rect);
 
+    /// Doubles either the width or the height of the Atlas, whichever is smaller.
+    /// @returns    False if the Atlas is already at its maximum size.
+    bool _grow();
+
+    /// (Re-)creates the Atlas texture from the pixels in `m_pixels` and binds it to the font atlas texture slot.
+    void _create_texture();
+
     // fields ---------------------------------------------------------------------------------- //
 private:
     /// Font atlas texture.
@@ -146,6 +209,15 @@ private:
     /// Height of the texture atlas.
     coord_t m_height;
 
+    /// Maximum width and height of the texture atlas.
+    coord_t m_max_size;
+
+    /// Client-side copy of the texture atlas, glyphs are written here first and uploaded in batches.
+    std::vector<uchar> m_pixels;
+
+    /// Region of the client-side copy that was changed since the last upload, has zero width if nothing changed.
+    Glyph::Rect m_dirty_rect = {0, 0, 0, 0};
+
     /// Used surface area in this atlas.
     area_t m_used_area;
 
@@ -154,6 +226,9 @@ private:
 
     /// Separate data structure to keep track of waste undereath the skyline.
     WasteMap m_waste;
+
+    /// Statistics about the use of the Atlas.
+    Statistics m_statistics;
 };
 
 NOTF_CLOSE_NAMESPACE
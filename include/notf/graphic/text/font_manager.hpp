@@ -1,9 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include "notf/common/thread_pool.hpp"
 
 #include "notf/graphic/text/font_atlas.hpp"
+#include "notf/graphic/text/text_layout.hpp"
 
 struct FT_LibraryRec_;
 typedef struct FT_LibraryRec_* FT_Library;
@@ -13,10 +19,39 @@ NOTF_OPEN_NAMESPACE
 // font manager ===================================================================================================== //
 
 /// Object used to load, render and work with Fonts and rendered text.
+///
+/// Glyphs that are not yet in the Atlas are rasterized in the background by a pool of worker threads, each with its
+/// own FreeType library and faces. Until a Glyph is ready, it is drawn as an empty placeholder that only advances the
+/// text origin. Rasterized Glyphs are integrated into the Atlas at the start of the next frame and all changes to the
+/// Atlas are uploaded to the GPU in a single transfer per frame.
 class FontManager {
 
     friend class Font;
 
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Nested `AccessFor<T>` type.
+    NOTF_ACCESS_TYPE(FontManager);
+
+private:
+    /// A Glyph rasterized by a worker thread, waiting to be integrated into the Atlas.
+    struct _RasterizedGlyph {
+        /// Font of the Glyph.
+        Font::Identifier font;
+
+        /// Codepoint of the Glyph.
+        codepoint_t codepoint;
+
+        /// The Glyph, its rect contains the size of the bitmap but no position in the Atlas yet.
+        Glyph glyph;
+
+        /// Rasterized Glyph bitmap, one byte per pixel without padding.
+        std::vector<uchar> bitmap;
+
+        /// Whether the Glyph was rasterized successfully.
+        bool is_rendered;
+    };
+
     // methods --------------------------------------------------------------------------------- //
 private:
     NOTF_CREATE_SMART_FACTORIES(FontManager);
@@ -36,6 +71,24 @@ public:
     /// Direct access to the font atlas texture.
     TexturePtr get_atlas_texture() const;
 
+    /// Font Atlas to store Glyphs of all loaded Fonts, can be used to inspect its occupancy and statistics.
+    const FontAtlas& get_atlas() const { return m_atlas; }
+
+    /// Cache of the TextLayouts of all Fonts, can be used to inspect its statistics.
+    const TextLayoutCache& get_layout_cache() const { return m_layout_cache; }
+
+    /// Starts a new frame.
+    /// Integrates all Glyphs that were rasterized in the background since the last frame into the Atlas. Glyphs used
+    /// in the last frame are never evicted to make room for them, since they are likely to be drawn again.
+    void start_frame();
+
+    /// Uploads all changes to the Atlas since the last upload to the GPU in a single transfer.
+    void upload_atlas() { m_atlas.upload(); }
+
+    /// Whether there are Glyphs that are still rasterized in the background or not yet integrated into the Atlas.
+    /// Text using these Glyphs should be drawn again after the next call to `start_frame`.
+    bool has_pending_glyphs() const { return m_pending_glyph_count != 0; }
+
 private: // for Font
     /// The Freetype library used by the Manager.
     FT_Library freetype() const { return m_freetype; }
@@ -43,6 +96,24 @@ private: // for Font
     /// Font Atlas to store Glyphs of all loaded Fonts.
     FontAtlas& atlas() { return m_atlas; }
 
+    /// Places a new rectangle of the given size into the Atlas.
+    /// If the Atlas is full and cannot grow any further, the least recently used Glyphs of all Fonts are evicted until
+    /// the new rectangle fits. Glyphs that were used in the last frame are never evicted. If there is enough
+    /// free space, but it is too fragmented to fit the new rectangle, the Atlas is repacked.
+    /// @returns    The placed rectangle, has zero width and height if the rect did not fit.
+    Glyph::Rect _allocate_rect(const Glyph::coord_t width, const Glyph::coord_t height);
+
+    /// Repacks the Atlas and moves the Glyphs of all given Fonts to their new position.
+    /// Glyphs that no longer fit are removed from their Font and rasterized again the next time they are requested.
+    /// @param fonts    All Fonts with Glyphs in the Atlas.
+    void _repack_atlas(const std::vector<FontPtr>& fonts);
+
+    /// Rasterizes a Glyph of the given Font on a worker thread.
+    /// The result is integrated into the Atlas in the next call to `start_frame`.
+    /// @param font         Font of the Glyph.
+    /// @param codepoint    Codepoint of the Glyph.
+    void _rasterize_glyph(const Font& font, const codepoint_t codepoint);
+
 private:
     /// Renders the Font Atlas on screen.
     void _debug_render_atlas();
@@ -57,6 +128,25 @@ private:
 
     /// All managed Fonts, uniquely identified by a filename/size-pair.
     std::unordered_map<Font::Identifier, FontWeakPtr> m_fonts;
+
+    /// Cache of the TextLayouts of all Fonts.
+    TextLayoutCache m_layout_cache;
+
+    /// Current frame, used to determine the least recently used Glyphs.
+    size_t m_frame = 0;
+
+    /// Glyphs rasterized by the workers, waiting to be integrated into the Atlas.
+    std::vector<_RasterizedGlyph> m_rasterized_glyphs;
+
+    /// Mutex guarding `m_rasterized_glyphs`.
+    std::mutex m_rasterized_mutex;
+
+    /// Number of requested Glyphs that are not yet integrated into the Atlas.
+    std::atomic_size_t m_pending_glyph_count = 0;
+
+    /// Worker threads rasterizing Glyphs in the background.
+    /// Is the last field, so it is destroyed (and finishes all outstanding tasks) before all others.
+    ThreadPool m_workers;
 };
 
 NOTF_CLOSE_NAMESPACE
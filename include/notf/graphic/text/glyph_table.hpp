@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "notf/meta/macros.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+/// Data type to identify a single Glyph.
+using codepoint_t = uint32_t;
+
+// glyph table ====================================================================================================== //
+
+/// Maps codepoints to values, optimized for looking up the Glyphs of a text one character after the other.
+///
+/// Codepoints are stored in pages of 256 consecutive codepoints, each of which is a dense array indexed directly by the
+/// lower 8 bits of the codepoint. The first page contains the Basic Latin and Latin-1 Supplement blocks and is always
+/// present, so the lookup of a latin character is a single array access. All other pages are created on demand and
+/// the last page that was looked up is cached, so consecutive characters of the same script skip the page lookup.
+///
+/// Lookups modify the page cache and are therefore not thread-safe, not even the const ones.
+template<class T>
+class GlyphTable {
+
+    // types ----------------------------------------------------------------------------------- //
+private:
+    /// Number of codepoints in a page.
+    static constexpr codepoint_t s_page_size = 256;
+
+    /// Dense array of values for 256 consecutive codepoints.
+    struct Page {
+        /// Values in this page, only those marked in `is_used` are valid.
+        std::array<T, s_page_size> values = {};
+
+        /// Which values in this page are in use.
+        std::bitset<s_page_size> is_used;
+    };
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    NOTF_NO_COPY_OR_ASSIGN(GlyphTable);
+
+    /// Default constructor.
+    GlyphTable() = default;
+
+    /// Number of values in the table.
+    size_t get_size() const noexcept { return m_size; }
+
+    /// Whether the table is empty.
+    bool is_empty() const noexcept { return m_size == 0; }
+
+    ///@{
+    /// Finds the value of a codepoint.
+    /// @param codepoint    Codepoint to look up.
+    /// @returns            The value, or nullptr if the codepoint is not in the table.
+    T* find(const codepoint_t codepoint) {
+        Page* page = _find_page(codepoint / s_page_size);
+        const codepoint_t index = codepoint % s_page_size;
+        return (page && page->is_used[index]) ? &page->values[index] : nullptr;
+    }
+    const T* find(const codepoint_t codepoint) const { return const_cast<GlyphTable*>(this)->find(codepoint); }
+    ///@}
+
+    /// Stores a value for a codepoint, replacing any previous value.
+    /// @param codepoint    Codepoint to store the value for.
+    /// @param value        Value to store.
+    /// @returns            The stored value.
+    T& emplace(const codepoint_t codepoint, T value) {
+        Page& page = _get_page(codepoint / s_page_size);
+        const codepoint_t index = codepoint % s_page_size;
+        if (!page.is_used[index]) {
+            page.is_used[index] = true;
+            ++m_size;
+        }
+        page.values[index] = std::move(value);
+        return page.values[index];
+    }
+
+    /// Removes the value of a codepoint from the table.
+    /// Does not release the memory of the value's page.
+    /// @param codepoint    Codepoint to remove.
+    /// @returns            True if the codepoint was removed, false if it was not in the table.
+    bool erase(const codepoint_t codepoint) {
+        Page* page = _find_page(codepoint / s_page_size);
+        const codepoint_t index = codepoint % s_page_size;
+        if (!page || !page->is_used[index]) { return false; }
+        page->values[index] = {};
+        page->is_used[index] = false;
+        --m_size;
+        return true;
+    }
+
+    /// Removes all values from the table.
+    void clear() {
+        m_first_page = {};
+        m_pages.clear();
+        m_cached_page_index = 0;
+        m_cached_page = &m_first_page;
+        m_size = 0;
+    }
+
+    /// Calls the given function for every codepoint in the table with the codepoint and a reference to its value.
+    /// The function must not add or remove values from the table.
+    template<class Function>
+    void for_each(Function&& function) {
+        _for_each_in_page(0, m_first_page, function);
+        for (auto& [page_index, page] : m_pages) {
+            _for_each_in_page(page_index, *page, function);
+        }
+    }
+
+private:
+    /// Returns the page with the given index, or nullptr if it does not exist.
+    Page* _find_page(const codepoint_t page_index) {
+        if (page_index == m_cached_page_index) { return m_cached_page; }
+        if (page_index == 0) { return &m_first_page; }
+        auto itr = m_pages.find(page_index);
+        if (itr == m_pages.end()) { return nullptr; }
+        m_cached_page_index = page_index;
+        m_cached_page = itr->second.get();
+        return m_cached_page;
+    }
+
+    /// Returns the page with the given index, creating it if it does not exist.
+    Page& _get_page(const codepoint_t page_index) {
+        if (Page* page = _find_page(page_index)) { return *page; }
+        m_cached_page_index = page_index;
+        m_cached_page = m_pages.emplace(page_index, std::make_unique<Page>()).first->second.get();
+        return *m_cached_page;
+    }
+
+    /// Calls a function for every used value in a page.
+    template<class Function>
+    static void _for_each_in_page(const codepoint_t page_index, Page& page, Function& function) {
+        if (page.is_used.none()) { return; }
+        for (codepoint_t index = 0; index < s_page_size; ++index) {
+            if (page.is_used[index]) { function(page_index * s_page_size + index, page.values[index]); }
+        }
+    }
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// The first page, containing the Basic Latin and Latin-1 Supplement blocks.
+    Page m_first_page;
+
+    /// All other pages, by page index.
+    std::unordered_map<codepoint_t, std::unique_ptr<Page>> m_pages;
+
+    /// Index of the last page that was looked up.
+    codepoint_t m_cached_page_index = 0;
+
+    /// Last page that was looked up.
+    Page* m_cached_page = &m_first_page;
+
+    /// Number of values in the table.
+    size_t m_size = 0;
+};
+
+NOTF_CLOSE_NAMESPACE
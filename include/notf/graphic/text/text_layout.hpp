@@ -0,0 +1,219 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "notf/common/geo/aabr.hpp"
+
+#include "notf/graphic/text/font.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// text layout ====================================================================================================== //
+
+/// The laid out Glyphs of a text, together with its line breaks and bounding box.
+///
+/// A layout only references Glyphs by their codepoint and stores the position of their origin, so it stays valid when
+/// Glyphs are evicted from the FontAtlas and moved to another place in it. Layouts are immutable and usually shared
+/// through the TextLayoutCache of the FontManager, see `Font::get_layout`.
+///
+/// Lines are broken at spaces, like with `break_text`. Subsequent lines start one line height below the previous one,
+/// with y growing up.
+class TextLayout {
+
+    friend class Font;
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Function returning the Glyph of a codepoint.
+    using GlyphLookup = std::function<const Glyph&(codepoint_t)>;
+
+    /// A single laid out character.
+    struct Character {
+        /// Codepoint of the character, used to look up its Glyph.
+        codepoint_t codepoint;
+
+        /// Horizontal position of the Glyph's origin, relative to the origin of the text.
+        Glyph::coord_t x;
+
+        /// Vertical position of the Glyph's origin, relative to the origin of the text.
+        Glyph::coord_t y;
+    };
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    /// Constructor.
+    /// @param text         UTF-8 encoded text to lay out.
+    /// @param width        Width at which lines are broken, zero means that the text is laid out in a single line.
+    /// @param line_height  Vertical distance between two baselines.
+    /// @param get_glyph    Function returning the Glyph of a codepoint.
+    TextLayout(const std::string& text, const int width, const int line_height, const GlyphLookup& get_glyph);
+
+    /// The laid out text.
+    const std::string& get_text() const noexcept { return m_text; }
+
+    /// Width at which lines are broken, zero if the text is laid out in a single line.
+    int get_width() const noexcept { return m_width; }
+
+    /// All laid out characters, in the order in which they appear in the text.
+    const std::vector<Character>& get_characters() const noexcept { return m_characters; }
+
+    /// Byte offset in the text of the first character of each line but the first.
+    const std::vector<size_t>& get_line_breaks() const noexcept { return m_line_breaks; }
+
+    /// Number of lines in the layout.
+    size_t get_line_count() const noexcept { return m_line_breaks.size() + 1; }
+
+    /// Bounding box of all Glyphs, with the origin at the first Glyph's origin.
+    const Aabri& get_aabr() const noexcept { return m_aabr; }
+
+    /// Whether some of the Glyphs were still being rasterized when the text was laid out.
+    /// Pending Glyphs already have their final advance but no size yet, so the bounding box might grow once they are
+    /// ready.
+    bool is_provisional() const noexcept { return m_is_provisional; }
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// The laid out text.
+    std::string m_text;
+
+    /// Width at which lines are broken, zero if the text is laid out in a single line.
+    int m_width;
+
+    /// All laid out characters.
+    std::vector<Character> m_characters;
+
+    /// Byte offset in the text of the first character of each line but the first.
+    std::vector<size_t> m_line_breaks;
+
+    /// Bounding box of all Glyphs.
+    Aabri m_aabr = Aabri::zero();
+
+    /// Whether some of the Glyphs were still being rasterized when the text was laid out.
+    bool m_is_provisional = false;
+};
+
+// text layout cache ================================================================================================ //
+
+/// Least recently used cache of TextLayouts, identified by their Font, text and width.
+/// Provisional layouts are laid out again every time they are requested, until all of their Glyphs are ready.
+///
+/// Like Fonts themselves, the cache is not thread-safe.
+class TextLayoutCache {
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Statistics about the use of the cache over its lifetime.
+    struct Statistics {
+        /// Number of requests answered with a cached layout.
+        size_t hits = 0;
+
+        /// Number of requests that had to lay out the text.
+        size_t misses = 0;
+
+        /// Number of layouts that were removed from the cache to make room for new ones.
+        size_t evictions = 0;
+
+        /// Ratio of requests answered with a cached layout.
+        float get_hit_ratio() const noexcept {
+            const size_t total = hits + misses;
+            return total == 0 ? 1 : static_cast<float>(hits) / static_cast<float>(total);
+        }
+    };
+
+private:
+    /// Cached layout with the Font it was laid out with.
+    struct _Entry {
+        /// Font of the layout.
+        Font::Identifier font;
+
+        /// The cached layout.
+        TextLayoutConstPtr layout;
+    };
+    using EntryList = std::list<_Entry>;
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    NOTF_NO_COPY_OR_ASSIGN(TextLayoutCache);
+
+    /// Constructor.
+    /// @param capacity     Maximum number of layouts in the cache.
+    TextLayoutCache(const size_t capacity = 4096) : m_capacity(max(capacity, size_t(1))) {}
+
+    /// Returns the layout of a text, produces and caches a new one if the text is not in the cache yet.
+    /// @param font     Font of the text.
+    /// @param text     UTF-8 encoded text.
+    /// @param width    Width at which lines are broken, zero means that the text is laid out in a single line.
+    /// @param produce  Function returning the TextLayout, called if the text is not in the cache.
+    template<class Producer>
+    TextLayoutConstPtr get(const Font::Identifier& font, std::string_view text, const int width, Producer&& produce) {
+        const size_t key = hash(font, text, width);
+
+        // find the cached layout
+        auto [first, last] = m_index.equal_range(key);
+        for (auto itr = first; itr != last; ++itr) {
+            EntryList::iterator entry = itr->second;
+            const TextLayout& layout = *entry->layout;
+            if (entry->font == font && layout.get_width() == width && layout.get_text() == text) {
+                if (layout.is_provisional()) {
+                    entry->layout = std::make_shared<const TextLayout>(produce());
+                    ++m_statistics.misses;
+                } else {
+                    ++m_statistics.hits;
+                }
+                m_entries.splice(m_entries.begin(), m_entries, entry);
+                return entry->layout;
+            }
+        }
+
+        // evict the least recently used layout to make room for the new one
+        if (m_entries.size() >= m_capacity) {
+            _remove(std::prev(m_entries.end()));
+            ++m_statistics.evictions;
+        }
+
+        ++m_statistics.misses;
+        m_entries.emplace_front(_Entry{font, std::make_shared<const TextLayout>(produce())});
+        m_index.emplace(key, m_entries.begin());
+        return m_entries.front().layout;
+    }
+
+    /// Removes all layouts from the cache.
+    void clear() {
+        m_entries.clear();
+        m_index.clear();
+    }
+
+    /// Number of layouts in the cache.
+    size_t get_size() const noexcept { return m_entries.size(); }
+
+    /// Maximum number of layouts in the cache.
+    size_t get_capacity() const noexcept { return m_capacity; }
+
+    /// Statistics about the use of the cache over its lifetime.
+    const Statistics& get_statistics() const noexcept { return m_statistics; }
+
+private:
+    /// Removes a single entry from the cache.
+    void _remove(EntryList::iterator entry);
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Maximum number of layouts in the cache.
+    size_t m_capacity;
+
+    /// All cached layouts, the most recently used one first.
+    EntryList m_entries;
+
+    /// Cached layouts by the hash of their Font, text and width.
+    std::unordered_multimap<size_t, EntryList::iterator> m_index;
+
+    /// Statistics about the use of the cache.
+    Statistics m_statistics;
+};
+
+NOTF_CLOSE_NAMESPACE
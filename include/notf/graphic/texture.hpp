@@ -10,6 +10,9 @@
 
 NOTF_OPEN_NAMESPACE
 
+class CompressedImage;
+class RawImage;
+
 // texture ========================================================================================================== //
 
 /// A texture is an OpenGL Object that contains one or more images that all have the same image format.
@@ -56,8 +59,9 @@ public:
 
     /// Codec used to store the texture in OpenGL.
     enum class Codec {
-        RAW,  ///< All image formats that are decoded into raw pixels before upload (png, jpg, almost all of them...)
-        ASTC, ///< ASTC compression
+        RAW,               ///< All image formats that are decoded into raw pixels before upload (png, jpg, ...)
+        COMPRESSED,        ///< Block-compressed images in .astc or KTX2 files, uploaded without decompression
+        ASTC = COMPRESSED, ///< Old name of `COMPRESSED`, from when only ASTC was supported
     };
 
     /// Type of the data passed into the texture.
@@ -117,13 +121,15 @@ private:
     NOTF_CREATE_SMART_FACTORIES(Texture);
 
     /// Value Constructor.
-    /// @param id       OpenGL texture ID.
-    /// @param target   How the texture is going to be used by OpenGL.
-    ///                 (see https://www.khronos.org/registry/OpenGL-Refpages/es3/html/glTexImage2D.xhtml)
-    /// @param name     Application-unique name of the Texture.
-    /// @param size     Size of the Texture in pixels.
-    /// @param format   Texture format.
-    Texture(const GLuint id, const GLenum target, std::string name, Size2i size, const Format format);
+    /// @param id           OpenGL texture ID.
+    /// @param target       How the texture is going to be used by OpenGL.
+    ///                     (see https://www.khronos.org/registry/OpenGL-Refpages/es3/html/glTexImage2D.xhtml)
+    /// @param name         Application-unique name of the Texture.
+    /// @param size         Size of the Texture in pixels.
+    /// @param format       Texture format.
+    /// @param byte_size    Size of the Texture (including all mip levels) in texture memory.
+    Texture(const GLuint id, const GLenum target, std::string name, Size2i size, const Format format,
+            const size_t byte_size);
 
 public:
     NOTF_NO_COPY_OR_ASSIGN(Texture);
@@ -143,6 +149,23 @@ public:
     /// @return Texture instance, is empty if the texture could not be loaded.
     static TexturePtr load_image(const std::string& file_path, std::string name, const Args& args = s_default_args);
 
+    /// Creates a texture from an image that was already decoded, for example on another thread.
+    /// The pixels are uploaded straight from the image without an intermediate copy.
+    /// @param image            Decoded image with 1, 3 or 4 channels per pixel.
+    /// @param name             Application-unique name of the Texture.
+    /// @param args             Arguments to initialize the texture, the codec is ignored.
+    /// @throws ResourceError   If the image has an unsupported number of channels.
+    static TexturePtr create_from_image(const RawImage& image, std::string name, const Args& args = s_default_args);
+
+    /// Creates a texture from a block-compressed image, including all of its mip levels.
+    /// Compressed textures cannot generate their own mipmaps and have the format and color space of the image, so
+    /// `create_mipmaps`, `format`, `is_linear` and `data_type` in the arguments are ignored, as is the codec.
+    /// @param image    Compressed image.
+    /// @param name     Application-unique name of the Texture.
+    /// @param args     Arguments to initialize the texture.
+    static TexturePtr create_from_image(const CompressedImage& image, std::string name,
+                                        const Args& args = s_default_args);
+
     /// Destructor.
     ~Texture();
 
@@ -166,6 +189,9 @@ public:
     /// The format of this Texture.
     const Format& get_format() const noexcept { return m_format; }
 
+    /// Size of this Texture (including all mip levels) in texture memory, used for the ResourceManager's budget.
+    size_t get_byte_size() const noexcept { return m_byte_size; }
+
     /// Sets a new filter mode when the texture pixels are smaller than scren pixels.
     void set_min_filter(const MinFilter filter);
 
@@ -182,6 +208,22 @@ public:
     void flood(const Color& color);
 
 private:
+    /// Creates a new OpenGL texture object, binds it and prepares the upload of its data.
+    /// @param size         Size of the texture in pixels.
+    /// @param alignment    Row alignment of the uploaded data in bytes.
+    /// @returns            OpenGL ID of the new texture.
+    static GLuint _generate(const Size2i& size, const GLint alignment);
+
+    /// Sets the filters and wraps of the currently bound texture, wraps the texture and registers it.
+    /// @param id           OpenGL ID of the texture.
+    /// @param name         Application-unique name of the Texture.
+    /// @param size         Size of the Texture in pixels.
+    /// @param format       Texture format.
+    /// @param byte_size    Size of the Texture (including all mip levels) in texture memory.
+    /// @param args         Arguments to initialize the texture.
+    static TexturePtr _finalize(const GLuint id, std::string name, Size2i size, const Format format,
+                                const size_t byte_size, const Args& args);
+
     /// Convenience method used to set all sorts of texture-related paramters.
     /// @param name     Parameter to set.
     /// @param value    New parameter value.
@@ -207,6 +249,9 @@ private:
     /// Texture format.
     const Format m_format;
 
+    /// Size of this Texture (including all mip levels) in texture memory.
+    const size_t m_byte_size;
+
     /// Default arguments.
     static const Args s_default_args;
 };
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+
+#include "notf/meta/time.hpp"
+
+#include "notf/common/thread_pool.hpp"
+
+#include "notf/graphic/compressed_image.hpp"
+#include "notf/graphic/raw_image.hpp"
+#include "notf/graphic/texture.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// texture loader =================================================================================================== //
+
+/// Loads Textures from image files without blocking the thread that requested them.
+///
+/// Reading and decoding the image files happens on a pool of worker threads, compressed images are read into memory
+/// without being decoded (see `Texture::Codec`). Decoded images are queued until the render thread uploads them with
+/// `upload`, which stops after a given time budget so that a large batch of images is spread over multiple frames. The
+/// decoded pixels are handed straight to OpenGL and freed right after the upload.
+///
+/// Each request returns a future that is fulfilled with the Texture once it was uploaded. Until then, the caller can
+/// draw a placeholder instead. Errors while loading or uploading the image are stored in the future as well.
+/// Alternatively, a request can pass a callback that is called with the Texture or the error instead.
+class TextureLoader {
+
+    // types ----------------------------------------------------------------------------------- //
+public:
+    /// Function called with the uploaded Texture, or with the exception that prevented it from loading.
+    /// Is called on the render thread after the upload, or on a worker thread if the image could not be loaded.
+    using Callback = std::function<void(TexturePtr texture, std::exception_ptr exception)>;
+
+private:
+    /// A requested Texture.
+    struct _Request {
+        /// Path to the image file.
+        std::string file_path;
+
+        /// Application-unique name of the Texture.
+        std::string name;
+
+        /// Arguments used to initialize the Texture.
+        Texture::Args args;
+
+        /// Decoded image of a raw Texture, is empty until the image was decoded by a worker thread.
+        std::unique_ptr<RawImage> image;
+
+        /// Image of a compressed Texture, is empty until the image was loaded by a worker thread.
+        std::unique_ptr<CompressedImage> compressed_image;
+
+        /// Callback called with the uploaded Texture.
+        Callback callback;
+
+        /// Destructor.
+        /// Requests that were never finished break their promise, just like a `std::promise` would.
+        ~_Request() {
+            if (callback) {
+                finish(nullptr, std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+            }
+        }
+
+        /// Calls the callback, which is called only once.
+        /// @param texture      The uploaded Texture, or nullptr on error.
+        /// @param exception    The exception that prevented the Texture from loading.
+        void finish(TexturePtr texture, std::exception_ptr exception) {
+            Callback finished = std::move(callback);
+            callback = nullptr;
+            finished(std::move(texture), std::move(exception));
+        }
+    };
+    using _RequestPtr = std::shared_ptr<_Request>;
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    NOTF_NO_COPY_OR_ASSIGN(TextureLoader);
+
+    /// Constructor.
+    /// @param thread_count     Number of worker threads decoding images.
+    TextureLoader(size_t thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1u);
+
+    /// Destructor.
+    /// Waits for all images that are currently decoded. Textures that were not uploaded yet fail with a broken promise.
+    ~TextureLoader();
+
+    /// Requests a Texture to be loaded from an image file in the background.
+    /// @param file_path    Path to the image file.
+    /// @param name         Application-unique name of the Texture.
+    /// @param args         Arguments to initialize the Texture.
+    /// @returns            Future fulfilled with the Texture once it was uploaded.
+    std::future<TexturePtr> load(std::string file_path, std::string name, const Texture::Args& args = {});
+
+    /// Requests a Texture to be loaded from an image file in the background.
+    /// @param file_path    Path to the image file.
+    /// @param name         Application-unique name of the Texture.
+    /// @param callback     Called once with the Texture after it was uploaded, or with the error.
+    /// @param args         Arguments to initialize the Texture.
+    void load(std::string file_path, std::string name, Callback callback, const Texture::Args& args = {});
+
+    /// Uploads decoded images into new Textures until the time budget is exhausted.
+    /// Must be called on a thread with a current GraphicsContext, usually the render thread before drawing a frame.
+    /// At least one image is uploaded per call, if one is ready, so that loading always progresses.
+    /// @param budget   Time after which no new upload is started.
+    /// @returns        Number of uploaded Textures.
+    size_t upload(const duration_t budget);
+
+    /// Number of requested Textures that have not been uploaded yet.
+    size_t get_pending_count() const { return m_pending_count; }
+
+    /// Whether there are requested Textures that have not been uploaded yet.
+    bool has_pending_textures() const { return m_pending_count != 0; }
+
+    /// Number of decoded images that are waiting to be uploaded.
+    size_t get_decoded_count() const;
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Requests whose image was decoded and that are waiting to be uploaded, in the order in which they were decoded.
+    std::deque<_RequestPtr> m_decoded;
+
+    /// Mutex guarding `m_decoded`.
+    mutable std::mutex m_decoded_mutex;
+
+    /// Number of requested Textures that have not been uploaded yet.
+    std::atomic_size_t m_pending_count = 0;
+
+    /// Worker threads decoding images in the background.
+    /// Is the last field, so it is destroyed (and finishes all outstanding tasks) before all others.
+    ThreadPool m_workers;
+};
+
+NOTF_CLOSE_NAMESPACE
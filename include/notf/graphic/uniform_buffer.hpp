@@ -56,7 +56,8 @@ private:
         GLint alignment = 0;
         NOTF_CHECK_GL(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
         NOTF_ASSERT(alignment);
-        return sizeof(Block) + alignment - sizeof(Block) % alignment;
+        // blocks that are already aligned are not padded any further
+        return ((static_cast<GLint>(sizeof(Block)) + alignment - 1) / alignment) * alignment;
     }
 };
 
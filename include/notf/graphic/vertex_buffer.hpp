@@ -182,6 +182,16 @@ public:
         return _create_shared(std::move(name), usage_hint, is_per_instance);
     }
 
+    /// Re-defines the attributes of this buffer in the bound VertexObject, so that they start at the given element.
+    /// OpenGL ES has no "base instance" parameter for its draw calls, so this is the only way to render instances
+    /// starting at an element other than the first one.
+    /// The buffer must have been bound to the bound VertexObject before.
+    /// @param first_element    Index of the first element to read the attributes from.
+    void set_first_element(const uint first_element) {
+        NOTF_CHECK_GL(glBindBuffer(GL_ARRAY_BUFFER, this->_get_handle()));
+        _define_attributes(m_locations, first_element * sizeof(vertex_t));
+    }
+
 private:
     /// Binds the VertexBuffer to the bound VertexObject.
     /// @throws OpenGLError If no VAO is bound.
@@ -195,11 +205,14 @@ private:
         }
         NOTF_CHECK_GL(glBindBuffer(GL_ARRAY_BUFFER, this->_get_handle()));
         _define_attributes(locations);
+        m_locations = locations;
     }
 
     /// Define a single Attribute in the buffer.
+    /// @param locations    Attribute location of each Attribute.
+    /// @param base_offset  Offset in bytes of the first element in the buffer.
     template<size_t Index = 0>
-    void _define_attributes(const AttributeLocations& locations) const {
+    void _define_attributes(const AttributeLocations& locations, const std::uintptr_t base_offset = 0) const {
         if constexpr (Index < std::tuple_size_v<vertex_t>) {
             using AttributePolicy = std::tuple_element_t<Index, policies>;
             using ValueType = typename AttributePolicy::type;
@@ -228,7 +241,8 @@ private:
             }
 
             for (uint location_offset = 0; location_offset < location_width; ++location_offset) {
-                const auto buffer_offset = gl_buffer_offset(memory_offset + (location_offset * 4 * sizeof(GLfloat)));
+                const auto buffer_offset
+                    = gl_buffer_offset(base_offset + memory_offset + (location_offset * 4 * sizeof(GLfloat)));
 
                 // link a location in the buffer to an attribute slot
                 NOTF_CHECK_GL(glEnableVertexAttribArray(attr_location + location_offset));
@@ -246,7 +260,7 @@ private:
             }
 
             // define remaining attributes
-            _define_attributes<Index + 1>(locations);
+            _define_attributes<Index + 1>(locations, base_offset);
         }
     }
 
@@ -254,6 +268,9 @@ private:
 private:
     /// Whether the data held in this buffer is applied per vertex (false -> the default) or per instance (true).
     const bool m_is_per_instance;
+
+    /// Attribute locations that this buffer was last bound to.
+    AttributeLocations m_locations = {};
 };
 
 /// VertexBuffer factory.
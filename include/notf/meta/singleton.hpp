@@ -59,7 +59,13 @@ protected:
     template<class... Args>
     ScopedSingleton(Holder, Args&&... args) {
         if (_State expected = _State::EMPTY; s_state.compare_exchange_strong(expected, _State::INITIALIZING)) {
-            s_instance.emplace(std::forward<Args>(args)...);
+            try {
+                s_instance.emplace(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                s_state.store(_State::EMPTY); // a failed construction must not block the next attempt
+                throw;
+            }
             s_state.store(_State::RUNNING);
             m_is_holder = true;
         } else {
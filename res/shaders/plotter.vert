@@ -5,14 +5,54 @@ precision highp float;
 layout(location = 0) in vec2 a_position;
 layout(location = 1) in vec2 a_left_ctrl;
 layout(location = 2) in vec2 a_right_ctrl;
-layout(location = 3) in mat2x3 a_instance_xform;
+layout(location = 3) in vec4 a_xform_linear;      // columns of the 2x2 linear part of the instance transformation
+layout(location = 4) in vec2 a_xform_translation; // translation of the instance transformation
+layout(location = 5) in vec4 a_stroke;            // stroke width, cap style, joint style, unused
 
 out VertexData {
     vec2 left_ctrl;
     vec2 right_ctrl;
+    vec3 stroke;
 } vec_out;
 
+// patch types
+const int TEXT = 3;
+
+uniform int patch_type;
+
+/// Transforms a control point by the linear part of the instance transformation.
+/// Control points are stored relative to their vertex and one unit longer than they actually are, so that a control
+/// point on top of its vertex still carries the tangent (see `set_left_ctrl` in plotter.cpp).
+/// The zero vector marks a missing control point and is not transformed.
+/// @param ctrl     Encoded control point in local space.
+/// @param linear   Linear part of the instance transformation.
+/// @returns        Encoded control point in screen space.
+vec2 transform_ctrl(vec2 ctrl, mat2 linear){
+    float ctrl_length = length(ctrl);
+    if(ctrl_length == 0.){
+        return ctrl;
+    }
+    vec2 delta = linear * (ctrl * ((ctrl_length - 1.) / ctrl_length));
+    float delta_length = length(delta);
+    if(delta_length == 0.){
+        return normalize(linear * ctrl);
+    }
+    return delta * (1. + (1. / delta_length));
+}
+
 void main(){
+    // paths are stored in local space and transformed per instance
+    // glyphs are already positioned in screen space and cannot be transformed
+    vec2 position = a_position;
+    vec2 left_ctrl = a_left_ctrl;
+    vec2 right_ctrl = a_right_ctrl;
+    if(patch_type != TEXT){
+        mat2 linear = mat2(a_xform_linear);
+        position = (linear * a_position) + a_xform_translation;
+        left_ctrl = transform_ctrl(a_left_ctrl, linear);
+        right_ctrl = transform_ctrl(a_right_ctrl, linear);
+    }
+
     // all plotter vertices are positioned with integer values in the center of the pixels
     // the first visible pixel has the index 1, meaning all positions are shifted 0.5 pixels to the bottom and left
     //
@@ -29,9 +69,10 @@ void main(){
     //    X=====+=====+=====+=
     // origin
     //
-    gl_Position = vec4(a_position.xy - vec2(.5), 0, 1);
+    gl_Position = vec4(position - vec2(.5), 0, 1);
 
     // pass attributes into block
-    vec_out.left_ctrl = a_left_ctrl;
-    vec_out.right_ctrl = a_right_ctrl;
+    vec_out.left_ctrl = left_ctrl;
+    vec_out.right_ctrl = right_ctrl;
+    vec_out.stroke = a_stroke.xyz;
 }
@@ -241,6 +241,7 @@ void AnyNode::_set_parent(AnyNodeHandle new_parent_handle) {
     old_parent->_remove_child(this);
 
     _ensure_modified_data().parent = new_parent.get();
+    _on_parent_changed(old_parent);
 }
 
 AnyNode* AnyNode::_get_parent() const {
@@ -260,6 +261,7 @@ void AnyNode::_set_finalized() {
     // do not check whether this is the UI thread as we need this method during Application construction
     NOTF_ASSERT(!m_modified_data);
     m_data.flags[to_number(InternalFlags::FINALIZED)] = true;
+    _on_finalized();
 }
 
 void AnyNode::_clear_modified_data() {
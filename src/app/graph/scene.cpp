@@ -19,6 +19,12 @@ void Scene::set_visualizer(VisualizerPtr visualizer) { m_visualizer = std::move(
 
 bool Scene::is_window_scene() const { return _has_parent_of_type<Window>(); }
 
+Aabri Scene::_get_damage() {
+    // nested Scenes are drawn into a Plate, where their damage would have to be transformed into window space
+    if (!m_visualizer || !is_window_scene()) { return Aabri::largest(); }
+    return m_visualizer->get_damage(this);
+}
+
 void Scene::_draw() {
     if(!m_visualizer){
         NOTF_THROW(LogicError, "Cannot draw Scene \"{}\" without defining a visualizer first");
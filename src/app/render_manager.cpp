@@ -1,8 +1,25 @@
 #include "notf/app/render_manager.hpp"
 
+#include <chrono>
+
 #include "notf/meta/log.hpp"
 
+#include "notf/graphic/graphics_system.hpp"
+#include "notf/graphic/text/font_manager.hpp"
+#include "notf/graphic/texture_loader.hpp"
+
 #include "notf/app/graph/graph.hpp"
+#include "notf/app/graph/root_node.hpp"
+
+namespace { // anonymous
+
+/// Interval in which Windows waiting for background work are redrawn.
+constexpr std::chrono::milliseconds g_waiting_interval(16);
+
+/// Time per frame that the render thread spends on uploading Textures loaded in the background.
+constexpr std::chrono::milliseconds g_texture_upload_budget(4);
+
+} // namespace
 
 NOTF_OPEN_NAMESPACE
 
@@ -35,8 +52,19 @@ void RenderManager::RenderThread::_run() {
     while (m_is_running) {
         { // wait until the next frame is ready
             std::unique_lock<std::mutex> lock(m_mutex);
+            const auto is_ready = [&] { return !m_dirty_windows.empty() || !m_is_running; };
             if (m_is_running) {
-                m_condition.wait(lock, [&] { return !m_dirty_windows.empty() || !m_is_running; });
+                if (m_waiting_windows.empty()) {
+                    m_condition.wait(lock, is_ready);
+                }
+                // windows waiting for background work are redrawn periodically, unless something else comes up first
+                else if (!m_condition.wait_for(lock, g_waiting_interval, is_ready)) {
+                    for (WindowHandle& window : m_waiting_windows) {
+                        auto itr = std::find(m_dirty_windows.begin(), m_dirty_windows.end(), window);
+                        if (itr == m_dirty_windows.end()) { m_dirty_windows.emplace_back(std::move(window)); }
+                    }
+                    m_waiting_windows.clear();
+                }
             }
             if (!m_is_running) { break; }
             window_handle = std::move(m_dirty_windows.front());
@@ -60,15 +88,32 @@ void RenderManager::RenderThread::_run() {
             GraphicsContext& context = window->get_graphics_context();
             NOTF_GUARD(context.make_current());
 
-            context.begin_frame();
+            // upload Textures that were decoded in the background, so they are available in this frame
+            TheGraphicsSystem()->get_texture_loader().upload(g_texture_upload_budget);
+
+            // only the area of the window that changed since the last frame is redrawn, if nothing changed at all, the
+            // frame is skipped entirely
+            bool is_drawing = false;
             try {
-                if (SceneHandle scene = window->get_scene()) { SceneHandle::AccessFor<RenderManager>::draw(scene); }
+                SceneHandle scene = window->get_scene();
+                const Aabri damage = scene ? SceneHandle::AccessFor<RenderManager>::get_damage(scene) : Aabri::largest();
+                is_drawing = context.begin_frame(damage);
+                if (is_drawing && scene) { SceneHandle::AccessFor<RenderManager>::draw(scene); }
             }
             // if an error bubbled all the way up here, something has gone horribly wrong
             catch (const notf_exception& error) {
                 NOTF_LOG_ERROR("Rendering failed: \"{}\"", error.what());
             }
-            context.finish_frame();
+            if (is_drawing) { context.finish_frame(); }
+        }
+
+        // text with glyphs that are still rasterized in the background and Textures that are still loaded are drawn
+        // again once they are ready
+        if (TheGraphicsSystem()->get_font_manager().has_pending_glyphs()
+            || TheGraphicsSystem()->get_texture_loader().has_pending_textures()) {
+            NOTF_GUARD(std::lock_guard(m_mutex));
+            auto itr = std::find(m_waiting_windows.begin(), m_waiting_windows.end(), window_handle);
+            if (itr == m_waiting_windows.end()) { m_waiting_windows.emplace_back(window_handle); }
         }
     }
     NOTF_LOG_TRACE("Finished render loop");
@@ -82,6 +127,17 @@ void RenderManager::RenderThread::_stop() {
 
 void RenderManager::render() {
     NOTF_ASSERT(this_thread::is_the_ui_thread());
+
+    // let all Scenes finish their deferred work (like layouting) before the Graph is synchronized
+    RootNodeHandle root_node = TheGraph()->get_root_node();
+    for (size_t i = 0, end = root_node->get_child_count(); i < end; ++i) {
+        if (WindowHandle window = handle_cast<WindowHandle>(root_node->get_child(i))) {
+            if (SceneHandle scene = window->get_scene()) {
+                SceneHandle::AccessFor<RenderManager>::prepare_frame(scene);
+            }
+        }
+    }
+
     if (std::vector<AnyNodeHandle> dirty_windows = TheGraph()->synchronize(); !dirty_windows.empty()) {
         m_render_thread->request_redraw(std::move(dirty_windows));
     }
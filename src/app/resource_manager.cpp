@@ -1,15 +1,40 @@
 #include "notf/app/resource_manager.hpp"
 
+#include "notf/common/thread_pool.hpp"
+
 NOTF_OPEN_NAMESPACE
 
 // resource manager ================================================================================================= //
 
 ResourceManager::ResourceTypeBase::~ResourceTypeBase() = default;
 
+ResourceManager::ResourceManager() = default;
+
+ResourceManager::~ResourceManager() { m_workers.reset(); }
+
+ResourceStats ResourceManager::get_stats() const {
+    ResourceStats result;
+    NOTF_GUARD(std::lock_guard(m_mutex));
+    for (const auto& type : m_types) {
+        result += type.second->get_stats();
+    }
+    return result;
+}
+
 void ResourceManager::cleanup() {
+    {
+        NOTF_GUARD(std::lock_guard(m_mutex));
+        for (auto& type : m_types) {
+            type.second->_cleanup();
+        }
+    }
+    _enforce_budget();
+}
+
+void ResourceManager::remove_all_inactive() {
     NOTF_GUARD(std::lock_guard(m_mutex));
     for (auto& type : m_types) {
-        type.second->_cleanup();
+        type.second->remove_all_inactive();
     }
 }
 
@@ -20,6 +45,33 @@ void ResourceManager::clear() {
     }
 }
 
+void ResourceManager::_enforce_budget() {
+    if (m_byte_count <= m_byte_budget) { return; }
+
+    NOTF_GUARD(std::lock_guard(m_mutex));
+    while (m_byte_count > m_byte_budget) {
+        // evict the least recently used inactive resource of any type
+        ResourceTypeBase* least_recent_type = nullptr;
+        timepoint_t least_recent_use = timepoint_t::max();
+        for (auto& type : m_types) {
+            const timepoint_t last_use = type.second->_get_least_recent_use();
+            if (last_use < least_recent_use) {
+                least_recent_use = last_use;
+                least_recent_type = type.second.get();
+            }
+        }
+        if (!least_recent_type || !least_recent_type->_evict_least_recently_used()) { break; }
+    }
+}
+
+void ResourceManager::_enqueue(std::function<void()> task) {
+    {
+        NOTF_GUARD(std::lock_guard(m_mutex));
+        if (!m_workers) { m_workers = std::make_unique<ThreadPool>(); }
+    }
+    m_workers->enqueue(std::move(task));
+}
+
 std::string ResourceManager::_ensure_is_dir(const std::string& path) {
     // TODO: use std::filesystem or equivalent for the resource manager
     //       also for `_ensure_is_subdir` - the current implementation does not much at all
@@ -23,6 +23,7 @@ AnyWidget::AnyWidget(valid_ptr<AnyNode*> parent)
         return true;
     });
     connect_property<visibility>()->subscribe(Trigger([this](const bool&) { this->_relayout_upwards(); }));
+    connect_property<offset_xform>()->subscribe(Trigger([this](const M3f&) { this->_on_offset_changed(); }));
 }
 
 M3f AnyWidget::get_xform_to(WidgetHandle target) const {
@@ -33,27 +34,8 @@ M3f AnyWidget::get_xform_to(WidgetHandle target) const {
         NOTF_THROW(GraphError, "Nodes \"{}\" and \"{}\" are not in the same Scene", get_name(), target.get_name());
     }
 
-    M3f source_branch = M3f::identity();
-    for (const AnyWidget* itr = this; itr != common_ancestor;
-         itr = dynamic_cast<const AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*itr))) {
-        if (!itr) {
-            NOTF_THROW(GraphError, "Nodes \"{}\" and \"{}\" are not in the same Scene", get_name(), target.get_name());
-        }
-        source_branch *= itr->get_xform();
-    }
-
-    M3f target_branch = M3f::identity();
-    for (const AnyWidget* itr = this; itr != common_ancestor;
-         itr = dynamic_cast<const AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*itr))) {
-        if (!itr) {
-            NOTF_THROW(GraphError, "Nodes \"{}\" and \"{}\" are not in the same Scene", get_name(), target.get_name());
-        }
-        target_branch *= itr->get_xform();
-    }
-    target_branch = target_branch.get_inverse();
-
-    source_branch *= target_branch;
-    return source_branch;
+    // transform from local- into window space and from there into the local space of the target
+    return other->get_window_xform_inverse() * get_window_xform();
 }
 
 const Aabrf& AnyWidget::get_clipping_rect() const {
@@ -74,8 +56,7 @@ void AnyWidget::set_claim(WidgetClaim claim) {
 void AnyWidget::unset_claim() {
     if (m_is_claim_explicit) {
         m_is_claim_explicit = false;
-        const auto [_, claim_list] = _get_claim_list();
-        _set_claim(m_layout->calculate_claim(claim_list));
+        _request_claim_update();
     }
 }
 
@@ -90,67 +71,275 @@ void AnyWidget::_set_grant(Size2f grant) {
     if (grant == m_grant) { return; }
     m_grant = std::move(grant);
     m_design.set_dirty();
-    _relayout_downwards();
+    _request_relayout();
 }
 
-std::pair<std::vector<AnyWidget*>, std::vector<const WidgetClaim*>> AnyWidget::_get_claim_list() {
-    std::vector<AnyWidget*> child_widgets;
-    child_widgets.reserve(get_child_count());
-    for (size_t i = 0; i < get_child_count(); ++i) {
-        // TODO: can we make sure that widgets can only parent other widgets? Or can they in fact parent other things?
-        if (AnyWidget* child
-            = dynamic_cast<AnyWidget*>(AnyNodeHandle::AccessFor<AnyWidget>::get_node_ptr(get_child(i)).get())) {
-            child_widgets.emplace_back(child);
-        }
+AnyWidget& AnyWidget::_get_child_widget(const size_t index) {
+    const std::vector<AnyNodePtr>& children = AnyNode::AccessFor<AnyWidget>::read_children(*this);
+    NOTF_ASSERT(index < children.size());
+    NOTF_ASSERT(dynamic_cast<AnyWidget*>(children[index].get()));
+    return *static_cast<AnyWidget*>(children[index].get());
+}
+
+const std::vector<const WidgetClaim*>& AnyWidget::_get_claim_list() {
+    const std::vector<AnyNodePtr>& children = AnyNode::AccessFor<AnyWidget>::read_children(*this);
+
+    m_child_widgets.clear();
+    m_child_claims.clear();
+    for (const AnyNodePtr& child_node : children) {
+        // widgets can only parent other widgets (see `AnyWidget::allowed_child_types`)
+        NOTF_ASSERT(dynamic_cast<AnyWidget*>(child_node.get()));
+        AnyWidget* child = static_cast<AnyWidget*>(child_node.get());
+        child->m_sibling_index = m_child_widgets.size();
+        m_child_widgets.emplace_back(child);
+        m_child_claims.emplace_back(&child->m_claim);
     }
 
-    std::vector<const WidgetClaim*> child_claims;
-    child_claims.reserve(child_widgets.size());
-    for (AnyWidget* child : child_widgets) {
-        child_claims.push_back(&child->m_claim);
+    return m_child_claims;
+}
+
+void AnyWidget::_on_finalized() {
+    // the implicit Claim of this Widget depends on its children, and the parent has to make room for this Widget
+    _request_claim_update();
+    _relayout_upwards();
+}
+
+void AnyWidget::_on_parent_changed(AnyNode* old_parent) {
+    // the cached window transformation of this Widget and all of its descendants was relative to the old parent
+    _invalidate_window_xform();
+
+    // a Widget that moved into another WidgetScene must not remain in the hit grid of the old one
+    WidgetScene* old_scene = nullptr;
+    for (AnyNode* node = old_parent; node && !old_scene; node = AnyNode::AccessFor<AnyWidget>::get_parent(*node)) {
+        old_scene = dynamic_cast<WidgetScene*>(node);
+    }
+    if (old_scene && old_scene != _find_scene()) {
+        _leave_scene(WidgetScene::AccessFor<AnyWidget>::get_hit_grid(*old_scene));
+    }
+
+    // the old parent lost a child and the new parent gained one, both need to update their Claim and layout
+    if (AnyWidget* old_parent_widget = dynamic_cast<AnyWidget*>(old_parent)) {
+        old_parent_widget->_request_claim_update();
+    }
+    _relayout_upwards();
+}
+
+WidgetScene* AnyWidget::_find_scene() {
+    size_t depth = 0;
+    AnyNode* ancestor = AnyNode::AccessFor<AnyWidget>::get_parent(*this);
+    while (ancestor) {
+        if (!dynamic_cast<AnyWidget*>(ancestor)) { break; }
+        ancestor = AnyNode::AccessFor<AnyWidget>::get_parent(*ancestor);
+        ++depth;
+    }
+    m_layout_depth = depth;
+    return dynamic_cast<WidgetScene*>(ancestor);
+}
+
+void AnyWidget::_request_claim_update() {
+    // the Claim of a Widget that is preparing its layout is updated right afterwards (see `_relayout_downwards`)
+    if (m_is_preparing_layout) {
+        m_is_claim_outdated = true;
+        return;
+    }
+    if (WidgetScene* scene = _find_scene()) {
+        WidgetScene::AccessFor<AnyWidget>::schedule(*scene, WidgetScene::LayoutStep::CLAIM, *this, m_layout_depth);
     }
+}
 
-    return std::make_pair(std::move(child_widgets), std::move(child_claims));
+void AnyWidget::_request_relayout() {
+    if (WidgetScene* scene = _find_scene()) {
+        WidgetScene::AccessFor<AnyWidget>::schedule(*scene, WidgetScene::LayoutStep::RELAYOUT, *this, m_layout_depth);
+    }
 }
 
 void AnyWidget::_relayout_upwards() {
-    AnyWidget* parent = dynamic_cast<AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*this));
-    if (!parent) {
-        // if the parent is not a widget, this is the root widget
-        _relayout_downwards();
-    } else if (parent->m_is_claim_explicit) {
-        // if the parent's claim is explicit, it will not update its own claim and only needs to re-layout its children
-        parent->_relayout_downwards();
+    if (AnyWidget* parent = dynamic_cast<AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*this))) {
+        parent->_request_claim_update();
     } else {
-        const auto [_, claim_list] = _get_claim_list();
-        WidgetClaim new_parent_claim = parent->get_layout().calculate_claim(claim_list);
-        if (new_parent_claim == parent->m_claim) {
-            // if the parent did not update its Claim, it needs to re-layout its children
-            parent->_relayout_downwards();
-        } else {
-            // if the parent's Claim changed as well, we need to propagate the update up the hierarchy
-            parent->_set_claim(std::move(new_parent_claim));
-        }
+        // if the parent is not a widget, this is the root widget
+        _request_relayout();
     }
 }
 
-void AnyWidget::_relayout_downwards() {
-    auto [child_widgets, claim_list] = _get_claim_list();
-    const std::vector<AnyLayout::Placement> placements = m_layout->update(claim_list, m_grant);
-    NOTF_ASSERT(placements.size() == child_widgets.size());
+void AnyWidget::_update_claim(WidgetScene& scene) {
+    _update_implicit_claim(scene);
 
-    m_children_aabr = Aabrf(m_grant);
-    for (size_t i = 0; i < child_widgets.size(); ++i) {
-        AnyWidget* child = child_widgets[i];
+    // the Claim of at least one child has changed, so the children need to be re-layouted in any case
+    WidgetScene::AccessFor<AnyWidget>::schedule(scene, WidgetScene::LayoutStep::RELAYOUT, *this, m_layout_depth);
+}
+
+void AnyWidget::_update_implicit_claim(WidgetScene& scene) {
+    // if the claim is explicit, the Widget will not update its own claim
+    if (m_is_claim_explicit) { return; }
+
+    WidgetClaim new_claim = m_layout->calculate_claim(_get_claim_list());
+    if (new_claim == m_claim) { return; }
+    m_claim = std::move(new_claim);
+
+    // if the Claim changed, we need to propagate the update up the hierarchy
+    if (AnyWidget* parent = dynamic_cast<AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*this))) {
+        NOTF_ASSERT(m_layout_depth > 0);
+        WidgetScene::AccessFor<AnyWidget>::schedule(scene, WidgetScene::LayoutStep::CLAIM, *parent, m_layout_depth - 1);
+    }
+}
+
+void AnyWidget::_relayout_downwards(WidgetScene& scene) {
+    // children created or shown in `_prepare_layout` request a Claim update of this Widget, which would schedule
+    // another relayout of this Widget, even though they are laid out right here
+    m_is_preparing_layout = true;
+    try {
+        _prepare_layout();
+    }
+    catch (...) {
+        m_is_preparing_layout = false;
+        throw;
+    }
+    m_is_preparing_layout = false;
+    if (std::exchange(m_is_claim_outdated, false)) { _update_implicit_claim(scene); }
+    m_layout->update(m_child_placements, _get_claim_list(), m_grant);
+    NOTF_ASSERT(m_child_placements.size() == m_child_widgets.size());
+
+    for (size_t i = 0; i < m_child_widgets.size(); ++i) {
+        AnyWidget* child = m_child_widgets[i];
         NOTF_ASSERT(child);
 
         // update the child's layout placement
-        child->m_layout_xform = std::move(placements[i].xform);
-        child->_set_grant(std::move(placements[i].grant));
+        if (child->m_layout_xform != m_child_placements[i].xform) {
+            child->m_layout_xform = m_child_placements[i].xform;
+            child->_update_xform();
+        }
+        child->m_layout_depth = m_layout_depth + 1;
+
+        // children whose grant changed need to re-layout their own children in turn
+        if (child->m_grant != m_child_placements[i].grant) {
+            child->m_grant = m_child_placements[i].grant;
+            child->m_design.set_dirty();
+            WidgetScene::AccessFor<AnyWidget>::schedule(scene, WidgetScene::LayoutStep::RELAYOUT, *child,
+                                                        child->m_layout_depth);
+        }
+    }
+
+    // the child transformations have changed, so the bounding rects have to be updated as well
+    WidgetScene::AccessFor<AnyWidget>::schedule(scene, WidgetScene::LayoutStep::AABR, *this, m_layout_depth);
+    WidgetScene::AccessFor<AnyWidget>::schedule(scene, WidgetScene::LayoutStep::HIT_GRID, *this, m_layout_depth);
+}
+
+void AnyWidget::_update_aabr(WidgetScene& scene) {
+    Aabrf aabr(m_grant);
+    for (const AnyNodePtr& child_node : AnyNode::AccessFor<AnyWidget>::read_children(*this)) {
+        NOTF_ASSERT(dynamic_cast<AnyWidget*>(child_node.get()));
+        const AnyWidget* child = static_cast<AnyWidget*>(child_node.get());
+        aabr.unite(transform_by(child->get_aabr(), child->get_xform()));
+    }
+    if (aabr == m_children_aabr) { return; }
+    m_children_aabr = std::move(aabr);
+    WidgetScene::AccessFor<AnyWidget>::schedule(scene, WidgetScene::LayoutStep::HIT_GRID, *this, m_layout_depth);
+
+    // the bounding rect of the parent includes the bounding rect of this Widget
+    if (AnyWidget* parent = dynamic_cast<AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*this))) {
+        NOTF_ASSERT(m_layout_depth > 0);
+        WidgetScene::AccessFor<AnyWidget>::schedule(scene, WidgetScene::LayoutStep::AABR, *parent, m_layout_depth - 1);
+    }
+}
+
+void AnyWidget::_on_offset_changed() {
+    _update_xform();
+
+    WidgetScene* scene = _find_scene();
+    if (!scene) { return; }
+    WidgetScene::AccessFor<AnyWidget>::schedule(*scene, WidgetScene::LayoutStep::HIT_GRID, *this, m_layout_depth);
+    if (AnyWidget* parent = dynamic_cast<AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*this))) {
+        WidgetScene::AccessFor<AnyWidget>::schedule(*scene, WidgetScene::LayoutStep::AABR, *parent, m_layout_depth - 1);
+    }
+}
+
+void AnyWidget::_update_hit_grid(WidgetHitGrid& grid) {
+    // descendants that are scheduled as well are updated right here
+    m_scheduled_layout_steps &= ~to_number(WidgetScene::LayoutStep::HIT_GRID);
+
+    if (!get<visibility>()) { return _remove_from_hit_grid(grid); }
+
+    const Aabrf window_aabr = transform_by(m_children_aabr, _get_cached_window_xform());
+    if (m_hit_handle == WidgetHitGrid::invalid_handle) {
+        m_hit_handle = grid.insert(window_aabr, weak_from_this());
+    } else {
+        grid.update(m_hit_handle, window_aabr);
+    }
+
+    for (const AnyNodePtr& child_node : AnyNode::AccessFor<AnyWidget>::read_children(*this)) {
+        NOTF_ASSERT(dynamic_cast<AnyWidget*>(child_node.get()));
+        static_cast<AnyWidget*>(child_node.get())->_update_hit_grid(grid);
+    }
+}
+
+void AnyWidget::_remove_from_hit_grid(WidgetHitGrid& grid) {
+    m_scheduled_layout_steps &= ~to_number(WidgetScene::LayoutStep::HIT_GRID);
+    if (m_hit_handle == WidgetHitGrid::invalid_handle) { return; } // descendants were removed together with this one
+    grid.remove(m_hit_handle);
+    m_hit_handle = WidgetHitGrid::invalid_handle;
+
+    for (const AnyNodePtr& child_node : AnyNode::AccessFor<AnyWidget>::read_children(*this)) {
+        NOTF_ASSERT(dynamic_cast<AnyWidget*>(child_node.get()));
+        static_cast<AnyWidget*>(child_node.get())->_remove_from_hit_grid(grid);
+    }
+}
+
+void AnyWidget::_leave_scene(WidgetHitGrid& grid) {
+    m_scheduled_layout_steps = 0;
+    if (m_hit_handle != WidgetHitGrid::invalid_handle) {
+        grid.remove(m_hit_handle);
+        m_hit_handle = WidgetHitGrid::invalid_handle;
+    }
+
+    for (const AnyNodePtr& child_node : AnyNode::AccessFor<AnyWidget>::read_children(*this)) {
+        NOTF_ASSERT(dynamic_cast<AnyWidget*>(child_node.get()));
+        static_cast<AnyWidget*>(child_node.get())->_leave_scene(grid);
+    }
+}
 
-        // update the children aabr
-        m_children_aabr.unite(transform_by(child->get_aabr(), child->get_xform()));
+size_t AnyWidget::_get_sibling_index() const {
+    const AnyNode* parent = AnyNode::AccessFor<AnyWidget>::get_parent(*this);
+    NOTF_ASSERT(parent);
+    const std::vector<AnyNodePtr>& siblings = AnyNode::AccessFor<AnyWidget>::read_children(*parent);
+
+    // the cached index is updated on every relayout of the parent, but the order of children might have changed since
+    if (m_sibling_index < siblings.size() && siblings[m_sibling_index].get() == this) { return m_sibling_index; }
+    for (size_t i = 0; i < siblings.size(); ++i) {
+        if (siblings[i].get() == this) {
+            m_sibling_index = i;
+            return i;
+        }
     }
+    NOTF_ASSERT(false);
+    return 0;
+}
+
+bool AnyWidget::_is_in_front_of(const AnyWidget& other) const {
+    if (&other == this) { return false; }
+    auto get_parent = [](const AnyWidget* widget) -> const AnyWidget* {
+        return static_cast<const AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*widget));
+    };
+
+    // bring both Widgets to the same depth
+    const AnyWidget* lhs = this;
+    const AnyWidget* rhs = &other;
+    while (lhs->m_layout_depth > rhs->m_layout_depth) {
+        lhs = get_parent(lhs);
+    }
+    while (rhs->m_layout_depth > lhs->m_layout_depth) {
+        rhs = get_parent(rhs);
+    }
+
+    // if one Widget is the ancestor of the other, the descendant is drawn in front
+    if (lhs == rhs) { return m_layout_depth > other.m_layout_depth; }
+
+    // otherwise, the order is determined by the order of their ancestors that are siblings
+    while (AnyNode::AccessFor<AnyWidget>::get_parent(*lhs) != AnyNode::AccessFor<AnyWidget>::get_parent(*rhs)) {
+        lhs = get_parent(lhs);
+        rhs = get_parent(rhs);
+    }
+    return lhs->_get_sibling_index() > rhs->_get_sibling_index();
 }
 
 const PlotterDesign& AnyWidget::_get_design() {
@@ -168,4 +357,43 @@ void AnyWidget::_get_window_xform(M3f& result) const {
     result *= get_xform();
 }
 
+const M3f& AnyWidget::_get_cached_window_xform() const {
+    NOTF_ASSERT(this_thread::is_the_ui_thread());
+    if (m_is_window_xform_dirty) {
+        if (AnyWidget* parent = dynamic_cast<AnyWidget*>(AnyNode::AccessFor<AnyWidget>::get_parent(*this))) {
+            m_window_xform = parent->_get_cached_window_xform() * m_xform;
+        } else {
+            m_window_xform = m_xform;
+        }
+        m_is_window_xform_dirty = false;
+    }
+    return m_window_xform;
+}
+
+const M3f& AnyWidget::_get_cached_window_xform_inverse() const {
+    if (m_is_window_xform_inverse_dirty || m_is_window_xform_dirty) {
+        m_window_xform_inverse = _get_cached_window_xform().get_inverse();
+        m_is_window_xform_inverse_dirty = false;
+    }
+    return m_window_xform_inverse;
+}
+
+void AnyWidget::_update_xform() {
+    NOTF_ASSERT(this_thread::is_the_ui_thread());
+    const M3f xform = get<offset_xform>() * m_layout_xform;
+    if (xform == m_xform) { return; }
+    m_xform = xform;
+    _invalidate_window_xform();
+}
+
+void AnyWidget::_invalidate_window_xform() {
+    if (m_is_window_xform_dirty) { return; } // all descendants are dirty already
+    m_is_window_xform_dirty = true;
+    m_is_window_xform_inverse_dirty = true;
+    for (const AnyNodePtr& child_node : AnyNode::AccessFor<AnyWidget>::read_children(*this)) {
+        NOTF_ASSERT(dynamic_cast<AnyWidget*>(child_node.get()));
+        static_cast<AnyWidget*>(child_node.get())->_invalidate_window_xform();
+    }
+}
+
 NOTF_CLOSE_NAMESPACE
@@ -4,7 +4,7 @@
 
 #include "notf/meta/breakable_scope.hpp"
 
-#include <map>
+#include <algorithm>
 
 NOTF_OPEN_NAMESPACE
 
@@ -12,11 +12,13 @@ NOTF_OPEN_NAMESPACE
 
 AnyLayout::~AnyLayout() = default;
 
-void AnyLayout::_relayout() { AnyWidget::AccessFor<AnyLayout>::relayout(m_widget); }
+void AnyLayout::_relayout() {
+    if (m_widget) { AnyWidget::AccessFor<AnyLayout>::relayout(*m_widget); }
+}
 
 // overlayout ======================================================================================================= //
 
-WidgetClaim OverLayout::calculate_claim(const std::vector<const WidgetClaim*> claims) const {
+WidgetClaim OverLayout::calculate_claim(const std::vector<const WidgetClaim*>& claims) const {
     WidgetClaim result;
     for (const WidgetClaim* claim : claims) {
         NOTF_ASSERT(claim);
@@ -25,11 +27,12 @@ WidgetClaim OverLayout::calculate_claim(const std::vector<const WidgetClaim*> cl
     return result;
 }
 
-std::vector<AnyLayout::Placement> OverLayout::update(const std::vector<const WidgetClaim*> claims,
-                                                     const Size2f& grant) const {
-    const Size2f available_size = {grant.width() - m_padding.get_width(), grant.height() - m_padding.get_height()};
+void OverLayout::update(std::vector<Placement>& placements, const std::vector<const WidgetClaim*>& claims,
+                        const Size2f& grant) const {
+    const Size2f available_size = {grant.get_width() - m_padding.get_width(),
+                                   grant.get_height() - m_padding.get_height()};
 
-    std::vector<Placement> placements(claims.size());
+    placements.resize(claims.size());
     for (size_t i = 0; i < claims.size(); ++i) {
         NOTF_ASSERT(claims[i]);
         const WidgetClaim& claim = *claims[i];
@@ -40,13 +43,14 @@ std::vector<AnyLayout::Placement> OverLayout::update(const std::vector<const Wid
 
         // the placement of the widget depends on how much it size it claimed
         V2f position;
-        position.x() = (max(0, available_size.width() - placement.grant.width()) * m_alignment.horizontal.get_value())
+        position.x() = (max(0, available_size.get_width() - placement.grant.get_width())
+                        * m_alignment.horizontal.get_value())
                        + m_padding.left;
-        position.y() = (max(0, available_size.height() - placement.grant.height()) * m_alignment.vertical.get_value())
+        position.y() = (max(0, available_size.get_height() - placement.grant.get_height())
+                        * m_alignment.vertical.get_value())
                        + m_padding.bottom;
         placement.xform = M3f::translation(std::move(position));
     }
-    return placements;
 }
 
 // flex layout ====================================================================================================== //
@@ -64,34 +68,79 @@ struct FlexItem {
     float preferred;
     float scale_factor;
     float lower_bound;
+    int priority;
 };
 
 struct FlexStack {
     uint first_item = 0;
     uint item_count = 0;
-    int priority = min_v<int>;
-    FlexItem item = {0, 0, 0, 0};
+    FlexItem item = {0, 0, 0, 0, min_v<int>};
 };
 
+/// Scratch memory used by the FlexLayout solver.
+/// Layouting only ever happens on the UI thread and a FlexLayout does not recurse into other Layouts while it is being
+/// updated, so all FlexLayouts can share the same buffers. Once they have grown large enough to accomodate the biggest
+/// layout, updating a FlexLayout does not allocate any memory at all.
+struct FlexArena {
+    /// Items of the stack that is currently being laid out.
+    std::vector<FlexItem> items;
+
+    /// Stacks of a wrapping FlexLayout.
+    std::vector<FlexStack> stacks;
+
+    /// Pointers to all items (or stacks) that take part in the distribution of surplus, sorted by priority.
+    std::vector<FlexItem*> batches;
+};
+FlexArena& get_arena() {
+    thread_local FlexArena arena;
+    return arena;
+}
+
+/// Sorts the given FlexItems into contiguous batches of descending priority.
+/// Items with the same priority retain their relative order.
+/// @param items    Items to sort.
+void sort_by_priority(std::vector<FlexItem*>& items) {
+    // most layouts only use a single priority, in which case there is nothing to sort
+    const auto different_priority = [](const FlexItem* lhs, const FlexItem* rhs) {
+        return lhs->priority != rhs->priority;
+    };
+    if (std::adjacent_find(items.begin(), items.end(), different_priority) == items.end()) { return; }
+
+    // all items are stored contiguously, meaning that we can use their address to break ties
+    std::sort(items.begin(), items.end(), [](const FlexItem* lhs, const FlexItem* rhs) {
+        return (lhs->priority > rhs->priority) || (lhs->priority == rhs->priority && lhs < rhs);
+    });
+}
+
 /// Distribute a surplus of space among the given FlexItems.
 /// We use FlexItems here instead of WidgetClaims, because stacks (thinkg "rows of widgets", if it is a horizontal
 /// FlexLayout) are themselves layed out vertically, just like Widgets would.
 /// @param surplus  Remaining surplus.
-/// @param batches  Lists of FlexItems, keyed by priority.
+/// @param items    FlexItems, sorted into batches of descending priority (see `sort_by_priority`).
+///                 The order of items within a batch is modified by this function.
 /// @returns        Remaining surplus, can be zero but never negative.
-float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> priority_batches) {
-    for (auto batch_it = priority_batches.rbegin(); batch_it != priority_batches.rend(); ++batch_it) {
+float distribute_surplus(float surplus, std::vector<FlexItem*>& items) {
+    for (size_t batch_begin = 0, next_batch = 0; batch_begin < items.size(); batch_begin = next_batch) {
 
         // return early, if the surplus has been depleted by a previous batch
         if (surplus <= precision_high<float>()) { return 0; }
-        std::vector<FlexItem*>& batch = batch_it->second;
+
+        // find the end of the batch, items that are removed from the batch are moved to its back
+        const int priority = items[batch_begin]->priority;
+        for (next_batch = batch_begin + 1; next_batch < items.size() && items[next_batch]->priority == priority;) {
+            ++next_batch;
+        }
+        size_t batch_end = next_batch;
+        const auto remove_from_batch = [&](const size_t item_index) {
+            std::swap(items[item_index], items[--batch_end]);
+        };
 
         // first, supply space to all items that are smaller than their preferred size
         NOTF_BREAKABLE_SCOPE {
             float total_deficit = 0;
             float total_scale_factor = 0;
-            for (size_t item_index = 0; item_index < batch.size();) {
-                FlexItem* item = batch[item_index];
+            for (size_t item_index = batch_begin; item_index < batch_end;) {
+                FlexItem* item = items[item_index];
                 float item_deficit = item->preferred - item->lower_bound;
                 NOTF_ASSERT(item_deficit >= 0);
 
@@ -104,8 +153,7 @@ float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> pr
 
                 // if the lower bound is already touching the upper bound, we can safely ignore this item
                 else if (item->upper_bound - item->lower_bound <= precision_high<float>()) {
-                    batch[item_index] = std::move(batch.back());
-                    batch.pop_back();
+                    remove_from_batch(item_index);
                     continue;
                 }
 
@@ -124,8 +172,8 @@ float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> pr
                     recalulate_refund = false;
                     refund_per_scale_factor = total_deficit / total_scale_factor;
 
-                    for (size_t item_index = 0; item_index < batch.size();) {
-                        FlexItem* item = batch[item_index];
+                    for (size_t item_index = batch_begin; item_index < batch_end;) {
+                        FlexItem* item = items[item_index];
                         const float item_deficit = item->preferred - item->lower_bound;
                         const float refund = refund_per_scale_factor * item->scale_factor;
 
@@ -139,8 +187,7 @@ float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> pr
 
                             // if the preferred size is also the upper bound, the item won't affect the layout any more
                             if (is_approx(item->lower_bound, item->upper_bound, precision_high<float>())) {
-                                batch[item_index] = std::move(batch.back());
-                                batch.pop_back();
+                                remove_from_batch(item_index);
                                 continue;
                             }
                         }
@@ -152,7 +199,8 @@ float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> pr
 
             // at this point, we know that for all remaining items in the batch `lower bound < upper bound` and
             // that the total deficit and scale factor only contains those items where `lower bound < preferred`
-            for (FlexItem* item : batch) {
+            for (size_t item_index = batch_begin; item_index < batch_end; ++item_index) {
+                FlexItem* item = items[item_index];
                 if (item->preferred - item->lower_bound > 0) {
                     item->lower_bound += refund_per_scale_factor * item->scale_factor;
                 }
@@ -167,9 +215,9 @@ float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> pr
         // items that have not reached their upper bound yet
         {
             float total_scale_factor = 0;
-            for (FlexItem* item : batch) {
-                NOTF_ASSERT(item->scale_factor > 0);
-                total_scale_factor += item->scale_factor;
+            for (size_t item_index = batch_begin; item_index < batch_end; ++item_index) {
+                NOTF_ASSERT(items[item_index]->scale_factor > 0);
+                total_scale_factor += items[item_index]->scale_factor;
             }
 
             // ensure that all items with a capacity lower than their assigned surplus only get as much surplus
@@ -181,8 +229,8 @@ float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> pr
                     recalculate_surplus = false;
                     surplus_per_scale_factor = surplus / total_scale_factor;
 
-                    for (size_t item_index = 0; item_index < batch.size();) {
-                        FlexItem* item = batch[item_index];
+                    for (size_t item_index = batch_begin; item_index < batch_end;) {
+                        FlexItem* item = items[item_index];
                         const float item_capacity = item->upper_bound - item->preferred;
                         const float item_surplus = surplus_per_scale_factor * item->scale_factor;
 
@@ -199,18 +247,17 @@ float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> pr
                         total_scale_factor -= item->scale_factor;
 
                         // remove the item from the batch because it cannot grow any further
-                        batch[item_index] = std::move(batch.back());
-                        batch.pop_back();
+                        remove_from_batch(item_index);
                     }
                 }
             }
             if (is_zero(surplus, precision_low<float>())) { return 0; }
-            if (batch.empty()) { continue; }
+            if (batch_begin == batch_end) { continue; }
 
             // at this point we know that each item has enough capacity to hold its assigned surplus and that there are
             // only items left that are not already maxed out
-            for (FlexItem* item : batch) {
-                item->lower_bound += surplus_per_scale_factor * item->scale_factor;
+            for (size_t item_index = batch_begin; item_index < batch_end; ++item_index) {
+                items[item_index]->lower_bound += surplus_per_scale_factor * items[item_index]->scale_factor;
             }
             return 0; // there can be no surplus left
         }
@@ -218,19 +265,23 @@ float distribute_surplus(float surplus, std::map<int, std::vector<FlexItem*>> pr
     return surplus;
 }
 
-void layout_single_stack(const FlexLayout& layout, const std::vector<const WidgetClaim*> claims,
+void layout_single_stack(const FlexLayout& layout, const std::vector<const WidgetClaim*>& claims,
                          const FlexSize& available, FlexSize offset, std::vector<AnyLayout::Placement>& placements,
                          const size_t first_item, const size_t item_count) {
     NOTF_ASSERT(item_count > 0);
     NOTF_ASSERT(claims.size() == placements.size());
     NOTF_ASSERT(first_item + item_count <= claims.size());
 
+    FlexArena& arena = get_arena();
+
     // create a FlexItem for each child claim in range
     float surplus;
-    std::vector<FlexItem> items(item_count);
+    std::vector<FlexItem>& items = arena.items;
+    items.resize(item_count);
     {
         float used_space = 0;
-        std::map<int, std::vector<FlexItem*>> items_by_priority;
+        std::vector<FlexItem*>& items_by_priority = arena.batches;
+        items_by_priority.clear();
         for (size_t item_index = 0; item_index < item_count; ++item_index) {
             NOTF_ASSERT(claims[item_index + first_item]);
             const WidgetClaim& claim = *claims[item_index + first_item];
@@ -238,6 +289,7 @@ void layout_single_stack(const FlexLayout& layout, const std::vector<const Widge
                                                                            claim.get_vertical();
             FlexItem& item = items[item_index];
             item.scale_factor = stretch.get_scale_factor();
+            item.priority = stretch.get_priority();
 
             // apply ratio limits to the upper bound
             item.upper_bound = stretch.get_max();
@@ -256,7 +308,7 @@ void layout_single_stack(const FlexLayout& layout, const std::vector<const Widge
             item.lower_bound = min(item.upper_bound, stretch.get_min());
 
             // store the new item
-            items_by_priority[stretch.get_priority()].emplace_back(&item);
+            items_by_priority.emplace_back(&item);
 
             // remove the lower bound from the available space right now
             used_space += item.lower_bound;
@@ -267,7 +319,10 @@ void layout_single_stack(const FlexLayout& layout, const std::vector<const Widge
 
         // distribute remaining surplus
         surplus = available.main - used_space;
-        if (surplus > 0) { surplus = distribute_surplus(surplus, std::move(items_by_priority)); }
+        if (surplus > 0) {
+            sort_by_priority(items_by_priority);
+            surplus = distribute_surplus(surplus, items_by_priority);
+        }
     }
 
     const bool is_positive = (layout.get_direction() == FlexLayout::Direction::LEFT_TO_RIGHT)
@@ -337,10 +392,11 @@ void layout_single_stack(const FlexLayout& layout, const std::vector<const Widge
     }
 }
 
-void layout_multi_stack(const FlexLayout& layout, const std::vector<const WidgetClaim*> claims,
+void layout_multi_stack(const FlexLayout& layout, const std::vector<const WidgetClaim*>& claims,
                         const FlexSize& available, FlexSize offset, std::vector<AnyLayout::Placement>& placements) {
 
-    std::vector<FlexStack> stacks;
+    std::vector<FlexStack>& stacks = get_arena().stacks;
+    stacks.clear();
     float cross_surplus;
     { // fill the child claims into stacks
         FlexStack current_stack;
@@ -364,7 +420,7 @@ void layout_multi_stack(const FlexLayout& layout, const std::vector<const Widget
                 used_space.cross += current_stack.item.lower_bound;
                 stacks.emplace_back(std::move(current_stack));
 
-                current_stack = {}; // re-using moved container, see http://stackoverflow.com/a/9168917/3444217
+                current_stack = {};
                 current_stack.first_item = claim_index;
 
                 used_space.main = 0;
@@ -372,7 +428,7 @@ void layout_multi_stack(const FlexLayout& layout, const std::vector<const Widget
 
             // if there is enough space, add the child to the current stack
             ++current_stack.item_count;
-            set_max(current_stack.priority, cross_stretch.get_priority());
+            set_max(current_stack.item.priority, cross_stretch.get_priority());
             set_max(current_stack.item.upper_bound, cross_stretch.get_max());
             set_max(current_stack.item.preferred, cross_stretch.get_preferred());
             set_max(current_stack.item.scale_factor, cross_stretch.get_scale_factor());
@@ -391,14 +447,16 @@ void layout_multi_stack(const FlexLayout& layout, const std::vector<const Widget
     // distribute cross surplus among the stacks
     if (cross_surplus > 0) {
 
-        // we need to order all stacks by priority and use a map since we don't know how many priorities there are
-        std::map<int, std::vector<FlexItem*>> stacks_by_priority;
+        // we need to order all stacks by priority
+        std::vector<FlexItem*>& stacks_by_priority = get_arena().batches;
+        stacks_by_priority.clear();
         for (FlexStack& stack : stacks) {
-            stacks_by_priority[stack.priority].emplace_back(&stack.item);
+            stacks_by_priority.emplace_back(&stack.item);
         }
+        sort_by_priority(stacks_by_priority);
 
         // the cross directional layout of stacks is itself a FlexLayout
-        cross_surplus = distribute_surplus(cross_surplus, std::move(stacks_by_priority));
+        cross_surplus = distribute_surplus(cross_surplus, stacks_by_priority);
     }
 
     // determine values for alignment along the cross axis
@@ -426,6 +484,7 @@ void layout_multi_stack(const FlexLayout& layout, const std::vector<const Widget
     }
 
     // layout all stacks in order
+    // (laying out a single stack re-uses the item and batch buffers of the arena, but leaves the stacks untouched)
     const bool is_reverse = layout.get_wrap() == FlexLayout::Wrap::REVERSE;
     for (size_t stack_index = 0, end = stacks.size(); stack_index < end; ++stack_index) {
         const FlexStack& stack = stacks[is_reverse ? stacks.size() - (stack_index + 1) : stack_index];
@@ -445,7 +504,7 @@ void layout_multi_stack(const FlexLayout& layout, const std::vector<const Widget
 } // namespace flex_layout
 } // namespace
 
-WidgetClaim FlexLayout::calculate_claim(const std::vector<const WidgetClaim*> claims) const {
+WidgetClaim FlexLayout::calculate_claim(const std::vector<const WidgetClaim*>& claims) const {
     if (is_wrapping()) { return {}; } // wrapping layouts adapt to whatever space is offered
 
     WidgetClaim result;
@@ -464,19 +523,20 @@ WidgetClaim FlexLayout::calculate_claim(const std::vector<const WidgetClaim*> cl
     return result;
 }
 
-std::vector<AnyLayout::Placement> FlexLayout::update(const std::vector<const WidgetClaim*> claims,
-                                                     const Size2f& grant) const {
+void FlexLayout::update(std::vector<Placement>& placements, const std::vector<const WidgetClaim*>& claims,
+                        const Size2f& grant) const {
     using namespace flex_layout;
 
     // early out if there are no items to lay out
-    if (claims.empty()) { return {}; }
+    placements.resize(claims.size());
+    if (claims.empty()) { return; }
 
     // determine available space to fit the layout into
     FlexSize available_space = [&] {
         FlexSize result;
         const Size2f available = grant - get_padding().get_size();
-        result.main = is_horizontal() ? available.width() : available.height();
-        result.cross = is_horizontal() ? available.height() : available.width();
+        result.main = is_horizontal() ? available.get_width() : available.get_height();
+        result.cross = is_horizontal() ? available.get_height() : available.get_width();
         return result;
     }();
 
@@ -485,29 +545,168 @@ std::vector<AnyLayout::Placement> FlexLayout::update(const std::vector<const Wid
     switch (m_direction) {
     case FlexLayout::Direction::LEFT_TO_RIGHT:
         offset.main = m_padding.left;
-        offset.cross = m_wrap == FlexLayout::Wrap::WRAP ? grant.height() - m_padding.top : m_padding.bottom;
+        offset.cross = m_wrap == FlexLayout::Wrap::WRAP ? grant.get_height() - m_padding.top : m_padding.bottom;
         break;
     case FlexLayout::Direction::RIGHT_TO_LEFT:
-        offset.main = grant.width() - m_padding.right;
-        offset.cross = m_wrap == FlexLayout::Wrap::WRAP ? grant.height() - m_padding.top : m_padding.bottom;
+        offset.main = grant.get_width() - m_padding.right;
+        offset.cross = m_wrap == FlexLayout::Wrap::WRAP ? grant.get_height() - m_padding.top : m_padding.bottom;
         break;
     case FlexLayout::Direction::TOP_TO_BOTTOM:
-        offset.main = grant.height() - m_padding.top;
-        offset.cross = m_wrap == FlexLayout::Wrap::WRAP ? m_padding.left : grant.width() - m_padding.right;
+        offset.main = grant.get_height() - m_padding.top;
+        offset.cross = m_wrap == FlexLayout::Wrap::WRAP ? m_padding.left : grant.get_width() - m_padding.right;
         break;
     case FlexLayout::Direction::BOTTOM_TO_TOP:
         offset.main = m_padding.bottom;
-        offset.cross = m_wrap == FlexLayout::Wrap::WRAP ? m_padding.left : grant.width() - m_padding.right;
+        offset.cross = m_wrap == FlexLayout::Wrap::WRAP ? m_padding.left : grant.get_width() - m_padding.right;
         break;
     }
 
-    std::vector<Placement> placements(claims.size());
     if (is_wrapping()) {
         layout_multi_stack(*this, claims, available_space, std::move(offset), placements);
     } else {
         layout_single_stack(*this, claims, available_space, std::move(offset), placements, 0, claims.size());
     }
-    return placements;
+}
+
+// list layout ====================================================================================================== //
+
+WidgetClaim ListLayout::calculate_claim(const std::vector<const WidgetClaim*>&) const {
+    WidgetClaim result;
+    result.get_horizontal() = m_row_claim.get_horizontal();
+    result.get_horizontal().grow_by(m_padding.get_width());
+
+    const float content_height = get_content_height() + m_padding.get_height();
+    result.get_vertical() = WidgetClaim::Stretch(content_height, 0, content_height);
+    return result;
+}
+
+void ListLayout::update(std::vector<Placement>& placements, const std::vector<const WidgetClaim*>& claims,
+                        const Size2f& grant) const {
+    const float pitch = _get_pitch();
+    const float top = grant.get_height() - m_padding.top + m_scroll_remainder;
+    const Size2f row_grant = {max(0, grant.get_width() - m_padding.get_width()),
+                              m_row_claim.get_vertical().get_preferred()};
+
+    placements.resize(claims.size());
+    for (size_t row = 0; row < placements.size(); ++row) {
+        Placement& placement = placements[row];
+        const size_t item = row < m_row_items.size() ? m_row_items[row] : no_item;
+        if (item == no_item) {
+            placement.grant = Size2f::zero();
+            placement.xform = M3f::identity();
+        } else {
+            // rows are placed relative to the scroll item, the distance between both is small enough to be exact
+            const auto distance = static_cast<std::ptrdiff_t>(item) - static_cast<std::ptrdiff_t>(m_scroll_item);
+            placement.grant = row_grant;
+            placement.xform = M3f::translation(
+                V2f{m_padding.left, top - static_cast<float>(distance) * pitch - row_grant.get_height()});
+        }
+    }
+}
+
+std::pair<size_t, size_t> ListLayout::get_visible_items(const Size2f& grant, const Aabrf& viewport) const {
+    const float pitch = _get_pitch();
+    const float row_height = m_row_claim.get_vertical().get_preferred();
+    if (m_item_count == 0 || pitch <= 0 || row_height <= 0) { return {0, 0}; }
+
+    // distance of the viewport's top and bottom edge from the top of the scroll item
+    const float top = grant.get_height() - m_padding.top + m_scroll_remainder;
+    const float viewport_top = top - viewport.get_top();
+    const float viewport_bottom = top - viewport.get_bottom();
+
+    // item i is visible if `(i - scroll_item) * pitch < viewport_bottom` and
+    // `(i - scroll_item) * pitch + row_height > viewport_top`
+    const auto scroll_item = static_cast<std::ptrdiff_t>(m_scroll_item);
+    const auto item_count = static_cast<std::ptrdiff_t>(m_item_count);
+    const std::ptrdiff_t first
+        = std::max(std::ptrdiff_t(0),
+                   scroll_item + static_cast<std::ptrdiff_t>(std::floor((viewport_top - row_height) / pitch)) + 1);
+    const std::ptrdiff_t last = scroll_item + static_cast<std::ptrdiff_t>(std::ceil(viewport_bottom / pitch));
+    if (last <= 0) { return {0, 0}; }
+    if (first >= item_count) { return {m_item_count, m_item_count}; }
+    return {static_cast<size_t>(first), static_cast<size_t>(std::min(std::max(first, last), item_count))};
+}
+
+void ListLayout::set_scroll_offset(const float offset, const bool relayout) {
+    const double pitch = static_cast<double>(_get_pitch());
+    if (offset <= 0 || pitch <= 0) { return set_scroll_position(0, offset, relayout); }
+
+    // split the offset into a whole number of items and the remainder, in double precision
+    const double item = std::floor(static_cast<double>(offset) / pitch);
+    set_scroll_position(static_cast<size_t>(item), static_cast<float>(static_cast<double>(offset) - item * pitch),
+                        relayout);
+}
+
+void ListLayout::set_scroll_position(size_t item, float offset, const bool relayout) {
+    const float pitch = _get_pitch();
+    const float row_height = m_row_claim.get_vertical().get_preferred();
+
+    // move whole items from the offset into the item index, until the offset is smaller than the pitch
+    if (pitch > 0) {
+        const float item_delta = std::floor(offset / pitch);
+        if (item_delta < 0 && static_cast<size_t>(-item_delta) > item) {
+            item = 0;
+            offset = 0;
+        } else {
+            item = static_cast<size_t>(static_cast<std::ptrdiff_t>(item) + static_cast<std::ptrdiff_t>(item_delta));
+            offset -= item_delta * pitch;
+        }
+    } else {
+        item = 0;
+        offset = 0;
+    }
+
+    // clamp to the height of all items, the furthest one can scroll is the bottom of the last item
+    if (m_item_count == 0) {
+        item = 0;
+        offset = 0;
+    } else if (item >= m_item_count - 1) {
+        offset = item == m_item_count - 1 ? min(offset, row_height) : row_height;
+        item = m_item_count - 1;
+    }
+    offset = max(0, offset);
+
+    if (item == m_scroll_item && is_approx(offset, m_scroll_remainder)) { return; }
+    m_scroll_item = item;
+    m_scroll_remainder = offset;
+    if (relayout) { _relayout(); }
+}
+
+void ListLayout::assign_rows(const Size2f& grant, const Aabrf& viewport, std::vector<size_t>& changed) {
+    const auto [first, last] = get_visible_items(grant, viewport);
+    m_previous_row_items = m_row_items;
+
+    // keep all rows that display a visible item and free all others
+    m_is_item_displayed.assign(last - first, false);
+    for (size_t& item : m_row_items) {
+        if (item != no_item && item >= first && item < last) {
+            m_is_item_displayed[item - first] = true;
+        } else {
+            item = no_item;
+        }
+    }
+
+    // assign all visible items that are not displayed yet to a free row, or create a new one
+    size_t free_row = 0;
+    for (size_t item = first; item < last; ++item) {
+        if (m_is_item_displayed[item - first]) { continue; }
+        while (free_row < m_row_items.size() && m_row_items[free_row] != no_item) {
+            ++free_row;
+        }
+        if (free_row < m_row_items.size()) {
+            m_row_items[free_row] = item;
+        } else {
+            m_row_items.emplace_back(item);
+        }
+    }
+
+    // report all rows that need to be updated
+    changed.clear();
+    for (size_t row = 0; row < m_row_items.size(); ++row) {
+        if (row >= m_previous_row_items.size() || m_row_items[row] != m_previous_row_items[row]) {
+            changed.emplace_back(row);
+        }
+    }
 }
 
 NOTF_CLOSE_NAMESPACE
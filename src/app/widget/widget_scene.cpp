@@ -1,11 +1,29 @@
 #include "notf/app/widget/widget_scene.hpp"
 
+#include <algorithm>
+
 #include "notf/meta/log.hpp"
 
 #include "notf/app/graph/window.hpp"
 
 NOTF_USING_NAMESPACE;
 
+namespace {
+
+/// Heap order of the relayout queue, Widgets closest to the root are updated first.
+template<class Request>
+bool is_deeper(const Request& lhs, const Request& rhs) {
+    return lhs.depth > rhs.depth;
+}
+
+/// Heap order of the claim- and aabr queues, the deepest Widgets are updated first.
+template<class Request>
+bool is_shallower(const Request& lhs, const Request& rhs) {
+    return lhs.depth < rhs.depth;
+}
+
+} // namespace
+
 // widget scene ===================================================================================================== //
 
 WidgetScene::WidgetScene(valid_ptr<AnyNode*> parent) : Scene(parent) {
@@ -17,9 +35,127 @@ WidgetScene::WidgetScene(valid_ptr<AnyNode*> parent) : Scene(parent) {
     // update the clipping rect whenever the Scene area changes
     _set_property_callback<area>([this](Aabri& aabr) {
         m_clipping = Aabrf(aabr);
+        m_hit_grid.set_bounds(m_clipping);
 
         if (m_root_widget) { WidgetHandle::AccessFor<WidgetScene>::set_grant(m_root_widget, m_clipping.get_size()); }
 
         return true;
     });
 }
+
+std::vector<WidgetHandle> WidgetScene::get_widgets_at(const V2f& window_pos) {
+    update_layout();
+    m_hit_grid.query(window_pos, m_hits);
+    return _collect_hits();
+}
+
+std::vector<WidgetHandle> WidgetScene::get_widgets_in(const Aabrf& window_rect) {
+    update_layout();
+    m_hit_grid.query(window_rect, m_hits);
+    return _collect_hits();
+}
+
+void WidgetScene::update_layout() {
+    if (m_claim_queue.empty() && m_relayout_queue.empty() && m_aabr_queue.empty() && m_hit_grid_queue.empty()) {
+        return;
+    }
+    ++m_layout_statistics.pass_count;
+
+    // claims only ever schedule relayouts and relayouts only ever schedule children or bounding rects, but a
+    // user-defined layout or claim might still request something from an earlier step, so we loop until everything is
+    // settled
+    do {
+        while (AnyWidgetPtr widget = _pop_scheduled(LayoutStep::CLAIM)) {
+            AnyWidget::AccessFor<WidgetScene>::update_claim(*widget, *this);
+            ++m_layout_statistics.claim_update_count;
+        }
+        while (AnyWidgetPtr widget = _pop_scheduled(LayoutStep::RELAYOUT)) {
+            AnyWidget::AccessFor<WidgetScene>::relayout(*widget, *this);
+            ++m_layout_statistics.relayout_count;
+        }
+        while (AnyWidgetPtr widget = _pop_scheduled(LayoutStep::AABR)) {
+            AnyWidget::AccessFor<WidgetScene>::update_aabr(*widget, *this);
+        }
+    } while (!m_claim_queue.empty() || !m_relayout_queue.empty());
+
+    // the hit grid is updated last, once all bounding rects are known
+    while (AnyWidgetPtr widget = _pop_scheduled(LayoutStep::HIT_GRID)) {
+        AnyWidget::AccessFor<WidgetScene>::update_hit_grid(*widget, m_hit_grid);
+    }
+}
+
+void WidgetScene::_schedule(const LayoutStep step, AnyWidget& widget, const size_t depth) {
+    uchar& scheduled_steps = AnyWidget::AccessFor<WidgetScene>::get_scheduled_layout_steps(widget);
+    if (scheduled_steps & to_number(step)) {
+        if (step != LayoutStep::AABR) { ++m_layout_statistics.avoided_relayout_count; }
+        return;
+    }
+    scheduled_steps |= to_number(step);
+
+    std::vector<LayoutRequest>& queue = _get_queue(step);
+    queue.emplace_back(LayoutRequest{depth, widget.weak_from_this()});
+    if (step == LayoutStep::RELAYOUT || step == LayoutStep::HIT_GRID) {
+        std::push_heap(queue.begin(), queue.end(), is_deeper<LayoutRequest>);
+    } else {
+        std::push_heap(queue.begin(), queue.end(), is_shallower<LayoutRequest>);
+    }
+}
+
+AnyWidgetPtr WidgetScene::_pop_scheduled(const LayoutStep step) {
+    std::vector<LayoutRequest>& queue = _get_queue(step);
+    while (!queue.empty()) {
+        if (step == LayoutStep::RELAYOUT || step == LayoutStep::HIT_GRID) {
+            std::pop_heap(queue.begin(), queue.end(), is_deeper<LayoutRequest>);
+        } else {
+            std::pop_heap(queue.begin(), queue.end(), is_shallower<LayoutRequest>);
+        }
+        AnyNodePtr node = queue.back().widget.lock();
+        queue.pop_back();
+
+        // skip widgets that have been removed since they were scheduled
+        if (!node) { continue; }
+        NOTF_ASSERT(dynamic_cast<AnyWidget*>(node.get()));
+        AnyWidgetPtr widget = std::static_pointer_cast<AnyWidget>(std::move(node));
+
+        // skip widgets that were already updated together with an ancestor
+        uchar& scheduled_steps = AnyWidget::AccessFor<WidgetScene>::get_scheduled_layout_steps(*widget);
+        if (!(scheduled_steps & to_number(step))) { continue; }
+        scheduled_steps &= ~to_number(step);
+        return widget;
+    }
+    return {};
+}
+
+std::vector<WidgetScene::LayoutRequest>& WidgetScene::_get_queue(const LayoutStep step) {
+    switch (step) {
+    case LayoutStep::CLAIM: return m_claim_queue;
+    case LayoutStep::RELAYOUT: return m_relayout_queue;
+    case LayoutStep::AABR: return m_aabr_queue;
+    case LayoutStep::HIT_GRID: return m_hit_grid_queue;
+    }
+    NOTF_ASSERT(false);
+    return m_claim_queue;
+}
+
+std::vector<WidgetHandle> WidgetScene::_collect_hits() {
+    m_hit_widgets.clear();
+    for (const WidgetHitGrid::Handle handle : m_hits) {
+        if (AnyNodePtr node = m_hit_grid.get_value(handle).lock()) {
+            NOTF_ASSERT(dynamic_cast<AnyWidget*>(node.get()));
+            m_hit_widgets.emplace_back(std::static_pointer_cast<AnyWidget>(std::move(node)));
+        } else {
+            m_hit_grid.remove(handle); // the widget has been removed from the scene
+        }
+    }
+    std::sort(m_hit_widgets.begin(), m_hit_widgets.end(), [](const AnyWidgetPtr& lhs, const AnyWidgetPtr& rhs) {
+        return AnyWidget::AccessFor<WidgetScene>::is_in_front_of(*lhs, *rhs);
+    });
+
+    std::vector<WidgetHandle> result;
+    result.reserve(m_hit_widgets.size());
+    for (AnyWidgetPtr& widget : m_hit_widgets) {
+        result.emplace_back(std::move(widget));
+    }
+    m_hit_widgets.clear();
+    return result;
+}
@@ -2,6 +2,8 @@
 
 #include "notf/meta/log.hpp"
 
+#include "notf/common/thread_pool.hpp"
+
 #include "notf/graphic/plotter/plotter.hpp"
 
 #include "notf/app/graph/window.hpp"
@@ -13,29 +15,48 @@ NOTF_OPEN_NAMESPACE
 // ================================================================================================================== //
 
 WidgetVisualizer::WidgetVisualizer(const Window& window)
-    : Visualizer(window), m_plotter(std::make_unique<Plotter>(window.get_graphics_context())) {}
+    : Visualizer(window)
+    , m_plotter(std::make_unique<Plotter>(window.get_graphics_context()))
+    , m_thread_pool(std::make_unique<ThreadPool>()) {}
 
 WidgetVisualizer::~WidgetVisualizer() = default;
 
 void WidgetVisualizer::visualize(valid_ptr<Scene*> scene) const {
+    if (!m_is_parsed && !_parse(scene)) { return; }
+    m_is_parsed = false;
+    m_plotter->finish_parsing(); // TODO Painterpreter::Picture RAII instance?
+}
+
+Aabri WidgetVisualizer::get_damage(valid_ptr<Scene*> scene) const {
+    m_is_parsed = _parse(scene);
+    return m_is_parsed ? m_plotter->get_damage() : Aabri::largest();
+}
+
+bool WidgetVisualizer::_parse(valid_ptr<Scene*> scene) const {
     WidgetScene* widget_scene = dynamic_cast<WidgetScene*>(raw_pointer(scene));
     if (!widget_scene) {
         NOTF_LOG_CRIT("Failed to visualize Scene \"{}\": WidgetVisualizer can only visualize WidgetScenes",
                       scene->get_name());
-        return;
+        return false;
     }
 
     AnyNode::Iterator iterator(widget_scene->get_widget());
     AnyNodeHandle node;
 
-    m_plotter->start_parsing();
+    // collect the designs of all widgets in draw order, this might re-paint dirty designs and is not thread-safe
+    std::vector<Plotter::DesignInstance> designs;
     while (iterator.next(node)) {
         WidgetHandle widget = handle_cast<WidgetHandle>(node);
         if (widget) {
-            m_plotter->parse(WidgetHandle::AccessFor<WidgetVisualizer>::get_design(widget), widget->get_xform());
+            const PlotterDesign& design = WidgetHandle::AccessFor<WidgetVisualizer>::get_design(widget);
+            designs.emplace_back(Plotter::DesignInstance{&design, widget->get_xform()});
         }
     }
-    m_plotter->finish_parsing(); // TODO Painterpreter::Picture RAII instance?
+
+    // the designs themselves are parsed in parallel
+    m_plotter->start_parsing();
+    m_plotter->parse(designs, *m_thread_pool);
+    return true;
 }
 
 NOTF_CLOSE_NAMESPACE
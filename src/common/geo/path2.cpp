@@ -27,3 +27,28 @@ Path2Ptr Path2::rect(const Aabrf& aabr) {
     std::vector<CubicPolyBezier2f> subpaths = {std::move(line)};
     return _create_shared(std::move(subpaths));
 }
+
+Path2Ptr Path2::circle(const V2f& center, const float radius) {
+    // distance of the control points from their vertex, so that the segments approximate quarter circles
+    constexpr float kappa = 0.5522847498f;
+
+    auto line = Polylinef(center + V2f(radius, 0), center + V2f(0, radius), //
+                          center + V2f(-radius, 0), center + V2f(0, -radius));
+    line.set_closed();
+    CubicPolyBezier2f bezier(std::move(line));
+
+    // turn the straight segments into quarter circles
+    std::vector<V2f>& hull = bezier.m_hull.get_vertices();
+    NOTF_ASSERT(hull.size() == 12);
+    for (size_t segment = 0; segment < 4; ++segment) {
+        const V2f& start = hull[segment * 3];
+        const V2f& end = hull[(segment * 3 + 3) % hull.size()];
+        const V2f start_tangent = (start - center).get_orthogonal() * kappa;
+        const V2f end_tangent = (end - center).get_orthogonal() * kappa;
+        hull[segment * 3 + 1] = start + start_tangent;
+        hull[segment * 3 + 2] = end - end_tangent;
+    }
+
+    std::vector<CubicPolyBezier2f> subpaths = {std::move(bezier)};
+    return _create_shared(std::move(subpaths));
+}
@@ -36,6 +36,9 @@ ThreadPool::~ThreadPool() {
     m_condition_variable.notify_all();
 
     // join all workers and finish
+    for (Thread& worker : m_workers) {
+        worker.join();
+    }
     m_workers.clear();
 }
 
@@ -0,0 +1,225 @@
+#include "notf/graphic/compressed_image.hpp"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "notf/meta/log.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+namespace { // anonymous
+
+/// Magic number at the start of every `.astc` file.
+constexpr uchar g_astc_magic[] = {0x13, 0xAB, 0xA1, 0x5C};
+
+/// Size of the header of an `.astc` file in bytes.
+constexpr size_t g_astc_header_size = 16;
+
+/// Identifier at the start of every KTX2 file.
+constexpr uchar g_ktx2_identifier[] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+/// Size of the KTX2 header and index up to the level index in bytes.
+constexpr size_t g_ktx2_header_size = 80;
+
+/// Size of a single entry in the KTX2 level index in bytes.
+constexpr size_t g_ktx2_level_entry_size = 24;
+
+/// Number of bytes in every ASTC block, regardless of its size in pixels.
+constexpr size_t g_astc_block_length = 16;
+
+/// All 2D ASTC block sizes, in the order of their OpenGL and Vulkan format enums.
+constexpr int g_astc_block_sizes[][2] = {{4, 4},  {5, 4},  {5, 5},  {6, 5},   {6, 6},   {8, 5},   {8, 6},
+                                         {8, 8},  {10, 5}, {10, 6}, {10, 8},  {10, 10}, {12, 10}, {12, 12}};
+
+/// First and last Vulkan format of ASTC blocks, alternating between UNORM and SRGB for each block size.
+constexpr uint32_t g_vk_format_astc_first = 157; // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+constexpr uint32_t g_vk_format_astc_last = 184;  // VK_FORMAT_ASTC_12x12_SRGB_BLOCK
+
+/// First and last Vulkan format of ETC2 blocks: RGB, RGB with 1 bit alpha and RGBA, each as UNORM and SRGB.
+constexpr uint32_t g_vk_format_etc2_first = 147; // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+constexpr uint32_t g_vk_format_etc2_last = 152;  // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+
+/// Reads an unsigned little-endian integer with the given number of bytes.
+template<class T>
+T read_le(const uchar* data, const size_t byte_count = sizeof(T)) {
+    T result = 0;
+    for (size_t i = 0; i < byte_count; ++i) {
+        result |= static_cast<T>(data[i]) << (i * 8);
+    }
+    return result;
+}
+
+/// Number of blocks needed to cover the given number of pixels.
+int get_block_count(const int pixels, const int block_size) { return (pixels + block_size - 1) / block_size; }
+
+} // namespace
+
+// compressed image ================================================================================================= //
+
+CompressedImage::CompressedImage(std::string image_path, const bool is_srgb)
+    : m_filepath(std::move(image_path)), m_is_srgb(is_srgb) {
+    { // map the file into memory
+        const int file = open(m_filepath.c_str(), O_RDONLY);
+        if (file < 0) { NOTF_THROW(ResourceError, "Failed to open compressed image \"{}\"", m_filepath); }
+        struct stat file_stat;
+        if (fstat(file, &file_stat) == 0 && file_stat.st_size > 0) {
+            m_file_size = static_cast<size_t>(file_stat.st_size);
+            void* mapping = mmap(nullptr, m_file_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (mapping != MAP_FAILED) { m_file = static_cast<uchar*>(mapping); }
+        }
+        close(file);
+        if (!m_file) { NOTF_THROW(ResourceError, "Failed to map compressed image \"{}\"", m_filepath); }
+    }
+
+    try {
+        if (m_file_size >= sizeof(g_astc_magic) && std::memcmp(m_file, g_astc_magic, sizeof(g_astc_magic)) == 0) {
+            m_container = Container::ASTC;
+            _parse_astc();
+        } else if (m_file_size >= sizeof(g_ktx2_identifier)
+                   && std::memcmp(m_file, g_ktx2_identifier, sizeof(g_ktx2_identifier)) == 0) {
+            m_container = Container::KTX2;
+            _parse_ktx2();
+        } else {
+            NOTF_THROW(ResourceError, "File \"{}\" is neither an .astc nor a KTX2 file", m_filepath);
+        }
+    }
+    catch (...) {
+        munmap(m_file, m_file_size);
+        throw;
+    }
+
+    NOTF_LOG_TRACE("Loaded compressed Image \"{}\" with {} mip levels", m_filepath, m_levels.size());
+}
+
+CompressedImage::~CompressedImage() { munmap(m_file, m_file_size); }
+
+size_t CompressedImage::get_data_length() const {
+    size_t result = 0;
+    for (const Level& level : m_levels) {
+        result += level.length;
+    }
+    return result;
+}
+
+void CompressedImage::page_in() const {
+    madvise(m_file, m_file_size, MADV_WILLNEED);
+
+    // touch every page, so this function returns only once all of them are resident
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    uchar checksum = 0;
+    for (size_t offset = 0; offset < m_file_size; offset += page_size) {
+        checksum ^= *static_cast<volatile const uchar*>(m_file + offset);
+    }
+    NOTF_UNUSED volatile uchar sink = checksum;
+}
+
+void CompressedImage::_parse_astc() {
+    if (m_file_size < g_astc_header_size) {
+        NOTF_THROW(ResourceError, "File \"{}\" is too short for an .astc header", m_filepath);
+    }
+    const uchar* header = m_file;
+    const int block_width = header[4];
+    const int block_height = header[5];
+    const int block_depth = header[6];
+    const int width = read_le<int>(header + 7, 3);
+    const int height = read_le<int>(header + 10, 3);
+    const int depth = read_le<int>(header + 13, 3);
+    if (block_depth != 1 || depth != 1) {
+        NOTF_THROW(ResourceError, "Cannot load 3D ASTC image \"{}\", only 2D images are supported", m_filepath);
+    }
+    if (width == 0 || height == 0) {
+        NOTF_THROW(ResourceError, "ASTC image \"{}\" has an invalid size of {}x{}", m_filepath, width, height);
+    }
+
+    for (size_t i = 0; i < std::size(g_astc_block_sizes); ++i) {
+        if (g_astc_block_sizes[i][0] == block_width && g_astc_block_sizes[i][1] == block_height) {
+            m_internal_format = static_cast<GLenum>(
+                (m_is_srgb ? GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4 : GL_COMPRESSED_RGBA_ASTC_4x4) + i);
+        }
+    }
+    if (m_internal_format == 0) {
+        NOTF_THROW(ResourceError, "Image \"{}\" uses an invalid ASTC block size of {}x{}", m_filepath, block_width,
+                   block_height);
+    }
+    m_block_size = Size2i(block_width, block_height);
+
+    _add_level(Size2i(width, height), g_astc_header_size, m_file_size - g_astc_header_size, g_astc_block_length);
+}
+
+void CompressedImage::_parse_ktx2() {
+    if (m_file_size < g_ktx2_header_size) {
+        NOTF_THROW(ResourceError, "File \"{}\" is too short for a KTX2 header", m_filepath);
+    }
+    const uchar* header = m_file + sizeof(g_ktx2_identifier);
+    const auto vk_format = read_le<uint32_t>(header + 0);
+    const auto width = read_le<uint32_t>(header + 8);
+    const auto height = read_le<uint32_t>(header + 12);
+    const auto depth = read_le<uint32_t>(header + 16);
+    const auto layer_count = read_le<uint32_t>(header + 20);
+    const auto face_count = read_le<uint32_t>(header + 24);
+    const auto level_count = max(read_le<uint32_t>(header + 28), 1u); // 0 means "generate mipmaps at runtime"
+    const auto supercompression = read_le<uint32_t>(header + 32);
+
+    if (depth > 0 || layer_count > 0 || face_count != 1) {
+        NOTF_THROW(ResourceError, "Cannot load KTX2 image \"{}\", only single 2D images are supported", m_filepath);
+    }
+    if (supercompression != 0) {
+        NOTF_THROW(ResourceError, "Cannot load KTX2 image \"{}\" with supercompression scheme {}", m_filepath,
+                   supercompression);
+    }
+    if (width == 0 || height == 0 || width > 0xFFFF || height > 0xFFFF) {
+        NOTF_THROW(ResourceError, "KTX2 image \"{}\" has an invalid size of {}x{}", m_filepath, width, height);
+    }
+
+    size_t block_length;
+    if (vk_format >= g_vk_format_astc_first && vk_format <= g_vk_format_astc_last) {
+        const size_t index = (vk_format - g_vk_format_astc_first) / 2;
+        m_is_srgb = (vk_format - g_vk_format_astc_first) % 2 == 1;
+        m_internal_format = static_cast<GLenum>(
+            (m_is_srgb ? GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4 : GL_COMPRESSED_RGBA_ASTC_4x4) + index);
+        m_block_size = Size2i(g_astc_block_sizes[index][0], g_astc_block_sizes[index][1]);
+        block_length = g_astc_block_length;
+    } else if (vk_format >= g_vk_format_etc2_first && vk_format <= g_vk_format_etc2_last) {
+        const uint32_t index = vk_format - g_vk_format_etc2_first;
+        m_is_srgb = index % 2 == 1;
+        m_internal_format = static_cast<GLenum>(GL_COMPRESSED_RGB8_ETC2 + index);
+        m_block_size = Size2i(4, 4);
+        block_length = index < 4 ? 8 : 16; // only ETC2 with EAC alpha uses 128 bit blocks
+    } else {
+        NOTF_THROW(ResourceError, "Cannot load KTX2 image \"{}\" with unsupported Vulkan format {}", m_filepath,
+                   vk_format);
+    }
+
+    // the level index lists the largest level first
+    if (m_file_size < g_ktx2_header_size + level_count * g_ktx2_level_entry_size) {
+        NOTF_THROW(ResourceError, "File \"{}\" is too short for its KTX2 level index", m_filepath);
+    }
+    m_levels.reserve(level_count);
+    for (uint32_t level = 0; level < level_count; ++level) {
+        const uchar* entry = m_file + g_ktx2_header_size + level * g_ktx2_level_entry_size;
+        _add_level(Size2i(max(static_cast<int>(width >> level), 1), max(static_cast<int>(height >> level), 1)),
+                   read_le<uint64_t>(entry), read_le<uint64_t>(entry + 8), block_length);
+    }
+}
+
+void CompressedImage::_add_level(Size2i size, const uint64_t offset, const uint64_t length,
+                                 const size_t block_length) {
+    if (offset > m_file_size || length > m_file_size - offset) {
+        NOTF_THROW(ResourceError, "Mip level {} of image \"{}\" lies outside of the file", m_levels.size(),
+                   m_filepath);
+    }
+    const size_t expected_length = static_cast<size_t>(get_block_count(size.get_width(), m_block_size.get_width()))
+                                   * static_cast<size_t>(get_block_count(size.get_height(), m_block_size.get_height()))
+                                   * block_length;
+    if (length < expected_length) {
+        NOTF_THROW(ResourceError, "Mip level {} of image \"{}\" contains {} bytes instead of {}", m_levels.size(),
+                   m_filepath, length, expected_length);
+    }
+    m_levels.emplace_back(Level{std::move(size), m_file + offset, expected_length});
+}
+
+NOTF_CLOSE_NAMESPACE
@@ -20,6 +20,57 @@
 
 NOTF_USING_NAMESPACE;
 
+// helper =========================================================================================================== //
+
+namespace {
+
+/// Maximum number of frames that the back buffer can be behind without being redrawn completely.
+constexpr size_t g_max_buffer_age = 4;
+
+/// Tokens and signatures of the EGL and GLX functions required to query the age of the back buffer.
+/// They are loaded at runtime, so that notf does not need to link against either library.
+constexpr int32_t g_egl_draw = 0x3059;             // EGL_DRAW
+constexpr int32_t g_egl_buffer_age = 0x313D;       // EGL_BUFFER_AGE_EXT
+constexpr int g_glx_back_buffer_age = 0x20F4;      // GLX_BACK_BUFFER_AGE_EXT
+using EglGetCurrentDisplay = void* (*)();
+using EglGetCurrentSurface = void* (*)(int32_t);
+using EglQuerySurface = unsigned int (*)(void*, void*, int32_t, int32_t*);
+using GlxGetCurrentDisplay = void* (*)();
+using GlxGetCurrentDrawable = unsigned long (*)();
+using GlxQueryDrawable = void (*)(void*, unsigned long, int, unsigned int*);
+
+/// Creates a function that queries the age of the back buffer of the current context.
+/// @returns    An empty function, if neither EGL_EXT_buffer_age nor GLX_EXT_buffer_age are supported.
+std::function<int()> create_buffer_age_query() {
+    if (glfwExtensionSupported("EGL_EXT_buffer_age")) {
+        const auto get_display = reinterpret_cast<EglGetCurrentDisplay>(glfwGetProcAddress("eglGetCurrentDisplay"));
+        const auto get_surface = reinterpret_cast<EglGetCurrentSurface>(glfwGetProcAddress("eglGetCurrentSurface"));
+        const auto query_surface = reinterpret_cast<EglQuerySurface>(glfwGetProcAddress("eglQuerySurface"));
+        if (get_display && get_surface && query_surface) {
+            return [=]() -> int {
+                int32_t age = 0;
+                if (!query_surface(get_display(), get_surface(g_egl_draw), g_egl_buffer_age, &age)) { return 0; }
+                return age;
+            };
+        }
+    }
+    if (glfwExtensionSupported("GLX_EXT_buffer_age")) {
+        const auto get_display = reinterpret_cast<GlxGetCurrentDisplay>(glfwGetProcAddress("glXGetCurrentDisplay"));
+        const auto get_drawable = reinterpret_cast<GlxGetCurrentDrawable>(glfwGetProcAddress("glXGetCurrentDrawable"));
+        const auto query_drawable = reinterpret_cast<GlxQueryDrawable>(glfwGetProcAddress("glXQueryDrawable"));
+        if (get_display && get_drawable && query_drawable) {
+            return [=]() -> int {
+                unsigned int age = 0;
+                query_drawable(get_display(), get_drawable(), g_glx_back_buffer_age, &age);
+                return static_cast<int>(age);
+            };
+        }
+    }
+    return {};
+}
+
+} // namespace
+
 // graphics context guard =========================================================================================== //
 
 GraphicsContext::Guard::Guard(GraphicsContext& context, std::unique_lock<RecursiveMutex>&& lock)
@@ -82,6 +133,21 @@ void GraphicsContext::_CullFace::operator=(const CullFace mode) {
     }
 }
 
+// scissor ========================================================================================================== //
+
+void GraphicsContext::_Scissor::operator=(const Aabri& area) {
+    if (area.is_valid() ? area == m_area : !m_area.is_valid()) { return; }
+
+    if (!m_area.is_valid()) { NOTF_CHECK_GL(glEnable(GL_SCISSOR_TEST)); }
+    m_area = area;
+
+    if (!m_area.is_valid()) {
+        NOTF_CHECK_GL(glDisable(GL_SCISSOR_TEST));
+    } else {
+        NOTF_CHECK_GL(glScissor(m_area.get_left(), m_area.get_bottom(), m_area.get_width(), m_area.get_height()));
+    }
+}
+
 // framebuffer binding ============================================================================================== //
 
 void GraphicsContext::_FrameBuffer::operator=(FrameBufferPtr framebuffer) {
@@ -273,6 +339,13 @@ GraphicsContext::GraphicsContext(std::string name, valid_ptr<GLFWwindow*> window
     // GLFW hints
     glfwSwapInterval(0);
 
+    // the age of the back buffer determines how many frames of damage need to be redrawn
+    m_buffer_age_query = create_buffer_age_query();
+    if (!m_buffer_age_query) {
+        NOTF_LOG_INFO("The age of the back buffer of GraphicsContext \"{}\" is unknown, every frame is redrawn in full",
+                      m_name);
+    }
+
     // OpenGL hints
     NOTF_CHECK_GL(glHint(GL_GENERATE_MIPMAP_HINT, GL_NICEST));
     NOTF_CHECK_GL(glHint(GL_FRAGMENT_SHADER_DERIVATIVE_HINT, GL_DONT_CARE));
@@ -342,7 +415,7 @@ GraphicsContext::Guard GraphicsContext::make_current(bool assume_is_current) {
     return Guard(*this, std::move(lock));
 }
 
-void GraphicsContext::begin_frame() {
+bool GraphicsContext::begin_frame(const Aabri& damage) {
 #ifdef NOTF_DEBUG
     const auto current_start_time = get_now();
     if (const auto difference
@@ -352,11 +425,41 @@ void GraphicsContext::begin_frame() {
     }
     m_frame_start_time = current_start_time;
 #endif
+
+    // if nothing changed, the front buffer already shows the current frame
+    const Aabri frame_area(m_state.framebuffer.get_size());
+    Aabri current_damage = damage.get_intersection(frame_area);
+    if (frame_area != m_frame_area) { current_damage = frame_area; }
+    if (current_damage.get_area() <= 0) { return false; }
+    m_frame_area = frame_area;
+
+    // the back buffer contains the frame from `buffer_age` frames ago and needs to be updated with the damage of all
+    // frames since then, if its age is unknown or its content is undefined (age 0), the whole frame is redrawn
+    const int buffer_age = m_buffer_age_query ? m_buffer_age_query() : 0;
+    Aabri redraw_area = current_damage;
+    if (buffer_age <= 0 || static_cast<size_t>(buffer_age) > m_past_damage.size() + 1) {
+        redraw_area = frame_area;
+    } else {
+        for (size_t i = 0; i < static_cast<size_t>(buffer_age) - 1; ++i) {
+            if (m_past_damage[i].get_area() > 0) { redraw_area.unite(m_past_damage[i]); }
+        }
+    }
+    m_past_damage.insert(m_past_damage.begin(), current_damage);
+    if (m_past_damage.size() >= g_max_buffer_age) { m_past_damage.pop_back(); }
+
+    m_frame_statistics.pixels_redrawn = static_cast<size_t>(redraw_area.get_area());
+    m_frame_statistics.pixels_total = static_cast<size_t>(frame_area.get_area());
+    m_frame_statistics.buffer_age = buffer_age;
+
+    // everything outside the redrawn area stays untouched, including by the clear
+    m_state.scissor = (redraw_area == frame_area) ? Aabri::wrongest() : redraw_area;
     m_state.framebuffer.clear(m_state._clear_color, GLBuffer::COLOR | GLBuffer::DEPTH | GLBuffer::STENCIL);
+    return true;
 }
 
 void GraphicsContext::finish_frame() {
     NOTF_ASSERT(is_current());
+    m_state.scissor = Aabri::wrongest();
     glfwSwapBuffers(m_window);
 
 #ifdef NOTF_DEBUG
@@ -371,6 +474,7 @@ void GraphicsContext::reset() {
     m_state.blend_mode = BlendMode();
     m_state.cull_face = CullFace::DEFAULT;
     m_state.stencil_mask = StencilMask();
+    m_state.scissor = Aabri::wrongest();
     m_state.program = nullptr;
     m_state.vertex_object = nullptr;
     m_state.framebuffer = nullptr;
@@ -15,10 +15,14 @@
 #include "notf/graphic/shader_program.hpp"
 #include "notf/graphic/text/font_manager.hpp"
 #include "notf/graphic/texture.hpp"
+#include "notf/graphic/texture_loader.hpp"
 
 namespace {
 NOTF_USING_NAMESPACE;
 
+/// Byte budget of all Textures held by the ResourceManager, inactive Textures are evicted beyond it.
+constexpr size_t g_texture_byte_budget = 256 * 1024 * 1024;
+
 /// The GraphicsSystem owns the first GraphicsContext to be initialized.
 /// In order to have this method executed BEFORE the GraphicsContext constructor, it is injected into the call.
 valid_ptr<GLFWwindow*> load_gl_functions(valid_ptr<GLFWwindow*> window) {
@@ -75,6 +79,13 @@ GraphicsSystem::Environment::Environment() {
         max_render_buffer_size = static_cast<decltype(max_render_buffer_size)>(max_renderbuffer_size);
     }
 
+    { // max texture size
+        GLint max_tex_size = -1;
+        NOTF_CHECK_GL(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_tex_size));
+        NOTF_ASSERT(max_tex_size >= 0);
+        max_texture_size = static_cast<decltype(max_texture_size)>(max_tex_size);
+    }
+
     { // color attachment count
         GLint max_color_attachments = -1;
         NOTF_CHECK_GL(glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &max_color_attachments));
@@ -138,11 +149,13 @@ GraphicsSystem::~GraphicsSystem() {
 
     NOTF_GUARD(m_context->make_current());
 
-    // destroy the font manager
+    // destroy the font manager and the texture loader, which fails all requests that are waiting for an upload
+    ResourceManager::get_instance().get_type<Texture>().set_loader({});
     m_font_manager.reset();
+    m_texture_loader.reset();
 
-    // cleanup unused resources
-    ResourceManager::get_instance().cleanup();
+    // remove all unused resources, even those that would still fit into their budget
+    ResourceManager::get_instance().remove_all_inactive();
 
     // deallocate and invalidate all remaining Textures
     for (auto itr : m_textures) {
@@ -183,7 +196,30 @@ GraphicsContext& GraphicsSystem::get_any_context() {
 
 void GraphicsSystem::release_shader_compiler() { NOTF_CHECK_GL(glReleaseShaderCompiler()); }
 
-void GraphicsSystem::_post_initialization() { m_font_manager = FontManager::create(); }
+void GraphicsSystem::_post_initialization() {
+    m_font_manager = FontManager::create();
+    m_texture_loader = std::make_shared<TextureLoader>();
+
+    // inactive Textures are kept by the ResourceManager until they exceed their budget, so that prefetched Textures
+    // are still there when they are first used
+    auto& texture_type = ResourceManager::get_instance().get_type<Texture>();
+    texture_type.set_byte_budget(g_texture_byte_budget);
+
+    // Textures requested asynchronously from the ResourceManager are decoded and uploaded by the TextureLoader
+    // the request is finished by the render thread once the Texture is uploaded, so that no worker of the
+    // ResourceManager has to wait for it; the loader only holds on to the TextureLoader while making the request,
+    // destroying the TextureLoader fails all requests of Textures that were not uploaded yet
+    using Completion = ResourceManager::ResourceType<Texture>::Completion;
+    texture_type.set_async_loader([weak_loader = TextureLoaderWeakPtr(m_texture_loader)](const std::string& name,
+                                                                                         Completion completion) {
+        TextureLoaderPtr texture_loader = weak_loader.lock();
+        if (!texture_loader) {
+            NOTF_THROW(ResourceError, "Cannot load Texture \"{}\" after the GraphicsSystem was shut down", name);
+        }
+        const std::string& path = ResourceManager::get_instance().get_type<Texture>().get_path();
+        texture_loader->load(path + name, name, std::move(completion));
+    });
+}
 
 void GraphicsSystem::_register_new(TexturePtr texture) {
     auto it = m_textures.find(texture->get_id());
@@ -0,0 +1,683 @@
+#include "notf/graphic/image_kernels.hpp"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+
+#include "notf/meta/exception.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NOTF_IMAGE_KERNELS_X86
+#include <immintrin.h>
+#define NOTF_TARGET_SSE2 __attribute__((target("sse2")))
+#define NOTF_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+NOTF_OPEN_NAMESPACE
+
+namespace { // anonymous
+
+// helper =========================================================================================================== //
+
+/// Radius of the Lanczos filter kernel.
+constexpr int g_lanczos_radius = 3;
+
+/// Number of samples in the lookup table used to encode linear values into sRGB.
+/// Large enough that every 8 bit sRGB value survives a round-trip through linear space.
+constexpr int g_encode_lut_size = 4096;
+
+/// Converts a value in [0, 1] from sRGB to linear color space.
+float srgb_to_linear(const float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+/// Converts a value in [0, 1] from linear to sRGB color space.
+float linear_to_srgb(const float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+}
+
+/// Linear values in [0, 1] of all 8 bit sRGB values.
+const std::array<float, 256>& get_decode_lut() {
+    static const std::array<float, 256> lut = [] {
+        std::array<float, 256> result;
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = srgb_to_linear(static_cast<float>(i) / 255.f);
+        }
+        return result;
+    }();
+    return lut;
+}
+
+/// 8 bit sRGB values of linear values in [0, 1], sampled at `g_encode_lut_size` points.
+const std::array<uchar, g_encode_lut_size>& get_encode_lut() {
+    static const std::array<uchar, g_encode_lut_size> lut = [] {
+        std::array<uchar, g_encode_lut_size> result;
+        for (size_t i = 0; i < result.size(); ++i) {
+            const float linear = static_cast<float>(i) / static_cast<float>(g_encode_lut_size - 1);
+            result[i] = static_cast<uchar>(std::lround(linear_to_srgb(linear) * 255.f));
+        }
+        return result;
+    }();
+    return lut;
+}
+
+/// Encodes a linear value in [0, 1] into 8 bit sRGB.
+uchar encode_linear(const float value) {
+    const int index = static_cast<int>(value * static_cast<float>(g_encode_lut_size - 1) + 0.5f);
+    return get_encode_lut()[static_cast<size_t>(clamp(index, 0, g_encode_lut_size - 1))];
+}
+
+/// Rounds a value in [0, 255] to the closest 8 bit value, values outside the range are clamped.
+uchar to_byte(const float value) { return static_cast<uchar>(clamp(value, 0.f, 255.f) + 0.5f); }
+
+/// Whether the given channel of a pixel is its alpha channel.
+bool is_alpha(const int channel, const int channels) {
+    return (channels == 2 || channels == 4) && channel == channels - 1;
+}
+
+/// Replaces each color channel of the given pixels with its entry in the lookup table.
+void apply_color_lut(uchar* pixels, const size_t pixel_count, const int channels, const std::array<uchar, 256>& lut) {
+    const size_t stride = static_cast<size_t>(channels);
+    const size_t color_channels = is_alpha(channels - 1, channels) ? stride - 1 : stride;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        uchar* pixel = pixels + i * stride;
+        for (size_t channel = 0; channel < color_channels; ++channel) {
+            pixel[channel] = lut[pixel[channel]];
+        }
+    }
+}
+
+/// Rounded `value * alpha / 255` for 8 bit values, exact for all inputs.
+uint32_t multiply_alpha(const uint32_t value, const uint32_t alpha) {
+    const uint32_t product = value * alpha + 128;
+    return (product + (product >> 8)) >> 8;
+}
+
+/// Rounded `value * 255 / alpha` for 8 bit values, clamped to 255.
+uint32_t divide_alpha(const uint32_t value, const uint32_t alpha) {
+    return min((value * 255 + alpha / 2) / alpha, 255u);
+}
+
+/// Set of kernel implementations currently in use.
+std::atomic<ImageKernelSet>& get_kernel_set() {
+    static std::atomic<ImageKernelSet> set(get_best_image_kernel_set());
+    return set;
+}
+
+/// Lanczos filter weights for resizing a single dimension.
+struct LanczosWeights {
+    /// Number of taps per output pixel.
+    int tap_count;
+
+    /// Input index of each tap, clamped to the input, `tap_count` per output pixel.
+    std::vector<int> indices;
+
+    /// Normalized weight of each tap, `tap_count` per output pixel.
+    std::vector<float> weights;
+};
+
+/// Lanczos kernel.
+float lanczos(const float x) {
+    if (x == 0.f) { return 1.f; }
+    if (std::abs(x) >= g_lanczos_radius) { return 0.f; }
+    const float pi_x = pi<float>() * x;
+    return static_cast<float>(g_lanczos_radius) * std::sin(pi_x) * std::sin(pi_x / g_lanczos_radius) / (pi_x * pi_x);
+}
+
+/// Calculates the Lanczos weights to resize a dimension of the given input size to the given output size.
+LanczosWeights calculate_lanczos_weights(const int input, const int output) {
+    const float scale = static_cast<float>(input) / static_cast<float>(output);
+    const float filter_scale = max(scale, 1.f); // when downsampling, the kernel is widened to avoid aliasing
+    const float support = g_lanczos_radius * filter_scale;
+
+    LanczosWeights result;
+    result.tap_count = static_cast<int>(std::ceil(support)) * 2 + 1;
+    result.indices.resize(static_cast<size_t>(output * result.tap_count));
+    result.weights.resize(static_cast<size_t>(output * result.tap_count));
+    for (int i = 0; i < output; ++i) {
+        const float center = (static_cast<float>(i) + 0.5f) * scale - 0.5f;
+        const int first = static_cast<int>(std::floor(center - support)) + 1;
+        float sum = 0;
+        for (int tap = 0; tap < result.tap_count; ++tap) {
+            const size_t index = static_cast<size_t>(i * result.tap_count + tap);
+            result.indices[index] = clamp(first + tap, 0, input - 1);
+            result.weights[index] = lanczos((static_cast<float>(first + tap) - center) / filter_scale);
+            sum += result.weights[index];
+        }
+        for (int tap = 0; tap < result.tap_count; ++tap) {
+            result.weights[static_cast<size_t>(i * result.tap_count + tap)] /= sum;
+        }
+    }
+    return result;
+}
+
+// scalar kernels =================================================================================================== //
+
+void premultiply_scalar(uchar* pixels, const size_t pixel_count) {
+    for (size_t i = 0; i < pixel_count; ++i) {
+        uchar* pixel = pixels + i * 4;
+        for (size_t channel = 0; channel < 3; ++channel) {
+            pixel[channel] = static_cast<uchar>(multiply_alpha(pixel[channel], pixel[3]));
+        }
+    }
+}
+
+void unpremultiply_scalar(uchar* pixels, const size_t pixel_count) {
+    for (size_t i = 0; i < pixel_count; ++i) {
+        uchar* pixel = pixels + i * 4;
+        for (size_t channel = 0; channel < 3; ++channel) {
+            pixel[channel] = pixel[3] == 0 ? 0 : static_cast<uchar>(divide_alpha(pixel[channel], pixel[3]));
+        }
+    }
+}
+
+void swizzle_scalar(uchar* pixels, const size_t pixel_count, const std::array<int, 4>& order) {
+    for (size_t i = 0; i < pixel_count; ++i) {
+        uchar* pixel = pixels + i * 4;
+        const std::array<uchar, 4> source = {pixel[0], pixel[1], pixel[2], pixel[3]};
+        for (size_t channel = 0; channel < 4; ++channel) {
+            pixel[channel] = source[static_cast<size_t>(order[channel])];
+        }
+    }
+}
+
+/// Downsamples the pixels [first_x, width / 2) of a single output row.
+void downsample_box_row_scalar(const uchar* row0, const uchar* row1, const int width, const int channels,
+                               const bool is_srgb, const int first_x, uchar* result) {
+    const std::array<float, 256>& decode = get_decode_lut();
+    const int result_width = max(width / 2, 1);
+    for (int x = first_x; x < result_width; ++x) {
+        const size_t left = static_cast<size_t>(x * 2 * channels);
+        const size_t right = static_cast<size_t>(min(x * 2 + 1, width - 1) * channels);
+        for (int channel = 0; channel < channels; ++channel) {
+            const size_t c = static_cast<size_t>(channel);
+            uchar& target = result[static_cast<size_t>(x * channels + channel)];
+            if (is_srgb && !is_alpha(channel, channels)) {
+                target = encode_linear(
+                    (decode[row0[left + c]] + decode[row0[right + c]] + decode[row1[left + c]] + decode[row1[right + c]])
+                    * 0.25f);
+            } else {
+                target = static_cast<uchar>((row0[left + c] + row0[right + c] + row1[left + c] + row1[right + c] + 2) / 4);
+            }
+        }
+    }
+}
+
+void lanczos_horizontal_scalar(const float* source, const int width, const int height, const int channels,
+                               const LanczosWeights& weights, const int result_width, float* result) {
+    for (int y = 0; y < height; ++y) {
+        const float* row = source + static_cast<size_t>(y * width * channels);
+        for (int x = 0; x < result_width; ++x) {
+            for (int channel = 0; channel < channels; ++channel) {
+                float sum = 0;
+                for (int tap = 0; tap < weights.tap_count; ++tap) {
+                    const size_t index = static_cast<size_t>(x * weights.tap_count + tap);
+                    sum += weights.weights[index] * row[weights.indices[index] * channels + channel];
+                }
+                result[static_cast<size_t>((y * result_width + x) * channels + channel)] = sum;
+            }
+        }
+    }
+}
+
+/// Filters the elements [first, row_length) of a single output row.
+void lanczos_vertical_row_scalar(const float* source, const int row_length, const LanczosWeights& weights,
+                                 const int y, const int first, float* result) {
+    for (int i = first; i < row_length; ++i) {
+        float sum = 0;
+        for (int tap = 0; tap < weights.tap_count; ++tap) {
+            const size_t index = static_cast<size_t>(y * weights.tap_count + tap);
+            sum += weights.weights[index] * source[static_cast<size_t>(weights.indices[index] * row_length + i)];
+        }
+        result[i] = sum;
+    }
+}
+
+// sse2 kernels ===================================================================================================== //
+
+#ifdef NOTF_IMAGE_KERNELS_X86
+
+// The vector kernels are split into small functions instead of lambdas, because lambdas do not inherit the target
+// attribute of the function that they are declared in.
+
+/// Premultiplies two RGBA pixels with 16 bits per channel.
+NOTF_TARGET_SSE2 inline __m128i premultiply_block_sse2(const __m128i values) {
+    const __m128i color_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alpha_one = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0); // alpha itself is multiplied by 255/255
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(values, 0xFF), 0xFF);
+    alpha = _mm_or_si128(_mm_and_si128(alpha, color_mask), alpha_one);
+    const __m128i product = _mm_add_epi16(_mm_mullo_epi16(values, alpha), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+NOTF_TARGET_SSE2 void premultiply_sse2(uchar* pixels, const size_t pixel_count) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= pixel_count; i += 4) {
+        __m128i* block = reinterpret_cast<__m128i*>(pixels + i * 4);
+        const __m128i values = _mm_loadu_si128(block);
+        _mm_storeu_si128(block, _mm_packus_epi16(premultiply_block_sse2(_mm_unpacklo_epi8(values, zero)),
+                                                 premultiply_block_sse2(_mm_unpackhi_epi8(values, zero))));
+    }
+    premultiply_scalar(pixels + i * 4, pixel_count - i);
+}
+
+/// Unpremultiplies a single RGBA pixel with 32 bits per channel.
+/// Division by zero produces an invalid integer, which is saturated to zero when packing.
+NOTF_TARGET_SSE2 inline __m128i unpremultiply_block_sse2(const __m128i values) {
+    const __m128i alpha = _mm_shuffle_epi32(values, 0xFF);
+    const __m128 dividend = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(values), _mm_set1_ps(255.f)),
+                                       _mm_cvtepi32_ps(_mm_srli_epi32(alpha, 1)));
+    return _mm_cvttps_epi32(_mm_div_ps(dividend, _mm_cvtepi32_ps(alpha)));
+}
+
+/// Restores the alpha channel of unpremultiplied RGBA pixels and clears fully transparent pixels.
+NOTF_TARGET_SSE2 inline __m128i merge_alpha_sse2(const __m128i colors, const __m128i values) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128i alpha = _mm_and_si128(values, alpha_mask);
+    const __m128i is_visible = _mm_cmpeq_epi32(_mm_cmpeq_epi32(alpha, zero), zero);
+    return _mm_or_si128(_mm_andnot_si128(alpha_mask, _mm_and_si128(colors, is_visible)), alpha);
+}
+
+NOTF_TARGET_SSE2 void unpremultiply_sse2(uchar* pixels, const size_t pixel_count) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= pixel_count; i += 4) {
+        __m128i* block = reinterpret_cast<__m128i*>(pixels + i * 4);
+        const __m128i values = _mm_loadu_si128(block);
+        const __m128i low = _mm_unpacklo_epi8(values, zero);
+        const __m128i high = _mm_unpackhi_epi8(values, zero);
+        const __m128i colors = _mm_packus_epi16(_mm_packs_epi32(unpremultiply_block_sse2(_mm_unpacklo_epi16(low, zero)),
+                                                                unpremultiply_block_sse2(_mm_unpackhi_epi16(low, zero))),
+                                                _mm_packs_epi32(unpremultiply_block_sse2(_mm_unpacklo_epi16(high, zero)),
+                                                                unpremultiply_block_sse2(_mm_unpackhi_epi16(high, zero))));
+        _mm_storeu_si128(block, merge_alpha_sse2(colors, values));
+    }
+    unpremultiply_scalar(pixels + i * 4, pixel_count - i);
+}
+
+NOTF_TARGET_SSE2 void swizzle_sse2(uchar* pixels, const size_t pixel_count, const std::array<int, 4>& order) {
+    // SSE2 has no byte shuffle, every channel is shifted into place within its 32 bit pixel instead
+    const __m128i channel_mask = _mm_set1_epi32(0xFF);
+    __m128i shifts[4];
+    for (size_t channel = 0; channel < 4; ++channel) {
+        shifts[channel] = _mm_cvtsi32_si128(order[channel] * 8);
+    }
+
+    size_t i = 0;
+    for (; i + 4 <= pixel_count; i += 4) {
+        __m128i* block = reinterpret_cast<__m128i*>(pixels + i * 4);
+        const __m128i values = _mm_loadu_si128(block);
+        __m128i result = _mm_setzero_si128();
+        for (size_t channel = 0; channel < 4; ++channel) {
+            const __m128i value = _mm_and_si128(_mm_srl_epi32(values, shifts[channel]), channel_mask);
+            result = _mm_or_si128(result, _mm_sll_epi32(value, _mm_cvtsi32_si128(static_cast<int>(channel) * 8)));
+        }
+        _mm_storeu_si128(block, result);
+    }
+    swizzle_scalar(pixels + i * 4, pixel_count - i, order);
+}
+
+/// Averages two rows of four RGBA pixels into two output pixels with 16 bits per channel.
+NOTF_TARGET_SSE2 inline __m128i downsample_box_block_sse2(const __m128i top, const __m128i bottom) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i left = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+    const __m128i right = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+    const __m128i sum = _mm_unpacklo_epi64(_mm_add_epi16(left, _mm_srli_si128(left, 8)),
+                                           _mm_add_epi16(right, _mm_srli_si128(right, 8)));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+NOTF_TARGET_SSE2 int downsample_box_row_sse2(const uchar* row0, const uchar* row1, const int result_width,
+                                             uchar* result) {
+    int x = 0;
+    for (; x + 4 <= result_width; x += 4) {
+        const __m128i* top = reinterpret_cast<const __m128i*>(row0 + x * 8);
+        const __m128i* bottom = reinterpret_cast<const __m128i*>(row1 + x * 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + x * 4),
+                         _mm_packus_epi16(downsample_box_block_sse2(_mm_loadu_si128(top), _mm_loadu_si128(bottom)),
+                                          downsample_box_block_sse2(_mm_loadu_si128(top + 1),
+                                                                    _mm_loadu_si128(bottom + 1))));
+    }
+    return x;
+}
+
+NOTF_TARGET_SSE2 void lanczos_horizontal_sse2(const float* source, const int width, const int height,
+                                              const LanczosWeights& weights, const int result_width, float* result) {
+    for (int y = 0; y < height; ++y) {
+        const float* row = source + static_cast<size_t>(y * width * 4);
+        for (int x = 0; x < result_width; ++x) {
+            __m128 sum = _mm_setzero_ps();
+            for (int tap = 0; tap < weights.tap_count; ++tap) {
+                const size_t index = static_cast<size_t>(x * weights.tap_count + tap);
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights.weights[index]),
+                                                 _mm_loadu_ps(row + weights.indices[index] * 4)));
+            }
+            _mm_storeu_ps(result + static_cast<size_t>((y * result_width + x) * 4), sum);
+        }
+    }
+}
+
+NOTF_TARGET_SSE2 int lanczos_vertical_row_sse2(const float* source, const int row_length,
+                                               const LanczosWeights& weights, const int y, float* result) {
+    int i = 0;
+    for (; i + 4 <= row_length; i += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (int tap = 0; tap < weights.tap_count; ++tap) {
+            const size_t index = static_cast<size_t>(y * weights.tap_count + tap);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights.weights[index]),
+                                             _mm_loadu_ps(source + weights.indices[index] * row_length + i)));
+        }
+        _mm_storeu_ps(result + i, sum);
+    }
+    return i;
+}
+
+// avx2 kernels ===================================================================================================== //
+
+/// Premultiplies four RGBA pixels with 16 bits per channel.
+NOTF_TARGET_AVX2 inline __m256i premultiply_block_avx2(const __m256i values) {
+    const __m256i color_mask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+    const __m256i alpha_one = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(values, 0xFF), 0xFF);
+    alpha = _mm256_or_si256(_mm256_and_si256(alpha, color_mask), alpha_one);
+    const __m256i product = _mm256_add_epi16(_mm256_mullo_epi16(values, alpha), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+NOTF_TARGET_AVX2 void premultiply_avx2(uchar* pixels, const size_t pixel_count) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        __m256i* block = reinterpret_cast<__m256i*>(pixels + i * 4);
+        const __m256i values = _mm256_loadu_si256(block);
+        // unpacking and packing both work within 128 bit lanes, so the pixels stay in order
+        _mm256_storeu_si256(block, _mm256_packus_epi16(premultiply_block_avx2(_mm256_unpacklo_epi8(values, zero)),
+                                                       premultiply_block_avx2(_mm256_unpackhi_epi8(values, zero))));
+    }
+    premultiply_sse2(pixels + i * 4, pixel_count - i);
+}
+
+/// Unpremultiplies two RGBA pixels with 32 bits per channel, one per 128 bit lane.
+NOTF_TARGET_AVX2 inline __m256i unpremultiply_block_avx2(const uchar* pixels) {
+    const __m256i values = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels)));
+    const __m256i alpha = _mm256_shuffle_epi32(values, 0xFF);
+    const __m256 dividend = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(values), _mm256_set1_ps(255.f)),
+                                          _mm256_cvtepi32_ps(_mm256_srli_epi32(alpha, 1)));
+    return _mm256_cvttps_epi32(_mm256_div_ps(dividend, _mm256_cvtepi32_ps(alpha)));
+}
+
+NOTF_TARGET_AVX2 void unpremultiply_avx2(uchar* pixels, const size_t pixel_count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha_mask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+    const __m256i pixel_order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        uchar* first = pixels + i * 4;
+        const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        // packing interleaves the 128 bit lanes, the permutation puts the pixels back in order
+        const __m256i colors = _mm256_permutevar8x32_epi32(
+            _mm256_packus_epi16(
+                _mm256_packs_epi32(unpremultiply_block_avx2(first), unpremultiply_block_avx2(first + 8)),
+                _mm256_packs_epi32(unpremultiply_block_avx2(first + 16), unpremultiply_block_avx2(first + 24))),
+            pixel_order);
+        const __m256i alpha = _mm256_and_si256(values, alpha_mask);
+        const __m256i is_visible = _mm256_cmpeq_epi32(_mm256_cmpeq_epi32(alpha, zero), zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(first),
+                            _mm256_or_si256(_mm256_andnot_si256(alpha_mask, _mm256_and_si256(colors, is_visible)),
+                                            alpha));
+    }
+    unpremultiply_sse2(pixels + i * 4, pixel_count - i);
+}
+
+NOTF_TARGET_AVX2 void swizzle_avx2(uchar* pixels, const size_t pixel_count, const std::array<int, 4>& order) {
+    std::array<char, 32> indices;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = static_cast<char>((i / 4) * 4 % 16 + static_cast<size_t>(order[i % 4])); // within 128 bit lanes
+    }
+    const __m256i shuffle = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices.data()));
+
+    size_t i = 0;
+    for (; i + 8 <= pixel_count; i += 8) {
+        __m256i* block = reinterpret_cast<__m256i*>(pixels + i * 4);
+        _mm256_storeu_si256(block, _mm256_shuffle_epi8(_mm256_loadu_si256(block), shuffle));
+    }
+    swizzle_scalar(pixels + i * 4, pixel_count - i, order);
+}
+
+/// Averages two rows of eight RGBA pixels into four output pixels with 16 bits per channel.
+/// The result contains output pixels 0 and 1 in its lower, and 2 and 3 in its upper 128 bit lane.
+NOTF_TARGET_AVX2 inline __m256i downsample_box_block_avx2(const uchar* row0, const uchar* row1) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i top = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0));
+    const __m256i bottom = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1));
+    const __m256i left = _mm256_add_epi16(_mm256_unpacklo_epi8(top, zero), _mm256_unpacklo_epi8(bottom, zero));
+    const __m256i right = _mm256_add_epi16(_mm256_unpackhi_epi8(top, zero), _mm256_unpackhi_epi8(bottom, zero));
+    const __m256i sum = _mm256_unpacklo_epi64(_mm256_add_epi16(left, _mm256_srli_si256(left, 8)),
+                                              _mm256_add_epi16(right, _mm256_srli_si256(right, 8)));
+    return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(2)), 2);
+}
+
+NOTF_TARGET_AVX2 int downsample_box_row_avx2(const uchar* row0, const uchar* row1, const int result_width,
+                                             uchar* result) {
+    int x = 0;
+    for (; x + 8 <= result_width; x += 8) {
+        const size_t offset = static_cast<size_t>(x * 8);
+        const __m256i packed = _mm256_packus_epi16(downsample_box_block_avx2(row0 + offset, row1 + offset),
+                                                   downsample_box_block_avx2(row0 + offset + 32, row1 + offset + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + x * 4),
+                            _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    return x + downsample_box_row_sse2(row0 + x * 8, row1 + x * 8, result_width - x, result + x * 4);
+}
+
+NOTF_TARGET_AVX2 int lanczos_vertical_row_avx2(const float* source, const int row_length,
+                                               const LanczosWeights& weights, const int y, float* result) {
+    int i = 0;
+    for (; i + 8 <= row_length; i += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for (int tap = 0; tap < weights.tap_count; ++tap) {
+            const size_t index = static_cast<size_t>(y * weights.tap_count + tap);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights.weights[index]),
+                                                   _mm256_loadu_ps(source + weights.indices[index] * row_length + i)));
+        }
+        _mm256_storeu_ps(result + i, sum);
+    }
+    return i;
+}
+
+#endif // NOTF_IMAGE_KERNELS_X86
+
+} // namespace
+
+// image kernels ==================================================================================================== //
+
+ImageKernelSet get_best_image_kernel_set() {
+#ifdef NOTF_IMAGE_KERNELS_X86
+    static const ImageKernelSet best = __builtin_cpu_supports("avx2") ?
+                                           ImageKernelSet::AVX2 :
+                                           (__builtin_cpu_supports("sse2") ? ImageKernelSet::SSE2 :
+                                                                             ImageKernelSet::SCALAR);
+    return best;
+#else
+    return ImageKernelSet::SCALAR;
+#endif
+}
+
+ImageKernelSet get_image_kernel_set() { return get_kernel_set(); }
+
+void set_image_kernel_set(const ImageKernelSet set) {
+    if (to_number(set) > to_number(get_best_image_kernel_set())) {
+        NOTF_THROW(ValueError, "The CPU does not support image kernel set {}", to_number(set));
+    }
+    get_kernel_set() = set;
+}
+
+void premultiply_alpha(uchar* pixels, const size_t pixel_count) {
+    switch (get_image_kernel_set()) {
+#ifdef NOTF_IMAGE_KERNELS_X86
+    case ImageKernelSet::AVX2: return premultiply_avx2(pixels, pixel_count);
+    case ImageKernelSet::SSE2: return premultiply_sse2(pixels, pixel_count);
+#endif
+    default: return premultiply_scalar(pixels, pixel_count);
+    }
+}
+
+void unpremultiply_alpha(uchar* pixels, const size_t pixel_count) {
+    switch (get_image_kernel_set()) {
+#ifdef NOTF_IMAGE_KERNELS_X86
+    case ImageKernelSet::AVX2: return unpremultiply_avx2(pixels, pixel_count);
+    case ImageKernelSet::SSE2: return unpremultiply_sse2(pixels, pixel_count);
+#endif
+    default: return unpremultiply_scalar(pixels, pixel_count);
+    }
+}
+
+void swizzle_channels(uchar* pixels, const size_t pixel_count, const std::array<int, 4>& order) {
+    for (const int index : order) {
+        if (index < 0 || index > 3) { NOTF_THROW(ValueError, "Invalid channel index {} for RGBA pixels", index); }
+    }
+    switch (get_image_kernel_set()) {
+#ifdef NOTF_IMAGE_KERNELS_X86
+    case ImageKernelSet::AVX2: return swizzle_avx2(pixels, pixel_count, order);
+    case ImageKernelSet::SSE2: return swizzle_sse2(pixels, pixel_count, order);
+#endif
+    default: return swizzle_scalar(pixels, pixel_count, order);
+    }
+}
+
+// 8 bit channels are converted with a lookup table, which is faster than any vectorized calculation
+void decode_srgb(uchar* pixels, const size_t pixel_count, const int channels) {
+    static const std::array<uchar, 256> lut = [] {
+        std::array<uchar, 256> result;
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = to_byte(get_decode_lut()[i] * 255.f);
+        }
+        return result;
+    }();
+    apply_color_lut(pixels, pixel_count, channels, lut);
+}
+
+void encode_srgb(uchar* pixels, const size_t pixel_count, const int channels) {
+    static const std::array<uchar, 256> lut = [] {
+        std::array<uchar, 256> result;
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = static_cast<uchar>(std::lround(linear_to_srgb(static_cast<float>(i) / 255.f) * 255.f));
+        }
+        return result;
+    }();
+    apply_color_lut(pixels, pixel_count, channels, lut);
+}
+
+std::vector<uchar> downsample_box(const uchar* pixels, const Size2i& size, const int channels, const bool is_srgb) {
+    const Size2i result_size = get_mip_size(size, 1);
+    const size_t row_length = static_cast<size_t>(size.get_width() * channels);
+    const size_t result_row_length = static_cast<size_t>(result_size.get_width() * channels);
+    std::vector<uchar> result(result_row_length * static_cast<size_t>(result_size.get_height()));
+
+    // the vectorized kernels handle RGBA images in linear color space that are at least 2 pixels wide
+    const ImageKernelSet kernel_set
+        = (channels == 4 && !is_srgb && size.get_width() > 1) ? get_image_kernel_set() : ImageKernelSet::SCALAR;
+    for (int y = 0; y < result_size.get_height(); ++y) {
+        const uchar* row0 = pixels + static_cast<size_t>(y * 2) * row_length;
+        const uchar* row1 = pixels + static_cast<size_t>(min(y * 2 + 1, size.get_height() - 1)) * row_length;
+        uchar* result_row = result.data() + static_cast<size_t>(y) * result_row_length;
+        int first_x = 0;
+        switch (kernel_set) {
+#ifdef NOTF_IMAGE_KERNELS_X86
+        case ImageKernelSet::AVX2:
+            first_x = downsample_box_row_avx2(row0, row1, result_size.get_width(), result_row);
+            break;
+        case ImageKernelSet::SSE2:
+            first_x = downsample_box_row_sse2(row0, row1, result_size.get_width(), result_row);
+            break;
+#endif
+        default: break;
+        }
+        downsample_box_row_scalar(row0, row1, size.get_width(), channels, is_srgb, first_x, result_row);
+    }
+    return result;
+}
+
+std::vector<uchar> downsample_lanczos(const uchar* pixels, const Size2i& size, const int channels,
+                                      const Size2i& target_size, const bool is_srgb) {
+    if (size.get_area() <= 0 || target_size.get_area() <= 0) {
+        NOTF_THROW(ValueError, "Cannot resize an image of {}x{} pixels to {}x{}", size.get_width(), size.get_height(),
+                   target_size.get_width(), target_size.get_height());
+    }
+    const int width = size.get_width();
+    const int height = size.get_height();
+    const int result_width = target_size.get_width();
+    const int result_height = target_size.get_height();
+
+    // convert to floats in linear color space
+    const std::array<float, 256>& decode = get_decode_lut();
+    std::vector<float> source(static_cast<size_t>(size.get_area() * channels));
+    for (size_t i = 0; i < source.size(); ++i) {
+        const bool is_color = !is_alpha(static_cast<int>(i % static_cast<size_t>(channels)), channels);
+        source[i] = (is_srgb && is_color) ? decode[pixels[i]] * 255.f : static_cast<float>(pixels[i]);
+    }
+
+    // resize horizontally, then vertically
+    const ImageKernelSet kernel_set = get_image_kernel_set();
+    const LanczosWeights horizontal = calculate_lanczos_weights(width, result_width);
+    std::vector<float> intermediate(static_cast<size_t>(result_width * height * channels));
+#ifdef NOTF_IMAGE_KERNELS_X86
+    if (kernel_set != ImageKernelSet::SCALAR && channels == 4) {
+        lanczos_horizontal_sse2(source.data(), width, height, horizontal, result_width, intermediate.data());
+    } else
+#endif
+    {
+        lanczos_horizontal_scalar(source.data(), width, height, channels, horizontal, result_width,
+                                  intermediate.data());
+    }
+
+    const LanczosWeights vertical = calculate_lanczos_weights(height, result_height);
+    const int row_length = result_width * channels;
+    std::vector<float> row(static_cast<size_t>(row_length));
+    std::vector<uchar> result(static_cast<size_t>(row_length * result_height));
+    for (int y = 0; y < result_height; ++y) {
+        int first = 0;
+        switch (kernel_set) {
+#ifdef NOTF_IMAGE_KERNELS_X86
+        case ImageKernelSet::AVX2:
+            first = lanczos_vertical_row_avx2(intermediate.data(), row_length, vertical, y, row.data());
+            break;
+        case ImageKernelSet::SSE2:
+            first = lanczos_vertical_row_sse2(intermediate.data(), row_length, vertical, y, row.data());
+            break;
+#endif
+        default: break;
+        }
+        lanczos_vertical_row_scalar(intermediate.data(), row_length, vertical, y, first, row.data());
+
+        // convert back to 8 bits
+        uchar* result_row = result.data() + static_cast<size_t>(y * row_length);
+        for (int i = 0; i < row_length; ++i) {
+            const bool is_color = !is_alpha(i % channels, channels);
+            result_row[i] = (is_srgb && is_color) ? encode_linear(row[static_cast<size_t>(i)] / 255.f) :
+                                                    to_byte(row[static_cast<size_t>(i)]);
+        }
+    }
+    return result;
+}
+
+Size2i get_mip_size(const Size2i& size, const int level) {
+    return Size2i(max(size.get_width() >> level, 1), max(size.get_height() >> level, 1));
+}
+
+std::vector<std::vector<uchar>> produce_mip_chain(const uchar* pixels, const Size2i& size, const int channels,
+                                                  const bool is_srgb) {
+    std::vector<std::vector<uchar>> result;
+    Size2i level_size = size;
+    const uchar* level_pixels = pixels;
+    while (level_size.get_width() > 1 || level_size.get_height() > 1) {
+        result.emplace_back(downsample_box(level_pixels, level_size, channels, is_srgb));
+        level_size = get_mip_size(level_size, 1);
+        level_pixels = result.back().data();
+    }
+    return result;
+}
+
+NOTF_CLOSE_NAMESPACE
@@ -4,12 +4,22 @@ NOTF_OPEN_NAMESPACE
 
 // ================================================================================================================== //
 
+namespace {
+
+/// Last generation assigned to any PlotterDesign.
+std::atomic<size_t> g_last_generation = 0;
+
+} // namespace
+
+// ================================================================================================================== //
+
 void PlotterDesign::_complete() {
     // TODO: optimize plotter design after it has been completed
     //  1. Drop intermediary Commands (like multiple set_xform-Commands, but is true for all).
     //  2. Remove all stroke-related Commands after the last `stroke` Command was issued (same for fill and write).
     //  3. Remove double stroke/fill/writes without change in xform (only if fully opaque)
 
+    m_generation = ++g_last_generation;
     m_is_dirty.store(false, std::memory_order_release);
 }
 
@@ -0,0 +1,770 @@
+#include "notf/graphic/plotter/frame_builder.hpp"
+
+#include <algorithm>
+
+#include "notf/meta/log.hpp"
+
+#include "notf/common/geo/bezier.hpp"
+#include "notf/common/thread_pool.hpp"
+#include "notf/common/variant.hpp"
+
+#include "notf/graphic/graphics_system.hpp"
+#include "notf/graphic/plotter/design.hpp"
+#include "notf/graphic/text/font_manager.hpp"
+#include "notf/graphic/text/text_layout.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+using Vertex = Plotter::FrameBuilder::Vertex;
+
+/// Minimum number of frames that a resident Path stays in the buffers after it was last drawn.
+/// Paths that were drawn in more frames stay resident for longer, up to the maximum number of frames.
+constexpr uint g_min_path_lifetime = 2;
+constexpr uint g_max_path_lifetime = 300;
+
+/// Minimum number of vertices left behind by evicted Paths, before the resident Paths are compacted.
+constexpr uint g_min_compaction_size = 1024;
+
+/// Minimum number of Designs that are parsed together by a single thread.
+constexpr size_t g_min_chunk_size = 64;
+
+/// Maximum number of chunks per thread that Designs are split into when parsed in parallel.
+constexpr size_t g_chunks_per_thread = 4;
+
+// vertex =========================================================================================================== //
+
+/// Sets the position of a Vertex.
+/// @param vertex   Vertex to modify.
+/// @param pos      Position in global coordinates.
+void set_pos(Vertex& vertex, V2f pos) { std::get<0>(vertex) = std::move(pos); }
+
+/// Sets the control point on the left of the Vertex.
+/// @param vertex   Vertex to modify.
+/// @param pos      Position in global coordinates.
+void set_left_ctrl(Vertex& vertex, V2f pos) { std::get<1>(vertex) = std::move(pos); }
+
+/// Sets the control point on the right of the Vertex.
+/// @param vertex   Vertex to modify.
+/// @param pos      Position in global coordinates.
+void set_right_ctrl(Vertex& vertex, V2f pos) { std::get<2>(vertex) = std::move(pos); }
+
+/// Sets the control point on the left of the Vertex from a spline.
+/// We might have to modify the given ctrl point so we can be certain that is stores the outgoing tangent
+/// of the vertex. For that, we get the tangent either from the ctrl point itself (if the distance to the
+/// vertex > 0) or by calculating the tangent from the spline at the vertex. The control point is then moved
+/// onto the tangent, one unit further away from the vertex than originally. If we encounter a ctrl point in
+/// the shader that is of unit length, we know that in reality it was positioned on the vertex itself and
+/// still get the vertex tangent.
+/// @param vertex   Vertex to modify.
+/// @param bezier   Bezier segment on the right of the vertex position.
+void set_left_ctrl(Vertex& vertex, const CubicBezier2f bezier) {
+    V2f delta = bezier.get_vertex(2) - bezier.get_vertex(3);
+    const float mag_sq = delta.get_magnitude_sq();
+    if (is_zero(mag_sq, precision_high<float>())) {
+        const SquareBezier2f derivate = bezier.get_derivate();
+        set_left_ctrl(vertex, -derivate.interpolate(0).normalize());
+    } else {
+        set_left_ctrl(vertex, delta *= 1 + (1 / sqrt(mag_sq)));
+    }
+}
+
+/// Sets the second control point from a spline.
+/// See `set_ctrl1` on why this method is needed.
+/// @param vertex   Vertex to modify.
+/// @param bezier   Bezier segment on the right of the vertex position.
+void set_right_ctrl(Vertex& vertex, const CubicBezier2f bezier) {
+    V2f delta = bezier.get_vertex(1) - bezier.get_vertex(0);
+    const float mag_sq = delta.get_magnitude_sq();
+    if (is_zero(mag_sq, precision_high<float>())) {
+        const SquareBezier2f derivate = bezier.get_derivate();
+        set_right_ctrl(vertex, derivate.interpolate(0).normalize());
+    } else {
+        set_right_ctrl(vertex, delta *= 1 + (1 / sqrt(mag_sq)));
+    }
+}
+
+} // namespace
+
+// plotter frame builder ============================================================================================ //
+
+Plotter::FrameBuilder::FrameBuilder(std::vector<Vertex>& vertices, std::vector<Index>& indices,
+                                    std::vector<PaintBlock>& paints, std::vector<Instance>& instances,
+                                    std::vector<Command>& commands)
+    : m_vertices(vertices), m_indices(indices), m_paint_blocks(paints), m_instances(instances), m_commands(commands) {}
+
+void Plotter::FrameBuilder::start_frame() {
+    ++m_frame;
+    m_statistics = {};
+
+    // remove paths that haven't been drawn in a while, all others stay resident in the vertex- and index buffer
+    _evict_paths();
+
+    // remove the fragments of all designs that were not drawn in the last frame, their designs might not even exist
+    for (auto itr = m_retained_fragments.begin(); itr != m_retained_fragments.end();) {
+        if (itr->second.last_frame + 1 < m_frame) {
+            itr = m_retained_fragments.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    m_extra_fragment_count = 0;
+
+    // the designs drawn in the last frame are compared against the ones drawn in this frame to find the damaged area
+    std::swap(m_drawn_designs, m_last_drawn_designs);
+    m_drawn_designs.clear();
+
+    // paths stored in a frame that was skipped for lack of damage are resident nonetheless
+    if (!m_is_frame_finished) {
+        m_resident_vertex_count = narrow_cast<uint>(m_vertices.size());
+        m_resident_index_count = narrow_cast<uint>(m_indices.size());
+    }
+    m_is_frame_finished = false;
+
+    // clear all buffers, except for resident paths
+    m_vertices.resize(m_resident_vertex_count);
+    m_indices.resize(m_resident_index_count);
+    m_paint_blocks.clear();
+    m_paint_indices.clear();
+    m_text_vertices.clear();
+    m_text_indices.clear();
+    m_text_paths.clear();
+
+    // reset the frame state
+    m_paths.clear();
+    m_xforms.clear();
+    m_clips.clear();
+    m_clip_indices.clear();
+    m_drawcalls.clear();
+
+    // TODO: mutable paths
+    //       Immutable paths are great for shapes and icons etc. But there are two other kind of paths that would be
+    //       nice to have in order to get maximum performance. Maybe they should be their own classes, maybe they should
+    //       be some sort of variant (managed via a shared_ptr like the current Path2), we'll see.
+    //       * The first type would be a mutable path, with a fixed number of vertices. Like an audio waveform or that
+    //         example graph from the nanovg application. It would be wasteful to allocate a completely new vector each
+    //         frame, but with the current Path2 we cannot modify the existing vertices one created. This type would
+    //         re-use the client-side memory but still be threadsafe when read from the render thread. A block of server
+    //         memory reserved for these kinds of paths would be updated not once but many times, each time with a very
+    //         small update only. This can happen in parallel because we know the location of each path.
+    //       * The second type is a straight-up mutable path, throwaway paths. Is there anything we can do then just to
+    //         create new Path2Ptrs each time?
+}
+
+void Plotter::FrameBuilder::parse(const PlotterDesign& design, const M3f& base_xform, const Aabrf& clip) {
+    const DesignInstance instance{&design, base_xform, clip};
+    auto [fragment, needs_parsing] = _retain_fragment(instance);
+    if (needs_parsing) { _parse(instance, *fragment); }
+    _merge_fragment(*fragment, m_drawn_designs.back());
+}
+
+void Plotter::FrameBuilder::parse(const std::vector<DesignInstance>& designs, ThreadPool& thread_pool) {
+    if (designs.empty()) { return; }
+
+    // only designs without a re-usable fragment need to be parsed
+    const size_t first_drawn = m_drawn_designs.size();
+    std::vector<_Fragment*> fragments(designs.size());
+    std::vector<size_t> dirty_designs;
+    for (size_t index = 0; index < designs.size(); ++index) {
+        bool needs_parsing;
+        std::tie(fragments[index], needs_parsing) = _retain_fragment(designs[index]);
+        if (needs_parsing) { dirty_designs.emplace_back(index); }
+    }
+
+    // parse the dirty designs in parallel, each fragment is only written by a single thread
+    thread_pool.for_each_chunk(dirty_designs.size(), g_min_chunk_size, g_chunks_per_thread,
+                               [&](const size_t first, const size_t last) {
+                                   for (size_t i = first; i < last; ++i) {
+                                       const size_t index = dirty_designs[i];
+                                       _parse(designs[index], *fragments[index]);
+                                   }
+                               });
+
+    // merge the fragments in order
+    for (size_t index = 0; index < fragments.size(); ++index) {
+        _merge_fragment(*fragments[index], m_drawn_designs[first_drawn + index]);
+    }
+}
+
+Aabri Plotter::FrameBuilder::get_damage() {
+    Aabrf damage = Aabrf::wrongest();
+    const auto add_damage = [&](const _DrawnDesign& drawn) {
+        if (drawn.bounds.is_valid()) { damage.unite(drawn.bounds); }
+    };
+
+    // designs are compared by their position in draw order, because overlapping designs depend on their order
+    for (size_t index = 0, end = max(m_drawn_designs.size(), m_last_drawn_designs.size()); index < end; ++index) {
+        const _DrawnDesign* current = index < m_drawn_designs.size() ? &m_drawn_designs[index] : nullptr;
+        const _DrawnDesign* last = index < m_last_drawn_designs.size() ? &m_last_drawn_designs[index] : nullptr;
+        if (current && last && current->design == last->design && !current->is_changed && !last->has_pending_glyphs) {
+            continue;
+        }
+        if (current) { add_damage(*current); }
+        if (last) { add_damage(*last); }
+        ++m_statistics.designs_damaged;
+    }
+    if (!damage.is_valid()) { return Aabri::zero(); }
+
+    // the damaged area covers every pixel that is touched by a damaged design
+    return Aabri(V2i(static_cast<int>(std::floor(damage.get_left())), static_cast<int>(std::floor(damage.get_bottom()))),
+                 V2i(static_cast<int>(std::ceil(damage.get_right())), static_cast<int>(std::ceil(damage.get_top()))));
+}
+
+void Plotter::FrameBuilder::finish_frame(const Aabrf& render_area, const Aabrf& visible_area) {
+    m_is_frame_finished = true;
+    { // all paths stored up to here stay resident, text is appended behind them and re-written every frame
+        m_resident_vertex_count = narrow_cast<uint>(m_vertices.size());
+        m_resident_index_count = narrow_cast<uint>(m_indices.size());
+        m_statistics.paths_resident = narrow_cast<uint>(m_resident_paths.size());
+
+        for (const uint path_index : m_text_paths) {
+            m_paths[path_index].vertex_offset += narrow_cast<int>(m_resident_vertex_count);
+            m_paths[path_index].index_offset += m_resident_index_count;
+        }
+        m_vertices.insert(m_vertices.end(), m_text_vertices.begin(), m_text_vertices.end());
+        m_indices.insert(m_indices.end(), m_text_indices.begin(), m_text_indices.end());
+    }
+
+    // group the draw calls into batches, each batch is rendered with a single draw call
+    // culled calls are removed, so that the index of each call added to the batcher is its index in `m_drawcalls`
+    m_statistics.calls_stored = narrow_cast<uint>(m_drawcalls.size());
+    m_batcher.clear(render_area);
+    size_t visible_count = 0;
+    for (size_t index = 0; index < m_drawcalls.size(); ++index) {
+        const DrawCall& drawcall = m_drawcalls[index];
+        const Aabrf bounds = _get_bounds(drawcall);
+        if (!bounds.intersects(visible_area)) {
+            ++m_statistics.calls_culled;
+            continue;
+        }
+        _BatchKey key = std::visit(
+            [&](const auto& call) {
+                return _BatchKey{drawcall.index(), call.path, call.paint, call.clip, call.blend_mode};
+            },
+            drawcall);
+        m_batcher.add(std::move(key), bounds);
+        if (index != visible_count) { m_drawcalls[visible_count] = drawcall; }
+        ++visible_count;
+    }
+    m_drawcalls.erase(m_drawcalls.begin() + static_cast<std::ptrdiff_t>(visible_count), m_drawcalls.end());
+
+    // store the per-instance parameters of each batch consecutively, and one indirect draw command per batch
+    m_instances.clear();
+    m_commands.clear();
+    for (const Batch& batch : m_batcher.get_batches()) {
+        const Path& path = m_paths[batch.key.path];
+        m_commands.emplace_back(
+            Command{narrow_cast<uint>(path.size), batch.draw_count, path.index_offset, path.vertex_offset});
+        m_batcher.for_each_draw(batch, [&](const uint draw) {
+            std::visit(overloaded{
+                           [&](const _StrokeCall& call) {
+                               m_instances.emplace_back(m_xforms[call.xform],
+                                                        V4f(call.width, static_cast<float>(to_number(call.cap)),
+                                                            static_cast<float>(to_number(call.join)), 0));
+                           },
+                           [&](const auto& call) { m_instances.emplace_back(m_xforms[call.xform], V4f::zero()); },
+                       },
+                       m_drawcalls[draw]);
+        });
+    }
+}
+
+void Plotter::FrameBuilder::_evict_paths() {
+    for (auto itr = m_resident_paths.begin(); itr != m_resident_paths.end();) {
+        const _ResidentPath& resident = itr->second;
+        const uint lifetime = clamp(resident.use_count, g_min_path_lifetime, g_max_path_lifetime);
+        if (m_frame - resident.last_frame > lifetime) {
+            m_evicted_vertex_count += resident.vertex_count;
+            m_evicted_index_count += narrow_cast<uint>(resident.path.size);
+            ++m_statistics.paths_evicted;
+            itr = m_resident_paths.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+
+    // evicted paths leave holes in the buffers, close them once they make up more than half of the buffer
+    if (m_evicted_vertex_count >= g_min_compaction_size && m_evicted_vertex_count * 2 > m_resident_vertex_count) {
+        _compact_paths();
+    }
+}
+
+void Plotter::FrameBuilder::_compact_paths() {
+    // paths that were drawn more often are moved further to the front of the buffer
+    std::vector<_ResidentPath*> order;
+    order.reserve(m_resident_paths.size());
+    for (auto& [key, resident] : m_resident_paths) {
+        order.emplace_back(&resident);
+    }
+    std::sort(order.begin(), order.end(), [](const _ResidentPath* lhs, const _ResidentPath* rhs) {
+        return lhs->use_count > rhs->use_count;
+    });
+
+    std::vector<Vertex> vertices;
+    std::vector<Index> indices;
+    vertices.reserve(m_resident_vertex_count - m_evicted_vertex_count);
+    indices.reserve(m_resident_index_count - m_evicted_index_count);
+    for (_ResidentPath* resident : order) {
+        Path& path = resident->path;
+        const auto first_vertex = m_vertices.begin() + path.vertex_offset;
+        const auto first_index = m_indices.begin() + path.index_offset;
+        path.vertex_offset = narrow_cast<int>(vertices.size());
+        path.index_offset = narrow_cast<uint>(indices.size());
+        vertices.insert(vertices.end(), first_vertex, first_vertex + resident->vertex_count);
+        indices.insert(indices.end(), first_index, first_index + path.size); // indices are relative to the path
+    }
+    m_vertices.swap(vertices);
+    m_indices.swap(indices);
+
+    // the complete buffer needs to be uploaded again
+    m_resident_vertex_count = narrow_cast<uint>(m_vertices.size());
+    m_resident_index_count = narrow_cast<uint>(m_indices.size());
+    m_evicted_vertex_count = 0;
+    m_evicted_index_count = 0;
+    m_dirty_vertex = 0;
+    m_dirty_index = 0;
+}
+
+uint Plotter::FrameBuilder::_store_path(const Path2Ptr& path) {
+    auto [itr, is_new] = m_resident_paths.try_emplace(path);
+    _ResidentPath& resident = itr->second;
+
+    // return the index of a path that was already drawn this frame
+    if (!is_new && resident.last_frame == m_frame) { return resident.frame_index; }
+
+    if (is_new) {
+        // tessellate the path in local space at the end of the resident part of the buffer, the transformation is
+        // applied per draw call in the vertex shader
+        NOTF_ASSERT(!path->get_subpaths().empty());
+        const size_t first_vertex = m_vertices.size();
+        resident.path = tessellate_path(*path, m_vertices, m_indices);
+        resident.vertex_count = narrow_cast<uint>(m_vertices.size() - first_vertex);
+        ++m_statistics.paths_added;
+    } else {
+        ++m_statistics.paths_reused;
+    }
+
+    // keep track of how often the path is drawn
+    ++resident.use_count;
+    resident.last_frame = m_frame;
+    resident.frame_index = narrow_cast<uint>(m_paths.size());
+    m_paths.emplace_back(resident.path);
+    return resident.frame_index;
+}
+
+Plotter::Path Plotter::FrameBuilder::tessellate_path(const Path2& path, std::vector<Vertex>& vertices,
+                                                     std::vector<Index>& indices) {
+    // create the new path
+    Path new_path;
+    new_path.vertex_offset = narrow_cast<int>(vertices.size());
+    new_path.index_offset = narrow_cast<uint>(indices.size());
+    new_path.center = path.get_center();
+    new_path.is_convex = path.is_convex();
+    new_path.bounds = Aabrf::wrongest();
+
+    // store new vertices in the vertex- and index buffer
+    for (const auto& subpath : path.get_subpaths()) {
+        if (subpath.segment_count == 0) { continue; }
+
+        // the hull of all control points contains the curve
+        for (uint i = 0; i < subpath.segment_count; ++i) {
+            const CubicBezier2f segment = subpath.get_segment(i);
+            for (uint vertex = 0; vertex < 4; ++vertex) {
+                new_path.bounds.grow_to(segment.get_vertex(vertex));
+            }
+        }
+
+        { // create indices
+            // no reserve, reserving the exact size for every path would re-allocate the whole buffer each time
+            const size_t expected_size = indices.size() + (subpath.segment_count * 4) + (subpath.is_closed ? 0 : 2);
+
+            // indices are relative to the first vertex of the path, not to the first vertex of the subpath
+            const Index subpath_vertex_base
+                = narrow_cast<Index>(vertices.size() - static_cast<uint>(new_path.vertex_offset));
+            const uint wrap_index = subpath.segment_count + (subpath.is_closed ? 0 : 1);
+            for (uint i = 0, index = 0; i < subpath.segment_count; ++i) {
+                // start cap / joint
+                indices.emplace_back(subpath_vertex_base + index);
+                indices.emplace_back(subpath_vertex_base + index);
+
+                // segment
+                indices.emplace_back(subpath_vertex_base + index);
+                ++index;
+                index %= wrap_index;
+                indices.emplace_back(subpath_vertex_base + index);
+            }
+
+            if (!subpath.is_closed) {
+                // end cap
+                indices.emplace_back(indices.back());
+                indices.emplace_back(indices.back());
+            }
+
+            new_path.size = narrow_cast<int>(indices.size() - new_path.index_offset);
+            NOTF_ASSERT(indices.size() == expected_size);
+        }
+
+        { // create vertices
+            const size_t expected_size = vertices.size() + subpath.segment_count + (subpath.is_closed ? 0 : 1);
+
+            { // first vertex
+                CubicBezier2f right_segment = subpath.get_segment(0);
+                Vertex vertex;
+                set_pos(vertex, right_segment.get_vertex(0));
+                if (subpath.is_closed) {
+                    set_left_ctrl(vertex, subpath.get_segment(subpath.segment_count - 1));
+                } else {
+                    set_left_ctrl(vertex, V2f::zero());
+                }
+                set_right_ctrl(vertex, std::move(right_segment));
+                vertices.emplace_back(std::move(vertex));
+            }
+
+            // middle vertices
+            for (size_t i = 0; i < subpath.segment_count - 1; ++i) {
+                CubicBezier2f right_segment = subpath.get_segment(i + 1);
+                Vertex vertex;
+                set_pos(vertex, right_segment.get_vertex(0));
+                set_left_ctrl(vertex, subpath.get_segment(i));
+                set_right_ctrl(vertex, std::move(right_segment));
+                vertices.emplace_back(std::move(vertex));
+            }
+
+            // last vertex
+            if (!subpath.is_closed) {
+                CubicBezier2f left_segment = subpath.get_segment(subpath.segment_count - 1);
+                Vertex vertex;
+                set_pos(vertex, left_segment.get_vertex(3));
+                set_left_ctrl(vertex, std::move(left_segment));
+                set_right_ctrl(vertex, V2f::zero());
+                vertices.emplace_back(std::move(vertex));
+            }
+
+            NOTF_ASSERT(vertices.size() == expected_size);
+        }
+    }
+
+    return new_path;
+}
+
+std::pair<Plotter::FrameBuilder::_Fragment*, bool>
+Plotter::FrameBuilder::_retain_fragment(const DesignInstance& design) {
+    const size_t generation = design.design->get_generation();
+    _RetainedFragment& retained = m_retained_fragments[design.design];
+    _DrawnDesign& drawn = m_drawn_designs.emplace_back(_DrawnDesign{design.design, Aabrf::wrongest(), true});
+
+    // the fragment can be re-used as it is
+    if (retained.generation == generation && retained.base_xform == design.base_xform && retained.clip == design.clip) {
+        drawn.is_changed = false;
+        if (retained.last_frame != m_frame) {
+            retained.last_frame = m_frame;
+            ++m_statistics.designs_reused;
+        }
+        return {&retained.fragment, false};
+    }
+
+    // the design was already drawn differently in this frame, parse it into an extra fragment that is not retained
+    if (retained.last_frame == m_frame) {
+        if (m_extra_fragment_count == m_extra_fragments.size()) { m_extra_fragments.emplace_back(); }
+        _Fragment& fragment = m_extra_fragments[m_extra_fragment_count++];
+        fragment.clear();
+        ++m_statistics.designs_parsed;
+        return {&fragment, true};
+    }
+    retained.last_frame = m_frame;
+
+    // if only the translation of the base transformation changed, the fragment can be moved to its new position
+    const M3f& old_xform = retained.base_xform;
+    const M3f& new_xform = design.base_xform;
+    if (retained.generation == generation && retained.clip == design.clip && old_xform[0] == new_xform[0]
+        && old_xform[1] == new_xform[1]) {
+        const V2f delta = new_xform[2] - old_xform[2];
+        for (M3f& xform : retained.fragment.xforms) {
+            xform.translate(delta);
+        }
+        retained.base_xform = new_xform;
+        ++m_statistics.designs_patched;
+        return {&retained.fragment, false};
+    }
+
+    // otherwise the design needs to be parsed again
+    retained.generation = generation;
+    retained.base_xform = design.base_xform;
+    retained.clip = design.clip;
+    retained.fragment.clear();
+    ++m_statistics.designs_parsed;
+    return {&retained.fragment, true};
+}
+
+void Plotter::FrameBuilder::_parse(const DesignInstance& design, _Fragment& fragment) {
+    // reset the state stack for each design
+    fragment.states.clear();
+    fragment.states.emplace_back();
+
+    // adopt the Design's auxiliary information
+    const M3f& base_xform = design.base_xform;
+    fragment.get_state().xform = base_xform;
+    fragment.get_state().clip = design.clip;
+
+    // replay the commands
+    design.design->replay(overloaded{
+        [&](const PlotterDesign::ResetState&) { fragment.get_state() = {}; },
+        [&](const PlotterDesign::PushState&) { fragment.states.emplace_back(fragment.states.back()); },
+        [&](const PlotterDesign::PopState&) { fragment.pop_state(); },
+        [&](const PlotterDesign::SetXform& cmd) { fragment.get_state().xform = base_xform * cmd.xform; },
+        [&](const PlotterDesign::SetPaint& cmd) { fragment.get_state().paint = cmd.paint; },
+        [&](const PlotterDesign::SetPath& cmd) { fragment.get_state().path = cmd.path; },
+        [&](const PlotterDesign::SetClip& cmd) { fragment.get_state().clip = cmd.clip; },
+        [&](const PlotterDesign::SetFont& cmd) { fragment.get_state().font = cmd.font; },
+        [&](const PlotterDesign::SetAlpha& cmd) { fragment.get_state().alpha = cmd.alpha; },
+        [&](const PlotterDesign::SetStrokeWidth& cmd) { fragment.get_state().stroke_width = cmd.stroke_width; },
+        [&](const PlotterDesign::SetBlendMode& cmd) { fragment.get_state().blend_mode = cmd.mode; },
+        [&](const PlotterDesign::SetLineCap& cmd) { fragment.get_state().line_cap = cmd.cap; },
+        [&](const PlotterDesign::SetLineJoin& cmd) { fragment.get_state().joint_style = cmd.join; },
+        [&](const PlotterDesign::Fill&) { _store_fill_call(fragment); },
+        [&](const PlotterDesign::Stroke&) { _store_stroke_call(fragment); },
+        [&](const PlotterDesign::Write& cmd) { _store_write_call(fragment, cmd.text); },
+    });
+}
+
+void Plotter::FrameBuilder::_store_call_base(_Fragment& fragment, _CallBase& call) {
+    const PainterState& state = fragment.get_state();
+    call.alpha = clamp(state.alpha, 0, 1);
+    call.blend_mode = state.blend_mode;
+
+    { // store xform
+        std::vector<M3f>& xforms = fragment.xforms;
+        if (xforms.empty() || state.xform != xforms.back()) { xforms.emplace_back(state.xform); }
+        call.xform = narrow_cast<uint>(xforms.size() - 1);
+    }
+
+    { // store paint, equal paints of all fragments are only stored once per frame when the fragment is merged
+        Paint paint = state.paint;
+        paint.inner_color.a *= call.alpha;
+        paint.outer_color.a *= call.alpha;
+        FragmentPaint fragment_paint(paint);
+        std::vector<FragmentPaint>& paints = fragment.paints;
+        if (paints.empty() || !(fragment_paint == paints.back())) { paints.emplace_back(std::move(fragment_paint)); }
+        call.paint = narrow_cast<uint>(paints.size() - 1);
+    }
+
+    { // store clip
+        std::vector<Aabrf>& clips = fragment.clips;
+        if (clips.empty() || state.clip != clips.back()) { clips.emplace_back(state.clip); }
+        call.clip = narrow_cast<uint>(clips.size() - 1);
+    }
+}
+
+void Plotter::FrameBuilder::_store_fill_call(_Fragment& fragment) {
+    // early out, if the call would have no visible effect
+    const PainterState& state = fragment.get_state();
+    if (state.path->is_empty()                                               // no path
+        || is_zero(state.alpha, precision_low<float>())                      // transparent
+        || is_zero(state.xform.get_determinant(), precision_low<float>())) { // xforms maps to zero area
+        return;
+    }
+
+    // store call
+    _FillCall call;
+    _store_call_base(fragment, call);
+    call.path = narrow_cast<uint>(fragment.paths.size());
+    fragment.paths.emplace_back(state.path);
+    fragment.drawcalls.emplace_back(std::move(call));
+}
+
+void Plotter::FrameBuilder::_store_stroke_call(_Fragment& fragment) {
+    // early out, if the call would have no visible effect
+    const PainterState& state = fragment.get_state();
+    if (!state.path || state.path->is_empty()                                // no path
+        || is_zero(state.stroke_width, precision_low<float>())               // zero width
+        || is_zero(state.alpha, precision_low<float>())                      // transparent
+        || is_zero(state.xform.get_determinant(), precision_low<float>())) { // xforms maps to zero area
+        return;
+    }
+
+    _StrokeCall call;
+    _store_call_base(fragment, call);
+    call.path = narrow_cast<uint>(fragment.paths.size());
+    call.cap = state.line_cap;
+    call.join = state.joint_style;
+    call.width = abs(state.stroke_width * state.xform.get_scale_factor());
+    fragment.paths.emplace_back(state.path);
+    fragment.drawcalls.emplace_back(std::move(call));
+}
+
+void Plotter::FrameBuilder::_store_write_call(_Fragment& fragment, std::string_view text) {
+    // early out, if the call would have no visible effect
+    const PainterState& state = fragment.get_state();
+    if (text.empty()                                                         // no text
+        || is_zero(state.alpha, precision_low<float>())                      // transparent
+        || is_zero(state.xform.get_determinant(), precision_low<float>())) { // xforms maps to zero area
+        return;
+    }
+    if (!state.font) {
+        NOTF_LOG_WARN("Cannot render a text without a font"); // TODO Plotter default font?
+        return;
+    }
+    // the Plotter can only draw coverage glyphs, which is reported once when a distance field Font is loaded
+    if (state.font->is_distance_field()) { return; }
+
+    // store call, the glyphs are created when the fragment is merged
+    _WriteCall call;
+    _store_call_base(fragment, call);
+    call.path = narrow_cast<uint>(fragment.texts.size());
+    fragment.texts.emplace_back(
+        _Text{narrow_cast<uint>(fragment.characters.size()), narrow_cast<uint>(text.size()), state.font});
+    fragment.characters.append(text);
+    fragment.drawcalls.emplace_back(std::move(call));
+}
+
+void Plotter::FrameBuilder::_merge_fragment(const _Fragment& fragment, _DrawnDesign& drawn) {
+    // transformations are appended, so their indices are offset by the number of existing ones
+    const uint xform_offset = narrow_cast<uint>(m_xforms.size());
+    m_xforms.insert(m_xforms.end(), fragment.xforms.begin(), fragment.xforms.end());
+
+    // clips are interned, so that draw calls of different Designs with the same clip can be batched
+    m_fragment_clips.clear();
+    for (const Aabrf& clip : fragment.clips) {
+        m_fragment_clips.emplace_back(_store_clip(clip));
+    }
+
+    // consecutive draw calls often share a paint, which then only needs to be looked up once
+    uint fragment_paint = max_v<uint>;
+    uint paint = 0;
+
+    for (DrawCall drawcall : fragment.drawcalls) {
+        std::visit(overloaded{
+                       [&](_WriteCall& call) {
+                           const _Text& text = fragment.texts[call.path];
+                           call.path = _store_text(fragment.get_characters(text), *text.font,
+                                                   fragment.xforms[call.xform], drawn.has_pending_glyphs);
+                       },
+                       [&](auto& call) { call.path = _store_path(fragment.paths[call.path]); },
+                   },
+                   drawcall);
+        std::visit(
+            [&](_CallBase& call) {
+                if (call.paint != fragment_paint) {
+                    fragment_paint = call.paint;
+                    paint = _store_paint(fragment.paints[call.paint]);
+                }
+                call.paint = paint;
+                call.xform += xform_offset;
+                call.clip = m_fragment_clips[call.clip];
+            },
+            drawcall);
+        drawn.bounds.unite(_get_bounds(drawcall));
+        m_drawcalls.emplace_back(std::move(drawcall));
+    }
+    m_statistics.paints_stored += narrow_cast<uint>(fragment.drawcalls.size());
+}
+
+uint Plotter::FrameBuilder::_store_paint(const FragmentPaint& paint) {
+    auto [itr, is_new] = m_paint_indices.try_emplace(paint, 0);
+    if (is_new) {
+        itr->second = narrow_cast<uint>(m_paint_blocks.size());
+        m_paint_blocks.emplace_back(paint);
+        ++m_statistics.paints_uploaded;
+    }
+    return itr->second;
+}
+
+uint Plotter::FrameBuilder::_store_clip(const Aabrf& clip) {
+    auto [itr, is_new] = m_clip_indices.try_emplace(clip, 0);
+    if (is_new) {
+        itr->second = narrow_cast<uint>(m_clips.size());
+        m_clips.emplace_back(clip);
+    }
+    return itr->second;
+}
+
+uint Plotter::FrameBuilder::_store_text(const std::string_view text, const Font& font, const M3f& xform,
+                                        bool& has_pending) {
+    // text is not kept resident, its offsets are fixed up when it is appended to the buffers in `finish_frame`
+    std::vector<Vertex>& vertices = m_text_vertices;
+    std::vector<Index>& indices = m_text_indices;
+
+    // create the new path
+    Path new_path;
+    new_path.vertex_offset = narrow_cast<int>(vertices.size());
+    new_path.index_offset = narrow_cast<uint>(indices.size());
+    new_path.bounds = Aabrf::wrongest();
+
+    { // vertices
+        // the layout of texts that do not change is cached, so only the glyphs have to be looked up again
+        const TextLayoutCache& layout_cache = TheGraphicsSystem()->get_font_manager().get_layout_cache();
+        const size_t layout_misses = layout_cache.get_statistics().misses;
+        const TextLayoutConstPtr layout = font.get_layout(text);
+        if (layout_cache.get_statistics().misses == layout_misses) {
+            ++m_statistics.text_layouts_reused;
+        } else {
+            ++m_statistics.text_layouts_created;
+        }
+
+        // make sure that text is always rendered on the pixel grid, not between pixels
+        // distance field Fonts, which could be placed anywhere, are rejected in `_store_write_call`
+        NOTF_ASSERT(!font.is_distance_field());
+        const V2f position = V2f::zero() * xform;
+        const float x = roundf(position.x());
+        const float y = roundf(position.y());
+        // TODO Glyphs cannot be rotated, sheared or otherwise transformed, only translated
+
+        for (const TextLayout::Character& character : layout->get_characters()) {
+            const Glyph& glyph = font.get_glyph(character.codepoint);
+
+            // skip glyphs without pixels, or whose pixels are not ready yet
+            if (!glyph.rect.width || !glyph.rect.height) {
+                if (font.is_pending(character.codepoint)) { has_pending = true; }
+                continue;
+            }
+
+            // quad which renders the glyph
+            const Aabrf quad(x + static_cast<float>(character.x + glyph.left),
+                             y + static_cast<float>(character.y - glyph.rect.height + glyph.top), glyph.rect.width,
+                             glyph.rect.height);
+            new_path.bounds.unite(quad);
+
+            // uv coordinates of the glyph - must be divided by the size of the font texture!
+            const V2f uv = V2f{glyph.rect.x, glyph.rect.y};
+
+            // create the vertex
+            Vertex vertex;
+            set_pos(vertex, uv);
+            set_left_ctrl(vertex, quad.get_bottom_left());
+            set_right_ctrl(vertex, quad.get_top_right());
+            vertices.emplace_back(std::move(vertex));
+        }
+    }
+
+    // indices, relative to the first vertex of the path like those of all other paths
+    const Index glyph_count = narrow_cast<Index>(vertices.size() - static_cast<uint>(new_path.vertex_offset));
+    for (Index i = 0; i < glyph_count; ++i) {
+        indices.emplace_back(i);
+    }
+    new_path.size = narrow_cast<int>(indices.size() - new_path.index_offset);
+
+    // store the path (is interpreted as glyph positions when rendered)
+    const uint path_index = narrow_cast<uint>(m_paths.size());
+    m_paths.emplace_back(std::move(new_path));
+    m_text_paths.emplace_back(path_index);
+
+    return path_index;
+}
+
+Aabrf Plotter::FrameBuilder::_get_bounds(const DrawCall& drawcall) const {
+    return std::visit(overloaded{
+                          [&](const _StrokeCall& call) {
+                              // grow by half the stroke width and the anti-aliasing border (see plotter.tesc)
+                              Aabrf bounds = transform_by(m_paths[call.path].bounds, m_xforms[call.xform]);
+                              return bounds.grow((call.width / 2) + 1);
+                          },
+                          [&](const _FillCall& call) {
+                              Aabrf bounds = transform_by(m_paths[call.path].bounds, m_xforms[call.xform]);
+                              return bounds.grow(1);
+                          },
+                          [&](const _WriteCall& call) { return m_paths[call.path].bounds; }, // in screen space
+                      },
+                      drawcall);
+}
+
@@ -0,0 +1,615 @@
+#include "notf/graphic/plotter/rasterizer.hpp"
+
+#include <array>
+#include <cmath>
+
+#include "notf/common/utf8.hpp"
+#include "notf/common/variant.hpp"
+
+#include "notf/graphic/plotter/design.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+using PainterState = Plotter::PainterState;
+
+/// Factors of the source and destination colors in the blend equation, see `get_blend_factors`.
+struct BlendFactors {
+    /// Source factor: constant, times the source alpha and times the destination alpha.
+    std::array<float, 3> source;
+
+    /// Destination factor: constant and times the source alpha.
+    std::array<float, 2> destination;
+};
+
+/// Factors used to blend a source color into a destination color with the given mode:
+///     result = source * (s0 + s1 * source_alpha + s2 * destination_alpha) + destination * (d0 + d1 * source_alpha)
+/// These are the same factors as used by OpenGL (see `BlendMode::OpenGLBlendMode`).
+BlendFactors get_blend_factors(const BlendMode::Mode mode) {
+    switch (mode) {
+    case BlendMode::SOURCE_OVER: return {{1, 0, 0}, {1, -1}};
+    case BlendMode::SOURCE_OVER2: return {{0, 1, 0}, {1, -1}};
+    case BlendMode::SOURCE_IN: return {{0, 0, 1}, {0, 0}};
+    case BlendMode::SOURCE_OUT: return {{1, 0, -1}, {0, 0}};
+    case BlendMode::SOURCE_ATOP: return {{0, 0, 1}, {1, -1}};
+    case BlendMode::DESTINATION_OVER: return {{1, 0, -1}, {1, 0}};
+    case BlendMode::DESTINATION_IN: return {{0, 0, 0}, {0, 1}};
+    case BlendMode::DESTINATION_OUT: return {{0, 0, 0}, {1, -1}};
+    case BlendMode::DESTINATION_ATOP: return {{1, 0, -1}, {0, 1}};
+    case BlendMode::LIGHTER: return {{1, 0, 0}, {1, 0}};
+    case BlendMode::XOR: return {{1, 0, -1}, {1, -1}};
+    case BlendMode::OFF:
+    case BlendMode::COPY: break;
+    }
+    return {{1, 0, 0}, {0, 0}};
+}
+
+/// Whether the given Aabr is used to clip, the zero and invalid Aabrs mean "no clipping".
+bool is_clipping(const Aabrf& clip) { return clip.is_valid() && clip.get_area() > 0; }
+
+/// Scale factor of the transformation, used to transform the tolerance into the space of the Path.
+float get_scale(const M3f& xform) { return std::sqrt(abs(xform.get_determinant())); }
+
+/// Whether a fill, stroke or write with the given state would have no visible effect.
+bool is_invisible(const PainterState& state) {
+    return is_zero(state.alpha, precision_low<float>())                    // transparent
+           || is_zero(state.xform.get_determinant(), precision_low<float>()); // xforms maps to zero area
+}
+
+/// Adds the signed area of a single edge to the coverage of all pixels that it touches, and the area to the right of
+/// the edge to the first pixel right of it. A running sum over a row of pixels then yields the coverage of each pixel.
+/// Each row of the coverage buffer has two additional pixels on the right, to accommodate edges on the right border.
+/// @param coverage Coverage buffer.
+/// @param width    Width of the coverage buffer in pixels, all edges must be within [0, width].
+/// @param height   Height of the coverage buffer in pixels.
+/// @param from     Start of the edge.
+/// @param to       End of the edge.
+void accumulate_edge(float* coverage, const uint width, const uint height, V2f from, V2f to) {
+    if (from.y() == to.y()) { return; }
+    float direction = 1;
+    if (from.y() > to.y()) {
+        std::swap(from, to);
+        direction = -1;
+    }
+    if (to.y() <= 0 || from.y() >= static_cast<float>(height)) { return; }
+
+    const float right = static_cast<float>(width);
+    const float dxdy = (to.x() - from.x()) / (to.y() - from.y());
+    float x = from.x();
+    if (from.y() < 0) { x -= from.y() * dxdy; }
+    const uint first_row = static_cast<uint>(max(0.f, from.y()));
+    const uint last_row = min(height, static_cast<uint>(std::ceil(to.y())));
+    for (uint row = first_row; row < last_row; ++row) {
+        float* pixels = coverage + row * (width + 2);
+        const float dy = min(static_cast<float>(row + 1), to.y()) - max(static_cast<float>(row), from.y());
+        const float x_next = x + dxdy * dy;
+        const float d = dy * direction;
+        const float x0 = clamp(min(x, x_next), 0, right);
+        const float x1 = clamp(max(x, x_next), 0, right);
+        const float x0_floor = std::floor(x0);
+        const uint x0i = static_cast<uint>(x0_floor);
+        const float x1_ceil = std::ceil(x1);
+        const uint x1i = static_cast<uint>(x1_ceil);
+
+        // the edge crosses a single pixel in this row
+        if (x1i <= x0i + 1) {
+            const float x_mid = (x0 + x1) * 0.5f - x0_floor;
+            pixels[x0i] += d - d * x_mid;
+            pixels[x0i + 1] += d * x_mid;
+        }
+
+        // the edge crosses multiple pixels, each of which is covered by a trapezoid
+        else {
+            const float s = 1 / (x1 - x0);
+            const float x0_fract = x0 - x0_floor;
+            const float a0 = 0.5f * s * (1 - x0_fract) * (1 - x0_fract);
+            const float x1_fract = x1 - x1_ceil + 1;
+            const float am = 0.5f * s * x1_fract * x1_fract;
+            pixels[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                pixels[x0i + 1] += d * (1 - a0 - am);
+            } else {
+                const float a1 = s * (1.5f - x0_fract);
+                pixels[x0i + 1] += d * (a1 - a0);
+                for (uint xi = x0i + 2; xi < x1i - 1; ++xi) {
+                    pixels[xi] += d * s;
+                }
+                const float a2 = a1 + static_cast<float>(x1i - x0i - 3) * s;
+                pixels[x1i - 1] += d * (1 - a2 - am);
+            }
+            pixels[x1i] += d * am;
+        }
+        x = x_next;
+    }
+}
+
+/// Paint and blend mode of a single fill, stroke or write, prepared to blend spans of pixels.
+class Brush {
+
+    // methods --------------------------------------------------------------------------------- //
+public:
+    /// Constructor.
+    /// @param state    State to draw with.
+    Brush(const PainterState& state)
+        : m_rgb_factors(get_blend_factors(state.blend_mode.rgb))
+        , m_alpha_factors(get_blend_factors(state.blend_mode.alpha)) {
+        const Plotter::Paint& paint = state.paint;
+        const float alpha = clamp(state.alpha, 0, 1);
+        const Color inner = Color(paint.inner_color.r, paint.inner_color.g, paint.inner_color.b,
+                                  paint.inner_color.a * alpha)
+                                .premultiplied();
+        const Color outer = Color(paint.outer_color.r, paint.outer_color.g, paint.outer_color.b,
+                                  paint.outer_color.a * alpha)
+                                .premultiplied();
+        m_inner_color = {inner.r, inner.g, inner.b, inner.a};
+        m_outer_color = {outer.r, outer.g, outer.b, outer.a};
+
+        // textures are not available on the CPU, textured paints use their inner color
+        m_is_solid = paint.texture || inner.is_approx(outer);
+        m_paint_xform = (state.xform * paint.xform).get_inverse();
+        m_extent = paint.extent;
+        m_radius = paint.gradient_radius;
+        m_feather = max(paint.feather, precision_high<float>());
+    }
+
+    /// Blends the paint into a span of pixels.
+    /// @param pixels   First pixel of the span.
+    /// @param coverage Coverage of each pixel in the span.
+    /// @param count    Number of pixels in the span.
+    /// @param center   Center of the first pixel, in image space.
+    /// @param colors   Buffer for the colors of gradient paints, is resized as needed.
+    void blend(uchar* pixels, const float* coverage, const uint count, const V2f& center,
+               std::vector<float>& colors) const {
+        if (count == 0) { return; }
+        if (m_is_solid) {
+            _blend<true>(pixels, coverage, m_inner_color.data(), count);
+        } else {
+            colors.resize(max(colors.size(), count * 4));
+            _shade(center, count, colors.data());
+            _blend<false>(pixels, coverage, colors.data(), count);
+        }
+    }
+
+private:
+    /// Evaluates the gradient of the paint for a span of pixels.
+    /// Like in nanovg, all gradients are based on the distance to a rounded rectangle in paint space, see
+    /// `get_rounded_rect_distance` in plotter.frag.
+    /// @param center   Center of the first pixel, in image space.
+    /// @param count    Number of pixels.
+    /// @param colors   Premultiplied RGBA colors of all pixels.
+    void _shade(const V2f& center, const uint count, float* colors) const {
+        const V2f origin = center * m_paint_xform;
+        const float step_x = m_paint_xform[0][0];
+        const float step_y = m_paint_xform[0][1];
+        const float inner_width = m_extent.get_width() - m_radius;
+        const float inner_height = m_extent.get_height() - m_radius;
+        const float half_feather = m_feather / 2;
+        const float inv_feather = 1 / m_feather;
+        for (uint i = 0; i < count; ++i) {
+            const float dx = std::abs(origin.x() + step_x * static_cast<float>(i)) - inner_width;
+            const float dy = std::abs(origin.y() + step_y * static_cast<float>(i)) - inner_height;
+            const float outside_x = std::max(dx, 0.f);
+            const float outside_y = std::max(dy, 0.f);
+            const float distance = std::min(std::max(dx, dy), 0.f)
+                                   + std::sqrt(outside_x * outside_x + outside_y * outside_y) - m_radius;
+            const float t = std::min(std::max((distance + half_feather) * inv_feather, 0.f), 1.f);
+            for (uint channel = 0; channel < 4; ++channel) {
+                colors[i * 4 + channel] = m_inner_color[channel] + (m_outer_color[channel] - m_inner_color[channel]) * t;
+            }
+        }
+    }
+
+    /// Blends colors into a span of pixels.
+    /// @param pixels   First pixel of the span.
+    /// @param coverage Coverage of each pixel in the span.
+    /// @param colors   Premultiplied RGBA colors, one per pixel or a single one for all pixels if `is_solid` is true.
+    /// @param count    Number of pixels in the span.
+    template<bool is_solid>
+    void _blend(uchar* pixels, const float* coverage, const float* colors, const uint count) const {
+        constexpr float to_float = 1.f / 255.f;
+        const BlendFactors& rgb = m_rgb_factors;
+        const BlendFactors& alpha = m_alpha_factors;
+        for (uint i = 0; i < count; ++i) {
+            const float* color = is_solid ? colors : colors + i * 4;
+            uchar* pixel = pixels + i * 4;
+            const float source_alpha = color[3];
+            const float destination_alpha = static_cast<float>(pixel[3]) * to_float;
+            const float rgb_source = rgb.source[0] + rgb.source[1] * source_alpha + rgb.source[2] * destination_alpha;
+            const float alpha_source
+                = alpha.source[0] + alpha.source[1] * source_alpha + alpha.source[2] * destination_alpha;
+            const std::array<float, 4> source_factor = {rgb_source, rgb_source, rgb_source, alpha_source};
+            const float rgb_destination = rgb.destination[0] + rgb.destination[1] * source_alpha;
+            const float alpha_destination = alpha.destination[0] + alpha.destination[1] * source_alpha;
+            const std::array<float, 4> destination_factor
+                = {rgb_destination, rgb_destination, rgb_destination, alpha_destination};
+
+            // coverage interpolates between the destination and the blended color
+            for (uint channel = 0; channel < 4; ++channel) {
+                const float destination = static_cast<float>(pixel[channel]) * to_float;
+                const float blended = color[channel] * source_factor[channel]
+                                      + destination * destination_factor[channel];
+                const float result = destination + (blended - destination) * coverage[i];
+                pixel[channel] = static_cast<uchar>(std::min(std::max(result, 0.f), 1.f) * 255.f + 0.5f);
+            }
+        }
+    }
+
+    // fields ---------------------------------------------------------------------------------- //
+private:
+    /// Blend factors for the color channels.
+    BlendFactors m_rgb_factors;
+
+    /// Blend factors for the alpha channel.
+    BlendFactors m_alpha_factors;
+
+    /// Premultiplied inner color of the paint.
+    std::array<float, 4> m_inner_color;
+
+    /// Premultiplied outer color of the paint.
+    std::array<float, 4> m_outer_color;
+
+    /// Transformation from image space into paint space.
+    M3f m_paint_xform;
+
+    /// Extent of the gradient.
+    Size2f m_extent;
+
+    /// Radius of the gradient.
+    float m_radius;
+
+    /// Width of the transition from the inner to the outer color.
+    float m_feather;
+
+    /// Whether every pixel has the same color.
+    bool m_is_solid;
+};
+
+} // namespace
+
+// plotter rasterizer =============================================================================================== //
+
+PlotterRasterizer::PlotterRasterizer(const Size2i& size, const float tolerance)
+    : m_size(size), m_tolerance(max(tolerance, precision_low<float>())), m_tessellator(m_tolerance) {
+    if (m_size.get_width() <= 0 || m_size.get_height() <= 0) {
+        NOTF_THROW(ValueError, "Cannot create a PlotterRasterizer with an image of size {}x{}", m_size.get_width(),
+                   m_size.get_height());
+    }
+    m_pixels.resize(static_cast<size_t>(m_size.get_area()) * get_channels(), 0);
+}
+
+void PlotterRasterizer::clear(const Color& color) {
+    const Color premultiplied = color.premultiplied();
+    const std::array<uchar, 4> pixel = {
+        static_cast<uchar>(clamp(premultiplied.r, 0, 1) * 255.f + 0.5f),
+        static_cast<uchar>(clamp(premultiplied.g, 0, 1) * 255.f + 0.5f),
+        static_cast<uchar>(clamp(premultiplied.b, 0, 1) * 255.f + 0.5f),
+        static_cast<uchar>(clamp(premultiplied.a, 0, 1) * 255.f + 0.5f),
+    };
+    for (size_t i = 0; i < m_pixels.size(); i += 4) {
+        std::copy(pixel.begin(), pixel.end(), &m_pixels[i]);
+    }
+}
+
+void PlotterRasterizer::set_font_atlas(std::vector<uchar> pixels, const Size2i& size) {
+    if (size.get_width() < 0 || size.get_height() < 0 || pixels.size() != static_cast<size_t>(size.get_area())) {
+        NOTF_THROW(ValueError, "Font atlas of size {}x{} cannot contain {} pixels", size.get_width(), size.get_height(),
+                   pixels.size());
+    }
+    m_font_atlas = std::move(pixels);
+    m_font_atlas_size = size;
+}
+
+void PlotterRasterizer::draw(const PlotterDesign& design, const M3f& base_xform, const Aabrf& clip) {
+    // the state expects the clip in image space, not in the space of the Design
+    const auto transform_clip = [&](const Aabrf& aabr) {
+        return is_clipping(aabr) ? transform_by(aabr, base_xform) : aabr;
+    };
+
+    // reset the state stack for each design
+    m_states.clear();
+    m_states.emplace_back();
+    m_states.back().xform = base_xform;
+    m_states.back().clip = transform_clip(clip);
+
+    // replay the commands
+    design.replay(overloaded{
+        [&](const PlotterDesign::ResetState&) { m_states.back() = {}; },
+        [&](const PlotterDesign::PushState&) { m_states.push_back(m_states.back()); },
+        [&](const PlotterDesign::PopState&) {
+            if (m_states.size() > 1) {
+                m_states.pop_back();
+            } else {
+                m_states.back() = {};
+            }
+        },
+        [&](const PlotterDesign::SetXform& cmd) { m_states.back().xform = base_xform * cmd.xform; },
+        [&](const PlotterDesign::SetPaint& cmd) { m_states.back().paint = cmd.paint; },
+        [&](const PlotterDesign::SetPath& cmd) { m_states.back().path = cmd.path; },
+        [&](const PlotterDesign::SetClip& cmd) { m_states.back().clip = transform_clip(cmd.clip); },
+        [&](const PlotterDesign::SetFont& cmd) { m_states.back().font = cmd.font; },
+        [&](const PlotterDesign::SetAlpha& cmd) { m_states.back().alpha = cmd.alpha; },
+        [&](const PlotterDesign::SetStrokeWidth& cmd) { m_states.back().stroke_width = cmd.stroke_width; },
+        [&](const PlotterDesign::SetBlendMode& cmd) { m_states.back().blend_mode = cmd.mode; },
+        [&](const PlotterDesign::SetLineCap& cmd) { m_states.back().line_cap = cmd.cap; },
+        [&](const PlotterDesign::SetLineJoin& cmd) { m_states.back().joint_style = cmd.join; },
+        [&](const PlotterDesign::Fill&) { fill(m_states.back()); },
+        [&](const PlotterDesign::Stroke&) { stroke(m_states.back()); },
+        [&](const PlotterDesign::Write& cmd) {
+            const PainterState& state = m_states.back();
+            if (!state.font || m_font_atlas.empty()) { return; }
+            m_glyphs.clear();
+            for (const auto character : Utf8(std::string(cmd.text))) {
+                m_glyphs.emplace_back(state.font->get_glyph(static_cast<codepoint_t>(character)));
+            }
+            write(m_glyphs, state, state.font->is_distance_field());
+        },
+    });
+}
+
+void PlotterRasterizer::fill(const PainterState& state) {
+    if (!state.path || state.path->is_empty() || is_invisible(state)) { return; }
+
+    // flatten the path and transform it into image space
+    m_tessellator.set_tolerance(m_tolerance / get_scale(state.xform));
+    m_contours.clear();
+    m_tessellator.flatten(*state.path, m_contours);
+    Aabrf bounds = Aabrf::wrongest();
+    for (V2f& point : m_contours.points) {
+        point = point * state.xform;
+        bounds.grow_to(point);
+    }
+
+    const Aabri region = _get_region(bounds, state);
+    if (region.get_area() == 0) { return; }
+    _begin_coverage(region);
+    for (const PathTessellator::Contours::Contour& contour : m_contours.contours) {
+        // open subpaths are filled as if they were closed
+        const V2f* points = &m_contours.points[contour.first_point];
+        for (uint i = 0, j = contour.point_count - 1; i < contour.point_count; j = i++) {
+            _add_edge(points[j], points[i]);
+        }
+    }
+    _end_coverage(state);
+}
+
+void PlotterRasterizer::stroke(const PainterState& state) {
+    if (!state.path || state.path->is_empty() || is_zero(state.stroke_width, precision_low<float>())
+        || is_invisible(state)) {
+        return;
+    }
+
+    // tessellate the stroke in the space of the path and transform it into image space
+    m_tessellator.set_tolerance(m_tolerance / get_scale(state.xform));
+    m_mesh.clear();
+    m_tessellator.stroke(*state.path, abs(state.stroke_width), state.line_cap, state.joint_style, m_mesh);
+    Aabrf bounds = Aabrf::wrongest();
+    for (V2f& vertex : m_mesh.vertices) {
+        vertex = vertex * state.xform;
+        bounds.grow_to(vertex);
+    }
+
+    // all triangles of a stroke have the same orientation, overlapping triangles do not cover a pixel more than once
+    const Aabri region = _get_region(bounds, state);
+    if (region.get_area() == 0) { return; }
+    _begin_coverage(region);
+    const std::vector<V2f>& vertices = m_mesh.vertices;
+    const std::vector<uint>& indices = m_mesh.indices;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const V2f& a = vertices[indices[i]];
+        const V2f& b = vertices[indices[i + 1]];
+        const V2f& c = vertices[indices[i + 2]];
+        _add_edge(a, b);
+        _add_edge(b, c);
+        _add_edge(c, a);
+    }
+    _end_coverage(state);
+}
+
+void PlotterRasterizer::write(const std::vector<Glyph>& glyphs, const PainterState& state,
+                              const bool is_distance_field) {
+    if (glyphs.empty() || m_font_atlas.empty() || is_invisible(state)) { return; }
+    if (is_distance_field) {
+        _write_distance_field(glyphs, state);
+        return;
+    }
+    const Brush brush(state);
+    constexpr float to_float = 1.f / 255.f;
+
+    // like the Plotter, glyphs are always rendered on the pixel grid and can only be translated
+    const V2f position = V2f::zero() * state.xform;
+    int x = static_cast<int>(std::round(position.x()));
+    int y = static_cast<int>(std::round(position.y()));
+    for (const Glyph& glyph : glyphs) {
+        const Glyph::Rect& rect = glyph.rect;
+        if (rect.width > 0 && rect.height > 0 && rect.x >= 0 && rect.y >= 0
+            && rect.x + rect.width <= m_font_atlas_size.get_width() && rect.y + rect.height <= m_font_atlas_size.get_height()) {
+            const int top = y + glyph.top;
+            const Aabri quad(x + glyph.left, top - rect.height, rect.width, rect.height);
+            const Aabri region = _get_region(Aabrf(quad), state);
+            const uint count = static_cast<uint>(region.get_width());
+            if (region.get_area() > 0) {
+                m_row_coverage.resize(max(m_row_coverage.size(), count));
+                for (int row = region.get_bottom(); row < region.get_top(); ++row) {
+                    // the first row of the glyph's bitmap is its top row
+                    const int atlas_row = rect.y + (top - 1 - row);
+                    const int atlas_column = rect.x + (region.get_left() - quad.get_left());
+                    const uchar* source
+                        = &m_font_atlas[static_cast<size_t>(atlas_row * m_font_atlas_size.get_width() + atlas_column)];
+                    for (uint i = 0; i < count; ++i) {
+                        m_row_coverage[i] = static_cast<float>(source[i]) * to_float;
+                    }
+                    const size_t offset
+                        = static_cast<size_t>((m_size.get_height() - 1 - row) * m_size.get_width() + region.get_left()) * 4;
+                    brush.blend(&m_pixels[offset], m_row_coverage.data(), count,
+                                V2f(static_cast<float>(region.get_left()) + 0.5f, static_cast<float>(row) + 0.5f),
+                                m_row_colors);
+                }
+            }
+        }
+
+        // advance to the next character position
+        x += glyph.advance_x;
+        y += glyph.advance_y;
+    }
+}
+
+void PlotterRasterizer::_write_distance_field(const std::vector<Glyph>& glyphs, const PainterState& state) {
+    const Brush brush(state);
+    const M3f inverse = state.xform.get_inverse();
+    const int atlas_width = m_font_atlas_size.get_width();
+    const int atlas_height = m_font_atlas_size.get_height();
+
+    // distances in the field are stored in pixels of the glyph, which are scaled by the transformation
+    const float scale = std::sqrt(std::abs(state.xform.get_determinant()));
+    const float distance_factor = static_cast<float>(Font::distance_field_spread * 2) * scale / 255.f;
+
+    // bilinear sample of the atlas, outside of the rect of a glyph the field is empty
+    const auto sample = [&](const Glyph::Rect& rect, const float u, const float v) {
+        const float column = u - 0.5f;
+        const float row = v - 0.5f;
+        const int left = static_cast<int>(std::floor(column));
+        const int bottom = static_cast<int>(std::floor(row));
+        const float fx = column - static_cast<float>(left);
+        const float fy = row - static_cast<float>(bottom);
+        const auto texel = [&](const int x, const int y) {
+            if (x < 0 || y < 0 || x >= rect.width || y >= rect.height) { return 0.f; }
+            return static_cast<float>(m_font_atlas[static_cast<size_t>((rect.y + y) * atlas_width + rect.x + x)]);
+        };
+        return (texel(left, bottom) * (1 - fx) + texel(left + 1, bottom) * fx) * (1 - fy)
+               + (texel(left, bottom + 1) * (1 - fx) + texel(left + 1, bottom + 1) * fx) * fy;
+    };
+
+    V2f origin = V2f::zero();
+    for (const Glyph& glyph : glyphs) {
+        const Glyph::Rect& rect = glyph.rect;
+        if (rect.width > 0 && rect.height > 0 && rect.x >= 0 && rect.y >= 0 && rect.x + rect.width <= atlas_width
+            && rect.y + rect.height <= atlas_height) {
+            // quad of the glyph in text space, the first row of its field is its top row
+            const float quad_left = origin.x() + glyph.left;
+            const float quad_top = origin.y() + glyph.top;
+            const Aabrf quad(quad_left, quad_top - rect.height, rect.width, rect.height);
+            const Aabri region = _get_region(transform_by(quad, state.xform), state);
+            const uint count = static_cast<uint>(region.get_width());
+            if (region.get_area() > 0) {
+                m_row_coverage.resize(max(m_row_coverage.size(), count));
+                for (int row = region.get_bottom(); row < region.get_top(); ++row) {
+                    for (uint i = 0; i < count; ++i) {
+                        const V2f pixel(static_cast<float>(region.get_left() + static_cast<int>(i)) + 0.5f,
+                                        static_cast<float>(row) + 0.5f);
+                        const V2f local = transform_by(pixel, inverse);
+                        const float distance = sample(rect, local.x() - quad_left, quad_top - local.y()) - 127.5f;
+                        m_row_coverage[i] = clamp(distance * distance_factor + 0.5f, 0.f, 1.f);
+                    }
+                    const size_t offset
+                        = static_cast<size_t>((m_size.get_height() - 1 - row) * m_size.get_width() + region.get_left()) * 4;
+                    brush.blend(&m_pixels[offset], m_row_coverage.data(), count,
+                                V2f(static_cast<float>(region.get_left()) + 0.5f, static_cast<float>(row) + 0.5f),
+                                m_row_colors);
+                }
+            }
+        }
+
+        // advance to the next character position
+        origin.x() += glyph.advance_x;
+        origin.y() += glyph.advance_y;
+    }
+}
+
+Aabri PlotterRasterizer::_get_region(const Aabrf& bounds, const PainterState& state) const {
+    if (!bounds.is_valid()) { return Aabri::zero(); }
+
+    // all pixels touched by the bounds
+    Aabri region(V2i(static_cast<int>(std::floor(bounds.get_left())), static_cast<int>(std::floor(bounds.get_bottom()))),
+                 V2i(static_cast<int>(std::ceil(bounds.get_right())), static_cast<int>(std::ceil(bounds.get_top()))));
+    region.intersect(Aabri(m_size));
+
+    // like a scissor rect, the clip is rounded to whole pixels
+    if (is_clipping(state.clip)) {
+        const Aabrf& clip = state.clip;
+        region.intersect(
+            Aabri(V2i(static_cast<int>(std::round(clip.get_left())), static_cast<int>(std::round(clip.get_bottom()))),
+                  V2i(static_cast<int>(std::round(clip.get_right())), static_cast<int>(std::round(clip.get_top())))));
+    }
+    return region.get_area() > 0 ? region : Aabri::zero();
+}
+
+void PlotterRasterizer::_begin_coverage(const Aabri& region) {
+    m_region = region;
+    const size_t size = static_cast<size_t>((region.get_width() + 2) * region.get_height());
+    if (m_coverage.size() < size) { m_coverage.resize(size, 0); }
+}
+
+void PlotterRasterizer::_add_edge(V2f from, V2f to) {
+    // move the edge into the space of the region
+    const V2f origin(static_cast<float>(m_region.get_left()), static_cast<float>(m_region.get_bottom()));
+    from -= origin;
+    to -= origin;
+    const uint width = static_cast<uint>(m_region.get_width());
+    const uint height = static_cast<uint>(m_region.get_height());
+    const float right = static_cast<float>(width);
+
+    // edges right of the region do not affect it, but edges left of it change the winding of all pixels in the row
+    if (from.x() >= right && to.x() >= right) { return; }
+    if (from.x() <= 0 && to.x() <= 0) {
+        accumulate_edge(m_coverage.data(), width, height, V2f(0, from.y()), V2f(0, to.y()));
+        return;
+    }
+
+    // split edges where they cross the left or right border of the region, the parts outside are clamped to the border
+    std::array<float, 2> splits;
+    uint split_count = 0;
+    for (const float border : {0.f, right}) {
+        if ((from.x() < border) != (to.x() < border)) {
+            splits[split_count++] = (border - from.x()) / (to.x() - from.x());
+        }
+    }
+    if (split_count == 2 && splits[0] > splits[1]) { std::swap(splits[0], splits[1]); }
+    V2f start = from;
+    for (uint i = 0; i <= split_count; ++i) {
+        V2f end = i < split_count ? from + (to - from) * splits[i] : to;
+        end.x() = clamp(end.x(), 0, right);
+        accumulate_edge(m_coverage.data(), width, height, V2f(clamp(start.x(), 0, right), start.y()), end);
+        start = end;
+    }
+}
+
+void PlotterRasterizer::_end_coverage(const PainterState& state) {
+    const Brush brush(state);
+    const uint width = static_cast<uint>(m_region.get_width());
+    const uint height = static_cast<uint>(m_region.get_height());
+    m_row_coverage.resize(max(m_row_coverage.size(), width));
+    float* row_coverage = m_row_coverage.data();
+
+    for (uint row = 0; row < height; ++row) {
+        // the running sum of the signed areas is the winding number of each pixel, weighted by its coverage
+        float* accumulation = &m_coverage[row * (width + 2)];
+        float sum = 0;
+        for (uint i = 0; i < width; ++i) {
+            sum += accumulation[i];
+            accumulation[i] = 0;
+            row_coverage[i] = std::min(std::abs(sum), 1.f);
+        }
+        accumulation[width] = 0;
+        accumulation[width + 1] = 0;
+
+        // only blend the covered span of the row
+        uint first = 0;
+        while (first < width && row_coverage[first] == 0) {
+            ++first;
+        }
+        uint last = width;
+        while (last > first && row_coverage[last - 1] == 0) {
+            --last;
+        }
+        if (first == last) { continue; }
+
+        const int x = m_region.get_left() + static_cast<int>(first);
+        const int y = m_region.get_bottom() + static_cast<int>(row);
+        const size_t offset = static_cast<size_t>((m_size.get_height() - 1 - y) * m_size.get_width() + x) * 4;
+        brush.blend(&m_pixels[offset], row_coverage + first, last - first,
+                    V2f(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f), m_row_colors);
+    }
+}
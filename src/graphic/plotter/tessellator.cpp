@@ -0,0 +1,415 @@
+#include "notf/graphic/plotter/tessellator.hpp"
+
+#include <cmath>
+
+#include "notf/common/thread_pool.hpp"
+
+NOTF_USING_NAMESPACE;
+
+// helper =========================================================================================================== //
+
+namespace {
+
+using Mesh = PathTessellator::Mesh;
+using Contour = PathTessellator::Contours::Contour;
+
+/// Paths are tessellated in chunks of at least this many paths.
+constexpr size_t g_min_chunk_size = 8;
+
+/// Number of chunks per thread, so that threads that finish early can help out with the remaining work.
+constexpr size_t g_chunks_per_thread = 4;
+
+/// Consecutive points closer than this fraction of the tolerance are merged.
+constexpr float g_merge_distance = 0.01f;
+
+/// Appends a vertex to the Mesh.
+/// @returns Index of the new vertex.
+uint add_vertex(Mesh& mesh, const V2f& vertex) {
+    mesh.vertices.emplace_back(vertex);
+    return narrow_cast<uint>(mesh.vertices.size() - 1);
+}
+
+/// Appends a triangle to the Mesh, in counterclockwise order.
+void add_ccw_triangle(Mesh& mesh, const uint a, uint b, uint c) {
+    const std::vector<V2f>& vertices = mesh.vertices;
+    if ((vertices[b] - vertices[a]).cross(vertices[c] - vertices[a]) < 0) { std::swap(b, c); }
+    mesh.indices.insert(mesh.indices.end(), {a, b, c});
+}
+
+/// Appends a new triangle to the Mesh, in counterclockwise order.
+void add_ccw_triangle(Mesh& mesh, const V2f& a, const V2f& b, const V2f& c) {
+    const uint first = add_vertex(mesh, a);
+    add_vertex(mesh, b);
+    add_vertex(mesh, c);
+    add_ccw_triangle(mesh, first, first + 1, first + 2);
+}
+
+/// Appends a new quad to the Mesh, made up of two counterclockwise triangles.
+/// The corners of the quad must be given in order.
+void add_ccw_quad(Mesh& mesh, const V2f& a, const V2f& b, const V2f& c, const V2f& d) {
+    const uint first = add_vertex(mesh, a);
+    add_vertex(mesh, b);
+    add_vertex(mesh, c);
+    add_vertex(mesh, d);
+    add_ccw_triangle(mesh, first, first + 1, first + 2);
+    add_ccw_triangle(mesh, first, first + 2, first + 3);
+}
+
+/// Twice the signed area of a Contour, is positive if the Contour is counterclockwise.
+float get_twice_signed_area(const V2f* points, const uint count) {
+    float result = 0;
+    for (uint i = 0, j = count - 1; i < count; j = i++) {
+        result += points[j].cross(points[i]);
+    }
+    return result;
+}
+
+/// Tests whether a point lies inside or on the edge of a counterclockwise triangle.
+bool is_in_ccw_triangle(const V2f& point, const V2f& a, const V2f& b, const V2f& c) {
+    return (b - a).cross(point - a) >= 0 && (c - b).cross(point - b) >= 0 && (a - c).cross(point - c) >= 0;
+}
+
+/// Tests whether two line segments intersect or touch.
+bool segments_intersect(const V2f& a, const V2f& b, const V2f& c, const V2f& d) {
+    const float abc = (b - a).cross(c - a);
+    const float abd = (b - a).cross(d - a);
+    const float cda = (d - c).cross(a - c);
+    const float cdb = (d - c).cross(b - c);
+    if ((abc > 0 && abd > 0) || (abc < 0 && abd < 0) || (cda > 0 && cdb > 0) || (cda < 0 && cdb < 0)) {
+        return false; // both ends of one segment are on the same side of the other
+    }
+    if (abc != 0 || abd != 0) { return true; }
+
+    // collinear segments intersect if they overlap
+    const V2f delta = b - a;
+    const float start = delta.dot(c - a);
+    const float end = delta.dot(d - a);
+    return max(start, end) >= 0 && min(start, end) <= delta.dot(delta);
+}
+
+/// Tests whether any two non-adjacent edges of a closed Contour intersect or touch.
+bool is_self_intersecting(const V2f* points, const uint count) {
+    for (uint i = 0; i + 2 < count; ++i) {
+        for (uint j = i + 2; j < count; ++j) {
+            if (i == 0 && j == count - 1) { continue; } // the last edge is adjacent to the first one
+            if (segments_intersect(points[i], points[i + 1], points[j], points[(j + 1) % count])) { return true; }
+        }
+    }
+    return false;
+}
+
+/// Direction from one point to another (normalized).
+V2f get_direction(const V2f& from, const V2f& to) { return (to - from).normalize(); }
+
+} // namespace
+
+// path tessellator ================================================================================================= //
+
+PathTessellator::PathTessellator(const float tolerance, const float miter_limit)
+    : m_tolerance(max(tolerance, precision_low<float>())), m_miter_limit(max(miter_limit, 1)) {}
+
+uint PathTessellator::get_subdivision_count(const CubicBezier2f& segment, const float tolerance) {
+    // The distance between a curve and the line between two of its points is at most 1/8 of the maximum of its second
+    // derivative times the squared parameter distance of the two points. For a cubic bezier, the second derivative is
+    // at most 6 times the largest second difference of its control points.
+    const V2f p0 = segment.get_vertex(0);
+    const V2f p1 = segment.get_vertex(1);
+    const V2f p2 = segment.get_vertex(2);
+    const V2f p3 = segment.get_vertex(3);
+    const float dd = std::sqrt(max((p0 - p1 * 2 + p2).get_magnitude_sq(), (p1 - p2 * 2 + p3).get_magnitude_sq()));
+    const float count = std::ceil(std::sqrt(0.75f * dd / max(tolerance, precision_low<float>())));
+    return static_cast<uint>(clamp(count, 1, static_cast<float>(max_segment_subdivisions)));
+}
+
+void PathTessellator::flatten(const CubicBezier2f& segment, const float tolerance, std::vector<V2f>& points) {
+    const uint count = get_subdivision_count(segment, tolerance);
+    const V2f p0 = segment.get_vertex(0);
+    const V2f p1 = segment.get_vertex(1);
+    const V2f p2 = segment.get_vertex(2);
+    const V2f p3 = segment.get_vertex(3);
+
+    // the segment in power basis, so each point can be evaluated independently (which allows vectorization)
+    const V2f a = (p1 - p2) * 3 + p3 - p0;
+    const V2f b = (p0 - p1 * 2 + p2) * 3;
+    const V2f c = (p1 - p0) * 3;
+
+    const size_t offset = points.size();
+    points.resize(offset + count);
+    V2f* output = &points[offset];
+    const float step = 1 / static_cast<float>(count);
+    for (uint i = 1; i < count; ++i) {
+        const float t = static_cast<float>(i) * step;
+        output[i - 1] = V2f(((a.x() * t + b.x()) * t + c.x()) * t + p0.x(), //
+                            ((a.y() * t + b.y()) * t + c.y()) * t + p0.y());
+    }
+    output[count - 1] = p3; // the end point is exact
+}
+
+void PathTessellator::flatten(const Path2& path, Contours& contours) const {
+    const float min_distance_sq = (m_tolerance * g_merge_distance) * (m_tolerance * g_merge_distance);
+    std::vector<V2f>& points = contours.points;
+    for (const auto& subpath : path.get_subpaths()) {
+        if (subpath.segment_count == 0) { continue; }
+
+        const size_t first_point = points.size();
+        points.emplace_back(subpath.get_segment(0).get_vertex(0));
+        for (uint i = 0; i < subpath.segment_count; ++i) {
+            flatten(subpath.get_segment(i), m_tolerance, points);
+        }
+
+        // merge points that are too close to each other, including the last and the first point of a closed subpath
+        size_t end = first_point + 1;
+        for (size_t i = first_point + 1; i < points.size(); ++i) {
+            if ((points[i] - points[end - 1]).get_magnitude_sq() > min_distance_sq) { points[end++] = points[i]; }
+        }
+        if (subpath.is_closed && end - first_point > 1
+            && (points[end - 1] - points[first_point]).get_magnitude_sq() <= min_distance_sq) {
+            --end;
+        }
+        points.resize(end);
+
+        contours.contours.emplace_back(Contours::Contour{narrow_cast<uint>(first_point),
+                                                         narrow_cast<uint>(end - first_point), subpath.is_closed});
+    }
+}
+
+void PathTessellator::fill(const Path2& path, Mesh& mesh) {
+    m_contours.clear();
+    flatten(path, m_contours);
+    const std::vector<Contour>& contours = m_contours.contours;
+    if (contours.empty()) { return; }
+
+    // a single subpath can be triangulated without overlapping triangles
+    if (contours.size() == 1) {
+        const Contour& contour = contours.front();
+        if (path.get_subpaths().front().is_convex) {
+            // the fan has the orientation of the contour, make it counterclockwise like all other simple meshes
+            const size_t first_index = mesh.indices.size();
+            _add_fan(contour, mesh);
+            if (get_twice_signed_area(&m_contours.points[contour.first_point], contour.point_count) < 0) {
+                for (size_t i = first_index; i < mesh.indices.size(); i += 3) {
+                    std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+                }
+            }
+            return;
+        }
+        if (_clip_ears(contour, mesh)) { return; }
+    }
+
+    // multiple subpaths can overlap or form holes, and self-intersecting subpaths cannot be ear-clipped
+    for (const Contour& contour : contours) {
+        _add_fan(contour, mesh);
+    }
+    mesh.needs_stencil = true;
+}
+
+void PathTessellator::stroke(const Path2& path, const float width, Plotter::CapStyle cap, Plotter::JointStyle joint,
+                             Mesh& mesh) {
+    if (width <= 0) { return; }
+    if (cap == Plotter::CapStyle::_CURRENT) { cap = Plotter::CapStyle::BUTT; }
+    if (joint == Plotter::JointStyle::_CURRENT) { joint = Plotter::JointStyle::MITER; }
+    const float half_width = width / 2;
+
+    m_contours.clear();
+    flatten(path, m_contours);
+    for (const Contour& contour : m_contours.contours) {
+        const V2f* points = &m_contours.points[contour.first_point];
+        const uint count = contour.point_count;
+        if (count < 2) { continue; }
+        const bool is_closed = contour.is_closed && count > 2;
+
+        // one quad per line segment
+        const uint segment_count = is_closed ? count : count - 1;
+        for (uint i = 0; i < segment_count; ++i) {
+            const V2f& start = points[i];
+            const V2f& end = points[(i + 1) % count];
+            const V2f normal = get_direction(start, end).get_orthogonal() * half_width;
+            add_ccw_quad(mesh, start - normal, end - normal, end + normal, start + normal);
+        }
+
+        // joints between the line segments
+        V2f in = is_closed ? get_direction(points[count - 1], points[0]) : get_direction(points[0], points[1]);
+        for (uint i = is_closed ? 0 : 1; i < segment_count; ++i) {
+            const V2f out = get_direction(points[i], points[(i + 1) % count]);
+            _add_joint(points[i], in, out, half_width, joint, mesh);
+            in = out;
+        }
+
+        // caps at both ends of an open line
+        if (!is_closed) {
+            _add_cap(points[0], get_direction(points[1], points[0]), half_width, cap, mesh);
+            _add_cap(points[count - 1], get_direction(points[count - 2], points[count - 1]), half_width, cap, mesh);
+        }
+    }
+    mesh.needs_stencil = true;
+}
+
+void PathTessellator::tessellate(const std::vector<Job>& jobs, std::vector<Mesh>& meshes, ThreadPool& thread_pool,
+                                 const float tolerance) {
+    meshes.resize(jobs.size());
+    thread_pool.for_each_chunk(jobs.size(), g_min_chunk_size, g_chunks_per_thread,
+                               [&](const size_t first, const size_t last) {
+                                   PathTessellator tessellator(tolerance);
+                                   for (size_t index = first; index < last; ++index) {
+                                       const Job& job = jobs[index];
+                                       Mesh& mesh = meshes[index];
+                                       mesh.clear();
+                                       if (!job.path) { continue; }
+                                       if (job.stroke_width > 0) {
+                                           tessellator.stroke(*job.path, job.stroke_width, job.cap, job.joint, mesh);
+                                       } else {
+                                           tessellator.fill(*job.path, mesh);
+                                       }
+                                   }
+                               });
+}
+
+bool PathTessellator::_clip_ears(const Contour& contour, Mesh& mesh) {
+    const uint count = contour.point_count;
+    if (count < 3) { return true; }
+    const V2f* points = &m_contours.points[contour.first_point];
+
+    // the ears of a contour without area or with crossing edges do not cover the area inside the contour
+    const float twice_area = get_twice_signed_area(points, count);
+    if (abs(twice_area) <= precision_high<float>() || is_self_intersecting(points, count)) { return false; }
+
+    // all vertices of the contour are added to the mesh, ears are clipped in counterclockwise order
+    const size_t first_index = mesh.indices.size();
+    const uint first_vertex = narrow_cast<uint>(mesh.vertices.size());
+    mesh.vertices.insert(mesh.vertices.end(), points, points + count);
+    m_polygon.resize(count);
+    for (uint i = 0; i < count; ++i) {
+        m_polygon[i] = twice_area > 0 ? i : count - 1 - i;
+    }
+
+    size_t current = 0;
+    size_t remaining_attempts = m_polygon.size();
+    while (m_polygon.size() > 3) {
+        if (remaining_attempts-- == 0) {
+            // no ear left, which can happen if the contour touches itself within the precision
+            mesh.vertices.resize(first_vertex);
+            mesh.indices.resize(first_index);
+            return false;
+        }
+
+        const size_t size = m_polygon.size();
+        current %= size;
+        const uint prev = m_polygon[(current + size - 1) % size];
+        const uint vertex = m_polygon[current];
+        const uint next = m_polygon[(current + 1) % size];
+        const V2f& a = points[prev];
+        const V2f& b = points[vertex];
+        const V2f& c = points[next];
+
+        // reflex vertices cannot be clipped, collinear ones can be removed without adding a triangle
+        const float cross = (b - a).cross(c - b);
+        if (cross < -precision_high<float>()) {
+            ++current;
+            continue;
+        }
+        bool is_ear = true;
+        if (cross > precision_high<float>()) {
+            for (const uint other : m_polygon) {
+                if (other == prev || other == vertex || other == next) { continue; }
+                const V2f& point = points[other];
+                if (point != a && point != b && point != c && is_in_ccw_triangle(point, a, b, c)) {
+                    is_ear = false;
+                    break;
+                }
+            }
+            if (!is_ear) {
+                ++current;
+                continue;
+            }
+            mesh.indices.insert(mesh.indices.end(), {first_vertex + prev, first_vertex + vertex, first_vertex + next});
+        }
+        m_polygon.erase(m_polygon.begin() + static_cast<std::ptrdiff_t>(current));
+        remaining_attempts = m_polygon.size();
+    }
+    mesh.indices.insert(mesh.indices.end(), {first_vertex + m_polygon[0], first_vertex + m_polygon[1],
+                                             first_vertex + m_polygon[2]});
+    return true;
+}
+
+void PathTessellator::_add_fan(const Contour& contour, Mesh& mesh) const {
+    if (contour.point_count < 3) { return; }
+    const uint first_vertex = narrow_cast<uint>(mesh.vertices.size());
+    const auto first_point = m_contours.points.begin() + contour.first_point;
+    mesh.vertices.insert(mesh.vertices.end(), first_point, first_point + contour.point_count);
+    for (uint i = 2; i < contour.point_count; ++i) {
+        mesh.indices.insert(mesh.indices.end(), {first_vertex, first_vertex + i - 1, first_vertex + i});
+    }
+}
+
+void PathTessellator::_add_joint(const V2f& point, const V2f& in, const V2f& out, const float half_width,
+                                 const Plotter::JointStyle joint, Mesh& mesh) const {
+    // straight lines need no joint
+    const float cross = in.cross(out);
+    if (abs(cross) <= precision_high<float>() && in.dot(out) > 0) { return; }
+
+    // the gap between the quads of both line segments is on the outside of the turn
+    const float side = cross > 0 ? -1 : 1;
+    const V2f from = in.get_orthogonal() * (half_width * side);
+    const V2f to = out.get_orthogonal() * (half_width * side);
+
+    switch (joint) {
+    case Plotter::JointStyle::ROUND:
+        _add_arc(point, from, std::atan2(from.cross(to), from.dot(to)), mesh);
+        return;
+
+    case Plotter::JointStyle::MITER: {
+        // the miter extends along the bisector until it meets the outer edges of both line segments
+        const V2f bisector = from + to;
+        if (!bisector.is_zero()) {
+            const V2f direction = V2f(bisector).normalize();
+            const float cos_half_angle = direction.dot(from) / half_width;
+            if (cos_half_angle * m_miter_limit >= 1) {
+                const V2f miter = point + direction * (half_width / cos_half_angle);
+                add_ccw_triangle(mesh, point, point + from, miter);
+                add_ccw_triangle(mesh, point, miter, point + to);
+                return;
+            }
+        }
+        break; // miter is too long, fall back to bevel
+    }
+
+    default: break;
+    }
+    add_ccw_triangle(mesh, point, point + from, point + to);
+}
+
+void PathTessellator::_add_cap(const V2f& point, const V2f& direction, const float half_width,
+                               const Plotter::CapStyle cap, Mesh& mesh) const {
+    const V2f side = direction.get_orthogonal() * half_width;
+    switch (cap) {
+    case Plotter::CapStyle::SQUARE: {
+        const V2f extension = direction * half_width;
+        add_ccw_quad(mesh, point - side, point - side + extension, point + side + extension, point + side);
+        break;
+    }
+    case Plotter::CapStyle::ROUND: _add_arc(point, side * -1, pi<float>(), mesh); break;
+    default: break;
+    }
+}
+
+void PathTessellator::_add_arc(const V2f& center, const V2f& from, const float angle, Mesh& mesh) const {
+    // each step of the fan may cut off at most the tolerance from the arc
+    const float radius = from.get_magnitude();
+    if (radius <= precision_high<float>()) { return; }
+    const float max_step
+        = m_tolerance < radius ? 2 * std::acos(1 - m_tolerance / radius) : pi<float>() / 2; // at least 4 per circle
+    const uint step_count = max(1u, static_cast<uint>(std::ceil(abs(angle) / max_step)));
+
+    const float step = angle / static_cast<float>(step_count);
+    const float cos_step = std::cos(step);
+    const float sin_step = std::sin(step);
+    const uint center_vertex = add_vertex(mesh, center);
+    V2f offset = from;
+    uint last_vertex = add_vertex(mesh, center + offset);
+    for (uint i = 0; i < step_count; ++i) {
+        offset = V2f(offset.x() * cos_step - offset.y() * sin_step, offset.x() * sin_step + offset.y() * cos_step);
+        const uint vertex = add_vertex(mesh, center + offset);
+        add_ccw_triangle(mesh, center_vertex, last_vertex, vertex);
+        last_vertex = vertex;
+    }
+}
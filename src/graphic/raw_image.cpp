@@ -1,5 +1,7 @@
 #include "notf/graphic/raw_image.hpp"
 
+#include <mutex>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -10,9 +12,13 @@ NOTF_USING_NAMESPACE;
 // raw image ======================================================================================================== //
 
 RawImage::RawImage(std::string image_path, const int force_format) : m_filepath(std::move(image_path)) {
-    stbi_set_flip_vertically_on_load(0);
-    stbi_set_unpremultiply_on_load(1);
-    stbi_convert_iphone_png_to_rgb(1);
+    // the flags are global in stb_image, so they are set only once to allow loading images on multiple threads
+    static std::once_flag flags_set;
+    std::call_once(flags_set, [] {
+        stbi_set_flip_vertically_on_load(0);
+        stbi_set_unpremultiply_on_load(1);
+        stbi_convert_iphone_png_to_rgb(1);
+    });
 
     // load the image from file
     m_data = stbi_load(m_filepath.c_str(), &m_size.width(), &m_size.height(), &m_channels, force_format);
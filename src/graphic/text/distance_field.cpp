@@ -0,0 +1,135 @@
+#include "notf/graphic/text/distance_field.hpp"
+
+#include <cmath>
+
+#include "notf/meta/assert.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+namespace { // anonymous
+
+/// Squared distance standing in for "infinitely far away".
+constexpr float g_infinity = 1e20f;
+
+/// One-dimensional squared euclidean distance transform of a sampled function (Felzenszwalb & Huttenlocher).
+/// Computes `min_q((p - q)^2 + f(q))` for every p in-place.
+/// @param values   Function samples, `stride` elements apart. Is replaced by the transform.
+/// @param count    Number of samples.
+/// @param stride   Distance between two samples in `values`.
+/// @param f        Scratch buffer for a copy of the samples, at least `count` elements.
+/// @param v        Scratch buffer for the locations of the parabolas in the lower envelope, at least `count` elements.
+/// @param z        Scratch buffer for the boundaries between the parabolas, at least `count + 1` elements.
+void transform_1d(float* values, const int count, const int stride, float* f, int* v, float* z) {
+    for (int q = 0; q < count; ++q) {
+        f[q] = values[q * stride];
+    }
+
+    // compute the lower envelope of all parabolas rooted at (q, f(q))
+    int k = 0;
+    v[0] = 0;
+    z[0] = -g_infinity;
+    z[1] = g_infinity;
+    for (int q = 1; q < count; ++q) {
+        const auto intersection = [&](const int r) {
+            return ((f[q] + static_cast<float>(q * q)) - (f[r] + static_cast<float>(r * r))) / static_cast<float>(2 * (q - r));
+        };
+        float s = intersection(v[k]);
+        while (s <= z[k]) {
+            --k;
+            s = intersection(v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = g_infinity;
+    }
+
+    // sample the lower envelope
+    k = 0;
+    for (int q = 0; q < count; ++q) {
+        while (z[k + 1] < static_cast<float>(q)) {
+            ++k;
+        }
+        const float distance = static_cast<float>(q - v[k]);
+        values[q * stride] = distance * distance + f[v[k]];
+    }
+}
+
+/// Two-dimensional squared euclidean distance transform, first along all columns and then along all rows.
+/// @param grid     Zero for all pixels from which the distance is measured, `g_infinity` for all others.
+/// @param width    Width of the grid.
+/// @param height   Height of the grid.
+void transform_2d(std::vector<float>& grid, const int width, const int height) {
+    const int length = max(width, height);
+    std::vector<float> f(static_cast<size_t>(length));
+    std::vector<int> v(static_cast<size_t>(length));
+    std::vector<float> z(static_cast<size_t>(length + 1));
+    for (int x = 0; x < width; ++x) {
+        transform_1d(&grid[static_cast<size_t>(x)], height, width, f.data(), v.data(), z.data());
+    }
+    for (int y = 0; y < height; ++y) {
+        transform_1d(&grid[static_cast<size_t>(y * width)], width, 1, f.data(), v.data(), z.data());
+    }
+}
+
+} // namespace
+
+// distance field =================================================================================================== //
+
+std::vector<uchar> produce_distance_field(const uchar* coverage, const int width, const int height, const int pitch,
+                                          const int spread) {
+    NOTF_ASSERT(width >= 0 && height >= 0 && spread > 0);
+    const int field_width = width + spread * 2;
+    const int field_height = height + spread * 2;
+    const size_t field_size = static_cast<size_t>(field_width * field_height);
+
+    // coverage of every pixel in the padded field
+    std::vector<float> field_coverage(field_size, 0.f);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            field_coverage[static_cast<size_t>((y + spread) * field_width + x + spread)]
+                = static_cast<float>(coverage[y * pitch + x]) / 255.f;
+        }
+    }
+
+    // squared distance of every pixel outside to the closest pixel inside and vice versa
+    std::vector<float> to_inside(field_size);
+    std::vector<float> to_outside(field_size);
+    for (size_t i = 0; i < field_size; ++i) {
+        const bool is_inside = field_coverage[i] >= 0.5f;
+        to_inside[i] = is_inside ? 0 : g_infinity;
+        to_outside[i] = is_inside ? g_infinity : 0;
+    }
+    transform_2d(to_inside, field_width, field_height);
+    transform_2d(to_outside, field_width, field_height);
+
+    // the outline lies halfway between the centers of neighboring pixels inside and outside, or where the coverage of
+    // a partially covered pixel places it
+    std::vector<uchar> result(field_size);
+    const float scale = 1.f / static_cast<float>(spread * 2);
+    for (size_t i = 0; i < field_size; ++i) {
+        const float pixel_coverage = field_coverage[i];
+        float distance;
+        if (pixel_coverage > 0.f && pixel_coverage < 1.f) {
+            distance = pixel_coverage - 0.5f;
+        } else if (pixel_coverage >= 0.5f) {
+            distance = std::sqrt(to_outside[i]) - 0.5f;
+        } else {
+            distance = 0.5f - std::sqrt(to_inside[i]);
+        }
+        result[i] = static_cast<uchar>(std::lround(clamp(0.5f + distance * scale, 0.f, 1.f) * 255.f));
+    }
+    return result;
+}
+
+void convert_to_distance_field(Glyph& glyph, std::vector<uchar>& bitmap, const int spread) {
+    if (glyph.rect.width <= 0 || glyph.rect.height <= 0) { return; }
+    NOTF_ASSERT(bitmap.size() == static_cast<size_t>(glyph.rect.width * glyph.rect.height));
+    bitmap = produce_distance_field(bitmap.data(), glyph.rect.width, glyph.rect.height, glyph.rect.width, spread);
+    glyph.rect.width = static_cast<Glyph::coord_t>(glyph.rect.width + spread * 2);
+    glyph.rect.height = static_cast<Glyph::coord_t>(glyph.rect.height + spread * 2);
+    glyph.left = static_cast<Glyph::coord_t>(glyph.left - spread);
+    glyph.top = static_cast<Glyph::coord_t>(glyph.top + spread);
+}
+
+NOTF_CLOSE_NAMESPACE
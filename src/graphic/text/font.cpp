@@ -1,15 +1,20 @@
 #include "notf/graphic/text/font.hpp"
 
+#include <algorithm>
+
 #include "notf/meta/assert.hpp"
 #include "notf/meta/log.hpp"
 
 #include "notf/common/string.hpp"
+#include "notf/common/utf8.hpp"
 
 #include "notf/app/resource_manager.hpp"
 
+#include "notf/graphic/text/distance_field.hpp"
 #include "notf/graphic/text/font_atlas.hpp"
 #include "notf/graphic/text/font_manager.hpp"
 #include "notf/graphic/text/freetype.hpp"
+#include "notf/graphic/text/text_layout.hpp"
 
 namespace { // anonymous
 NOTF_USING_NAMESPACE;
@@ -24,8 +29,10 @@ NOTF_OPEN_NAMESPACE
 
 static_assert(std::is_pod<Glyph::Rect>::value, "This compiler does not recognize notf::Glyph::Rect as a POD.");
 
-Font::Font(FontManager& manager, const std::string& filename, const pixel_size_t pixel_size)
-    : m_manager(manager), m_name(), m_identifier({filename, pixel_size}), m_face(nullptr), m_glyphs() {
+Font::Font(FontManager& manager, Identifier identifier)
+    : m_manager(manager), m_name(), m_identifier(std::move(identifier)), m_face(nullptr), m_glyphs() {
+    const std::string& filename = m_identifier.filename;
+    const pixel_size_t pixel_size = m_identifier.pixel_size;
     { // extract the name of the font from the file name
         const std::string basestring = basename(filename.c_str());
         m_name = basestring.substr(0, basestring.rfind('.'));
@@ -47,43 +54,29 @@ Font::Font(FontManager& manager, const std::string& filename, const pixel_size_t
         m_line_height = static_cast<pixel_size_t>(std::abs(m_face->size->metrics.height) / 64);
     }
 
-    // create the map of glyphs
-    FT_GlyphSlot slot = m_face->glyph;
-    std::vector<FontAtlas::FitRequest> fit_atlas_request;
-    for (codepoint_t codepoint = 32; codepoint < 128; codepoint++) {
-        if (FT_Load_Char(m_face, codepoint, FT_LOAD_RENDER)) {
-            NOTF_LOG_WARN("Failed to render codepoint {} of Font \"{}\"", codepoint, m_name);
-            continue;
+    { // pre-warm all renderable ascii glyphs
+        std::string ascii;
+        for (char character = 32; character < 127; ++character) {
+            ascii.push_back(character);
         }
-
-        Glyph new_glyph;
-        new_glyph.rect = {0, 0, 0, 0}; // is determined in the next step
-        new_glyph.left = static_cast<Glyph::coord_t>(slot->bitmap_left);
-        new_glyph.top = static_cast<Glyph::coord_t>(slot->bitmap_top);
-        new_glyph.advance_x = static_cast<Glyph::coord_t>(slot->advance.x / 64);
-        new_glyph.advance_y = static_cast<Glyph::coord_t>(slot->advance.y / 64);
-        m_glyphs.insert(std::make_pair(codepoint, std::move(new_glyph)));
-
-        fit_atlas_request.emplace_back(FontAtlas::FitRequest{codepoint, static_cast<Glyph::coord_t>(slot->bitmap.width),
-                                                             static_cast<Glyph::coord_t>(slot->bitmap.rows)});
-    }
-
-    // render the glyph into the atlas
-    FontAtlas& font_atlas = m_manager.atlas();
-    for (const FontAtlas::ProtoGlyph& protoglyph : font_atlas.insert_rects(std::move(fit_atlas_request))) {
-        if (FT_Load_Char(m_face, protoglyph.first, FT_LOAD_RENDER)) { continue; }
-        font_atlas.fill_rect(protoglyph.second, slot->bitmap.buffer);
-
-        NOTF_ASSERT(m_glyphs.count(protoglyph.first));
-        m_glyphs[protoglyph.first].rect = protoglyph.second;
+        prewarm(ascii);
     }
 
     NOTF_LOG_TRACE("Loaded Font \"{}\" from file: {}", m_name, filename);
 }
 
 FontPtr Font::load(FontManager& font_manager, const std::string& filename, const pixel_size_t pixel_size) {
+    const std::string& path = ResourceManager::get_instance().get_type<Font>().get_path();
+    return _load(font_manager, {path + filename, pixel_size, /* is_distance_field = */ false});
+}
+
+FontPtr Font::load_distance_field(FontManager& font_manager, const std::string& filename) {
+    const std::string& path = ResourceManager::get_instance().get_type<Font>().get_path();
+    return _load(font_manager, {path + filename, distance_field_size, /* is_distance_field = */ true});
+}
+
+FontPtr Font::_load(FontManager& font_manager, Identifier identifier) {
     auto& font_resource_type = ResourceManager::get_instance().get_type<Font>();
-    const Font::Identifier identifier = {font_resource_type.get_path() + filename, pixel_size};
 
     { // check if the given filename/size - pair is already a known (and loaded) font
         auto it = font_manager.m_fonts.find(identifier);
@@ -97,51 +90,115 @@ FontPtr Font::load(FontManager& font_manager, const std::string& filename, const
     }
 
     // create and store the new Font in the manager, so it can be re-used
-    FontPtr font = _create_shared(font_manager, identifier.filename, pixel_size);
+    FontPtr font = _create_shared(font_manager, identifier);
+    if (identifier.is_distance_field) {
+        NOTF_LOG_WARN("Text written with the distance field Font \"{}\" is skipped by the Plotter, only the "
+                      "PlotterRasterizer can draw it",
+                      font->name());
+    }
     font_resource_type.set(identifier.filename, font);
     font_manager.m_fonts.insert({std::move(identifier), font});
 
     return font;
 }
 
+void Font::prewarm(const std::string& characters) {
+    if (!m_face) { return; }
+
+    // render all new glyphs and keep their bitmaps around until they have a place in the atlas
+    FT_GlyphSlot slot = m_face->glyph;
+    std::vector<FontAtlas::FitRequest> fit_atlas_request;
+    std::vector<std::pair<codepoint_t, std::vector<uchar>>> bitmaps;
+    for (const auto character : Utf8(characters)) {
+        const codepoint_t codepoint = static_cast<codepoint_t>(character);
+        if (m_glyphs.find(codepoint)) { continue; }
+        if (FT_Load_Char(m_face, codepoint, FT_LOAD_RENDER)) {
+            NOTF_LOG_WARN("Failed to render codepoint {} of Font \"{}\"", codepoint, m_name);
+            continue;
+        }
+
+        Glyph new_glyph;
+        new_glyph.rect = {0, 0, static_cast<Glyph::coord_t>(slot->bitmap.width),
+                          static_cast<Glyph::coord_t>(slot->bitmap.rows)};
+        new_glyph.left = static_cast<Glyph::coord_t>(slot->bitmap_left);
+        new_glyph.top = static_cast<Glyph::coord_t>(slot->bitmap_top);
+        new_glyph.advance_x = static_cast<Glyph::coord_t>(slot->advance.x / 64);
+        new_glyph.advance_y = static_cast<Glyph::coord_t>(slot->advance.y / 64);
+
+        // copy the bitmap row by row, because FreeType may pad its rows
+        std::vector<uchar> bitmap(slot->bitmap.width * slot->bitmap.rows);
+        for (uint row = 0; row < slot->bitmap.rows; ++row) {
+            const uchar* source = slot->bitmap.buffer + static_cast<std::ptrdiff_t>(row) * slot->bitmap.pitch;
+            std::copy(source, source + slot->bitmap.width, bitmap.begin() + row * slot->bitmap.width);
+        }
+        if (is_distance_field()) { convert_to_distance_field(new_glyph, bitmap, distance_field_spread); }
+
+        const Glyph::Rect size = new_glyph.rect;
+        new_glyph.rect = {0, 0, 0, 0}; // is determined in the next step
+        m_glyphs.emplace(codepoint, _AtlasGlyph{std::move(new_glyph), m_manager.m_frame});
+        if (size.width == 0 || size.height == 0) { continue; }
+        bitmaps.emplace_back(codepoint, std::move(bitmap));
+        fit_atlas_request.emplace_back(FontAtlas::FitRequest{codepoint, size.width, size.height});
+    }
+    if (fit_atlas_request.empty()) { return; }
+
+    // place all glyphs into the atlas at once
+    FontAtlas& font_atlas = m_manager.atlas();
+    for (const FontAtlas::ProtoGlyph& protoglyph : font_atlas.insert_rects(std::move(fit_atlas_request))) {
+        auto bitmap = std::find_if(bitmaps.begin(), bitmaps.end(), [&](const auto& entry) { //
+            return entry.first == protoglyph.first;
+        });
+        NOTF_ASSERT(bitmap != bitmaps.end());
+        font_atlas.fill_rect(protoglyph.second, bitmap->second.data());
+        bitmap->second.clear();
+
+        _AtlasGlyph* atlas_glyph = m_glyphs.find(protoglyph.first);
+        NOTF_ASSERT(atlas_glyph);
+        atlas_glyph->glyph.rect = protoglyph.second;
+    }
+
+    // glyphs that did not fit into the full atlas are removed again and allocated one by one when they are first
+    // requested, which allows the FontManager to evict other glyphs to make room
+    for (const auto& [codepoint, bitmap] : bitmaps) {
+        if (!bitmap.empty()) { m_glyphs.erase(codepoint); }
+    }
+}
+
 const Glyph& Font::get_glyph(const codepoint_t codepoint) const {
-    const auto& it = m_glyphs.find(codepoint);
-    if (it != std::end(m_glyphs)) {
-        return it->second;
-    } else {
-        return _allocate_glyph(codepoint);
+    if (_AtlasGlyph* atlas_glyph = m_glyphs.find(codepoint)) {
+        atlas_glyph->last_use = m_manager.m_frame;
+        return atlas_glyph->glyph;
     }
+    return _allocate_glyph(codepoint);
+}
+
+TextLayoutConstPtr Font::get_layout(const std::string_view text, const int width) const {
+    return m_manager.m_layout_cache.get(m_identifier, text, width, [&] {
+        bool is_provisional = false;
+        TextLayout layout(std::string(text), width, m_line_height, [&](const codepoint_t codepoint) -> const Glyph& {
+            const Glyph& glyph = get_glyph(codepoint);
+            if (!glyph.rect.width && is_pending(codepoint)) { is_provisional = true; }
+            return glyph;
+        });
+        layout.m_is_provisional = is_provisional;
+        return layout;
+    });
 }
 
 const Glyph& Font::_allocate_glyph(const codepoint_t codepoint) const {
-    FT_GlyphSlot slot = m_face->glyph;
-    if (FT_Load_Char(m_face, codepoint, FT_LOAD_RENDER)) {
-        NOTF_LOG_WARN("Failed to render codepoint {} of Font \"{}\"", codepoint, m_name);
+    // the advance is known without rendering the glyph, so text can be laid out correctly while the glyph itself is
+    // rasterized in the background
+    FT_Fixed advance = 0;
+    if (FT_Get_Advance(m_face, FT_Get_Char_Index(m_face, codepoint), FT_LOAD_DEFAULT, &advance)) {
+        NOTF_LOG_WARN("Failed to load codepoint {} of Font \"{}\"", codepoint, m_name);
         return INVALID_GLYPH;
     }
+    Glyph placeholder = INVALID_GLYPH;
+    placeholder.advance_x = static_cast<Glyph::coord_t>((advance + 0x8000) >> 16); // advance is in 16.16 fixed point
+    m_manager._rasterize_glyph(*this, codepoint);
 
-    Glyph glyph;
-    glyph.left = static_cast<Glyph::coord_t>(slot->bitmap_left);
-    glyph.top = static_cast<Glyph::coord_t>(slot->bitmap_top);
-    glyph.advance_x = static_cast<Glyph::coord_t>(slot->advance.x >> 6); // "x >> 6" is "x / 64" in fancy
-    glyph.advance_y = static_cast<Glyph::coord_t>(slot->advance.y >> 6);
-
-    if (slot->bitmap.width > 0) {
-        NOTF_ASSERT(slot->bitmap.rows);
-        FontAtlas& font_atlas = m_manager.atlas();
-        glyph.rect = font_atlas.insert_rect(static_cast<Glyph::coord_t>(slot->bitmap.width),
-                                            static_cast<Glyph::coord_t>(slot->bitmap.rows));
-        font_atlas.fill_rect(glyph.rect, slot->bitmap.buffer);
-    } else {
-        NOTF_ASSERT(!slot->bitmap.rows);
-        glyph.rect.x = 0;
-        glyph.rect.y = 0;
-        glyph.rect.height = 0;
-        glyph.rect.width = 0;
-    }
-
-    // store and return the new Glyph
-    return m_glyphs.insert(std::make_pair(codepoint, std::move(glyph))).first->second;
+    // store and return the placeholder
+    return m_glyphs.emplace(codepoint, _AtlasGlyph{placeholder, m_manager.m_frame, true}).glyph;
 }
 
 NOTF_CLOSE_NAMESPACE
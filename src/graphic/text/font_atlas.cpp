@@ -1,6 +1,8 @@
 #include "notf/graphic/text/font_atlas.hpp"
 
+#include <algorithm>
 #include <limits>
+#include <tuple>
 
 #include "notf/meta/assert.hpp"
 #include "notf/meta/log.hpp"
@@ -19,14 +21,22 @@ namespace { // anonymous
 
 const size_t INVALID_SIZE_T = notf::max_v<size_t>;
 
+/// Name of the font atlas texture.
+const char* ATLAS_NAME = "__notf_font_atlas";
+
+/// Width and height of a newly created font atlas.
+const notf::Glyph::coord_t INITIAL_SIZE = 512;
+
+/// Upper limit for the width and height of the font atlas, is further limited by the maximum texture size.
+const notf::Glyph::coord_t MAX_SIZE = 4096;
+
 } // namespace
 
 NOTF_OPEN_NAMESPACE
 
-void FontAtlas::WasteMap::initialize(const coord_t width, const coord_t height) {
-    // start with a single big free rectangle, that spans the whole bin
+void FontAtlas::WasteMap::clear() {
+    // start without any waste, all free space above the skyline is managed by the skyline itself
     m_free_rects.clear();
-    m_free_rects.emplace_back(0, 0, width, height);
 }
 
 void FontAtlas::WasteMap::add_waste(Glyph::Rect rect) { m_free_rects.emplace_back(std::move(rect)); }
@@ -47,7 +57,7 @@ Glyph::Rect FontAtlas::WasteMap::reclaim_rect(const coord_t width, const coord_t
                 result.height = height;
                 goto return_success;
             }
-            if (width < rect.width && height < rect.height) {
+            if (width <= rect.width && height <= rect.height) {
                 // possible fit
                 const area_t waste
                     = min(static_cast<area_t>(rect.width - width), static_cast<area_t>(rect.height - height));
@@ -100,23 +110,22 @@ return_success:
     return result;
 }
 
-FontAtlas::FontAtlas() : m_texture(nullptr), m_width(512), m_height(512), m_used_area(0), m_nodes(), m_waste() {
-    // create the atlas texture
-    Texture::Args tex_args;
-    tex_args.format = Texture::Format::GRAYSCALE;
-
-    NOTF_GUARD(TheGraphicsSystem()->get_any_context().make_current());
+FontAtlas::FontAtlas()
+    : m_texture(nullptr)
+    , m_width(INITIAL_SIZE)
+    , m_height(INITIAL_SIZE)
+    , m_max_size(INITIAL_SIZE)
+    , m_pixels()
+    , m_used_area(0)
+    , m_nodes()
+    , m_waste()
+    , m_statistics() {
+    m_max_size = static_cast<coord_t>(clamp(TheGraphicsSystem::get_environment().max_texture_size,
+                                            static_cast<GLuint>(INITIAL_SIZE), static_cast<GLuint>(MAX_SIZE)));
 
-    m_texture = Texture::create_empty("__notf_font_atlas", Size2i(m_width, m_height), tex_args);
-    m_texture->set_wrap_x(Texture::Wrap::CLAMP_TO_EDGE);
-    m_texture->set_wrap_y(Texture::Wrap::CLAMP_TO_EDGE);
-    m_texture->set_min_filter(Texture::MinFilter::LINEAR);
-    m_texture->set_mag_filter(Texture::MagFilter::LINEAR);
-
-    // permanently bind the atlas texture to its slot (it is reserved and won't be rebound)
-    const GLenum texture_slot = TheGraphicsSystem::get_environment().font_atlas_texture_slot;
-    NOTF_CHECK_GL(glActiveTexture(GL_TEXTURE0 + texture_slot));
-    NOTF_CHECK_GL(glBindTexture(GL_TEXTURE_2D, m_texture->get_id().get_value()));
+    // create the atlas texture
+    m_pixels.resize(static_cast<size_t>(m_width * m_height), 0);
+    _create_texture();
 
     // initialize
     reset();
@@ -138,10 +147,13 @@ void FontAtlas::reset() {
     // create a flat skyline of zero height
     m_nodes.clear();
     m_nodes.emplace_back(SkylineNode{0, 0, m_width});
-    m_waste.initialize(m_width, m_height);
+    m_waste.clear();
     m_used_area = 0;
+    m_statistics.rect_count = 0;
 
     // fill the atlas with transparency
+    std::fill(m_pixels.begin(), m_pixels.end(), 0);
+    m_dirty_rect = {0, 0, 0, 0};
     m_texture->flood(Color::transparent());
 }
 
@@ -151,19 +163,21 @@ Glyph::Rect FontAtlas::insert_rect(const coord_t width, const coord_t height) {
         if (rect.height != 0) {
             NOTF_ASSERT(rect.width != 0);
             m_used_area += rect.width * rect.height;
+            ++m_statistics.rect_count;
             return rect;
         }
     }
 
-    // ... otherwise add it to the skyline
+    // ... otherwise add it to the skyline, growing the atlas if there is no more space
     ScoredRect result = _get_rect(width, height);
-    if (result.rect.width == 0) {
-        NOTF_ASSERT(result.rect.height == 0);
-        NOTF_LOG_WARN("Failed to fit new rectangle of size {}x{} into FontAtlas", width, height);
-    } else {
+    while (result.rect.width == 0 && _grow()) {
+        result = _get_rect(width, height);
+    }
+    if (result.rect.width != 0) {
         NOTF_ASSERT(result.rect.height != 0);
         _add_node(result.node_index, result.rect);
         m_used_area += result.rect.width * result.rect.height;
+        ++m_statistics.rect_count;
     }
 
     return result.rect;
@@ -196,9 +210,10 @@ std::vector<FontAtlas::ProtoGlyph> FontAtlas::insert_rects(std::vector<FitReques
             }
         }
 
-        // return what you got if you cannot fit anymore
+        // grow the atlas if you cannot fit anymore, or return what you got if it is already at its maximum size
         if (best_node_index == INVALID_SIZE_T) {
-            NOTF_LOG_CRIT("Could not fit all requested rects into the font atlas");
+            if (_grow()) { continue; }
+            NOTF_LOG_WARN("Could not fit all requested rects into the font atlas");
             break;
         }
         NOTF_ASSERT(best_extend_index != INVALID_SIZE_T);
@@ -206,6 +221,7 @@ std::vector<FontAtlas::ProtoGlyph> FontAtlas::insert_rects(std::vector<FitReques
         // insert the new node into the atlas and add the resulting Rect to the results
         _add_node(best_node_index, best_rect);
         m_used_area += best_rect.width * best_rect.height;
+        ++m_statistics.rect_count;
         named_extends.erase(iterator_at(named_extends, best_extend_index));
         result.emplace_back(best_code_point, std::move(best_rect));
     }
@@ -213,16 +229,91 @@ std::vector<FontAtlas::ProtoGlyph> FontAtlas::insert_rects(std::vector<FitReques
     return result;
 }
 
+void FontAtlas::release_rect(const Glyph::Rect& rect) {
+    if (rect.height == 0 || rect.width == 0) { return; }
+    NOTF_ASSERT(m_used_area >= rect.width * rect.height);
+    NOTF_ASSERT(m_statistics.rect_count > 0);
+
+    m_used_area -= rect.width * rect.height;
+    --m_statistics.rect_count;
+    ++m_statistics.rects_released;
+    m_waste.add_waste(rect);
+}
+
+std::vector<Glyph::Rect> FontAtlas::repack(const std::vector<Glyph::Rect>& rects) {
+    // copy the pixels of all rects out of the atlas before it is cleared
+    std::vector<std::vector<uchar>> bitmaps(rects.size());
+    for (size_t index = 0; index < rects.size(); ++index) {
+        const Glyph::Rect& rect = rects[index];
+        std::vector<uchar>& bitmap = bitmaps[index];
+        bitmap.resize(static_cast<size_t>(rect.width * rect.height));
+        for (coord_t row = 0; row < rect.height; ++row) {
+            const auto source = m_pixels.begin() + (rect.y + row) * m_width + rect.x;
+            std::copy(source, source + rect.width, bitmap.begin() + row * rect.width);
+        }
+    }
+
+    // place the tallest rects first, which leaves a lot less waste below the skyline than the order in which the rects
+    // were originally inserted
+    std::vector<size_t> order(rects.size());
+    for (size_t index = 0; index < order.size(); ++index) {
+        order[index] = index;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](const size_t lhs, const size_t rhs) {
+        return std::tie(rects[lhs].height, rects[lhs].width) > std::tie(rects[rhs].height, rects[rhs].width);
+    });
+
+    reset();
+    std::vector<Glyph::Rect> result(rects.size(), Glyph::Rect(0, 0, 0, 0));
+    for (const size_t index : order) {
+        const Glyph::Rect& rect = rects[index];
+        if (rect.width == 0 || rect.height == 0) { continue; }
+        result[index] = insert_rect(rect.width, rect.height);
+        fill_rect(result[index], bitmaps[index].data());
+    }
+    ++m_statistics.repack_count;
+    return result;
+}
+
 void FontAtlas::fill_rect(const Glyph::Rect& rect, const uchar* data) {
     if (rect.height == 0 || rect.width == 0 || !data) { return; }
 
+    for (coord_t row = 0; row < rect.height; ++row) {
+        std::copy(data + row * rect.width, data + (row + 1) * rect.width,
+                  m_pixels.begin() + (rect.y + row) * m_width + rect.x);
+    }
+
+    // grow the dirty region to include the new rect
+    if (m_dirty_rect.width == 0) {
+        m_dirty_rect = rect;
+    } else {
+        const int right = max(m_dirty_rect.x + m_dirty_rect.width, rect.x + rect.width);
+        const int top = max(m_dirty_rect.y + m_dirty_rect.height, rect.y + rect.height);
+        m_dirty_rect.x = min(m_dirty_rect.x, rect.x);
+        m_dirty_rect.y = min(m_dirty_rect.y, rect.y);
+        m_dirty_rect.width = static_cast<coord_t>(right - m_dirty_rect.x);
+        m_dirty_rect.height = static_cast<coord_t>(top - m_dirty_rect.y);
+    }
+}
+
+void FontAtlas::upload() {
+    if (m_dirty_rect.width == 0) { return; }
+
     NOTF_GUARD(TheGraphicsSystem()->get_any_context().make_current());
 
+    // upload the dirty region straight out of the client-side copy
     NOTF_CHECK_GL(glActiveTexture(GL_TEXTURE0 + TheGraphicsSystem::get_environment().font_atlas_texture_slot));
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, rect.width));
-    NOTF_CHECK_GL(glTexSubImage2D(GL_TEXTURE_2D, /* level = */ 0, rect.x, rect.y, rect.width, rect.height, GL_RED,
-                                  GL_UNSIGNED_BYTE, data));
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, m_texture->get_size().width()));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, m_width));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, m_dirty_rect.x));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_ROWS, m_dirty_rect.y));
+    NOTF_CHECK_GL(glTexSubImage2D(GL_TEXTURE_2D, /* level = */ 0, m_dirty_rect.x, m_dirty_rect.y, m_dirty_rect.width,
+                                  m_dirty_rect.height, GL_RED, GL_UNSIGNED_BYTE, m_pixels.data()));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+
+    m_dirty_rect = {0, 0, 0, 0};
+    ++m_statistics.upload_count;
 }
 
 FontAtlas::ScoredRect FontAtlas::_get_rect(const coord_t width, const coord_t height) const {
@@ -334,4 +425,61 @@ void FontAtlas::_add_node(const size_t node_index, const Glyph::Rect& rect) {
     }
 }
 
+bool FontAtlas::_grow() {
+    if (is_at_max_size()) { return false; }
+
+    if (m_width <= m_height && m_width < m_max_size) {
+        const coord_t new_width = static_cast<coord_t>(min(m_width * 2, static_cast<int>(m_max_size)));
+
+        // copy the existing rows into the left part of the wider atlas
+        std::vector<uchar> pixels(static_cast<size_t>(new_width * m_height), 0);
+        for (coord_t row = 0; row < m_height; ++row) {
+            std::copy(m_pixels.begin() + row * m_width, m_pixels.begin() + (row + 1) * m_width,
+                      pixels.begin() + row * new_width);
+        }
+        m_pixels.swap(pixels);
+
+        // the new space on the right is covered by a skyline node of zero height
+        if (m_nodes.back().y == 0) {
+            m_nodes.back().width += new_width - m_width;
+        } else {
+            m_nodes.emplace_back(SkylineNode{m_width, 0, static_cast<coord_t>(new_width - m_width)});
+        }
+        m_width = new_width;
+    } else {
+        // rows are stored bottom-up, so new space on top is simply appended and the skyline is not affected
+        m_height = static_cast<coord_t>(min(m_height * 2, static_cast<int>(m_max_size)));
+        m_pixels.resize(static_cast<size_t>(m_width * m_height), 0);
+    }
+
+    _create_texture();
+    ++m_statistics.growth_count;
+    NOTF_LOG_TRACE("Grew font atlas to {}x{}", m_width, m_height);
+    return true;
+}
+
+void FontAtlas::_create_texture() {
+    NOTF_GUARD(TheGraphicsSystem()->get_any_context().make_current());
+
+    // permanently bind the atlas texture to its slot (it is reserved and won't be rebound)
+    const GLenum texture_slot = TheGraphicsSystem::get_environment().font_atlas_texture_slot;
+    NOTF_CHECK_GL(glActiveTexture(GL_TEXTURE0 + texture_slot));
+
+    // replaces the previous atlas texture, if there is one
+    Texture::Args tex_args;
+    tex_args.format = Texture::Format::GRAYSCALE;
+    tex_args.min_filter = Texture::MinFilter::LINEAR;
+    tex_args.mag_filter = Texture::MagFilter::LINEAR;
+    tex_args.wrap_horizontal = Texture::Wrap::CLAMP_TO_EDGE;
+    tex_args.wrap_vertical = Texture::Wrap::CLAMP_TO_EDGE;
+    m_texture = Texture::create_empty(ATLAS_NAME, Size2i(m_width, m_height), tex_args);
+    NOTF_CHECK_GL(glBindTexture(GL_TEXTURE_2D, m_texture->get_id().get_value()));
+
+    // upload the existing pixels
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, m_width));
+    NOTF_CHECK_GL(glTexSubImage2D(GL_TEXTURE_2D, /* level = */ 0, 0, 0, m_width, m_height, GL_RED, GL_UNSIGNED_BYTE,
+                                  m_pixels.data()));
+    m_dirty_rect = {0, 0, 0, 0};
+}
+
 NOTF_CLOSE_NAMESPACE
@@ -1,11 +1,58 @@
 #include "notf/graphic/text/font_manager.hpp"
 
+#include <algorithm>
+#include <tuple>
+
+#include "notf/graphic/text/distance_field.hpp"
 #include "notf/graphic/text/freetype.hpp"
 #include "notf/meta/log.hpp"
 
+namespace { // anonymous
+NOTF_USING_NAMESPACE;
+
+/// Number of worker threads used to rasterize Glyphs in the background.
+const size_t WORKER_COUNT = clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+
+/// FreeType objects owned by a single worker thread, because FreeType faces must not be shared between threads.
+struct WorkerFaces {
+    /// Destructor.
+    ~WorkerFaces() {
+        for (auto& [identifier, face] : faces) {
+            FT_Done_Face(face);
+        }
+        if (library) { FT_Done_FreeType(library); }
+    }
+
+    /// FreeType library of the worker thread.
+    FT_Library library = nullptr;
+
+    /// All faces loaded by the worker thread.
+    std::unordered_map<Font::Identifier, FT_Face> faces;
+};
+
+/// Returns the FreeType face of the given Font that is owned by the calling worker thread.
+/// @returns    The face, or nullptr if it could not be loaded.
+FT_Face get_worker_face(const Font::Identifier& identifier) {
+    thread_local WorkerFaces worker;
+    if (!worker.library && FT_Init_FreeType(&worker.library)) {
+        worker.library = nullptr;
+        return nullptr;
+    }
+
+    if (auto itr = worker.faces.find(identifier); itr != worker.faces.end()) { return itr->second; }
+
+    FT_Face face = nullptr;
+    if (FT_New_Face(worker.library, identifier.filename.c_str(), 0, &face)) { return nullptr; }
+    FT_Set_Pixel_Sizes(face, 0, identifier.pixel_size);
+    worker.faces.emplace(identifier, face);
+    return face;
+}
+
+} // namespace
+
 NOTF_OPEN_NAMESPACE
 
-FontManager::FontManager() : m_freetype(nullptr), m_atlas() {
+FontManager::FontManager() : m_freetype(nullptr), m_atlas(), m_workers(WORKER_COUNT) {
     if (FT_Init_FreeType(&m_freetype)) {
         NOTF_LOG_CRIT("Failed to initialize the Freetype library");
         return;
@@ -16,4 +63,161 @@ FontManager::~FontManager() { FT_Done_FreeType(m_freetype); }
 
 TexturePtr FontManager::get_atlas_texture() const { return m_atlas.get_texture(); }
 
+void FontManager::start_frame() {
+    std::vector<_RasterizedGlyph> rasterized_glyphs;
+    {
+        NOTF_GUARD(std::lock_guard(m_rasterized_mutex));
+        rasterized_glyphs.swap(m_rasterized_glyphs);
+    }
+
+    // integrate all glyphs rasterized since the last frame into the atlas
+    // this happens before the frame counter advances, so that all glyphs used in the last frame, which includes the
+    // ones integrated here, are protected from eviction, because the text that uses them is drawn again in this frame
+    for (_RasterizedGlyph& rasterized : rasterized_glyphs) {
+        NOTF_ASSERT(m_pending_glyph_count > 0);
+        --m_pending_glyph_count;
+
+        // the font might have been removed while its glyph was rasterized
+        auto font_itr = m_fonts.find(rasterized.font);
+        if (font_itr == m_fonts.end()) { continue; }
+        FontPtr font = font_itr->second.lock();
+        if (!font) { continue; }
+        Font::_AtlasGlyph* atlas_glyph_ptr = font->m_glyphs.find(rasterized.codepoint);
+        if (!atlas_glyph_ptr || !atlas_glyph_ptr->is_pending) { continue; }
+
+        // glyphs that failed to render remain empty placeholders
+        Font::_AtlasGlyph& atlas_glyph = *atlas_glyph_ptr;
+        atlas_glyph.is_pending = false;
+        if (!rasterized.is_rendered) { continue; }
+
+        // the glyph has no place in the atlas until it is allocated, otherwise a repack would try to move it
+        Glyph& glyph = atlas_glyph.glyph;
+        glyph = rasterized.glyph;
+        glyph.rect = {0, 0, 0, 0};
+        const Glyph::Rect& size = rasterized.glyph.rect;
+        if (size.width > 0 && size.height > 0) {
+            glyph.rect = _allocate_rect(size.width, size.height);
+            m_atlas.fill_rect(glyph.rect, rasterized.bitmap.data());
+        }
+    }
+
+    ++m_frame;
+}
+
+Glyph::Rect FontManager::_allocate_rect(const Glyph::coord_t width, const Glyph::coord_t height) {
+    Glyph::Rect rect = m_atlas.insert_rect(width, height);
+    if (rect.width != 0) { return rect; }
+
+    // the atlas is full, collect all glyphs that were not used in the last frame as candidates for eviction
+    std::vector<FontPtr> fonts;
+    std::vector<std::tuple<size_t, Font*, codepoint_t>> candidates;
+    for (auto itr = m_fonts.begin(); itr != m_fonts.end();) {
+        if (FontPtr font = itr->second.lock()) {
+            font->m_glyphs.for_each([&](const codepoint_t codepoint, const Font::_AtlasGlyph& atlas_glyph) {
+                if (atlas_glyph.last_use < m_frame && atlas_glyph.glyph.rect.width != 0) {
+                    candidates.emplace_back(atlas_glyph.last_use, font.get(), codepoint);
+                }
+            });
+            fonts.emplace_back(std::move(font));
+            ++itr;
+        } else {
+            itr = m_fonts.erase(itr);
+        }
+    }
+
+    // evict the least recently used glyphs until the new one fits
+    // once there is enough free space in total, but the new glyph still does not fit, the free space is scattered in
+    // holes too small for it and the atlas is repacked (at most once, repacking is expensive)
+    std::sort(candidates.begin(), candidates.end());
+    const Glyph::area_t area = width * height;
+    bool is_repacked = false;
+    for (size_t next_candidate = 0;; ++next_candidate) {
+        if (!is_repacked && m_atlas.get_free_area() >= area) {
+            _repack_atlas(fonts);
+            is_repacked = true;
+            rect = m_atlas.insert_rect(width, height);
+            if (rect.width != 0) { return rect; }
+        }
+        if (next_candidate == candidates.size()) { break; }
+
+        // glyphs that did not fit into the repacked atlas are already gone
+        const auto& [last_use, font, codepoint] = candidates[next_candidate];
+        const Font::_AtlasGlyph* atlas_glyph = font->m_glyphs.find(codepoint);
+        if (!atlas_glyph) { continue; }
+        m_atlas.release_rect(atlas_glyph->glyph.rect);
+        font->m_glyphs.erase(codepoint);
+
+        rect = m_atlas.insert_rect(width, height);
+        if (rect.width != 0) { return rect; }
+    }
+
+    NOTF_LOG_WARN("Failed to fit new Glyph of size {}x{} into the FontAtlas", width, height);
+    return rect;
+}
+
+void FontManager::_repack_atlas(const std::vector<FontPtr>& fonts) {
+    // collect all glyphs that occupy space in the atlas
+    std::vector<std::tuple<Font*, codepoint_t, Font::_AtlasGlyph*>> glyphs;
+    std::vector<Glyph::Rect> rects;
+    for (const FontPtr& font : fonts) {
+        font->m_glyphs.for_each([&](const codepoint_t codepoint, Font::_AtlasGlyph& atlas_glyph) {
+            if (atlas_glyph.glyph.rect.width == 0) { return; }
+            glyphs.emplace_back(font.get(), codepoint, &atlas_glyph);
+            rects.emplace_back(atlas_glyph.glyph.rect);
+        });
+    }
+
+    // move them to their new position, glyphs that no longer fit are removed from their Font, so that they are
+    // rasterized again the next time they are requested
+    const std::vector<Glyph::Rect> new_rects = m_atlas.repack(rects);
+    size_t dropped_count = 0;
+    for (size_t index = 0; index < glyphs.size(); ++index) {
+        const auto& [font, codepoint, atlas_glyph] = glyphs[index];
+        if (new_rects[index].width == 0) {
+            font->m_glyphs.erase(codepoint);
+            ++dropped_count;
+        } else {
+            atlas_glyph->glyph.rect = new_rects[index];
+        }
+    }
+    NOTF_LOG_TRACE("Repacked {} Glyphs in the FontAtlas, {} did not fit", glyphs.size() - dropped_count, dropped_count);
+}
+
+void FontManager::_rasterize_glyph(const Font& font, const codepoint_t codepoint) {
+    ++m_pending_glyph_count;
+    m_workers.enqueue([this, identifier = font.m_identifier, codepoint] {
+        _RasterizedGlyph rasterized{identifier, codepoint, {{0, 0, 0, 0}, 0, 0, 0, 0}, {}, false};
+
+        FT_Face face = get_worker_face(identifier);
+        if (!face || FT_Load_Char(face, codepoint, FT_LOAD_RENDER)) {
+            NOTF_LOG_WARN("Failed to render codepoint {} of Font \"{}\"", codepoint, identifier.filename);
+        } else {
+            const FT_GlyphSlot slot = face->glyph;
+            Glyph& glyph = rasterized.glyph;
+            glyph.rect.width = static_cast<Glyph::coord_t>(slot->bitmap.width);
+            glyph.rect.height = static_cast<Glyph::coord_t>(slot->bitmap.rows);
+            glyph.left = static_cast<Glyph::coord_t>(slot->bitmap_left);
+            glyph.top = static_cast<Glyph::coord_t>(slot->bitmap_top);
+            glyph.advance_x = static_cast<Glyph::coord_t>(slot->advance.x >> 6);
+            glyph.advance_y = static_cast<Glyph::coord_t>(slot->advance.y >> 6);
+
+            // copy the bitmap row by row, because FreeType may pad its rows
+            rasterized.bitmap.resize(slot->bitmap.width * slot->bitmap.rows);
+            for (uint row = 0; row < slot->bitmap.rows; ++row) {
+                const uchar* source = slot->bitmap.buffer + static_cast<std::ptrdiff_t>(row) * slot->bitmap.pitch;
+                std::copy(source, source + slot->bitmap.width, rasterized.bitmap.begin() + row * slot->bitmap.width);
+            }
+
+            // distance fields are produced here as well, so the render thread only has to copy them into the atlas
+            if (identifier.is_distance_field) {
+                convert_to_distance_field(glyph, rasterized.bitmap, Font::distance_field_spread);
+            }
+            rasterized.is_rendered = true;
+        }
+
+        NOTF_GUARD(std::lock_guard(m_rasterized_mutex));
+        m_rasterized_glyphs.emplace_back(std::move(rasterized));
+    });
+}
+
 NOTF_CLOSE_NAMESPACE
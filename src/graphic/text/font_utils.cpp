@@ -1,32 +1,28 @@
 #include "notf/graphic/text/font_utils.hpp"
 
 #include "notf/graphic/text/font.hpp"
+#include "notf/graphic/text/text_layout.hpp"
 
 NOTF_OPEN_NAMESPACE
 
-Aabri text_aabr(const FontPtr& font, const std::string& text) {
-    Aabri result = Aabri::zero();
-    result.left() = 0;
-
-    Aabri::element_t advance = 0;
-    const utf8_string utf8_text(text);
-    for (const auto character : utf8_text) {
-        const Glyph& glyph = font->get_glyph(static_cast<codepoint_t>(character));
-
-        result.bottom() = min(result.bottom(), glyph.rect.height - glyph.top);
-        result.top() = max(result.top(), glyph.top);
-
-        advance += glyph.advance_x;
-        result.right() = advance;
-    }
-
-    return result;
-}
+Aabri text_aabr(const FontPtr& font, const std::string& text) { return font->get_layout(text)->get_aabr(); }
 
 std::vector<std::string::const_iterator> break_text(const int width, const FontPtr& font, const std::string& text,
                                                     const size_t first, const int limit, const char32_t delimiter) {
     std::vector<std::string::const_iterator> result;
 
+    // the line breaks of whole texts with the default delimiter are cached in the text's layout
+    if (first == 0 && delimiter == ' ' && width > 0) {
+        const TextLayoutConstPtr layout = font->get_layout(text, width);
+        const std::vector<size_t>& line_breaks = layout->get_line_breaks();
+        const size_t count = limit > 0 ? min(line_breaks.size(), static_cast<size_t>(limit)) : line_breaks.size();
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            result.emplace_back(std::begin(text) + static_cast<std::string::difference_type>(line_breaks[i]));
+        }
+        return result;
+    }
+
     int advance = 0;
     int word_advance = 0;
     long last_delimiter_index = 0;
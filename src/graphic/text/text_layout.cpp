@@ -0,0 +1,91 @@
+#include "notf/graphic/text/text_layout.hpp"
+
+#include "notf/common/utf8.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// text layout ====================================================================================================== //
+
+TextLayout::TextLayout(const std::string& text, const int width, const int line_height, const GlyphLookup& get_glyph)
+    : m_text(text), m_width(width) {
+    const Utf8 utf8_text(m_text);
+    std::vector<const Glyph*> glyphs;
+    glyphs.reserve(utf8_text.length());
+    m_characters.reserve(utf8_text.length());
+
+    // break lines at the last delimiter before the text exceeds the width (see `break_text`)
+    std::vector<size_t> line_starts; // index of the first character of each line but the first
+    int advance = 0;
+    int word_advance = 0;
+    size_t last_delimiter_index = 0;
+    size_t character_after_delimiter = 0;
+    for (auto it = std::begin(utf8_text); it != std::end(utf8_text); ++it) {
+        const codepoint_t codepoint = static_cast<codepoint_t>(*it);
+        const Glyph& glyph = get_glyph(codepoint);
+        glyphs.emplace_back(&glyph);
+        m_characters.emplace_back(Character{codepoint, 0, 0});
+        if (width <= 0) { continue; }
+
+        if (codepoint == ' ') {
+            auto one_step_further = it; // include the delimiter
+            last_delimiter_index = static_cast<size_t>((++one_step_further).get_index());
+            character_after_delimiter = m_characters.size();
+            word_advance = 0;
+        } else {
+            word_advance += glyph.advance_x;
+        }
+
+        const int new_advance = advance + glyph.advance_x;
+        if (last_delimiter_index && new_advance > width) {
+            m_line_breaks.emplace_back(last_delimiter_index);
+            line_starts.emplace_back(character_after_delimiter);
+            advance = word_advance;
+            word_advance = 0;
+            last_delimiter_index = 0;
+        } else {
+            advance = new_advance;
+        }
+    }
+
+    // place the glyphs, each line starts at the left edge one line height below the last
+    int x = 0;
+    int y = 0;
+    int right = 0;
+    int bottom = 0;
+    int top = 0;
+    auto next_line = line_starts.begin();
+    for (size_t index = 0; index < m_characters.size(); ++index) {
+        if (next_line != line_starts.end() && *next_line == index) {
+            x = 0;
+            y -= line_height;
+            ++next_line;
+        }
+        const Glyph& glyph = *glyphs[index];
+        m_characters[index].x = static_cast<Glyph::coord_t>(x);
+        m_characters[index].y = static_cast<Glyph::coord_t>(y);
+
+        bottom = min(bottom, y + glyph.top - glyph.rect.height);
+        top = max(top, y + glyph.top);
+
+        x += glyph.advance_x;
+        y += glyph.advance_y;
+        right = max(right, x);
+    }
+    m_aabr = Aabri(V2i(0, bottom), V2i(right, top));
+}
+
+// text layout cache ================================================================================================ //
+
+void TextLayoutCache::_remove(EntryList::iterator entry) {
+    const TextLayout& layout = *entry->layout;
+    auto [first, last] = m_index.equal_range(hash(entry->font, layout.get_text(), layout.get_width()));
+    for (auto itr = first; itr != last; ++itr) {
+        if (itr->second == entry) {
+            m_index.erase(itr);
+            break;
+        }
+    }
+    m_entries.erase(entry);
+}
+
+NOTF_CLOSE_NAMESPACE
@@ -1,11 +1,10 @@
 #include "notf/graphic/texture.hpp"
 
-#include <fstream>
-
 #include "notf/meta/log.hpp"
 
 #include "notf/app/resource_manager.hpp"
 
+#include "notf/graphic/compressed_image.hpp"
 #include "notf/graphic/graphics_system.hpp"
 #include "notf/graphic/raw_image.hpp"
 
@@ -60,6 +59,23 @@ GLenum datatype_to_gl(const Texture::DataType type) {
     }
 }
 
+/// Number of bytes per pixel in texture memory.
+size_t get_pixel_byte_size(const Texture::Format format, const Texture::DataType type) {
+    const size_t channels = static_cast<size_t>(to_number(format));
+    switch (type) {
+    case Texture::DataType::BYTE:
+    case Texture::DataType::UBYTE: return channels;
+    case Texture::DataType::SHORT:
+    case Texture::DataType::USHORT:
+    case Texture::DataType::HALF: return channels * 2;
+    case Texture::DataType::INT:
+    case Texture::DataType::UINT:
+    case Texture::DataType::FLOAT: return channels * 4;
+    case Texture::DataType::USHORT_5_6_5: return 2; // all channels packed into a single short
+    default: NOTF_ASSERT(false);
+    }
+}
+
 void assert_is_valid(const Texture& texture) {
     if constexpr (config::is_debug_build()) {
         if (!texture.is_valid()) {
@@ -77,8 +93,14 @@ void assert_is_valid(const Texture& texture) {
 
 const Texture::Args Texture::s_default_args = {};
 
-Texture::Texture(const GLuint id, const GLenum target, std::string name, Size2i size, const Format format)
-    : m_id(id), m_target(target), m_name(std::move(name)), m_size(std::move(size)), m_format(format) {
+Texture::Texture(const GLuint id, const GLenum target, std::string name, Size2i size, const Format format,
+                 const size_t byte_size)
+    : m_id(id)
+    , m_target(target)
+    , m_name(std::move(name))
+    , m_size(std::move(size))
+    , m_format(format)
+    , m_byte_size(byte_size) {
     if (!m_size.is_valid() || m_size.get_area() == 0) {
         NOTF_LOG_ERROR("Cannot create a Texture with zero or negative area");
         _deallocate();
@@ -118,13 +140,13 @@ TexturePtr Texture::create_empty(std::string name, Size2i size, const Args& args
     NOTF_CHECK_GL(glBindTexture(GL_TEXTURE_2D, id));
 
     NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, alignment));
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, size.width()));
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, size.height()));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, size.get_width()));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, size.get_height()));
     NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
     NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
 
-    NOTF_CHECK_GL(glTexImage2D(GL_TEXTURE_2D, /* level= */ 0, internal_format, size.width(), size.height(), BORDER,
-                               gl_format, datatype_to_gl(args.data_type), nullptr));
+    NOTF_CHECK_GL(glTexImage2D(GL_TEXTURE_2D, /* level= */ 0, internal_format, size.get_width(), size.get_height(),
+                               BORDER, gl_format, datatype_to_gl(args.data_type), nullptr));
 
     NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minfilter_to_gl(args.min_filter)));
     NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magfilter_to_gl(args.mag_filter)));
@@ -132,97 +154,62 @@ TexturePtr Texture::create_empty(std::string name, Size2i size, const Args& args
     NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_to_gl(args.wrap_vertical)));
 
     // return the empty texture on success
-    TexturePtr texture = Texture::_create_shared(id, GL_TEXTURE_2D, name, std::move(size), args.format);
+    const size_t byte_size = static_cast<size_t>(size.get_area()) * get_pixel_byte_size(args.format, args.data_type);
+    TexturePtr texture = Texture::_create_shared(id, GL_TEXTURE_2D, name, std::move(size), args.format, byte_size);
     TheGraphicsSystem::AccessFor<Texture>::register_new(texture);
     ResourceManager::get_instance().get_type<Texture>().set(std::move(name), texture);
     return texture;
 }
 
 TexturePtr Texture::load_image(const std::string& file_path, std::string name, const Args& args) {
-    std::vector<uchar> image_data;
-    Size2i image_size;
-    Texture::Format texture_format;
-    GLenum gl_format = 0;
-    GLenum internal_format = 0;
-    GLint alignment = 0;
-    GLsizei image_length = 0;
-    int image_bytes = 0;
-
-    // load the texture from file
     if (args.codec == Codec::RAW) {
         RawImage image(file_path);
         if (!image) { return {}; }
+        return create_from_image(image, std::move(name), args);
+    } else if (args.codec == Codec::COMPRESSED) {
+        return create_from_image(CompressedImage(file_path), std::move(name), args);
+    }
+    NOTF_ASSERT(false);
+    return {};
+}
 
-        image_size = image.get_size();
-        image_bytes = image.get_channels();
-        image_data = std::vector<uchar>(image.get_data(), image.get_data() + (image_size.get_area() * image_bytes));
-
-        if (image_bytes == 1) { // grayscale
-            gl_format = GL_RED;
-            internal_format = GL_R8;
-            texture_format = Texture::Format::GRAYSCALE;
-            alignment = 1;
-        } else if (image_bytes == 3) { // color
-            gl_format = GL_RGB;
-            internal_format = args.is_linear ? GL_RGB : GL_SRGB8;
-            texture_format = Texture::Format::RGB;
-            alignment = 4;
-        } else if (image_bytes == 4) { // color + alpha
-            gl_format = GL_RGBA;
-            internal_format = args.is_linear ? GL_RGBA : GL_SRGB8_ALPHA8;
-            texture_format = Texture::Format::RGBA;
-            alignment = 4;
-        } else {
-            NOTF_THROW(ResourceError, "Cannot load texture with {} bytes per pixel (must be 1, 3 or 4)", image_bytes);
-        }
-    } else if (args.codec == Codec::ASTC) {
-        std::ifstream image_file(file_path, std::ios::in | std::ios::binary);
-        if (!image_file.good()) { NOTF_THROW(ResourceError, "Failed to read texture file: \"{}\"", file_path); }
-        image_data = std::vector<uchar>(std::istreambuf_iterator<char>(image_file), std::istreambuf_iterator<char>());
+TexturePtr Texture::create_from_image(const RawImage& image, std::string name, const Args& args) {
+    const Size2i& size = image.get_size();
+    const int channels = image.get_channels();
 
-        image_size = {1024, 1024};
+    Texture::Format texture_format;
+    GLenum gl_format = 0;
+    GLenum internal_format = 0;
+    GLint alignment = 0;
+    if (channels == 1) { // grayscale
+        gl_format = GL_RED;
+        internal_format = GL_R8;
+        texture_format = Texture::Format::GRAYSCALE;
+        alignment = 1;
+    } else if (channels == 3) { // color
+        gl_format = GL_RGB;
+        internal_format = args.is_linear ? GL_RGB : GL_SRGB8;
+        texture_format = Texture::Format::RGB;
+        alignment = 4;
+    } else if (channels == 4) { // color + alpha
+        gl_format = GL_RGBA;
+        internal_format = args.is_linear ? GL_RGBA : GL_SRGB8_ALPHA8;
         texture_format = Texture::Format::RGBA;
         alignment = 4;
-        image_bytes = 4;
-
-        internal_format = GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6;
-        image_length = static_cast<GLsizei>(ceil(image_size.width() / 6.))
-                       * static_cast<GLsizei>(ceil(image_size.height() / 6.)) * 16;
-
-        // TODO: 'header' reader for ASTC files, we need the image size, the block size and the format (rgb/argb)
     } else {
-        NOTF_ASSERT(false);
+        NOTF_THROW(ResourceError, "Cannot load texture with {} bytes per pixel (must be 1, 3 or 4)", channels);
     }
 
     // load the texture into OpenGL
-    GLuint id = 0;
-    NOTF_CHECK_GL(glGenTextures(1, &id));
-    NOTF_ASSERT(id);
-    NOTF_CHECK_GL(glBindTexture(GL_TEXTURE_2D, id));
-
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, alignment));
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, image_size.width()));
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, image_size.height()));
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-
+    const GLuint id = _generate(size, alignment);
     if (args.make_immutable) {
         // immutable texture
-        const GLsizei max_levels = static_cast<GLsizei>(floor(log2(max(image_size.width(), image_size.height())))) + 1;
+        const GLsizei max_levels = static_cast<GLsizei>(floor(log2(max(size.get_width(), size.get_height())))) + 1;
         const GLsizei levels = args.create_mipmaps ? max_levels : 1;
-        NOTF_CHECK_GL(glTexStorage2D(GL_TEXTURE_2D, levels, internal_format, image_size.width(), image_size.height()));
-
-        if (args.codec == Codec::RAW) {
-            NOTF_CHECK_GL(glTexSubImage2D(GL_TEXTURE_2D, /* level= */ 0, /* xoffset= */ 0, /* yoffset= */ 0,
-                                          image_size.width(), image_size.height(), gl_format,
-                                          datatype_to_gl(args.data_type), &image_data.front()));
-        } else if (args.codec == Codec::ASTC) {
-            NOTF_CHECK_GL(glCompressedTexSubImage2D(GL_TEXTURE_2D, /* level= */ 0, /* xoffset= */ 0, /* yoffset= */ 0,
-                                                    image_size.width(), image_size.height(), internal_format,
-                                                    image_length, &image_data.front()));
-        } else {
-            NOTF_ASSERT(false);
-        }
+        NOTF_CHECK_GL(glTexStorage2D(GL_TEXTURE_2D, levels, internal_format, size.get_width(), size.get_height()));
+        NOTF_CHECK_GL(glTexSubImage2D(GL_TEXTURE_2D, /* level= */ 0, /* xoffset= */ 0, /* yoffset= */ 0,
+                                      size.get_width(), size.get_height(), gl_format, datatype_to_gl(args.data_type),
+                                      image.get_data()));
 #ifdef NOTF_DEBUG
         {
             GLint is_immutable = 0;
@@ -232,34 +219,13 @@ TexturePtr Texture::load_image(const std::string& file_path, std::string name, c
 #endif
     } else {
         // mutable texture
-        if (args.codec == Codec::RAW) {
-            NOTF_CHECK_GL(glTexImage2D(GL_TEXTURE_2D, /* level= */ 0, static_cast<GLint>(internal_format),
-                                       image_size.width(), image_size.height(), BORDER, gl_format,
-                                       datatype_to_gl(args.data_type), &image_data.front()));
-        } else if (args.codec == Codec::ASTC) {
-            NOTF_CHECK_GL(glCompressedTexImage2D(GL_TEXTURE_2D, /* level= */ 0, internal_format, image_size.width(),
-                                                 image_size.height(), BORDER, image_length, &image_data.front()));
-        } else {
-            NOTF_ASSERT(false);
-        }
+        NOTF_CHECK_GL(glTexImage2D(GL_TEXTURE_2D, /* level= */ 0, static_cast<GLint>(internal_format), size.get_width(),
+                                   size.get_height(), BORDER, gl_format, datatype_to_gl(args.data_type),
+                                   image.get_data()));
     }
 
     // highest quality mip-mapping by default
     if (args.create_mipmaps) { NOTF_CHECK_GL(glGenerateMipmap(GL_TEXTURE_2D)); }
-    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minfilter_to_gl(args.min_filter)));
-    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magfilter_to_gl(args.mag_filter)));
-
-    // repeat wrap by default
-    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_to_gl(args.wrap_horizontal)));
-    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_to_gl(args.wrap_vertical)));
-
-    // make texture anisotropic, if requested and available
-    if (args.anisotropy > 1.f && TheGraphicsSystem::get_extensions().anisotropic_filter) {
-        GLfloat highest_anisotropy;
-        NOTF_CHECK_GL(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &highest_anisotropy));
-        NOTF_CHECK_GL(
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, min(args.anisotropy, highest_anisotropy)));
-    }
 
     { // log success
 #if NOTF_LOG_LEVEL <= 0
@@ -268,22 +234,95 @@ TexturePtr Texture::load_image(const std::string& file_path, std::string name, c
         static const std::string rgba = "rgba";
 
         const std::string* format_name;
-        if (image_bytes == 1) {
+        if (channels == 1) {
             format_name = &grayscale;
-        } else if (image_bytes == 3) {
+        } else if (channels == 3) {
             format_name = &rgb;
         } else { // color + alpha
-            NOTF_ASSERT(image_bytes == 4);
+            NOTF_ASSERT(channels == 4);
             format_name = &rgba;
         }
 
-        NOTF_LOG_TRACE("Loaded {}x{} {} OpenGL texture with ID: {} from: \"{}\"", image_size.width(),
-                       image_size.height(), *format_name, id, file_path);
+        NOTF_LOG_TRACE("Loaded {}x{} {} OpenGL texture with ID: {} from: \"{}\"", size.get_width(), size.get_height(),
+                       *format_name, id, image.get_filepath());
 #endif
     }
 
+    // return the loaded texture on success, a full mip chain adds a third to the size of the largest level
+    size_t byte_size = static_cast<size_t>(size.get_area()) * get_pixel_byte_size(texture_format, args.data_type);
+    if (args.create_mipmaps) { byte_size += byte_size / 3; }
+    return _finalize(id, std::move(name), size, texture_format, byte_size, args);
+}
+
+TexturePtr Texture::create_from_image(const CompressedImage& image, std::string name, const Args& args) {
+    const Size2i& size = image.get_size();
+    const GLenum internal_format = image.get_internal_format();
+    const std::vector<CompressedImage::Level>& levels = image.get_levels();
+    const GLsizei level_count = static_cast<GLsizei>(levels.size());
+
+    // upload all levels as they are, compressed textures cannot generate their own mipmaps
+    const GLuint id = _generate(size, /* alignment= */ 4);
+    if (args.make_immutable) {
+        // immutable texture
+        NOTF_CHECK_GL(glTexStorage2D(GL_TEXTURE_2D, level_count, internal_format, size.get_width(), size.get_height()));
+        for (GLint level = 0; level < level_count; ++level) {
+            const CompressedImage::Level& data = levels[static_cast<size_t>(level)];
+            NOTF_CHECK_GL(glCompressedTexSubImage2D(GL_TEXTURE_2D, level, /* xoffset= */ 0, /* yoffset= */ 0,
+                                                    data.size.get_width(), data.size.get_height(), internal_format,
+                                                    static_cast<GLsizei>(data.length), data.data));
+        }
+    } else {
+        // mutable texture
+        for (GLint level = 0; level < level_count; ++level) {
+            const CompressedImage::Level& data = levels[static_cast<size_t>(level)];
+            NOTF_CHECK_GL(glCompressedTexImage2D(GL_TEXTURE_2D, level, internal_format, data.size.get_width(),
+                                                 data.size.get_height(), BORDER, static_cast<GLsizei>(data.length),
+                                                 data.data));
+        }
+    }
+    // without this, a mipmap filter would sample levels that do not exist and the texture would be incomplete
+    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level_count - 1));
+
+    const bool is_rgb = internal_format == GL_COMPRESSED_RGB8_ETC2 || internal_format == GL_COMPRESSED_SRGB8_ETC2;
+    NOTF_LOG_TRACE("Loaded {}x{} compressed OpenGL texture with {} mip levels and ID: {} from: \"{}\"",
+                   size.get_width(), size.get_height(), level_count, id, image.get_filepath());
+
     // return the loaded texture on success
-    TexturePtr texture = Texture::_create_shared(id, GL_TEXTURE_2D, name, std::move(image_size), texture_format);
+    return _finalize(id, std::move(name), size, is_rgb ? Format::RGB : Format::RGBA, image.get_data_length(), args);
+}
+
+GLuint Texture::_generate(const Size2i& size, const GLint alignment) {
+    GLuint id = 0;
+    NOTF_CHECK_GL(glGenTextures(1, &id));
+    NOTF_ASSERT(id);
+    NOTF_CHECK_GL(glBindTexture(GL_TEXTURE_2D, id));
+
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, alignment));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, size.get_width()));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, size.get_height()));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+    NOTF_CHECK_GL(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+    return id;
+}
+
+TexturePtr Texture::_finalize(const GLuint id, std::string name, Size2i size, const Format format,
+                              const size_t byte_size, const Args& args) {
+    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minfilter_to_gl(args.min_filter)));
+    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magfilter_to_gl(args.mag_filter)));
+
+    // repeat wrap by default
+    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_to_gl(args.wrap_horizontal)));
+    NOTF_CHECK_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_to_gl(args.wrap_vertical)));
+
+    // make texture anisotropic, if requested and available
+    if (args.anisotropy > 1.f && TheGraphicsSystem::get_extensions().anisotropic_filter) {
+        GLfloat highest_anisotropy;
+        NOTF_CHECK_GL(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &highest_anisotropy));
+        NOTF_CHECK_GL(
+            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, min(args.anisotropy, highest_anisotropy)));
+    }
+
+    TexturePtr texture = Texture::_create_shared(id, GL_TEXTURE_2D, name, std::move(size), format, byte_size);
     TheGraphicsSystem::AccessFor<Texture>::register_new(texture);
     ResourceManager::get_instance().get_type<Texture>().set(std::move(name), texture);
     return texture;
@@ -316,30 +355,31 @@ void Texture::flood(const Color& color) {
 
     // create the source buffer and copy it into the texture
     if (m_format == Format::GRAYSCALE) {
-        const std::vector<uchar> buffer(static_cast<size_t>(m_size.width() * m_size.height() * to_number(m_format)), r);
-        NOTF_CHECK_GL(
-            glTexImage2D(m_target, 0, GL_R8, m_size.width(), m_size.height(), 0, GL_RED, GL_UNSIGNED_BYTE, &buffer[0]));
+        const std::vector<uchar> buffer(
+            static_cast<size_t>(m_size.get_width() * m_size.get_height() * to_number(m_format)), r);
+        NOTF_CHECK_GL(glTexImage2D(m_target, 0, GL_R8, m_size.get_width(), m_size.get_height(), 0, GL_RED,
+                                   GL_UNSIGNED_BYTE, &buffer[0]));
     } else if (m_format == Format::RGB) {
         std::vector<uchar> buffer;
-        buffer.reserve(static_cast<size_t>(m_size.width() * m_size.height() * to_number(m_format)));
-        for (size_t i = 0; i < static_cast<size_t>(m_size.width() * m_size.height()); ++i) {
+        buffer.reserve(static_cast<size_t>(m_size.get_width() * m_size.get_height() * to_number(m_format)));
+        for (size_t i = 0; i < static_cast<size_t>(m_size.get_width() * m_size.get_height()); ++i) {
             buffer[i * to_number(Format::RGB) + 0] = r;
             buffer[i * to_number(Format::RGB) + 1] = g;
             buffer[i * to_number(Format::RGB) + 2] = b;
         }
-        NOTF_CHECK_GL(glTexImage2D(m_target, 0, GL_RGB, m_size.width(), m_size.height(), 0, GL_RGB, GL_UNSIGNED_BYTE,
-                                   &buffer[0]));
+        NOTF_CHECK_GL(glTexImage2D(m_target, 0, GL_RGB, m_size.get_width(), m_size.get_height(), 0, GL_RGB,
+                                   GL_UNSIGNED_BYTE, &buffer[0]));
     } else if (m_format == Format::RGBA) {
         std::vector<uchar> buffer;
-        buffer.reserve(static_cast<size_t>(m_size.width() * m_size.height() * to_number(m_format)));
-        for (size_t i = 0; i < static_cast<size_t>(m_size.width() * m_size.height()); ++i) {
+        buffer.reserve(static_cast<size_t>(m_size.get_width() * m_size.get_height() * to_number(m_format)));
+        for (size_t i = 0; i < static_cast<size_t>(m_size.get_width() * m_size.get_height()); ++i) {
             buffer[i * to_number(Format::RGBA) + 0] = r;
             buffer[i * to_number(Format::RGBA) + 1] = g;
             buffer[i * to_number(Format::RGBA) + 2] = b;
             buffer[i * to_number(Format::RGBA) + 3] = a;
         }
-        NOTF_CHECK_GL(glTexImage2D(m_target, 0, GL_RGBA, m_size.width(), m_size.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                                   &buffer[0]));
+        NOTF_CHECK_GL(glTexImage2D(m_target, 0, GL_RGBA, m_size.get_width(), m_size.get_height(), 0, GL_RGBA,
+                                   GL_UNSIGNED_BYTE, &buffer[0]));
     }
 }
 
@@ -0,0 +1,97 @@
+#include "notf/graphic/texture_loader.hpp"
+
+#include "notf/meta/log.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// texture loader =================================================================================================== //
+
+TextureLoader::TextureLoader(const size_t thread_count) : m_workers(thread_count) {}
+
+TextureLoader::~TextureLoader() = default;
+
+std::future<TexturePtr> TextureLoader::load(std::string file_path, std::string name, const Texture::Args& args) {
+    auto promise = std::make_shared<std::promise<TexturePtr>>();
+    std::future<TexturePtr> result = promise->get_future();
+    load(
+        std::move(file_path), std::move(name),
+        [promise = std::move(promise)](TexturePtr texture, std::exception_ptr exception) {
+            if (exception) {
+                promise->set_exception(std::move(exception));
+            } else {
+                promise->set_value(std::move(texture));
+            }
+        },
+        args);
+    return result;
+}
+
+void TextureLoader::load(std::string file_path, std::string name, Callback callback, const Texture::Args& args) {
+    auto request = std::make_shared<_Request>();
+    request->file_path = std::move(file_path);
+    request->name = std::move(name);
+    request->args = args;
+    request->callback = std::move(callback);
+
+    ++m_pending_count;
+    m_workers.enqueue([this, request = std::move(request)] {
+        try {
+            if (request->args.codec == Texture::Codec::COMPRESSED) {
+                request->compressed_image = std::make_unique<CompressedImage>(request->file_path);
+                request->compressed_image->page_in();
+            } else {
+                request->image = std::make_unique<RawImage>(request->file_path);
+            }
+        }
+        catch (...) {
+            NOTF_LOG_WARN("Failed to load Texture \"{}\" from \"{}\"", request->name, request->file_path);
+            --m_pending_count;
+            request->finish(nullptr, std::current_exception());
+            return;
+        }
+        NOTF_GUARD(std::lock_guard(m_decoded_mutex));
+        m_decoded.emplace_back(std::move(request));
+    });
+}
+
+size_t TextureLoader::upload(const duration_t budget) {
+    const timepoint_t deadline = get_now() + budget;
+    size_t upload_count = 0;
+    do {
+        _RequestPtr request;
+        {
+            NOTF_GUARD(std::lock_guard(m_decoded_mutex));
+            if (m_decoded.empty()) { break; }
+            request = std::move(m_decoded.front());
+            m_decoded.pop_front();
+        }
+
+        TexturePtr texture;
+        std::exception_ptr exception;
+        try {
+            if (request->compressed_image) {
+                texture
+                    = Texture::create_from_image(*request->compressed_image, std::move(request->name), request->args);
+            } else {
+                texture = Texture::create_from_image(*request->image, std::move(request->name), request->args);
+            }
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+        request->image.reset(); // free the decoded pixels right away
+        request->compressed_image.reset();
+
+        --m_pending_count;
+        request->finish(std::move(texture), std::move(exception));
+        ++upload_count;
+    } while (get_now() < deadline);
+    return upload_count;
+}
+
+size_t TextureLoader::get_decoded_count() const {
+    NOTF_GUARD(std::lock_guard(m_decoded_mutex));
+    return m_decoded.size();
+}
+
+NOTF_CLOSE_NAMESPACE
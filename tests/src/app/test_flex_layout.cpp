@@ -0,0 +1,68 @@
+#include "catch.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#include "notf/app/widget/layout.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Number of heap allocations made by this thread so far.
+thread_local size_t g_allocation_count = 0;
+
+/// Produces `count` Claims with varied sizes, scale factors and priorities.
+std::vector<WidgetClaim> produce_claims(const size_t count) {
+    std::vector<WidgetClaim> claims(count);
+    for (size_t i = 0; i < count; ++i) {
+        const float size = static_cast<float>(i % 30);
+        claims[i].set_min(5, 5);
+        claims[i].set_preferred(10 + size, 40 - size);
+        claims[i].set_max(50 + size, 50 + size);
+        claims[i].set_scale_factor(0.5f + static_cast<float>(i % 4) / 2);
+        claims[i].set_priority(static_cast<int>(i % 8));
+    }
+    return claims;
+}
+
+} // namespace
+
+// every allocation in the test runner is counted, so the test can check that a relayout does not allocate
+void* operator new(const std::size_t size) {
+    ++g_allocation_count;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) { return ptr; }
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+SCENARIO("flex layout", "[app][layout]") {
+    const std::vector<WidgetClaim> claims = produce_claims(10000);
+    std::vector<const WidgetClaim*> claim_list;
+    for (const WidgetClaim& claim : claims) {
+        claim_list.push_back(&claim);
+    }
+    std::vector<AnyLayout::Placement> placements;
+
+    SECTION("relayouts re-use the scratch buffers of the solver and do not allocate") {
+        for (const FlexLayout::Wrap wrap : {FlexLayout::Wrap::NO_WRAP, FlexLayout::Wrap::WRAP}) {
+            FlexLayout layout;
+            layout.set_spacing(2, /* relayout = */ false);
+            layout.set_cross_spacing(2, false);
+            layout.set_wrap(wrap, false);
+
+            // the first relayout grows all buffers, without wrapping the surplus is distributed among all children
+            const Size2f grant(wrap == FlexLayout::Wrap::WRAP ? 2000 : 600000, 1000);
+            layout.update(placements, claim_list, grant);
+            REQUIRE(placements.size() == claims.size());
+
+            const size_t allocations_before = g_allocation_count;
+            for (int frame = 0; frame < 10; ++frame) {
+                layout.update(placements, claim_list, grant);
+            }
+            const size_t allocations = g_allocation_count - allocations_before;
+            REQUIRE(allocations == 0);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include "catch.hpp"
+
+#include <algorithm>
+
+#include "notf/app/widget/hit_grid.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Values of all live entries found by the given point or rect query, sorted.
+template<class T, class Query>
+std::vector<int> query_values(const HitGrid<T>& grid, const Query& query) {
+    std::vector<typename HitGrid<T>::Handle> handles;
+    grid.query(query, handles);
+    std::vector<int> result;
+    for (const auto handle : handles) {
+        if constexpr (std::is_same_v<T, int>) {
+            result.emplace_back(grid.get_value(handle));
+        } else {
+            if (auto value = grid.get_value(handle).lock()) { result.emplace_back(*value); }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+SCENARIO("hit grid", "[app][widget]") {
+    HitGrid<int> grid(Aabrf(0, 0, 100, 100), 10);
+
+    SECTION("inserted entries are found at points and in rects") {
+        grid.insert(Aabrf(5, 5, 10, 10), 1);
+        grid.insert(Aabrf(12, 12, 30, 30), 2);
+        grid.insert(Aabrf(0, 0, 100, 100), 3); // too large for the cells
+        REQUIRE(grid.get_size() == 3);
+
+        REQUIRE(query_values(grid, V2f(7, 7)) == std::vector<int>{1, 3});
+        REQUIRE(query_values(grid, V2f(20, 20)) == std::vector<int>{2, 3});
+        REQUIRE(query_values(grid, V2f(50, 50)) == std::vector<int>{3});
+        REQUIRE(query_values(grid, V2f(500, 500)).empty());
+
+        // entries spanning multiple cells are only reported once
+        REQUIRE(query_values(grid, Aabrf(0, 0, 40, 40)) == std::vector<int>{1, 2, 3});
+        REQUIRE(query_values(grid, Aabrf(16, 16, 2, 2)) == std::vector<int>{2, 3});
+    }
+
+    SECTION("entries outside the bounds are clamped to the border cells") {
+        grid.insert(Aabrf(-20, 50, 10, 10), 1);
+        grid.insert(Aabrf(150, 150, 10, 10), 2);
+
+        REQUIRE(query_values(grid, V2f(-15, 55)) == std::vector<int>{1});
+        REQUIRE(query_values(grid, V2f(155, 155)) == std::vector<int>{2});
+        REQUIRE(query_values(grid, V2f(95, 95)).empty());
+    }
+
+    SECTION("moved entries are only found at their new position") {
+        const auto handle = grid.insert(Aabrf(5, 5, 10, 10), 1);
+
+        grid.update(handle, Aabrf(60, 60, 10, 10));
+        REQUIRE(query_values(grid, V2f(7, 7)).empty());
+        REQUIRE(query_values(grid, V2f(65, 65)) == std::vector<int>{1});
+
+        // moving within the same cells
+        grid.update(handle, Aabrf(61, 61, 5, 5));
+        REQUIRE(query_values(grid, V2f(68, 68)).empty());
+        REQUIRE(query_values(grid, V2f(63, 63)) == std::vector<int>{1});
+
+        // moving into and out of the list of large entries
+        grid.update(handle, Aabrf(0, 0, 100, 100));
+        REQUIRE(query_values(grid, V2f(7, 7)) == std::vector<int>{1});
+        grid.update(handle, Aabrf(5, 5, 10, 10));
+        REQUIRE(query_values(grid, V2f(50, 50)).empty());
+        REQUIRE(query_values(grid, V2f(7, 7)) == std::vector<int>{1});
+
+        // re-distributing the grid keeps the entry
+        grid.set_bounds(Aabrf(0, 0, 20, 20));
+        REQUIRE(query_values(grid, V2f(7, 7)) == std::vector<int>{1});
+        REQUIRE(grid.get_size() == 1);
+    }
+
+    SECTION("removed entries are no longer found and their handles are re-used") {
+        const auto first = grid.insert(Aabrf(5, 5, 10, 10), 1);
+        grid.insert(Aabrf(5, 5, 20, 20), 2);
+
+        grid.remove(first);
+        REQUIRE(grid.get_size() == 1);
+        REQUIRE(query_values(grid, V2f(7, 7)) == std::vector<int>{2});
+
+        REQUIRE(grid.insert(Aabrf(50, 50, 10, 10), 3) == first);
+        REQUIRE(grid.get_size() == 2);
+        REQUIRE(query_values(grid, V2f(55, 55)) == std::vector<int>{3});
+
+        grid.clear();
+        REQUIRE(grid.get_size() == 0);
+        REQUIRE(query_values(grid, V2f(7, 7)).empty());
+    }
+}
+
+SCENARIO("hit grid with expiring values", "[app][widget]") {
+    HitGrid<std::weak_ptr<int>> grid(Aabrf(0, 0, 100, 100), 10);
+    auto alive = std::make_shared<int>(1);
+    auto expiring = std::make_shared<int>(2);
+    auto large = std::make_shared<int>(3);
+
+    const auto alive_handle = grid.insert(Aabrf(5, 5, 10, 10), alive);
+    grid.insert(Aabrf(30, 30, 10, 10), expiring);
+    grid.insert(Aabrf(0, 0, 100, 100), large);
+    expiring.reset();
+    large.reset();
+    REQUIRE(grid.get_size() == 3);
+
+    SECTION("stale entries are purged from the cells that an insert touches") {
+        grid.insert(Aabrf(35, 35, 2, 2), alive);
+        REQUIRE(grid.get_size() == 3); // the stale large entry is not in the touched cells
+    }
+
+    SECTION("stale entries are purged from the cells that a move leaves and enters") {
+        grid.update(alive_handle, Aabrf(80, 80, 10, 10));
+        REQUIRE(grid.get_size() == 3);
+        grid.update(alive_handle, Aabrf(35, 35, 2, 2));
+        REQUIRE(grid.get_size() == 2);
+
+        // moving into the list of large entries purges the other large entries
+        grid.update(alive_handle, Aabrf(0, 0, 100, 100));
+        REQUIRE(grid.get_size() == 1);
+        REQUIRE(query_values(grid, V2f(50, 50)) == std::vector<int>{1});
+    }
+
+    SECTION("all stale entries are purged when the grid is re-distributed") {
+        grid.set_bounds(Aabrf(0, 0, 50, 50));
+        REQUIRE(grid.get_size() == 1);
+        REQUIRE(query_values(grid, Aabrf(0, 0, 100, 100)) == std::vector<int>{1});
+    }
+}
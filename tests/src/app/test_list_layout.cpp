@@ -0,0 +1,94 @@
+#include "catch.hpp"
+
+#include <algorithm>
+
+#include "notf/app/widget/layout.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Vertical position of each row that displays an item.
+std::vector<std::pair<size_t, float>> get_row_positions(const ListLayout& layout, const Size2f& grant) {
+    std::vector<WidgetClaim> claims(layout.get_row_items().size(), layout.get_row_claim());
+    std::vector<const WidgetClaim*> claim_list;
+    for (const WidgetClaim& claim : claims) {
+        claim_list.push_back(&claim);
+    }
+    std::vector<AnyLayout::Placement> placements;
+    layout.update(placements, claim_list, grant);
+
+    std::vector<std::pair<size_t, float>> result;
+    for (size_t row = 0; row < placements.size(); ++row) {
+        const size_t item = layout.get_row_items()[row];
+        if (item != ListLayout::no_item) { result.emplace_back(item, placements[row].xform[2][1]); }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+SCENARIO("list layout", "[app][layout]") {
+    ListLayout layout;
+    layout.set_item_count(1000000, /* relayout = */ false);
+    layout.set_row_claim(WidgetClaim(WidgetClaim::Stretch(200), WidgetClaim::Stretch(20)), false);
+    layout.set_spacing(1, false);
+
+    const Size2f grant(200, 100);
+    const Aabrf viewport(grant);
+    std::vector<size_t> changed_rows;
+
+    SECTION("only visible items are assigned to rows") {
+        layout.assign_rows(grant, viewport, changed_rows);
+        REQUIRE(layout.get_visible_items(grant, viewport) == std::make_pair(size_t(0), size_t(5)));
+        REQUIRE(layout.get_row_items().size() == 5);
+        REQUIRE(changed_rows.size() == 5);
+
+        // scrolling by less than a row keeps all rows that are still visible
+        layout.scroll_by(10, false);
+        layout.assign_rows(grant, viewport, changed_rows);
+        REQUIRE(layout.get_visible_items(grant, viewport) == std::make_pair(size_t(0), size_t(6)));
+        REQUIRE(layout.get_row_items().size() == 6);
+        REQUIRE(changed_rows == std::vector<size_t>{5});
+    }
+
+    SECTION("rows are placed exactly, even far down a very long list") {
+        layout.set_scroll_position(999990, 10.5f, false);
+        REQUIRE(layout.get_scroll_item() == 999990);
+        REQUIRE(layout.get_scroll_remainder() == 10.5f);
+
+        layout.assign_rows(grant, viewport, changed_rows);
+        const std::vector<std::pair<size_t, float>> rows = get_row_positions(layout, grant);
+        REQUIRE(rows.size() == 6);
+        REQUIRE(rows.front().first == 999990);
+        REQUIRE(rows.front().second == 100 + 10.5f - 20);
+        for (size_t i = 1; i < rows.size(); ++i) {
+            REQUIRE(rows[i].first == rows[i - 1].first + 1);
+            REQUIRE(rows[i - 1].second - rows[i].second == 21);
+        }
+    }
+
+    SECTION("scrolling is relative to the scroll item and clamped to the list") {
+        layout.set_scroll_position(999990, 0, false);
+        layout.scroll_by(-42.5f, false);
+        REQUIRE(layout.get_scroll_item() == 999987);
+        REQUIRE(layout.get_scroll_remainder() == 20.5f);
+
+        layout.scroll_by(1000, false);
+        REQUIRE(layout.get_scroll_item() == 999999);
+        REQUIRE(layout.get_scroll_remainder() == 20);
+
+        layout.set_scroll_position(3, -100, false);
+        REQUIRE(layout.get_scroll_item() == 0);
+        REQUIRE(layout.get_scroll_remainder() == 0);
+
+        layout.set_scroll_offset(42 + 5, false);
+        REQUIRE(layout.get_scroll_item() == 2);
+        REQUIRE(layout.get_scroll_remainder() == 5);
+
+        layout.set_item_count(2, false);
+        REQUIRE(layout.get_scroll_item() == 1);
+        REQUIRE(layout.get_scroll_remainder() == 20);
+    }
+}
@@ -0,0 +1,232 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "notf/app/resource_manager.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Resource reporting its size.
+struct SizedResource {
+    size_t get_byte_size() const { return byte_size; }
+    size_t byte_size;
+};
+
+/// Another resource type, to test budgets across types.
+struct OtherSizedResource {
+    size_t get_byte_size() const { return byte_size; }
+    size_t byte_size;
+};
+
+/// Resource without a size.
+struct UnsizedResource {};
+
+/// Resource whose type keeps the default byte budget.
+struct PrefetchedResource {
+    size_t get_byte_size() const { return byte_size; }
+    size_t byte_size;
+};
+
+} // namespace
+
+SCENARIO("resource manager", "[app][resource_manager]") {
+    ResourceManager& manager = ResourceManager::get_instance();
+    manager.clear();
+    auto& sized = manager.get_type<SizedResource>();
+    auto& other = manager.get_type<OtherSizedResource>();
+    sized.set_byte_budget(0);
+    other.set_byte_budget(0);
+
+    SECTION("resources report their size") {
+        const ResourceStats before = sized.get_stats();
+        auto a = std::make_shared<SizedResource>(SizedResource{10});
+        auto b = std::make_shared<SizedResource>(SizedResource{20});
+        sized.set("a", a);
+        sized.set("b", b);
+        manager.get_type<UnsizedResource>().set("c", std::make_shared<UnsizedResource>());
+
+        REQUIRE(sized.get("a").get_shared() == a);
+        REQUIRE(!sized.get("x"));
+
+        const ResourceStats after = sized.get_stats();
+        REQUIRE(after.hits - before.hits == 1);
+        REQUIRE(after.misses - before.misses == 1);
+        REQUIRE(after.resource_count == 2);
+        REQUIRE(after.bytes_resident == 30);
+        REQUIRE(manager.get_stats().bytes_resident == 30);
+        REQUIRE(manager.get_stats().resource_count == 3);
+
+        // replacing a resource replaces its size
+        sized.set("a", std::make_shared<SizedResource>(SizedResource{5}));
+        REQUIRE(sized.get_stats().bytes_resident == 5 + 20);
+    }
+
+    SECTION("inactive resources are evicted in least recently used order") {
+        sized.set_byte_budget(50);
+        const size_t evictions = sized.get_stats().evictions;
+
+        sized.set("a", std::make_shared<SizedResource>(SizedResource{10}));
+        sized.set("b", std::make_shared<SizedResource>(SizedResource{20}));
+        sized.set("c", std::make_shared<SizedResource>(SizedResource{20}));
+        REQUIRE(sized.get_stats().bytes_resident == 50);
+
+        sized.set("d", std::make_shared<SizedResource>(SizedResource{10}));
+        REQUIRE(!sized.get("a"));
+        REQUIRE(sized.get_stats().bytes_resident == 50);
+
+        // looking up a resource marks it as recently used
+        REQUIRE(sized.get("b"));
+        sized.set("e", std::make_shared<SizedResource>(SizedResource{20}));
+        REQUIRE(sized.get("b"));
+        REQUIRE(!sized.get("c"));
+        REQUIRE(sized.get("d"));
+        REQUIRE(sized.get("e"));
+        REQUIRE(sized.get_stats().evictions - evictions == 2);
+
+        // lowering the budget evicts right away
+        sized.set_byte_budget(20);
+        REQUIRE(sized.get_stats().bytes_resident <= 20);
+    }
+
+    SECTION("active resources are never evicted") {
+        sized.set_byte_budget(10);
+        ResourceHandle<SizedResource> large = sized.set("large", std::make_shared<SizedResource>(SizedResource{100}));
+        sized.set("small", std::make_shared<SizedResource>(SizedResource{1})); // active until `set` returns
+        manager.cleanup();
+        REQUIRE(sized.get("large"));
+        REQUIRE(!sized.get("small"));
+        REQUIRE(sized.get_stats().bytes_resident == 100);
+
+        large = {};
+        sized.remove_all_inactive();
+        REQUIRE(sized.get_stats().bytes_resident == 0);
+    }
+
+    SECTION("the global budget evicts across all types") {
+        sized.set_byte_budget(1000);
+        other.set_byte_budget(1000);
+        manager.set_byte_budget(50);
+
+        sized.set("a", std::make_shared<SizedResource>(SizedResource{20}));
+        other.set("b", std::make_shared<OtherSizedResource>(OtherSizedResource{20}));
+        sized.set("c", std::make_shared<SizedResource>(SizedResource{20}));
+        REQUIRE(!sized.get("a"));
+        REQUIRE(other.get("b"));
+        REQUIRE(sized.get("c"));
+        REQUIRE(manager.get_stats().bytes_resident == 40);
+
+        manager.set_byte_budget(max_v<size_t>);
+    }
+
+    SECTION("resources can be loaded asynchronously") {
+        std::atomic<int> load_count = 0;
+        std::promise<void> gate;
+        std::shared_future<void> gate_future = gate.get_future().share();
+        sized.set_loader([&](const std::string& name) {
+            ++load_count;
+            gate_future.wait();
+            if (name == "bad") { throw std::runtime_error("cannot load"); }
+            return std::make_shared<SizedResource>(SizedResource{name.size()});
+        });
+
+        // concurrent requests for the same resource share a single load
+        auto first = sized.get_async("a");
+        auto second = sized.get_async("a");
+        auto bad = sized.get_async("bad");
+        REQUIRE(sized.get_request_count() == 2);
+        gate.set_value();
+
+        REQUIRE(first.get().get_shared() == second.get().get_shared());
+        REQUIRE(first.get().get_shared()->byte_size == 1);
+        REQUIRE_THROWS_AS(bad.get(), std::runtime_error);
+        REQUIRE(load_count == 2);
+
+        // loaded resources are cached
+        REQUIRE(sized.get("a").get_shared() == first.get().get_shared());
+        auto cached = sized.get_async("a");
+        REQUIRE(cached.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        REQUIRE(load_count == 2);
+
+        // failed requests can be retried
+        REQUIRE(sized.get_request_count() == 0);
+        REQUIRE_THROWS_AS(sized.get_async("bad").get(), std::runtime_error);
+        REQUIRE(load_count == 3);
+
+        // resources are prefetched in the background
+        sized.set_byte_budget(1000);
+        sized.prefetch({"bb", "ccc"});
+        sized.get_async("bb").wait();
+        sized.get_async("ccc").wait();
+        REQUIRE(sized.get("bb"));
+        REQUIRE(sized.get("ccc"));
+        REQUIRE(load_count == 5);
+
+        sized.set_loader({});
+        REQUIRE_THROWS_AS(sized.get_async("d"), ResourceError);
+    }
+
+    SECTION("asynchronous loaders are completed later by another thread") {
+        std::vector<std::pair<std::string, ResourceManager::ResourceType<SizedResource>::Completion>> started;
+        std::mutex started_mutex;
+        sized.set_async_loader([&](const std::string& name, auto completion) {
+            NOTF_GUARD(std::lock_guard(started_mutex));
+            started.emplace_back(name, std::move(completion));
+        });
+
+        // the worker returns right away, the request stays open until it is completed
+        auto good = sized.get_async("good");
+        auto bad = sized.get_async("bad");
+        while (true) {
+            {
+                NOTF_GUARD(std::lock_guard(started_mutex));
+                if (started.size() == 2) { break; }
+            }
+            std::this_thread::yield();
+        }
+        REQUIRE(good.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+        REQUIRE(sized.get_request_count() == 2);
+
+        for (auto& [name, completion] : started) {
+            if (name == "good") {
+                completion(std::make_shared<SizedResource>(SizedResource{4}), nullptr);
+            } else {
+                completion(nullptr, std::make_exception_ptr(std::runtime_error("cannot load")));
+            }
+        }
+        REQUIRE(good.get().get_shared()->byte_size == 4);
+        REQUIRE(sized.get("good"));
+        REQUIRE_THROWS_AS(bad.get(), std::runtime_error);
+        REQUIRE(sized.get_request_count() == 0);
+        sized.set_async_loader({});
+    }
+
+    SECTION("prefetched resources are still resident after other resources are stored") {
+        auto& prefetched = manager.get_type<PrefetchedResource>();
+        REQUIRE(prefetched.get_byte_budget() == max_v<size_t>);
+        prefetched.set_loader([](const std::string& name) {
+            return std::make_shared<PrefetchedResource>(PrefetchedResource{name.size()});
+        });
+
+        // nobody holds on to the prefetched resource, so it is inactive once it is loaded
+        prefetched.prefetch({"a"});
+        prefetched.get_async("a").wait();
+        REQUIRE(prefetched.get_request_count() == 0);
+
+        const size_t evictions = prefetched.get_stats().evictions;
+        prefetched.set("bb", std::make_shared<PrefetchedResource>(PrefetchedResource{2}));
+        REQUIRE(prefetched.get("a"));
+        REQUIRE(prefetched.get_stats().evictions == evictions);
+
+        // inactive resources are still removed on request
+        manager.remove_all_inactive();
+        REQUIRE(prefetched.get_stats().resource_count == 0);
+        prefetched.set_loader({});
+    }
+
+    manager.clear();
+    REQUIRE(manager.get_stats().bytes_resident == 0);
+}
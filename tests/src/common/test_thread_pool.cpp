@@ -0,0 +1,67 @@
+#include <atomic>
+
+#include "catch.hpp"
+
+#include "notf/common/thread_pool.hpp"
+
+NOTF_USING_NAMESPACE;
+
+SCENARIO("thread pool", "[common][thread]") {
+
+    SECTION("tasks with a return value return a future") {
+        ThreadPool pool(2);
+        REQUIRE(pool.get_thread_count() == 2);
+
+        std::vector<std::future<size_t>> futures;
+        for (size_t i = 0; i < 16; ++i) {
+            futures.emplace_back(pool.enqueue([i]() -> size_t { return i * i; }));
+        }
+        for (size_t i = 0; i < futures.size(); ++i) {
+            REQUIRE(futures[i].get() == i * i);
+        }
+    }
+
+    SECTION("all tasks without a return value are finished when the pool is destroyed") {
+        std::atomic<size_t> counter = 0;
+        {
+            ThreadPool pool(3);
+            for (size_t i = 0; i < 100; ++i) {
+                pool.enqueue([&counter] { ++counter; });
+            }
+        }
+        REQUIRE(counter == 100);
+    }
+
+    SECTION("exceptions thrown by a task are forwarded through its future") {
+        ThreadPool pool(1);
+        std::future<int> future = pool.enqueue([]() -> int { throw std::runtime_error("task failed"); });
+        REQUIRE_THROWS_AS(future.get(), std::runtime_error);
+    }
+
+    SECTION("chunks cover every index exactly once") {
+        ThreadPool pool(3);
+        for (const size_t count : {size_t(0), size_t(1), size_t(10), size_t(1000)}) {
+            std::vector<std::atomic<size_t>> visits(count);
+            pool.for_each_chunk(count, 8, 4, [&](const size_t first, const size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    ++visits[i];
+                }
+            });
+            for (const std::atomic<size_t>& visit : visits) {
+                REQUIRE(visit == 1);
+            }
+        }
+    }
+
+    SECTION("exceptions thrown while processing a chunk are rethrown once all chunks are done") {
+        ThreadPool pool(2);
+        std::atomic<size_t> processed = 0;
+        REQUIRE_THROWS_AS(pool.for_each_chunk(100, 1, 4,
+                                              [&](const size_t first, const size_t last) {
+                                                  processed += last - first;
+                                                  if (first == 0) { throw std::runtime_error("chunk failed"); }
+                                              }),
+                          std::runtime_error);
+        REQUIRE(processed == 100);
+    }
+}
@@ -0,0 +1,137 @@
+#include "catch.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include "notf/graphic/compressed_image.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Appends an unsigned little-endian integer with the given number of bytes.
+void append(std::vector<uchar>& data, const uint64_t value, const size_t byte_count) {
+    for (size_t i = 0; i < byte_count; ++i) {
+        data.push_back(static_cast<uchar>(value >> (i * 8)));
+    }
+}
+
+/// Contents of an `.astc` file with the given block and image size.
+std::vector<uchar> make_astc(const int block_width, const int block_height, const int width, const int height) {
+    std::vector<uchar> data = {0x13, 0xAB, 0xA1, 0x5C};
+    append(data, static_cast<uint64_t>(block_width), 1);
+    append(data, static_cast<uint64_t>(block_height), 1);
+    append(data, 1, 1);
+    append(data, static_cast<uint64_t>(width), 3);
+    append(data, static_cast<uint64_t>(height), 3);
+    append(data, 1, 3);
+    const int block_count = ((width + block_width - 1) / block_width) * ((height + block_height - 1) / block_height);
+    data.resize(data.size() + static_cast<size_t>(block_count * 16), 0xAA);
+    return data;
+}
+
+/// Contents of a KTX2 file with the given Vulkan format and mip level lengths, the largest level first.
+std::vector<uchar> make_ktx2(const uint32_t vk_format, const int width, const int height,
+                             const std::vector<size_t>& level_lengths, const uint32_t supercompression = 0) {
+    std::vector<uchar> data = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    append(data, vk_format, 4);
+    append(data, 1, 4); // type size
+    append(data, static_cast<uint64_t>(width), 4);
+    append(data, static_cast<uint64_t>(height), 4);
+    append(data, 0, 4); // depth
+    append(data, 0, 4); // layer count
+    append(data, 1, 4); // face count
+    append(data, level_lengths.size(), 4);
+    append(data, supercompression, 4);
+    append(data, 0, 4 * 4 + 8 * 2); // data format descriptor, key/value data and supercompression global data
+
+    // the levels are stored from the smallest to the largest
+    size_t offset = data.size() + level_lengths.size() * 24;
+    std::vector<size_t> offsets(level_lengths.size());
+    for (size_t level = level_lengths.size(); level-- > 0;) {
+        offsets[level] = offset;
+        offset += level_lengths[level];
+    }
+    for (size_t level = 0; level < level_lengths.size(); ++level) {
+        append(data, offsets[level], 8);
+        append(data, level_lengths[level], 8);
+        append(data, level_lengths[level], 8);
+    }
+    for (size_t level = level_lengths.size(); level-- > 0;) {
+        data.resize(data.size() + level_lengths[level], static_cast<uchar>(level));
+    }
+    return data;
+}
+
+/// Writes the given data into a temporary file and returns its path.
+std::string write_file(const std::vector<uchar>& data) {
+    const std::string path = (std::filesystem::temp_directory_path() / "notf_test_compressed_image").string();
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return path;
+}
+
+} // namespace
+
+SCENARIO("compressed image", "[graphic][compressed_image]") {
+
+    SECTION("astc files contain a single level of any block size") {
+        const CompressedImage image(write_file(make_astc(6, 5, 20, 13)));
+        REQUIRE(image.get_container() == CompressedImage::Container::ASTC);
+        REQUIRE(image.get_size() == Size2i(20, 13));
+        REQUIRE(image.get_block_size() == Size2i(6, 5));
+        REQUIRE(image.is_srgb());
+        REQUIRE(image.get_internal_format() == GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5);
+        REQUIRE(image.get_levels().size() == 1);
+        REQUIRE(image.get_data_length() == 4 * 3 * 16);
+        REQUIRE(image.get_levels()[0].data[0] == 0xAA);
+
+        const CompressedImage linear(write_file(make_astc(12, 12, 12, 12)), /* is_srgb = */ false);
+        REQUIRE(linear.get_internal_format() == GL_COMPRESSED_RGBA_ASTC_12x12);
+    }
+
+    SECTION("ktx2 files contain all their mip levels") {
+        const CompressedImage image(write_file(make_ktx2(158, 8, 6, {64, 16, 16, 16}))); // ASTC 4x4 sRGB
+        REQUIRE(image.get_container() == CompressedImage::Container::KTX2);
+        REQUIRE(image.get_internal_format() == GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4);
+        REQUIRE(image.is_srgb());
+        REQUIRE(image.get_block_size() == Size2i(4, 4));
+
+        const std::vector<CompressedImage::Level>& levels = image.get_levels();
+        REQUIRE(levels.size() == 4);
+        REQUIRE(levels[0].size == Size2i(8, 6));
+        REQUIRE(levels[1].size == Size2i(4, 3));
+        REQUIRE(levels[2].size == Size2i(2, 1));
+        REQUIRE(levels[3].size == Size2i(1, 1));
+        for (size_t level = 0; level < levels.size(); ++level) {
+            REQUIRE(levels[level].data[0] == level);
+        }
+        REQUIRE(image.get_data_length() == 64 + 16 * 3);
+    }
+
+    SECTION("ktx2 files can contain ETC2 images") {
+        const CompressedImage rgb(write_file(make_ktx2(147, 8, 8, {32}))); // ETC2 RGB, 8 bytes per block
+        REQUIRE(rgb.get_internal_format() == GL_COMPRESSED_RGB8_ETC2);
+        REQUIRE(!rgb.is_srgb());
+
+        const CompressedImage rgba(write_file(make_ktx2(152, 8, 8, {64}))); // ETC2 RGBA sRGB, 16 bytes per block
+        REQUIRE(rgba.get_internal_format() == GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC);
+        REQUIRE(rgba.is_srgb());
+    }
+
+    SECTION("invalid files are rejected") {
+        REQUIRE_THROWS_AS(CompressedImage("/this/file/does/not/exist.astc"), ResourceError);
+        REQUIRE_THROWS_AS(CompressedImage(write_file({1, 2, 3, 4, 5, 6, 7, 8})), ResourceError);
+
+        // truncated data
+        std::vector<uchar> astc = make_astc(4, 4, 16, 16);
+        astc.pop_back();
+        REQUIRE_THROWS_AS(CompressedImage(write_file(astc)), ResourceError);
+        REQUIRE_THROWS_AS(CompressedImage(write_file(make_ktx2(157, 8, 8, {64, 15}))), ResourceError);
+
+        // unsupported block size, format or supercompression
+        REQUIRE_THROWS_AS(CompressedImage(write_file(make_astc(7, 7, 14, 14))), ResourceError);
+        REQUIRE_THROWS_AS(CompressedImage(write_file(make_ktx2(37, 8, 8, {256}))), ResourceError); // RGBA8
+        REQUIRE_THROWS_AS(CompressedImage(write_file(make_ktx2(157, 8, 8, {64}, 2))), ResourceError);
+    }
+}
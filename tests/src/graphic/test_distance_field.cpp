@@ -0,0 +1,88 @@
+#include "catch.hpp"
+
+#include "notf/graphic/text/distance_field.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Value of the field at the given position, with the origin in the top-left corner.
+int get_value(const std::vector<uchar>& field, const int width, const int x, const int y) {
+    return field[static_cast<size_t>(y * width + x)];
+}
+
+} // namespace
+
+SCENARIO("signed distance field", "[graphic][text][distance_field]") {
+    constexpr int spread = 4;
+
+    SECTION("empty bitmaps produce an empty, padded field") {
+        const std::vector<uchar> bitmap(4 * 2, 0);
+        const std::vector<uchar> field = produce_distance_field(bitmap.data(), 4, 2, 4, spread);
+        REQUIRE(field.size() == (4 + spread * 2) * (2 + spread * 2));
+        for (const uchar value : field) {
+            REQUIRE(value == 0);
+        }
+    }
+
+    SECTION("the outline lies halfway between the pixels inside and outside") {
+        // 8x16 rectangle in a bitmap with a pitch of 10
+        std::vector<uchar> bitmap(10 * 16, 0);
+        for (int y = 0; y < 16; ++y) {
+            for (int x = 0; x < 8; ++x) {
+                bitmap[static_cast<size_t>(y * 10 + x)] = 255;
+            }
+        }
+        const std::vector<uchar> field = produce_distance_field(bitmap.data(), 8, 16, 10, spread);
+        const int width = 8 + spread * 2;
+
+        // pixels on both sides of the outline are half a pixel away from it
+        const int row = spread + 8;
+        REQUIRE(get_value(field, width, spread, row) == 143);
+        REQUIRE(get_value(field, width, spread - 1, row) == 112);
+
+        // the field is symmetric around the outline
+        REQUIRE(get_value(field, width, 0, row) == 16);
+        REQUIRE(get_value(field, width, spread + 3, row) == 239);
+
+        // the field grows from the outside to the inside
+        for (int x = 1; x <= spread + 3; ++x) {
+            REQUIRE(get_value(field, width, x, row) > get_value(field, width, x - 1, row));
+        }
+    }
+
+    SECTION("partially covered pixels place the outline between pixel centers") {
+        const std::vector<uchar> bitmap = {255, 128, 0};
+        const std::vector<uchar> field = produce_distance_field(bitmap.data(), 3, 1, 3, spread);
+        const int width = 3 + spread * 2;
+        REQUIRE(get_value(field, width, spread + 1, spread) == 128);
+        REQUIRE(get_value(field, width, spread, spread) > 128);
+        REQUIRE(get_value(field, width, spread + 2, spread) < 128);
+    }
+
+    SECTION("glyphs converted to distance fields are padded on all sides") {
+        Glyph glyph;
+        glyph.rect = Glyph::Rect(0, 0, 3, 2);
+        glyph.left = 1;
+        glyph.top = 2;
+        glyph.advance_x = 4;
+        glyph.advance_y = 0;
+        std::vector<uchar> bitmap(6, 255);
+        convert_to_distance_field(glyph, bitmap, spread);
+        REQUIRE(glyph.rect.width == 3 + spread * 2);
+        REQUIRE(glyph.rect.height == 2 + spread * 2);
+        REQUIRE(glyph.left == 1 - spread);
+        REQUIRE(glyph.top == 2 + spread);
+        REQUIRE(glyph.advance_x == 4);
+        REQUIRE(bitmap.size() == static_cast<size_t>(glyph.rect.width * glyph.rect.height));
+
+        // glyphs without pixels stay as they are
+        Glyph space = glyph;
+        space.rect = Glyph::Rect(0, 0, 0, 0);
+        std::vector<uchar> empty;
+        convert_to_distance_field(space, empty, spread);
+        REQUIRE(space.rect.width == 0);
+        REQUIRE(space.left == glyph.left);
+        REQUIRE(empty.empty());
+    }
+}
@@ -0,0 +1,88 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include "notf/graphic/graphics_context.hpp"
+#include "notf/graphic/graphics_system.hpp"
+#include "notf/graphic/text/font_manager.hpp"
+#include "notf/graphic/texture.hpp"
+
+#include "test/app.hpp"
+
+NOTF_OPEN_NAMESPACE
+
+// accessors ======================================================================================================== //
+
+/// FontManager
+template<>
+struct Accessor<FontManager, Tester> {
+    static FontAtlas& get_atlas(FontManager& manager) { return manager.m_atlas; }
+    static void repack_atlas(FontManager& manager, const FontPtr& font) { manager._repack_atlas({font}); }
+};
+
+/// Font
+template<>
+struct Accessor<Font, Tester> {
+    static void set_rect(const Font& font, const codepoint_t codepoint, const Glyph::Rect& rect) {
+        Font::_AtlasGlyph* atlas_glyph = font.m_glyphs.find(codepoint);
+        REQUIRE(atlas_glyph);
+        atlas_glyph->glyph.rect = rect;
+    }
+};
+
+NOTF_CLOSE_NAMESPACE
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Starts new frames until all Glyphs rasterized in the background are integrated into the Atlas.
+void integrate_pending_glyphs(FontManager& manager) {
+    while (manager.has_pending_glyphs()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        manager.start_frame();
+    }
+}
+
+} // namespace
+
+SCENARIO("font manager", "[graphic][text]") {
+    TheApplication app(test_app_arguments());
+    NOTF_GUARD(TheGraphicsSystem()->get_internal_context().make_current());
+    FontManager& manager = TheGraphicsSystem()->get_font_manager();
+    using ManagerAccess = FontManager::AccessFor<Tester>;
+
+    const FontPtr font = Font::load(manager, "res/fonts/Roboto-Regular.ttf", 12);
+    REQUIRE(font->is_valid());
+
+    SECTION("glyphs that no longer fit into the repacked atlas are rasterized again when requested") {
+        // grow the atlas to its maximum size
+        FontAtlas& atlas = ManagerAccess::get_atlas(manager);
+        const auto get_full_rect = [&] {
+            const Size2i size = atlas.get_texture()->get_size();
+            return Glyph::Rect(0, 0, static_cast<Glyph::coord_t>(size.get_width()),
+                               static_cast<Glyph::coord_t>(size.get_height()));
+        };
+        while (!atlas.is_at_max_size()) {
+            const Glyph::Rect full_rect = get_full_rect();
+            atlas.insert_rect(full_rect.width, full_rect.height);
+        }
+
+        // overfill the atlas with two glyphs that each claim all of it, only the first one fits after the repack
+        const Glyph::Rect full_rect = get_full_rect();
+        Font::AccessFor<Tester>::set_rect(*font, 'A', full_rect);
+        Font::AccessFor<Tester>::set_rect(*font, 'B', full_rect);
+        ManagerAccess::repack_atlas(manager, font);
+        REQUIRE(font->get_glyph('A').rect.width == full_rect.width);
+        REQUIRE(atlas.get_free_area() == 0);
+
+        // the evicted glyph is no empty placeholder forever, but rasterized and placed into the atlas once more
+        manager.start_frame();
+        REQUIRE(font->get_glyph('B').rect.width == 0);
+        REQUIRE(font->is_pending('B'));
+        integrate_pending_glyphs(manager);
+        REQUIRE(!font->is_pending('B'));
+        REQUIRE(font->get_glyph('B').rect.width != 0);
+    }
+}
@@ -0,0 +1,126 @@
+#include "catch.hpp"
+
+#include "notf/common/geo/path2.hpp"
+#include "notf/common/thread.hpp"
+
+#include "notf/graphic/plotter/design.hpp"
+#include "notf/graphic/plotter/frame_builder.hpp"
+#include "notf/graphic/plotter/painter.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+using FrameBuilder = Plotter::FrameBuilder;
+using Indices = std::vector<FrameBuilder::Index>;
+
+/// Position of a Vertex.
+const V2f& get_pos(const FrameBuilder::Vertex& vertex) { return std::get<0>(vertex); }
+
+} // namespace
+
+SCENARIO("plotter frame builder", "[graphic][plotter]") {
+    std::vector<FrameBuilder::Vertex> vertices;
+    Indices indices;
+
+    SECTION("indices of all subpaths are relative to the first vertex of their path") {
+        Polylinef square(V2f(0, 0), V2f(10, 0), V2f(10, 10), V2f(0, 10));
+        square.set_closed();
+        Polylinef line(V2f(20, 0), V2f(30, 0), V2f(30, 10));
+        std::vector<CubicPolyBezier2f> subpaths = {std::move(square), std::move(line)};
+        const Path2Ptr path = Path2::create(std::move(subpaths));
+
+        // the path is stored behind another one
+        FrameBuilder::tessellate_path(*Path2::rect(Aabrf(Size2f(5, 5))), vertices, indices);
+        const auto result = FrameBuilder::tessellate_path(*path, vertices, indices);
+        REQUIRE(result.vertex_offset == 4);
+        REQUIRE(result.index_offset == 16);
+        REQUIRE(result.size == 26);
+        REQUIRE(vertices.size() == 4 + 4 + 3);
+
+        // two indices for the start cap / joint and two for the segment, per segment, plus the end cap of open subpaths
+        const Indices path_indices(indices.begin() + result.index_offset, indices.end());
+        REQUIRE(path_indices
+                == Indices{0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 0, // closed square
+                           4, 4, 4, 5, 5, 5, 5, 6, 6, 6});                 // open line, starts behind the square
+        REQUIRE(get_pos(vertices[result.vertex_offset + path_indices[0]]).is_approx(V2f(0, 0)));
+        REQUIRE(get_pos(vertices[result.vertex_offset + path_indices[16]]).is_approx(V2f(20, 0)));
+        REQUIRE(get_pos(vertices[result.vertex_offset + path_indices.back()]).is_approx(V2f(30, 10)));
+    }
+
+    SECTION("draw calls of different designs with the same paint and clip share a batch") {
+        const Path2Ptr icon = Path2::rect(Aabrf(Size2f(16, 16)));
+        PlotterDesign first, second;
+        Thread render_thread(Thread::Kind::RENDER);
+        render_thread.run([&] {
+            for (PlotterDesign* design : {&first, &second}) {
+                Painter painter(*design);
+                painter.set_paint(Color::red());
+                painter.set_path(icon);
+                painter.fill();
+            }
+        });
+        render_thread.join();
+
+        std::vector<FrameBuilder::PaintBlock> paints;
+        std::vector<FrameBuilder::Instance> instances;
+        std::vector<FrameBuilder::Command> commands;
+        FrameBuilder builder(vertices, indices, paints, instances, commands);
+        const Aabrf area(Size2f(200, 200));
+
+        // both designs are clipped to the same area, like the rows of a list
+        builder.start_frame();
+        builder.parse(first, M3f::translation(V2f(10, 10)), area);
+        builder.parse(second, M3f::translation(V2f(10, 50)), area);
+        builder.finish_frame(area);
+        REQUIRE(builder.get_batches().size() == 1);
+        REQUIRE(builder.get_batches().front().draw_count == 2);
+        REQUIRE(paints.size() == 1);
+
+        // different clips cannot be batched
+        builder.start_frame();
+        builder.parse(first, M3f::translation(V2f(10, 10)), area);
+        builder.parse(second, M3f::translation(V2f(10, 50)), Aabrf(Size2f(100, 100)));
+        builder.finish_frame(area);
+        REQUIRE(builder.get_batches().size() == 2);
+    }
+
+    SECTION("draw calls outside the visible area are culled without shifting the calls behind them") {
+        const Path2Ptr rect = Path2::rect(Aabrf(Size2f(16, 16)));
+        std::vector<PlotterDesign> designs(3);
+        Thread render_thread(Thread::Kind::RENDER);
+        render_thread.run([&] {
+            for (size_t i = 0; i < designs.size(); ++i) {
+                Painter painter(designs[i]);
+                painter.set_paint(Color::red());
+                painter.set_path(rect);
+                painter.set_stroke_width(static_cast<float>(i + 1));
+                painter.stroke();
+            }
+        });
+        render_thread.join();
+
+        std::vector<FrameBuilder::PaintBlock> paints;
+        std::vector<FrameBuilder::Instance> instances;
+        std::vector<FrameBuilder::Command> commands;
+        FrameBuilder builder(vertices, indices, paints, instances, commands);
+        const Aabrf area(Size2f(200, 200));
+
+        // the second design is outside the visible area
+        builder.start_frame();
+        builder.parse(designs[0], M3f::translation(V2f(10, 10)));
+        builder.parse(designs[1], M3f::translation(V2f(500, 500)));
+        builder.parse(designs[2], M3f::translation(V2f(10, 50)));
+        builder.finish_frame(area, area);
+        REQUIRE(builder.get_statistics().calls_stored == 3);
+        REQUIRE(builder.get_statistics().calls_culled == 1);
+        REQUIRE(builder.get_drawcalls().size() == 2);
+        REQUIRE(builder.get_batches().size() == 1);
+        REQUIRE(builder.get_batches().front().draw_count == 2);
+
+        // the call rendered after the culled one is the one of the third design
+        REQUIRE(instances.size() == 2);
+        REQUIRE(std::get<1>(instances[0]).x() == 1);
+        REQUIRE(std::get<1>(instances[1]).x() == 3);
+    }
+}
@@ -0,0 +1,92 @@
+#include "catch.hpp"
+
+#include <map>
+
+#include "notf/common/random.hpp"
+
+#include "notf/graphic/text/glyph_table.hpp"
+
+NOTF_USING_NAMESPACE;
+
+SCENARIO("glyph table", "[graphic][text][glyph_table]") {
+
+    SECTION("empty tables contain no codepoints") {
+        GlyphTable<int> table;
+        REQUIRE(table.is_empty());
+        REQUIRE(table.get_size() == 0);
+        REQUIRE(table.find(0) == nullptr);
+        REQUIRE(table.find('a') == nullptr);
+        REQUIRE(table.find(0x4E2D) == nullptr);
+        REQUIRE(!table.erase('a'));
+    }
+
+    SECTION("codepoints inside and outside of the latin page can be stored and found") {
+        GlyphTable<int> table;
+        table.emplace('a', 1);
+        table.emplace(0xFF, 2);     // last codepoint of the Latin-1 Supplement block
+        table.emplace(0x100, 3);    // first codepoint of the Latin Extended-A block
+        table.emplace(0x4E2D, 4);   // CJK
+        table.emplace(0x1F600, 5);  // outside of the Basic Multilingual Plane
+        REQUIRE(table.get_size() == 5);
+
+        REQUIRE(*table.find('a') == 1);
+        REQUIRE(*table.find(0xFF) == 2);
+        REQUIRE(*table.find(0x100) == 3);
+        REQUIRE(*table.find(0x4E2D) == 4);
+        REQUIRE(*table.find(0x1F600) == 5);
+
+        // neighbours of stored codepoints in the same page are not found
+        REQUIRE(table.find('b') == nullptr);
+        REQUIRE(table.find(0x101) == nullptr);
+        REQUIRE(table.find(0x4E2E) == nullptr);
+    }
+
+    SECTION("emplacing a known codepoint replaces its value") {
+        GlyphTable<int> table;
+        table.emplace(0x4E2D, 1);
+        int& value = table.emplace(0x4E2D, 2);
+        REQUIRE(value == 2);
+        REQUIRE(*table.find(0x4E2D) == 2);
+        REQUIRE(table.get_size() == 1);
+    }
+
+    SECTION("erased codepoints are no longer found") {
+        GlyphTable<int> table;
+        table.emplace('a', 1);
+        table.emplace(0x4E2D, 2);
+        REQUIRE(table.erase(0x4E2D));
+        REQUIRE(table.find(0x4E2D) == nullptr);
+        REQUIRE(!table.erase(0x4E2D));
+        REQUIRE(table.get_size() == 1);
+
+        table.clear();
+        REQUIRE(table.is_empty());
+        REQUIRE(table.find('a') == nullptr);
+    }
+
+    SECTION("lookups alternating between pages find the right values") {
+        GlyphTable<codepoint_t> table;
+        std::map<codepoint_t, codepoint_t> reference;
+        for (size_t i = 0; i < 1000; ++i) {
+            const codepoint_t codepoint = random<codepoint_t>(0, 0x3000);
+            table.emplace(codepoint, codepoint * 2);
+            reference[codepoint] = codepoint * 2;
+        }
+        REQUIRE(table.get_size() == reference.size());
+        for (codepoint_t codepoint = 0; codepoint <= 0x3000; ++codepoint) {
+            const codepoint_t* value = table.find(codepoint);
+            auto itr = reference.find(codepoint);
+            if (itr == reference.end()) {
+                REQUIRE(value == nullptr);
+            } else {
+                REQUIRE(value != nullptr);
+                REQUIRE(*value == itr->second);
+            }
+        }
+
+        // for_each visits every codepoint exactly once
+        std::map<codepoint_t, codepoint_t> visited;
+        table.for_each([&](const codepoint_t codepoint, codepoint_t& value) { visited[codepoint] = value; });
+        REQUIRE(visited == reference);
+    }
+}
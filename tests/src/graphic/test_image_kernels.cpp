@@ -0,0 +1,143 @@
+#include "catch.hpp"
+
+#include <random>
+
+#include "notf/graphic/image_kernels.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Random pixels with a fixed seed.
+std::vector<uchar> make_pixels(const size_t byte_count) {
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    std::vector<uchar> result(byte_count);
+    for (uchar& value : result) {
+        value = static_cast<uchar>(distribution(random));
+    }
+    return result;
+}
+
+/// All kernel sets supported by the CPU.
+std::vector<ImageKernelSet> get_supported_sets() {
+    std::vector<ImageKernelSet> result;
+    for (int set = 0; set <= to_number(get_best_image_kernel_set()); ++set) {
+        result.push_back(static_cast<ImageKernelSet>(set));
+    }
+    return result;
+}
+
+} // namespace
+
+SCENARIO("image kernels", "[graphic][image_kernels]") {
+    const ImageKernelSet original_set = get_image_kernel_set();
+    REQUIRE(original_set == get_best_image_kernel_set());
+
+    SECTION("premultiplying rounds to the closest value") {
+        std::vector<uchar> pixels = {255, 128, 0, 128, 10, 20, 30, 255, 10, 20, 30, 0};
+        premultiply_alpha(pixels.data(), 3);
+        REQUIRE(pixels == std::vector<uchar>{128, 64, 0, 128, 10, 20, 30, 255, 0, 0, 0, 0});
+    }
+
+    SECTION("unpremultiplying restores the colors, transparent pixels become black") {
+        std::vector<uchar> pixels = {128, 64, 0, 128, 10, 20, 30, 255, 10, 20, 30, 0};
+        unpremultiply_alpha(pixels.data(), 3);
+        REQUIRE(pixels == std::vector<uchar>{255, 128, 0, 128, 10, 20, 30, 255, 0, 0, 0, 0});
+    }
+
+    SECTION("channels can be swizzled") {
+        std::vector<uchar> pixels = {1, 2, 3, 4, 5, 6, 7, 8};
+        swizzle_channels(pixels.data(), 2, {2, 1, 0, 3});
+        REQUIRE(pixels == std::vector<uchar>{3, 2, 1, 4, 7, 6, 5, 8});
+        REQUIRE_THROWS_AS(swizzle_channels(pixels.data(), 2, {0, 1, 2, 4}), ValueError);
+    }
+
+    SECTION("sRGB conversion leaves the alpha channel untouched") {
+        std::vector<uchar> pixels = {0, 188, 255, 188};
+        decode_srgb(pixels.data(), 1, 4);
+        REQUIRE(pixels == std::vector<uchar>{0, 128, 255, 188});
+        encode_srgb(pixels.data(), 1, 4);
+        REQUIRE(pixels == std::vector<uchar>{0, 188, 255, 188});
+
+        std::vector<uchar> gray = {188, 188, 188};
+        decode_srgb(gray.data(), 3, 1);
+        REQUIRE(gray == std::vector<uchar>{128, 128, 128});
+    }
+
+    SECTION("box downsampling averages blocks of 2x2 pixels") {
+        const std::vector<uchar> pixels = {0, 4, 8, //
+                                           2, 6, 9, //
+                                           100, 100, 100};
+        REQUIRE(downsample_box(pixels.data(), Size2i(3, 3), 1) == std::vector<uchar>{3});
+        REQUIRE(downsample_box(pixels.data(), Size2i(1, 9), 1) == std::vector<uchar>{2, 5, 8, 100});
+
+        // sRGB colors are averaged in linear space, alpha is not
+        const std::vector<uchar> srgb = {0, 0, 255, 255, 0, 0, 255, 255};
+        REQUIRE(downsample_box(srgb.data(), Size2i(2, 2), 2, /* is_srgb = */ true) == std::vector<uchar>{188, 128});
+    }
+
+    SECTION("lanczos resizing keeps flat images flat and scales to any size") {
+        const std::vector<uchar> flat(13 * 7 * 3, 77);
+        const std::vector<uchar> smaller = downsample_lanczos(flat.data(), Size2i(13, 7), 3, Size2i(5, 4));
+        REQUIRE(smaller == std::vector<uchar>(5 * 4 * 3, 77));
+
+        const std::vector<uchar> pixels = make_pixels(9 * 6);
+        REQUIRE(downsample_lanczos(pixels.data(), Size2i(9, 6), 1, Size2i(9, 6)) == pixels);
+        REQUIRE(downsample_lanczos(pixels.data(), Size2i(9, 6), 1, Size2i(20, 3)).size() == 20 * 3);
+        REQUIRE_THROWS_AS(downsample_lanczos(pixels.data(), Size2i(9, 6), 1, Size2i(0, 3)), ValueError);
+    }
+
+    SECTION("mip chains go down to a single pixel") {
+        REQUIRE(get_mip_size(Size2i(100, 6), 0) == Size2i(100, 6));
+        REQUIRE(get_mip_size(Size2i(100, 6), 3) == Size2i(12, 1));
+
+        const std::vector<uchar> pixels = make_pixels(10 * 3 * 4);
+        const std::vector<std::vector<uchar>> chain = produce_mip_chain(pixels.data(), Size2i(10, 3), 4);
+        REQUIRE(chain.size() == 3);
+        REQUIRE(chain[0] == downsample_box(pixels.data(), Size2i(10, 3), 4));
+        REQUIRE(chain[1].size() == 2 * 1 * 4);
+        REQUIRE(chain[2].size() == 1 * 1 * 4);
+    }
+
+    SECTION("all kernel sets produce the same results") {
+        const Size2i size(37, 23); // not a multiple of any vector width
+        const size_t pixel_count = static_cast<size_t>(size.get_area());
+        const std::vector<uchar> pixels = make_pixels(pixel_count * 4);
+
+        set_image_kernel_set(ImageKernelSet::SCALAR);
+        std::vector<uchar> premultiplied = pixels;
+        premultiply_alpha(premultiplied.data(), pixel_count);
+        std::vector<uchar> unpremultiplied = pixels; // includes colors brighter than their alpha
+        unpremultiply_alpha(unpremultiplied.data(), pixel_count);
+        std::vector<uchar> swizzled = pixels;
+        swizzle_channels(swizzled.data(), pixel_count, {3, 2, 0, 0});
+        const std::vector<uchar> box = downsample_box(pixels.data(), size, 4);
+        const std::vector<uchar> lanczos = downsample_lanczos(pixels.data(), size, 4, Size2i(15, 10));
+
+        for (const ImageKernelSet set : get_supported_sets()) {
+            set_image_kernel_set(set);
+            std::vector<uchar> result = pixels;
+            premultiply_alpha(result.data(), pixel_count);
+            REQUIRE(result == premultiplied);
+
+            result = pixels;
+            unpremultiply_alpha(result.data(), pixel_count);
+            REQUIRE(result == unpremultiplied);
+
+            result = pixels;
+            swizzle_channels(result.data(), pixel_count, {3, 2, 0, 0});
+            REQUIRE(result == swizzled);
+
+            REQUIRE(downsample_box(pixels.data(), size, 4) == box);
+
+            result = downsample_lanczos(pixels.data(), size, 4, Size2i(15, 10));
+            REQUIRE(result.size() == lanczos.size());
+            for (size_t i = 0; i < result.size(); ++i) {
+                REQUIRE(std::abs(result[i] - lanczos[i]) <= 1);
+            }
+        }
+    }
+
+    set_image_kernel_set(original_set);
+}
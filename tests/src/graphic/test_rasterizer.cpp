@@ -0,0 +1,277 @@
+#include "catch.hpp"
+
+#include "notf/common/thread.hpp"
+
+#include "notf/graphic/plotter/design.hpp"
+#include "notf/graphic/plotter/painter.hpp"
+#include "notf/graphic/plotter/rasterizer.hpp"
+#include "notf/graphic/text/distance_field.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+using Pixel = std::array<uchar, 4>;
+
+/// Pixel of the image at the given position, with the origin in the bottom-left corner.
+Pixel get_pixel(const PlotterRasterizer& rasterizer, const int x, const int y) {
+    const Size2i& size = rasterizer.get_size();
+    const uchar* pixel = rasterizer.get_data() + ((size.get_height() - 1 - y) * size.get_width() + x) * 4;
+    return {pixel[0], pixel[1], pixel[2], pixel[3]};
+}
+
+/// Sum of the alpha of all pixels in the image, in pixels.
+float get_covered_area(const PlotterRasterizer& rasterizer) {
+    float result = 0;
+    const uchar* data = rasterizer.get_data();
+    for (int i = 0; i < rasterizer.get_size().get_area(); ++i) {
+        result += static_cast<float>(data[i * 4 + 3]) / 255.f;
+    }
+    return result;
+}
+
+/// State that fills or strokes the given Path in opaque white.
+Plotter::PainterState make_state(Path2Ptr path) {
+    Plotter::PainterState state;
+    state.path = std::move(path);
+    state.paint = Color::white();
+    return state;
+}
+
+/// Closed path from a Polyline.
+CubicPolyBezier2f make_polygon(Polylinef polyline) {
+    polyline.set_closed();
+    return CubicPolyBezier2f(std::move(polyline));
+}
+
+} // namespace
+
+SCENARIO("plotter rasterizer", "[graphic][plotter][rasterizer]") {
+    PlotterRasterizer rasterizer(Size2i(40, 40));
+
+    SECTION("images are cleared with a premultiplied color") {
+        REQUIRE(get_pixel(rasterizer, 0, 0) == Pixel{0, 0, 0, 0});
+        rasterizer.clear(Color(1.f, 0.f, 0.f, 0.5f));
+        REQUIRE(get_pixel(rasterizer, 0, 0) == Pixel{128, 0, 0, 128});
+        REQUIRE(get_pixel(rasterizer, 39, 39) == Pixel{128, 0, 0, 128});
+    }
+
+    SECTION("rects on the pixel grid cover whole pixels") {
+        rasterizer.fill(make_state(Path2::rect(Aabrf(10, 10, 10, 20))));
+        REQUIRE(get_pixel(rasterizer, 10, 10) == Pixel{255, 255, 255, 255});
+        REQUIRE(get_pixel(rasterizer, 19, 29) == Pixel{255, 255, 255, 255});
+        REQUIRE(get_pixel(rasterizer, 9, 10) == Pixel{0, 0, 0, 0});
+        REQUIRE(get_pixel(rasterizer, 20, 29) == Pixel{0, 0, 0, 0});
+        REQUIRE(get_pixel(rasterizer, 10, 30) == Pixel{0, 0, 0, 0});
+        REQUIRE(get_covered_area(rasterizer) == Approx(200));
+    }
+
+    SECTION("edges between pixels are anti-aliased") {
+        rasterizer.fill(make_state(Path2::rect(Aabrf(10.5f, 10, 10, 10))));
+        REQUIRE(get_pixel(rasterizer, 10, 15)[3] == 128);
+        REQUIRE(get_pixel(rasterizer, 15, 15)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 20, 15)[3] == 128);
+        REQUIRE(get_covered_area(rasterizer) == Approx(100).margin(0.1));
+    }
+
+    SECTION("curves cover their area") {
+        const float radius = 15;
+        rasterizer.fill(make_state(Path2::circle(V2f(20, 20), radius)));
+        REQUIRE(get_pixel(rasterizer, 20, 20)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 1, 1)[3] == 0);
+        // the flattened circle lies within the tolerance of the true circle
+        const float area = pi<float>() * radius * radius;
+        REQUIRE(get_covered_area(rasterizer) <= area);
+        REQUIRE(get_covered_area(rasterizer) >= area - 2 * pi<float>() * radius * PathTessellator::default_tolerance);
+    }
+
+    SECTION("subpaths are filled using the non-zero rule") {
+        const CubicPolyBezier2f outer = make_polygon(Polylinef(V2f(0, 0), V2f(30, 0), V2f(30, 30), V2f(0, 30)));
+        const CubicPolyBezier2f inner = make_polygon(Polylinef(V2f(10, 10), V2f(10, 20), V2f(20, 20), V2f(20, 10)));
+        rasterizer.fill(make_state(Path2::create(std::vector<CubicPolyBezier2f>{outer, inner})));
+        REQUIRE(get_pixel(rasterizer, 5, 5)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 15, 15)[3] == 0);
+        REQUIRE(get_covered_area(rasterizer) == Approx(800));
+
+        // subpaths with the same orientation do not cancel each other out
+        rasterizer.clear();
+        const CubicPolyBezier2f same = make_polygon(Polylinef(V2f(10, 10), V2f(20, 10), V2f(20, 20), V2f(10, 20)));
+        rasterizer.fill(make_state(Path2::create(std::vector<CubicPolyBezier2f>{outer, same})));
+        REQUIRE(get_pixel(rasterizer, 15, 15)[3] == 255);
+        REQUIRE(get_covered_area(rasterizer) == Approx(900));
+    }
+
+    SECTION("strokes cover the area around their path") {
+        Plotter::PainterState state = make_state(Path2::create(CubicPolyBezier2f(Polylinef(V2f(5, 20), V2f(35, 20)))));
+        state.stroke_width = 4;
+        rasterizer.stroke(state);
+        REQUIRE(get_pixel(rasterizer, 20, 18)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 20, 21)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 20, 22)[3] == 0);
+        REQUIRE(get_pixel(rasterizer, 4, 20)[3] == 0);
+        REQUIRE(get_covered_area(rasterizer) == Approx(120));
+
+        // overlapping joints do not cover pixels more than once
+        rasterizer.clear();
+        state.path = Path2::rect(Aabrf(10, 10, 20, 20));
+        state.joint_style = Plotter::JointStyle::ROUND;
+        rasterizer.stroke(state);
+        REQUIRE(get_pixel(rasterizer, 10, 10)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 20, 20)[3] == 0);
+        REQUIRE(get_covered_area(rasterizer) == Approx(24 * 24 - 16 * 16 - (16 - 4 * pi<float>())).epsilon(0.01));
+    }
+
+    SECTION("gradients are interpolated per pixel") {
+        Plotter::PainterState state = make_state(Path2::rect(Aabrf(0, 0, 40, 40)));
+        state.paint = Plotter::Paint::linear_gradient(V2f(0, 0), V2f(40, 0), Color::black(), Color::white());
+        rasterizer.fill(state);
+        REQUIRE(get_pixel(rasterizer, 0, 20)[0] <= 8);
+        REQUIRE(get_pixel(rasterizer, 39, 20)[0] >= 247);
+        for (int x = 1; x < 40; ++x) {
+            REQUIRE(get_pixel(rasterizer, x, 20)[0] > get_pixel(rasterizer, x - 1, 20)[0]);
+            REQUIRE(get_pixel(rasterizer, x, 20)[3] == 255);
+        }
+
+        // the inner color is in the center of a radial gradient and the outer color outside its outer radius
+        state.paint = Plotter::Paint::radial_gradient(V2f(20, 20), 5, 10, Color::red(), Color::blue());
+        rasterizer.fill(state);
+        REQUIRE(get_pixel(rasterizer, 20, 20) == Pixel{255, 0, 0, 255});
+        REQUIRE(get_pixel(rasterizer, 20, 35) == Pixel{0, 0, 255, 255});
+
+        // box gradients have the inner color inside the box
+        state.paint = Plotter::Paint::box_gradient(V2f(10, 10), Size2f(20, 20), 2, 4, Color::green(), Color::black());
+        rasterizer.fill(state);
+        REQUIRE(get_pixel(rasterizer, 20, 20) == Pixel{0, 255, 0, 255});
+        REQUIRE(get_pixel(rasterizer, 2, 2) == Pixel{0, 0, 0, 255});
+    }
+
+    SECTION("the clip limits the pixels that are drawn") {
+        Plotter::PainterState state = make_state(Path2::rect(Aabrf(0, 0, 40, 40)));
+        state.clip = Aabrf(10, 10, 5, 10);
+        rasterizer.fill(state);
+        REQUIRE(get_pixel(rasterizer, 10, 10)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 15, 10)[3] == 0);
+        REQUIRE(get_covered_area(rasterizer) == Approx(50));
+    }
+
+    SECTION("colors are blended with the blend mode of the state") {
+        rasterizer.clear(Color::white());
+        Plotter::PainterState state = make_state(Path2::rect(Aabrf(0, 0, 40, 40)));
+        state.paint = Color::blue();
+        state.alpha = 0.5f;
+        state.blend_mode = BlendMode::SOURCE_OVER;
+        rasterizer.fill(state);
+        REQUIRE(get_pixel(rasterizer, 20, 20) == Pixel{128, 128, 255, 255});
+
+        state.blend_mode = BlendMode::COPY;
+        rasterizer.fill(state);
+        REQUIRE(get_pixel(rasterizer, 20, 20) == Pixel{0, 0, 128, 128});
+
+        state.alpha = 1;
+        state.blend_mode = BlendMode::DESTINATION_OUT;
+        rasterizer.fill(state);
+        REQUIRE(get_pixel(rasterizer, 20, 20) == Pixel{0, 0, 0, 0});
+    }
+
+    SECTION("glyphs are copied from the font atlas") {
+        // 2x3 glyph in the bottom-left corner of the atlas, its first row is at the bottom of the atlas
+        std::vector<uchar> atlas(4 * 4, 0);
+        atlas[0] = 255;
+        atlas[4 + 1] = 255;
+        atlas[8 + 0] = 255;
+        atlas[8 + 1] = 255;
+        rasterizer.set_font_atlas(std::move(atlas), Size2i(4, 4));
+
+        Glyph glyph;
+        glyph.rect = Glyph::Rect(0, 0, 2, 3);
+        glyph.left = 1;
+        glyph.top = 3;
+        glyph.advance_x = 3;
+        glyph.advance_y = 0;
+
+        Plotter::PainterState state;
+        state.paint = Color::white();
+        state.xform = M3f::translation(V2f(10, 10));
+        rasterizer.write({glyph, glyph}, state);
+        REQUIRE(get_pixel(rasterizer, 11, 12)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 12, 12)[3] == 0);
+        REQUIRE(get_pixel(rasterizer, 11, 11)[3] == 0);
+        REQUIRE(get_pixel(rasterizer, 12, 11)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 11, 10)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 12, 10)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 14, 12)[3] == 255);
+        REQUIRE(get_covered_area(rasterizer) == Approx(8));
+
+        REQUIRE_THROWS_AS(rasterizer.set_font_atlas(std::vector<uchar>(3), Size2i(2, 2)), ValueError);
+    }
+
+    SECTION("distance field glyphs follow the full transformation") {
+        // distance field of an 8x8 square, stored in the bottom-left corner of the atlas
+        const int spread = Font::distance_field_spread;
+        Glyph glyph;
+        glyph.rect = Glyph::Rect(0, 0, 8, 8);
+        glyph.left = 0;
+        glyph.top = 8;
+        glyph.advance_x = 10;
+        glyph.advance_y = 0;
+        std::vector<uchar> field(8 * 8, 255);
+        convert_to_distance_field(glyph, field, spread);
+
+        const int atlas_size = 8 + spread * 2;
+        rasterizer.set_font_atlas(std::move(field), Size2i(atlas_size, atlas_size));
+
+        Plotter::PainterState state;
+        state.paint = Color::white();
+        state.xform = M3f::translation(V2f(4, 4));
+        rasterizer.write({glyph}, state, /* is_distance_field = */ true);
+        REQUIRE(get_pixel(rasterizer, 8, 8)[3] == 255);
+        REQUIRE(get_pixel(rasterizer, 12, 12)[3] == 0);
+        REQUIRE(get_covered_area(rasterizer) == Approx(64).epsilon(0.02));
+
+        // scaled glyphs are not rasterized again, but still cover the scaled area
+        rasterizer.clear();
+        state.xform = M3f::translation(V2f(4, 4)) * M3f::scale(3);
+        rasterizer.write({glyph}, state, /* is_distance_field = */ true);
+        REQUIRE(get_pixel(rasterizer, 20, 20)[3] == 255);
+        REQUIRE(get_covered_area(rasterizer) == Approx(24 * 24).epsilon(0.02));
+
+        // rotated glyphs as well
+        rasterizer.clear();
+        state.xform = M3f::translation(V2f(20, 8)) * M3f::rotation(pi<float>() / 4) * M3f::scale(2);
+        rasterizer.write({glyph}, state, /* is_distance_field = */ true);
+        REQUIRE(get_covered_area(rasterizer) == Approx(16 * 16).epsilon(0.02));
+    }
+
+    SECTION("designs are drawn like the individual commands") {
+        PlotterDesign design;
+        Thread render_thread(Thread::Kind::RENDER);
+        render_thread.run([&] {
+            Painter painter(design);
+            painter.set_transform(M3f::translation(V2f(5, 5)));
+            painter.set_paint(Color::red());
+            painter.set_path(Path2::circle(V2f(10, 10), 8));
+            painter.fill();
+            painter.set_paint(Color::green());
+            painter.set_stroke_width(3);
+            painter.stroke();
+        });
+        render_thread.join();
+        rasterizer.draw(design, M3f::translation(V2f(2, 3)));
+
+        PlotterRasterizer expected(rasterizer.get_size());
+        Plotter::PainterState state;
+        state.xform = M3f::translation(V2f(7, 8));
+        state.path = Path2::circle(V2f(10, 10), 8);
+        state.paint = Color::red();
+        expected.fill(state);
+        state.paint = Color::green();
+        state.stroke_width = 3;
+        expected.stroke(state);
+
+        const size_t byte_count = static_cast<size_t>(rasterizer.get_size().get_area() * 4);
+        REQUIRE(std::equal(rasterizer.get_data(), rasterizer.get_data() + byte_count, expected.get_data()));
+        REQUIRE(get_pixel(rasterizer, 17, 18) == Pixel{255, 0, 0, 255});
+    }
+
+    SECTION("images must not be empty") { REQUIRE_THROWS_AS(PlotterRasterizer(Size2i(0, 10)), ValueError); }
+}
@@ -0,0 +1,234 @@
+#include "catch.hpp"
+
+#include "notf/common/geo/path2.hpp"
+#include "notf/common/thread_pool.hpp"
+
+#include "notf/graphic/plotter/tessellator.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+using Mesh = PathTessellator::Mesh;
+
+/// Path from a Polyline.
+Path2Ptr make_path(Polylinef polyline) { return Path2::create(CubicPolyBezier2f(std::move(polyline))); }
+
+/// Twice the signed area of a triangle in the Mesh.
+float get_twice_signed_area(const Mesh& mesh, const size_t triangle) {
+    const V2f& a = mesh.vertices[mesh.indices[triangle * 3 + 0]];
+    const V2f& b = mesh.vertices[mesh.indices[triangle * 3 + 1]];
+    const V2f& c = mesh.vertices[mesh.indices[triangle * 3 + 2]];
+    return (b - a).cross(c - a);
+}
+
+/// Sum of the areas of all triangles in the Mesh.
+float get_area(const Mesh& mesh) {
+    float result = 0;
+    for (size_t i = 0; i < mesh.get_triangle_count(); ++i) {
+        result += get_twice_signed_area(mesh, i) / 2;
+    }
+    return result;
+}
+
+/// Whether all triangles in the Mesh are counterclockwise.
+bool is_ccw(const Mesh& mesh) {
+    for (size_t i = 0; i < mesh.get_triangle_count(); ++i) {
+        if (get_twice_signed_area(mesh, i) < 0) { return false; }
+    }
+    return true;
+}
+
+/// Winding number of a point in the Mesh, counterclockwise triangles count +1 and clockwise triangles -1.
+int get_winding(const Mesh& mesh, const V2f& point) {
+    int result = 0;
+    for (size_t i = 0; i < mesh.get_triangle_count(); ++i) {
+        const V2f& a = mesh.vertices[mesh.indices[i * 3 + 0]];
+        const V2f& b = mesh.vertices[mesh.indices[i * 3 + 1]];
+        const V2f& c = mesh.vertices[mesh.indices[i * 3 + 2]];
+        const float ab = (b - a).cross(point - a);
+        const float bc = (c - b).cross(point - b);
+        const float ca = (a - c).cross(point - c);
+        if (ab > 0 && bc > 0 && ca > 0) { ++result; }
+        if (ab < 0 && bc < 0 && ca < 0) { --result; }
+    }
+    return result;
+}
+
+/// Whether the Mesh has a vertex at the given position.
+bool has_vertex(const Mesh& mesh, const V2f& position) {
+    for (const V2f& vertex : mesh.vertices) {
+        if (vertex.is_approx(position, 0.001f)) { return true; }
+    }
+    return false;
+}
+
+} // namespace
+
+SCENARIO("path tessellator", "[graphic][plotter][tessellator]") {
+
+    SECTION("straight segments are not subdivided") {
+        const CubicBezier2f line(V2f(0, 0), V2f(1, 1), V2f(2, 2), V2f(3, 3));
+        REQUIRE(PathTessellator::get_subdivision_count(line, 0.25f) == 1);
+
+        std::vector<V2f> points;
+        PathTessellator::flatten(line, 0.25f, points);
+        REQUIRE(points.size() == 1);
+        REQUIRE(points.front() == V2f(3, 3));
+    }
+
+    SECTION("flattened curves stay within the tolerance") {
+        const float radius = 100;
+        const Path2Ptr circle = Path2::circle(V2f(0, 0), radius);
+        for (const float tolerance : {1.f, 0.25f, 0.01f}) {
+            PathTessellator::Contours contours;
+            PathTessellator(tolerance).flatten(*circle, contours);
+            REQUIRE(contours.contours.size() == 1);
+            REQUIRE(contours.contours.front().is_closed);
+
+            // four bezier segments deviate from a true circle by less than 0.03% of the radius
+            for (size_t i = 0; i < contours.points.size(); ++i) {
+                const V2f& point = contours.points[i];
+                const V2f& next = contours.points[(i + 1) % contours.points.size()];
+                REQUIRE(abs(point.get_magnitude() - radius) <= radius * 0.0003f);
+                REQUIRE(radius - ((point + next) / 2).get_magnitude() <= tolerance + radius * 0.0003f);
+            }
+        }
+    }
+
+    SECTION("convex fills are triangulated as a fan") {
+        Mesh mesh;
+        PathTessellator().fill(*Path2::rect(Aabrf(Size2f(10, 20))), mesh);
+        REQUIRE(!mesh.needs_stencil);
+        REQUIRE(mesh.get_triangle_count() == 2);
+        REQUIRE(is_ccw(mesh));
+        REQUIRE(get_area(mesh) == Approx(200));
+    }
+
+    SECTION("concave fills are triangulated without overlap") {
+        Polylinef l_shape(V2f(0, 0), V2f(20, 0), V2f(20, 10), V2f(10, 10), V2f(10, 30), V2f(0, 30));
+        l_shape.set_closed();
+        Mesh mesh;
+        PathTessellator().fill(*make_path(l_shape), mesh);
+        REQUIRE(!mesh.needs_stencil);
+        REQUIRE(mesh.get_triangle_count() == 4);
+        REQUIRE(is_ccw(mesh));
+        REQUIRE(get_area(mesh) == Approx(400));
+
+        // clockwise paths produce counterclockwise triangles as well
+        Polylinef reversed(V2f(0, 30), V2f(10, 30), V2f(10, 10), V2f(20, 10), V2f(20, 0), V2f(0, 0));
+        reversed.set_closed();
+        mesh.clear();
+        PathTessellator().fill(*make_path(reversed), mesh);
+        REQUIRE(is_ccw(mesh));
+        REQUIRE(get_area(mesh) == Approx(400));
+    }
+
+    SECTION("self-intersecting fills are drawn with the stencil buffer") {
+        // bowties with a net area of zero, and with a net area that is smaller than the area they cover
+        for (const float height : {10.f, 8.f, 5.f}) {
+            Polylinef bowtie(V2f(0, 0), V2f(10, 10), V2f(10, 0), V2f(0, height));
+            bowtie.set_closed();
+            Mesh mesh;
+            PathTessellator().fill(*make_path(bowtie), mesh);
+            REQUIRE(mesh.needs_stencil);
+            REQUIRE(get_winding(mesh, V2f(1, height / 2)) != 0); // left lobe
+            REQUIRE(get_winding(mesh, V2f(9.5f, 5)) != 0);        // right lobe
+            REQUIRE(get_winding(mesh, V2f(5, 0.5f)) == 0);        // between the lobes
+        }
+    }
+
+    SECTION("fills without area produce no visible triangles") {
+        Polylinef spike(V2f(0, 0), V2f(10, 0), V2f(20, 0), V2f(10, 0));
+        spike.set_closed();
+        Mesh mesh;
+        PathTessellator().fill(*make_path(spike), mesh);
+        REQUIRE(get_area(mesh) == Approx(0));
+        for (const V2f& point : {V2f(5, 0.5f), V2f(5, -0.5f), V2f(15, 0.5f)}) {
+            REQUIRE(get_winding(mesh, point) == 0);
+        }
+    }
+
+    SECTION("strokes are made of counterclockwise triangles") {
+        const Path2Ptr line = make_path(Polylinef(V2f(0, 0), V2f(10, 0)));
+        PathTessellator tessellator;
+        Mesh mesh;
+
+        tessellator.stroke(*line, 2, Plotter::CapStyle::BUTT, Plotter::JointStyle::MITER, mesh);
+        REQUIRE(mesh.needs_stencil);
+        REQUIRE(is_ccw(mesh));
+        REQUIRE(get_area(mesh) == Approx(20));
+
+        mesh.clear();
+        tessellator.stroke(*line, 2, Plotter::CapStyle::SQUARE, Plotter::JointStyle::MITER, mesh);
+        REQUIRE(is_ccw(mesh));
+        REQUIRE(get_area(mesh) == Approx(24));
+
+        mesh.clear();
+        tessellator.stroke(*line, 2, Plotter::CapStyle::ROUND, Plotter::JointStyle::MITER, mesh);
+        REQUIRE(is_ccw(mesh));
+        // the caps are approximated within the tolerance, the missing area is at most their length times the tolerance
+        REQUIRE(get_area(mesh) <= 20 + pi<float>());
+        REQUIRE(get_area(mesh) >= 20 + pi<float>() * (1 - 2 * PathTessellator::default_tolerance));
+    }
+
+    SECTION("joints are mitered, beveled or rounded") {
+        const Path2Ptr rect = Path2::rect(Aabrf(Size2f(10, 20)));
+        PathTessellator tessellator;
+        Mesh mesh;
+
+        tessellator.stroke(*rect, 2, Plotter::CapStyle::BUTT, Plotter::JointStyle::MITER, mesh);
+        REQUIRE(is_ccw(mesh));
+        REQUIRE(has_vertex(mesh, V2f(-1, -1)));
+        REQUIRE(has_vertex(mesh, V2f(11, 21)));
+
+        mesh.clear();
+        tessellator.stroke(*rect, 2, Plotter::CapStyle::BUTT, Plotter::JointStyle::BEVEL, mesh);
+        REQUIRE(is_ccw(mesh));
+        REQUIRE(!has_vertex(mesh, V2f(-1, -1)));
+        REQUIRE(has_vertex(mesh, V2f(-1, 0)));
+
+        mesh.clear();
+        tessellator.stroke(*rect, 2, Plotter::CapStyle::BUTT, Plotter::JointStyle::ROUND, mesh);
+        REQUIRE(is_ccw(mesh));
+        REQUIRE(!has_vertex(mesh, V2f(-1, -1)));
+        const float diagonal = 1 / std::sqrt(2.f);
+        REQUIRE(has_vertex(mesh, V2f(-diagonal, -diagonal)));
+
+        // sharp angles exceed the miter limit
+        mesh.clear();
+        const Path2Ptr spike = make_path(Polylinef(V2f(0, 0), V2f(100, 1), V2f(0, 2)));
+        PathTessellator(PathTessellator::default_tolerance, 4)
+            .stroke(*spike, 2, Plotter::CapStyle::BUTT, Plotter::JointStyle::MITER, mesh);
+        for (const V2f& vertex : mesh.vertices) {
+            REQUIRE(vertex.x() <= 102);
+        }
+    }
+
+    SECTION("paths can be tessellated in parallel") {
+        std::vector<PathTessellator::Job> jobs;
+        for (size_t i = 0; i < 100; ++i) {
+            PathTessellator::Job job;
+            job.path = Path2::circle(V2f(static_cast<float>(i), 0), 10 + static_cast<float>(i));
+            job.stroke_width = static_cast<float>(i % 2) * 3;
+            jobs.emplace_back(std::move(job));
+        }
+
+        ThreadPool pool(3);
+        std::vector<Mesh> meshes;
+        PathTessellator::tessellate(jobs, meshes, pool);
+        REQUIRE(meshes.size() == jobs.size());
+
+        PathTessellator tessellator;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            Mesh expected;
+            if (jobs[i].stroke_width > 0) {
+                tessellator.stroke(*jobs[i].path, jobs[i].stroke_width, jobs[i].cap, jobs[i].joint, expected);
+            } else {
+                tessellator.fill(*jobs[i].path, expected);
+            }
+            REQUIRE(meshes[i].vertices == expected.vertices);
+            REQUIRE(meshes[i].indices == expected.indices);
+        }
+    }
+}
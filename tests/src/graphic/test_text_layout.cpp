@@ -0,0 +1,136 @@
+#include "catch.hpp"
+
+#include "notf/graphic/text/text_layout.hpp"
+
+NOTF_USING_NAMESPACE;
+
+namespace {
+
+/// Synthetic Glyph of a monospace font: 8 pixels wide, 10 pixels high with 2 pixels below the baseline.
+/// Spaces have an advance but no pixels.
+const Glyph& get_glyph(const codepoint_t codepoint) {
+    static const Glyph space = {{0, 0, 0, 0}, 0, 0, 8, 0};
+    static const Glyph letter = {{0, 0, 8, 10}, 0, 8, 8, 0};
+    return codepoint == ' ' ? space : letter;
+}
+
+/// Lays out the given text with the synthetic font.
+TextLayout layout_text(const std::string& text, const int width = 0) { return TextLayout(text, width, 12, get_glyph); }
+
+} // namespace
+
+SCENARIO("text layout", "[graphic][text][text_layout]") {
+
+    SECTION("single line layouts place each glyph one advance after the other") {
+        const TextLayout layout = layout_text("ab cd");
+        REQUIRE(layout.get_line_count() == 1);
+        REQUIRE(layout.get_characters().size() == 5);
+        for (size_t i = 0; i < 5; ++i) {
+            REQUIRE(layout.get_characters()[i].x == static_cast<Glyph::coord_t>(i * 8));
+            REQUIRE(layout.get_characters()[i].y == 0);
+        }
+        REQUIRE(layout.get_characters()[2].codepoint == ' ');
+    }
+
+    SECTION("the bounding box includes the parts of glyphs below the baseline") {
+        const Aabri aabr = layout_text("ab cd").get_aabr();
+        REQUIRE(aabr.get_left() == 0);
+        REQUIRE(aabr.get_right() == 40);
+        REQUIRE(aabr.get_bottom() == -2);
+        REQUIRE(aabr.get_top() == 8);
+    }
+
+    SECTION("empty texts have an empty layout") {
+        const TextLayout layout = layout_text("");
+        REQUIRE(layout.get_characters().empty());
+        REQUIRE(layout.get_aabr() == Aabri::zero());
+    }
+
+    SECTION("multi-byte characters are laid out as single characters") {
+        const TextLayout layout = layout_text("aä中");
+        REQUIRE(layout.get_characters().size() == 3);
+        REQUIRE(layout.get_characters()[1].codepoint == 0xE4);
+        REQUIRE(layout.get_characters()[2].codepoint == 0x4E2D);
+        REQUIRE(layout.get_characters()[2].x == 16);
+    }
+
+    SECTION("lines are broken at the last space before the text exceeds the width") {
+        const std::string text = "abc def ghi";
+        const TextLayout layout = layout_text(text, 60);
+        REQUIRE(layout.get_line_count() == 2);
+        REQUIRE(layout.get_line_breaks()[0] == 8);
+
+        // the second line starts at the left edge one line height below the first
+        const TextLayout::Character& first_of_second_line = layout.get_characters()[8];
+        REQUIRE(first_of_second_line.codepoint == 'g');
+        REQUIRE(first_of_second_line.x == 0);
+        REQUIRE(first_of_second_line.y == -12);
+
+        const Aabri aabr = layout.get_aabr();
+        REQUIRE(aabr.get_right() == 64);
+        REQUIRE(aabr.get_bottom() == -14);
+    }
+
+    SECTION("words longer than the width are not broken") {
+        const TextLayout layout = layout_text("abcdefghij", 40);
+        REQUIRE(layout.get_line_count() == 1);
+    }
+}
+
+SCENARIO("text layout cache", "[graphic][text][text_layout]") {
+    const Font::Identifier font{"font.ttf", 12};
+    const Font::Identifier other_font{"font.ttf", 14};
+    size_t layout_count = 0;
+    const auto produce = [&](const std::string& text, const int width = 0) {
+        return [&, text, width] {
+            ++layout_count;
+            return layout_text(text, width);
+        };
+    };
+
+    SECTION("layouts are only produced once") {
+        TextLayoutCache cache;
+        const TextLayoutConstPtr first = cache.get(font, "hello", 0, produce("hello"));
+        const TextLayoutConstPtr second = cache.get(font, "hello", 0, produce("hello"));
+        REQUIRE(first == second);
+        REQUIRE(layout_count == 1);
+        REQUIRE(cache.get_statistics().hits == 1);
+        REQUIRE(cache.get_statistics().misses == 1);
+        REQUIRE(cache.get_statistics().get_hit_ratio() == Approx(0.5f));
+    }
+
+    SECTION("layouts are identified by their font, text and width") {
+        TextLayoutCache cache;
+        cache.get(font, "hello", 0, produce("hello"));
+        cache.get(other_font, "hello", 0, produce("hello"));
+        cache.get(font, "hello", 20, produce("hello", 20));
+        cache.get(font, "world", 0, produce("world"));
+        REQUIRE(layout_count == 4);
+        REQUIRE(cache.get_size() == 4);
+    }
+
+    SECTION("the least recently used layout is evicted when the cache is full") {
+        TextLayoutCache cache(2);
+        cache.get(font, "a", 0, produce("a"));
+        cache.get(font, "b", 0, produce("b"));
+        cache.get(font, "a", 0, produce("a")); // "b" is now the least recently used
+        cache.get(font, "c", 0, produce("c"));
+        REQUIRE(cache.get_size() == 2);
+        REQUIRE(cache.get_statistics().evictions == 1);
+
+        layout_count = 0;
+        cache.get(font, "a", 0, produce("a"));
+        REQUIRE(layout_count == 0);
+        cache.get(font, "b", 0, produce("b"));
+        REQUIRE(layout_count == 1);
+    }
+
+    SECTION("clearing the cache removes all layouts") {
+        TextLayoutCache cache;
+        cache.get(font, "a", 0, produce("a"));
+        cache.clear();
+        REQUIRE(cache.get_size() == 0);
+        cache.get(font, "a", 0, produce("a"));
+        REQUIRE(layout_count == 2);
+    }
+}